@@ -57,10 +57,73 @@ bool CheckAnonInputMempoolConflicts(const CTxIn &txin, const uint256 txhash, CTx
     return true;
 };
 
-bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
+/**
+ * Reject key images repeated within the transaction or spent in the chain.
+ * A key image spent by txhash itself is allowed while connecting the block
+ * that contains it.
+ */
+static bool CheckKeyImages(const std::vector<uint8_t> &vKeyImages, uint32_t nInputs, const uint256 &txhash,
+                           CBlockTreeDB &blocktree, std::set<CCmpPubKey> &setHaveKI, TxValidationState &state)
+{
+    for (size_t k = 0; k < nInputs; ++k) {
+        const CCmpPubKey &ki = *((CCmpPubKey*)&vKeyImages[k*33]);
+
+        if (!setHaveKI.insert(ki).second) {
+            if (LogAcceptCategory(BCLog::VALIDATION, BCLog::Level::Debug)) {
+                LogPrintf("%s: Duplicate keyimage detected in txn %s.\n", __func__, HexStr(ki));
+            }
+            return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-anonin-dup-ki");
+        }
+
+        CAnonKeyImageInfo ki_data;
+        if (blocktree.ReadRCTKeyImage(ki, ki_data)) {
+            if (LogAcceptCategory(BCLog::VALIDATION, BCLog::Level::Debug)) {
+                LogPrintf("%s: Duplicate keyimage detected %s, used in %s.\n", __func__,
+                          HexStr(ki), ki_data.txid.ToString());
+            }
+            if (ki_data.txid == txhash) {
+                if (state.m_check_equal_rct_txid &&
+                    !(state.m_in_block && state.m_spend_height == ki_data.height)) {
+                    return state.Invalid(TxValidationResult::TX_CONFLICT, "txn-already-in-chain");
+                }
+            } else {
+                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-anonin-dup-ki");
+            }
+        }
+    }
+    return true;
+}
+
+bool PrecheckAnonKeyImages(const CTransaction &tx, CBlockTreeDB &blocktree, CTxMemPool *pmempool, TxValidationState &state)
+{
+    std::set<CCmpPubKey> setHaveKI;
+    const uint256 txhash = tx.GetHash();
+    for (const auto &txin : tx.vin) {
+        if (!txin.IsAnonInput()) {
+            continue;
+        }
+        // Also checks the size of the key image stack
+        if (!CheckAnonInputMempoolConflicts(txin, txhash, pmempool, state)) {
+            return false;
+        }
+        uint32_t nInputs, nRingSize;
+        txin.GetAnonInfo(nInputs, nRingSize);
+        if (!CheckKeyImages(txin.scriptData.stack[0], nInputs, txhash, blocktree, setHaveKI, state)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Check the MLSAG signatures of tx, only those of input only_input if set.
+ * A single input is checked before cs_main is taken, its ring is read from
+ * the rct index as it is then. Its key images are checked beforehand by
+ * PrecheckAnonKeyImages and again by VerifyMLSAG, which finds the signature
+ * in the prevalidation cache.
+ */
+static bool CheckMLSAG(const CTransaction &tx, TxValidationState &state, CBlockTreeDB *pblocktree, std::optional<size_t> only_input)
 {
-    assert(state.m_chainstate);
-    auto &pblocktree{state.m_chainstate->m_blockman.m_block_tree_db};
     const Consensus::Params &consensus = Params().GetConsensus();
 
     bool default_accept_anon = state.m_exploit_fix_2 ? true : globe::DEFAULT_ACCEPT_ANON_TX; // TODO: Remove after fork, set DEFAULT_ACCEPT_ANON_TX to true
@@ -100,7 +163,11 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
     }
     uint256 txhash = tx.GetHash();
 
-    for (const auto &txin : tx.vin) {
+    for (size_t n = 0; n < tx.vin.size(); ++n) {
+        const auto &txin = tx.vin[n];
+        if (only_input && n != *only_input) {
+            continue;
+        }
         if (!txin.IsAnonInput()) {
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-anon-input");
         }
@@ -142,6 +209,8 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
         std::vector<const uint8_t*> vpOutCommits;
         std::vector<const uint8_t*> vpInCommits(nCols * nInputs);
         std::vector<uint8_t> vM(nCols * nRows * 33);
+        std::vector<std::array<uint8_t, 64>> vKeyImageBases(nCols * nInputs);
+        std::vector<const uint8_t*> vpKeyImageBases(nCols * nInputs, nullptr);
 
         if (fSplitCommitments) {
             vpOutCommits.push_back(&vDL[(1 + (nInputs+1) * nRingSize) * 32]);
@@ -180,6 +249,10 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
             memcpy(&vM[(i+k*nCols)*33], ao.pubkey.begin(), 33);
             vCommitments.push_back(ao.commitment);
             vpInCommits[i+k*nCols] = vCommitments.back().data;
+            if (ao.key_image_base) {
+                vKeyImageBases[i+k*nCols] = *ao.key_image_base;
+                vpKeyImageBases[i+k*nCols] = vKeyImageBases[i+k*nCols].data();
+            }
 
             if (state.m_spend_height - ao.nBlockHeight + 1 < consensus.nMinRCTOutputDepth) {
                 LogPrint(BCLog::VALIDATION, "%s: Low input depth %s\n", __func__, state.m_spend_height - ao.nBlockHeight);
@@ -187,31 +260,16 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
             }
         }
 
-        for (size_t k = 0; k < nInputs; ++k) {
-            const CCmpPubKey &ki = *((CCmpPubKey*)&vKeyImages[k*33]);
-
-            if (!setHaveKI.insert(ki).second) {
-                if (LogAcceptCategory(BCLog::VALIDATION, BCLog::Level::Debug)) {
-                    LogPrintf("%s: Duplicate keyimage detected in txn %s.\n", __func__, HexStr(ki));
-                }
-                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-anonin-dup-ki");
-            }
+        if (!only_input &&
+            !CheckKeyImages(vKeyImages, nInputs, txhash, *pblocktree, setHaveKI, state)) {
+            return false;
+        }
 
-            CAnonKeyImageInfo ki_data;
-            if (pblocktree->ReadRCTKeyImage(ki, ki_data)) {
-                if (LogAcceptCategory(BCLog::VALIDATION, BCLog::Level::Debug)) {
-                    LogPrintf("%s: Duplicate keyimage detected %s, used in %s.\n", __func__,
-                              HexStr(ki), ki_data.txid.ToString());
-                }
-                if (ki_data.txid == txhash) {
-                    if (state.m_check_equal_rct_txid &&
-                        !(state.m_in_block && state.m_spend_height == ki_data.height)) {
-                        return state.Invalid(TxValidationResult::TX_CONFLICT, "txn-already-in-chain");
-                    }
-                } else {
-                    return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-anonin-dup-ki");
-                }
-            }
+        // The signature depends only on the transaction and the ring read
+        const uint256 cache_entry = MLSAGCacheEntry(tx.GetWitnessHash(), n,
+            Span{vM}.first(nCols * nInputs * 33), vCommitments);
+        if (!only_input && PrevalidationCacheContains(cache_entry, /*erase=*/state.m_in_block)) {
+            continue;
         }
         if (0 != (rv = secp256k1_prepare_mlsag(&vM[0], nullptr,
             vpOutCommits.size(), 0, nCols, nRows,
@@ -219,12 +277,18 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
             LogPrintf("ERROR: %s: prepare-mlsag-failed %d\n", __func__, rv);
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "prepare-mlsag-failed");
         }
-        if (0 != (rv = secp256k1_verify_mlsag(
+        if (0 != (rv = secp256k1_verify_mlsag_hp(
             txhash.begin(), nCols, nRows,
-            &vM[0], &vKeyImages[0], &vDL[0], &vDL[32]))) {
+            &vM[0], vpKeyImageBases.data(), &vKeyImages[0], &vDL[0], &vDL[32]))) {
             LogPrintf("ERROR: %s: verify-mlsag-failed %d\n", __func__, rv);
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "verify-mlsag-failed");
         }
+        if (!state.m_in_block) {
+            PrevalidationCacheInsert(cache_entry);
+        }
+    }
+    if (only_input) {
+        return true;
     }
 
     // Verify commitment sums match
@@ -250,11 +314,32 @@ bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
     return true;
 };
 
+bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state)
+{
+    assert(state.m_chainstate);
+    return CheckMLSAG(tx, state, state.m_chainstate->m_blockman.m_block_tree_db.get(), std::nullopt);
+};
+
+bool PrevalidateMLSAG(const CTransaction &tx, size_t input, CBlockTreeDB &blocktree, TxValidationState &state)
+{
+    return CheckMLSAG(tx, state, &blocktree, input);
+};
+
 int GetKeyImage(CCmpPubKey &ki, const CCmpPubKey &pubkey, const CKey &key)
 {
     return secp256k1_get_keyimage(ki.ncbegin(), pubkey.begin(), key.begin());
 };
 
+bool SetKeyImageBase(CAnonOutput &ao)
+{
+    std::array<uint8_t, 64> base;
+    if (0 != secp256k1_get_keyimage_base(base.data(), ao.pubkey.begin())) {
+        return false;
+    }
+    ao.key_image_base = base;
+    return true;
+};
+
 bool AddKeyImagesToMempool(const CTransaction &tx, CTxMemPool &pool)
 {
     for (const CTxIn &txin : tx.vin) {
@@ -15,6 +15,8 @@ extern RecursiveMutex cs_main;
 
 class uint256;
 class CTxIn;
+class CAnonOutput;
+class CBlockTreeDB;
 class CKey;
 class CTransaction;
 class CTxMemPool;
@@ -36,8 +38,15 @@ const size_t DEFAULT_INPUTS_PER_SIG = 1;
 bool CheckAnonInputMempoolConflicts(const CTxIn &txin, const uint256 txhash, CTxMemPool *pmempool, TxValidationState &state);
 
 bool VerifyMLSAG(const CTransaction &tx, TxValidationState &state) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+/** Reject tx if a key image repeats, is spent in the chain or by another mempool
+ * transaction. Cheap checks run before the MLSAGs are prevalidated. */
+bool PrecheckAnonKeyImages(const CTransaction &tx, CBlockTreeDB &blocktree, CTxMemPool *pmempool, TxValidationState &state);
+/** Check the MLSAG of one input without cs_main, see ChainstateManager::PrevalidateTransaction */
+bool PrevalidateMLSAG(const CTransaction &tx, size_t input, CBlockTreeDB &blocktree, TxValidationState &state);
 
 int GetKeyImage(CCmpPubKey &ki, const CCmpPubKey &pubkey, const CKey &key);
+/** Set ao.key_image_base, the point its key image is taken from */
+bool SetKeyImageBase(CAnonOutput &ao);
 bool AddKeyImagesToMempool(const CTransaction &tx, CTxMemPool &pool);
 bool RemoveKeyImagesFromMempool(const uint256 &hash, const CTxIn &txin, CTxMemPool &pool);
 
@@ -8,6 +8,7 @@
 #include <util/time.h>
 
 #include <blind.h>
+#include <consensus/params.h>
 #include <random.h>
 #include <key.h>
 
@@ -62,5 +63,37 @@ static void Blind(benchmark::Bench& bench)
     ECC_Stop();
 }
 
+static void BlindedOutputLists(benchmark::Bench& bench)
+{
+    LoadBlindedOutputFilters();
+    Consensus::Params params;
+    params.exploit_fix_3_time = 0;
+
+    // Ring member indices spread over the range the compiled in lists cover
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<int64_t> indices(4096);
+    for (auto& index : indices) {
+        index = rng.randrange(30000);
+    }
+    std::vector<uint256> txids(256);
+    for (auto& txid : txids) {
+        txid = rng.rand256();
+    }
+
+    size_t n = 0, found = 0;
+    bench.batch(indices.size() + txids.size()).unit("lookup").run([&] {
+        for (int64_t index : indices) {
+            found += IsBlacklistedAnonOutput(index);
+            found += IsWhitelistedAnonOutput(index, n, params);
+        }
+        for (const auto& txid : txids) {
+            found += IsFrozenBlindOutput(txid);
+        }
+        n++;
+    });
+    assert(found > 0);
+}
+
 BENCHMARK(Blind);
+BENCHMARK(BlindedOutputLists);
 
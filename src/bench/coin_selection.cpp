@@ -17,9 +17,11 @@ using wallet::CHANGE_LOWER;
 using wallet::COutput;
 using wallet::CWallet;
 using wallet::CWalletTx;
+using wallet::ChooseBlindedSelectionResult;
 using wallet::CoinEligibilityFilter;
 using wallet::CoinSelectionParams;
 using wallet::CreateDummyWalletDatabase;
+using wallet::KnapsackSolver;
 using wallet::OutputGroup;
 using wallet::SelectCoinsBnB;
 using wallet::TxStateInactive;
@@ -121,5 +123,46 @@ static void BnBExhaustion(benchmark::Bench& bench)
     });
 }
 
+/** Many small anon outputs, each input costing a ring of 12 members */
+static void BlindedCoinSelection(benchmark::Bench& bench, bool legacy)
+{
+    FastRandomContext rand{/*fDeterministic=*/true};
+    CoinSelectionParams coin_selection_params{rand};
+    coin_selection_params.m_effective_feerate = CFeeRate(10000);
+    coin_selection_params.m_long_term_feerate = CFeeRate(10000);
+    coin_selection_params.m_discard_feerate = CFeeRate(10000);
+    coin_selection_params.change_output_size = 779;
+    coin_selection_params.change_spend_size = 284;
+    coin_selection_params.m_change_fee = coin_selection_params.m_effective_feerate.GetFee(coin_selection_params.change_output_size);
+    coin_selection_params.m_cost_of_change = coin_selection_params.m_discard_feerate.GetFee(coin_selection_params.change_spend_size) + coin_selection_params.m_change_fee;
+    coin_selection_params.min_viable_change = coin_selection_params.m_discard_feerate.GetFee(coin_selection_params.change_spend_size) + 1;
+    coin_selection_params.m_min_change_target = CHANGE_LOWER;
+
+    std::vector<OutputGroup> groups;
+    for (int i = 0; i < 20000; ++i) {
+        CTxOut txout(1000000 + rand.randrange(10 * COIN), CScript());
+        COutput output(COutPoint(rand.rand256(), 0), txout, /*depth=*/6, /*input_bytes=*/284, /*spendable=*/true, /*solvable=*/true, /*safe=*/true, /*time=*/0, /*from_me=*/true,
+                       coin_selection_params.m_effective_feerate);
+        groups.emplace_back(coin_selection_params);
+        groups.back().Insert(output, /*ancestors=*/0, /*descendants=*/0, /*positive_only=*/false);
+    }
+
+    bench.run([&] {
+        if (legacy) {
+            std::vector<OutputGroup> all_groups(groups);
+            auto result = KnapsackSolver(all_groups, 25 * COIN, coin_selection_params.m_min_change_target, rand);
+            assert(result);
+        } else {
+            auto result = ChooseBlindedSelectionResult(groups, 25 * COIN, coin_selection_params, /*random_selection=*/false);
+            assert(result);
+        }
+    });
+}
+
+static void BlindedCoinSelectionKnapsack(benchmark::Bench& bench) { BlindedCoinSelection(bench, /*legacy=*/true); }
+static void BlindedCoinSelectionWaste(benchmark::Bench& bench) { BlindedCoinSelection(bench, /*legacy=*/false); }
+
 BENCHMARK(CoinSelection);
 BENCHMARK(BnBExhaustion);
+BENCHMARK(BlindedCoinSelectionKnapsack);
+BENCHMARK(BlindedCoinSelectionWaste);
@@ -6,6 +6,10 @@
 
 #include <support/lockedpool.h>
 
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #define ASIZE 2048
@@ -39,4 +43,45 @@ static void BenchLockedPool(benchmark::Bench& bench)
     addr.clear();
 }
 
+/** Heap backed pages, so the benchmark does not depend on the mlock limit */
+class BenchPageAllocator: public LockedPageAllocator
+{
+public:
+    void* AllocateLocked(size_t len, bool *lockingSuccess) override
+    {
+        *lockingSuccess = true;
+        return std::malloc(len);
+    }
+    void FreeLocked(void* addr, size_t len) override
+    {
+        std::free(addr);
+    }
+    size_t GetLimit() override
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+};
+
+/** Allocate and free a batch of keys and blinding factors, as a wallet unlock does */
+static void LockedPoolKeys(benchmark::Bench& bench, size_t num_keys)
+{
+    LockedPool pool(std::make_unique<BenchPageAllocator>());
+
+    std::vector<void*> keys(num_keys);
+    bench.batch(num_keys * 2).unit("alloc").run([&] {
+        for (size_t i = 0; i < num_keys; ++i) {
+            keys[i] = pool.alloc(i % 4 == 3 ? 64 : 32);
+            assert(keys[i]);
+        }
+        for (size_t i = 0; i < num_keys; ++i) {
+            pool.free(keys[i]);
+        }
+    });
+}
+
+static void LockedPoolKeys1000(benchmark::Bench& bench) { LockedPoolKeys(bench, 1000); }
+static void LockedPoolKeys5000(benchmark::Bench& bench) { LockedPoolKeys(bench, 5000); }
+
 BENCHMARK(BenchLockedPool);
+BENCHMARK(LockedPoolKeys1000);
+BENCHMARK(LockedPoolKeys5000);
@@ -33,6 +33,14 @@ static void LoggingNoCategory(benchmark::Bench& bench)
 {
     Logging(bench, {"-logthreadnames=0", "-debug=0"}, [] { LogPrint(BCLog::NET, "%s\n", "test"); });
 }
+static void LoggingAsync(benchmark::Bench& bench)
+{
+    Logging(bench, {"-logthreadnames=0", "-logasync", "-logasyncbuffer=65536"}, [] { LogPrintf("%s\n", "test"); });
+}
+static void LoggingAsyncCategory(benchmark::Bench& bench)
+{
+    Logging(bench, {"-logthreadnames=0", "-logasync", "-logasyncbuffer=65536", "-debug=net"}, [] { LogPrint(BCLog::NET, "%s\n", "test"); });
+}
 static void LoggingNoFile(benchmark::Bench& bench)
 {
     Logging(bench, {"-nodebuglogfile", "-debug=1"}, [] {
@@ -45,4 +53,6 @@ BENCHMARK(LoggingYoThreadNames);
 BENCHMARK(LoggingNoThreadNames);
 BENCHMARK(LoggingYoCategory);
 BENCHMARK(LoggingNoCategory);
+BENCHMARK(LoggingAsync);
+BENCHMARK(LoggingAsyncCategory);
 BENCHMARK(LoggingNoFile);
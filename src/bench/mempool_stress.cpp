@@ -3,7 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <netmessagemaker.h>
+#include <node/txrelaycache.h>
 #include <policy/policy.h>
+#include <protocol.h>
 #include <test/util/setup_common.h>
 #include <txmempool.h>
 #include <validation.h>
@@ -114,5 +117,81 @@ static void MempoolCheck(benchmark::Bench& bench)
     });
 }
 
+/** Transactions with blinded outputs, the rangeproofs are the bulk of their size */
+static std::vector<CTransactionRef> CreateCTTxs(FastRandomContext& det_rand, int count)
+{
+    std::vector<CTransactionRef> txs;
+    for (int x = 0; x < count; ++x) {
+        CMutableTransaction tx;
+        tx.nVersion = GLOBE_TXN_VERSION;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(det_rand.rand256(), 0);
+        tx.vin[0].scriptWitness.stack.push_back(det_rand.randbytes(72));
+        tx.vin[0].scriptWitness.stack.push_back(det_rand.randbytes(33));
+        for (int i = 0; i < 2; ++i) {
+            auto out = MAKE_OUTPUT<CTxOutCT>();
+            const std::vector<unsigned char> commitment = det_rand.randbytes(33);
+            memcpy(out->commitment.data, commitment.data(), 33);
+            out->vData = det_rand.randbytes(33);
+            out->scriptPubKey = CScript() << OP_DUP << OP_HASH160 << det_rand.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG;
+            out->vRangeproof = det_rand.randbytes(2893);
+            tx.vpout.push_back(out);
+        }
+        txs.emplace_back(MakeTransactionRef(tx));
+    }
+    return txs;
+}
+
+/** Answer a getdata for each mempool transaction, serializing them every time */
+static void MempoolRelayCTSerialize(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    std::vector<CTransactionRef> txs = CreateCTTxs(det_rand, 200);
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN);
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+    {
+        LOCK2(cs_main, pool.cs);
+        for (auto& tx : txs) {
+            AddTx(tx, pool);
+        }
+    }
+    const CNetMsgMaker msg_maker(PROTOCOL_VERSION);
+
+    bench.batch(txs.size()).unit("tx").run([&] {
+        for (const auto& tx : txs) {
+            const TxMempoolInfo info = pool.info(GenTxid::Wtxid(tx->GetWitnessHash()));
+            CSerializedNetMsg msg = msg_maker.Make(NetMsgType::TX, *info.tx);
+            ankerl::nanobench::doNotOptimizeAway(msg.data.size());
+        }
+    });
+}
+
+/** Answer a getdata for each mempool transaction from the relay cache, as when several peers request them */
+static void MempoolRelayCTCached(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    std::vector<CTransactionRef> txs = CreateCTTxs(det_rand, 200);
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN);
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+    {
+        LOCK2(cs_main, pool.cs);
+        for (auto& tx : txs) {
+            AddTx(tx, pool);
+        }
+    }
+    const CNetMsgMaker msg_maker(PROTOCOL_VERSION);
+    node::TxRelayCache relay_cache{node::DEFAULT_TX_RELAY_CACHE_BYTES};
+
+    bench.batch(txs.size()).unit("tx").run([&] {
+        for (const auto& tx : txs) {
+            const TxMempoolInfo info = pool.info(GenTxid::Wtxid(tx->GetWitnessHash()));
+            CSerializedNetMsg msg = msg_maker.Make(NetMsgType::TX, Span{*relay_cache.Get(*info.tx)});
+            ankerl::nanobench::doNotOptimizeAway(msg.data.size());
+        }
+    });
+}
+
 BENCHMARK(ComplexMemPool);
 BENCHMARK(MempoolCheck);
+BENCHMARK(MempoolRelayCTSerialize);
+BENCHMARK(MempoolRelayCTCached);
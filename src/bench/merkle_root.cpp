@@ -23,4 +23,20 @@ static void MerkleRoot(benchmark::Bench& bench)
     });
 }
 
+static void MerkleRootUpdateFirst(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves;
+    leaves.resize(9001);
+    for (auto& item : leaves) {
+        item = rng.rand256();
+    }
+    MerkleTree tree(leaves), witness_tree(leaves);
+    bench.batch(1).unit("update").run([&] {
+        // As staking does when replacing the coinstake
+        MerkleTree::Update({{&tree, rng.rand256()}, {&witness_tree, rng.rand256()}}, 0);
+    });
+}
+
 BENCHMARK(MerkleRoot);
+BENCHMARK(MerkleRootUpdateFirst);
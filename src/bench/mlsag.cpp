@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <iostream>
+#include <vector>
 
 #include <bench/bench.h>
 #include <util/time.h>
@@ -16,30 +17,31 @@
 #include <secp256k1_rangeproof.h>
 #include <secp256k1_mlsag.h>
 
-static void Mlsag(benchmark::Bench& bench)
+/** Verify a signature over nInputs inputs and rings of nCols members */
+static void MlsagVerify(benchmark::Bench& bench, const size_t nInputs, const size_t nCols, bool precomputed_bases = false)
 {
     TestingSetup test_setup{CBaseChainParams::REGTEST, {}, true};
 
-    const size_t nInputs = 2;
-    const size_t nCols = 4;
     const size_t nRows = nInputs+1;
     const size_t nRealCol = 1;
     const size_t nOutputs = 2;
     const size_t nBlinded = 1;
     uint8_t tmp32[32], preimage[32];
 
-    int64_t nValues[] = {1234 * COIN, 1234 * COIN, 2467 * COIN, 1 * COIN};
+    std::vector<int64_t> nValues(nInputs, 1234 * COIN);
+    nValues.push_back(1234 * COIN * nInputs - 1 * COIN);
+    nValues.push_back(1 * COIN);
 
-    std::vector<CKey> vKeys(2), vBlindsOut(1), vBlindsIn(2);
+    std::vector<CKey> vKeys(nInputs), vBlindsOut(1), vBlindsIn(nInputs);
 
-    const uint8_t *pkeys[nInputs+1];
-    uint8_t m[nRows * nCols * 33];
-    const uint8_t *pcm_in[nInputs * nCols], *pcm_out[nOutputs], *pblinds[nInputs + nOutputs];
-    secp256k1_pedersen_commitment cm_in[nInputs * nCols];
-    secp256k1_pedersen_commitment cm_out[nOutputs];
+    std::vector<const uint8_t*> pkeys(nInputs+1);
+    std::vector<uint8_t> m(nRows * nCols * 33);
+    std::vector<const uint8_t*> pcm_in(nInputs * nCols), pcm_out(nOutputs), pblinds(nInputs + nOutputs);
+    std::vector<secp256k1_pedersen_commitment> cm_in(nInputs * nCols);
+    std::vector<secp256k1_pedersen_commitment> cm_out(nOutputs);
     uint8_t pc[32];
-    uint8_t ki[nInputs * 33];
-    uint8_t ss[(nInputs+1) * nCols * 33]; // max_rows * max_cols
+    std::vector<uint8_t> ki(nInputs * 33);
+    std::vector<uint8_t> ss(nRows * nCols * 32);
 
 
     for (size_t k = 0; k < nBlinded; ++k) {
@@ -91,23 +93,43 @@ static void Mlsag(benchmark::Bench& bench)
     uint8_t blindSum[32];
     pkeys[nInputs] = blindSum;
 
-    assert(0 == secp256k1_prepare_mlsag(m, blindSum,
+    assert(0 == secp256k1_prepare_mlsag(m.data(), blindSum,
         nOutputs, nBlinded, nCols, nRows,
-        pcm_in, pcm_out, pblinds));
+        pcm_in.data(), pcm_out.data(), pblinds.data()));
 
     GetRandBytes(Span<unsigned char>(tmp32, 32));
     GetRandBytes(Span<unsigned char>(preimage, 32));
 
-    assert(0 == secp256k1_generate_mlsag(secp256k1_ctx_blind, ki, pc, ss,
+    assert(0 == secp256k1_generate_mlsag(secp256k1_ctx_blind, ki.data(), pc, ss.data(),
         tmp32, preimage, nCols, nRows, nRealCol,
-        pkeys, m));
+        pkeys.data(), m.data()));
 
 
+    // Key image bases as stored in the rct index
+    std::vector<uint8_t> bases(nCols * nInputs * 64);
+    std::vector<const uint8_t*> hp(nCols * nInputs, nullptr);
+    if (precomputed_bases) {
+        for (size_t i = 0; i < hp.size(); ++i) {
+            assert(0 == secp256k1_get_keyimage_base(&bases[i * 64], &m[i * 33]));
+            hp[i] = &bases[i * 64];
+        }
+    }
+
     bench.run([&] {
-        assert(0 == secp256k1_verify_mlsag(
+        assert(0 == secp256k1_verify_mlsag_hp(
             preimage, nCols, nRows,
-            m, ki, pc, ss));
+            m.data(), hp.data(), ki.data(), pc, ss.data()));
     });
 }
 
+static void Mlsag(benchmark::Bench& bench) { MlsagVerify(bench, 2, 4); }
+static void MlsagRing16(benchmark::Bench& bench) { MlsagVerify(bench, 1, 16); }
+static void MlsagRing32(benchmark::Bench& bench) { MlsagVerify(bench, 1, 32); }
+static void MlsagRing32Inputs4(benchmark::Bench& bench) { MlsagVerify(bench, 4, 32); }
+static void MlsagRing32Precomputed(benchmark::Bench& bench) { MlsagVerify(bench, 1, 32, /*precomputed_bases=*/true); }
+
 BENCHMARK(Mlsag);
+BENCHMARK(MlsagRing16);
+BENCHMARK(MlsagRing32);
+BENCHMARK(MlsagRing32Inputs4);
+BENCHMARK(MlsagRing32Precomputed);
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <rpc/server.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+
+#include <univalue.h>
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace {
+/** Stand-in for the HTTP work queue */
+class BenchWorkers
+{
+    Mutex cs;
+    std::condition_variable cond;
+    std::deque<std::function<void()>> queue GUARDED_BY(cs);
+    bool running GUARDED_BY(cs){true};
+    std::vector<std::thread> threads;
+
+    void Run()
+    {
+        while (true) {
+            std::function<void()> func;
+            {
+                WAIT_LOCK(cs, lock);
+                while (running && queue.empty()) {
+                    cond.wait(lock);
+                }
+                if (queue.empty()) {
+                    return;
+                }
+                func = std::move(queue.front());
+                queue.pop_front();
+            }
+            func();
+        }
+    }
+
+public:
+    explicit BenchWorkers(int num_threads)
+    {
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([this] { Run(); });
+        }
+    }
+    ~BenchWorkers()
+    {
+        {
+            LOCK(cs);
+            running = false;
+        }
+        cond.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    bool Submit(std::function<void()> func)
+    {
+        {
+            LOCK(cs);
+            queue.push_back(std::move(func));
+        }
+        cond.notify_one();
+        return true;
+    }
+};
+} // namespace
+
+static void RpcBatch(benchmark::Bench& bench, size_t batch_size, int max_parallel)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    SetRPCWarmupFinished();
+
+    const std::string genesis_hash = testing_setup->m_node.chainman->ActiveChain().Genesis()->GetBlockHash().GetHex();
+    UniValue batch(UniValue::VARR);
+    for (size_t i = 0; i < batch_size; ++i) {
+        UniValue params(UniValue::VARR);
+        std::string method;
+        if (i % 2 == 0) {
+            method = "getblockhash";
+            params.push_back(0);
+        } else {
+            method = "getblockheader";
+            params.push_back(genesis_hash);
+        }
+        UniValue req(UniValue::VOBJ);
+        req.pushKV("method", method);
+        req.pushKV("params", params);
+        req.pushKV("id", (int)i);
+        batch.push_back(req);
+    }
+
+    JSONRPCRequest jreq;
+    jreq.context = &testing_setup->m_node;
+
+    BenchWorkers workers(max_parallel - 1);
+    const RPCWorkSubmitter submit = [&](std::function<void()> func) { return workers.Submit(std::move(func)); };
+    bench.batch(batch_size).unit("call").run([&] {
+        std::string reply = JSONRPCExecBatch(jreq, batch, submit, max_parallel);
+        assert(!reply.empty());
+    });
+}
+
+static void RpcBatch1Serial(benchmark::Bench& bench) { RpcBatch(bench, 1, 1); }
+static void RpcBatch16Serial(benchmark::Bench& bench) { RpcBatch(bench, 16, 1); }
+static void RpcBatch16Parallel(benchmark::Bench& bench) { RpcBatch(bench, 16, 4); }
+static void RpcBatch256Serial(benchmark::Bench& bench) { RpcBatch(bench, 256, 1); }
+static void RpcBatch256Parallel(benchmark::Bench& bench) { RpcBatch(bench, 256, 4); }
+
+BENCHMARK(RpcBatch1Serial);
+BENCHMARK(RpcBatch16Serial);
+BENCHMARK(RpcBatch16Parallel);
+BENCHMARK(RpcBatch256Serial);
+BENCHMARK(RpcBatch256Parallel);
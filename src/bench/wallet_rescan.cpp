@@ -0,0 +1,111 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/script.h>
+#include <streams.h>
+#include <version.h>
+#include <wallet/rescan.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using wallet::RescanCoordinator;
+
+static constexpr int RESCAN_WALLETS{20};
+static constexpr int RESCAN_BLOCKS{10000};
+
+/** Serialized blocks standing in for the block files */
+struct RescanBlocks {
+    std::vector<uint256> hashes;
+    std::vector<std::vector<unsigned char>> data;
+
+    RescanBlocks()
+    {
+        FastRandomContext rng{/*fDeterministic=*/true};
+        for (int height = 0; height < RESCAN_BLOCKS; ++height) {
+            CBlock block;
+            block.nTime = height;
+            for (int i = 0; i < 4; ++i) {
+                CMutableTransaction mtx;
+                mtx.vin.resize(2);
+                for (auto& txin : mtx.vin) {
+                    txin.prevout = COutPoint(rng.rand256(), rng.randrange(4));
+                    txin.scriptSig = CScript() << std::vector<unsigned char>(72, 1) << std::vector<unsigned char>(33, 2);
+                }
+                mtx.vout.resize(2);
+                for (auto& txout : mtx.vout) {
+                    txout.nValue = rng.randrange(1000000);
+                    txout.scriptPubKey = CScript() << OP_DUP << OP_HASH160 << rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG;
+                }
+                block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+            }
+            CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+            stream << block;
+            hashes.push_back(block.GetHash());
+            data.emplace_back(UCharCast(stream.data()), UCharCast(stream.data() + stream.size()));
+        }
+    }
+
+    bool Read(int height, CBlock& block) const
+    {
+        CDataStream stream(data[height], SER_NETWORK, PROTOCOL_VERSION);
+        stream >> block;
+        return true;
+    }
+};
+
+/** Minimal per block work of a wallet, look at every output */
+static size_t ScanBlock(const CBlock& block)
+{
+    size_t outputs{0};
+    for (const auto& tx : block.vtx) {
+        outputs += tx->vout.size();
+    }
+    return outputs;
+}
+
+static void WalletRescan(benchmark::Bench& bench, bool shared)
+{
+    const RescanBlocks blocks;
+    bench.batch(RESCAN_BLOCKS).unit("block").epochs(1).epochIterations(1).run([&] {
+        RescanCoordinator coordinator;
+        std::atomic<size_t> total_outputs{0};
+        auto scan = [&] {
+            RescanCoordinator::Scan shared_scan(coordinator, /*start_height=*/0);
+            size_t outputs{0};
+            for (int height = 0; height < RESCAN_BLOCKS; ++height) {
+                if (shared) {
+                    const auto block = shared_scan.ReadBlock(blocks.hashes[height], height, [&](const uint256&, CBlock& block) {
+                        return blocks.Read(height, block);
+                    });
+                    assert(block);
+                    outputs += ScanBlock(*block);
+                } else {
+                    CBlock block;
+                    blocks.Read(height, block);
+                    outputs += ScanBlock(block);
+                }
+            }
+            total_outputs += outputs;
+        };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < RESCAN_WALLETS; ++i) {
+            threads.emplace_back(scan);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(total_outputs == size_t{RESCAN_WALLETS} * RESCAN_BLOCKS * 4 * 2);
+    });
+}
+
+static void WalletRescanSeparate(benchmark::Bench& bench) { WalletRescan(bench, /*shared=*/false); }
+static void WalletRescanShared(benchmark::Bench& bench) { WalletRescan(bench, /*shared=*/true); }
+
+BENCHMARK(WalletRescanSeparate);
+BENCHMARK(WalletRescanShared);
@@ -18,18 +18,109 @@
 #include <chain/ct_tainted.h>
 #include <chain/tx_blacklist.h>
 #include <chain/tx_whitelist.h>
-#include <set>
+
+#include <algorithm>
+#include <vector>
 
 
 secp256k1_context *secp256k1_ctx_blind = nullptr;
-secp256k1_scratch_space *blind_scratch = nullptr;
 secp256k1_bulletproof_generators *blind_gens = nullptr;
 
+namespace {
+/** Scratch space of one thread, secp256k1 scratch spaces are not thread safe.
+ * Scratch spaces only use the context to report errors, so they do not depend
+ * on the lifetime of secp256k1_ctx_blind.
+ */
+class BlindScratch
+{
+public:
+    ~BlindScratch()
+    {
+        if (m_scratch) {
+            secp256k1_scratch_space_destroy(secp256k1_context_no_precomp, m_scratch);
+        }
+    }
+    secp256k1_scratch_space *Get()
+    {
+        if (!m_scratch) {
+            m_scratch = secp256k1_scratch_space_create(secp256k1_context_no_precomp, 1024 * 1024);
+            assert(m_scratch);
+        }
+        return m_scratch;
+    }
+private:
+    secp256k1_scratch_space *m_scratch{nullptr};
+};
+} // namespace
+
+secp256k1_scratch_space *GetBlindScratch()
+{
+    static thread_local BlindScratch scratch;
+    return scratch.Get();
+}
+
+namespace {
+/**
+ * Set of anon output indices, checked for every ring member.
+ * Stored as one bit per index from the lowest to the highest entry, which
+ * for the compiled in lists is a few KiB. Sparse sets fall back to a sorted
+ * array.
+ */
+class AnonIndexSet
+{
+public:
+    static constexpr uint64_t MAX_BITS{1 << 24};
+
+    void Set(const int64_t indices[], size_t num_indices)
+    {
+        m_sorted.assign(indices, indices + num_indices);
+        std::sort(m_sorted.begin(), m_sorted.end());
+        m_sorted.erase(std::unique(m_sorted.begin(), m_sorted.end()), m_sorted.end());
+
+        m_base = m_sorted.empty() ? 0 : m_sorted.front();
+        // Spans the whole int64 range at most, adding one may wrap
+        const uint64_t span = m_sorted.empty() ? 0 : uint64_t(m_sorted.back()) - uint64_t(m_base);
+        m_dense = span < MAX_BITS;
+        if (!m_dense) {
+            m_num_bits = 0;
+            // Word 0 is read for indices out of range, keep at least one
+            m_bits.assign(1, 0);
+            return;
+        }
+        m_num_bits = m_sorted.empty() ? 0 : span + 1;
+        m_bits.assign(std::max<uint64_t>(1, (m_num_bits + 63) / 64), 0);
+        for (int64_t index : m_sorted) {
+            const uint64_t pos = uint64_t(index) - uint64_t(m_base);
+            m_bits[pos >> 6] |= uint64_t{1} << (pos & 63);
+        }
+    }
+
+    bool Contains(int64_t index) const
+    {
+        if (!m_dense) {
+            return std::binary_search(m_sorted.begin(), m_sorted.end(), index);
+        }
+        const uint64_t pos = uint64_t(index) - uint64_t(m_base); // Wraps below m_base
+        const uint64_t in_range = pos < m_num_bits;
+        return (m_bits[(pos >> 6) * in_range] >> (pos & 63)) & in_range;
+    }
+
+    size_t size() const { return m_sorted.size(); }
+
+private:
+    std::vector<int64_t> m_sorted;
+    std::vector<uint64_t> m_bits{0};
+    int64_t m_base{0};
+    uint64_t m_num_bits{0};
+    bool m_dense{true};
+};
+} // namespace
+
 static CBloomFilter ct_tainted_filter;
-static std::set<uint256> ct_whitelist;
-static std::set<int64_t> rct_whitelist;
-static std::set<int64_t> rct_blacklist;
-static std::set<int64_t> rct_whitelist2;
+static std::vector<uint256> ct_whitelist; // Sorted
+static AnonIndexSet rct_whitelist;
+static AnonIndexSet rct_blacklist;
+static AnonIndexSet rct_whitelist2;
 
 static int CountLeadingZeros(uint64_t nValueIn)
 {
@@ -144,7 +235,7 @@ int GetRangeProofInfo(const std::vector<uint8_t> &vRangeproof, int &rexp, int &r
 
 void LoadRCTBlacklist(const int64_t indices[], size_t num_indices)
 {
-    rct_blacklist = std::set<int64_t>(indices, indices + num_indices);
+    rct_blacklist.Set(indices, num_indices);
     LogPrintf("RCT blacklist size %d\n", rct_blacklist.size());
 }
 
@@ -152,11 +243,11 @@ void LoadRCTWhitelist(const int64_t indices[], size_t num_indices, int list_id)
 {
     switch (list_id) {
         case 1:
-            rct_whitelist = std::set<int64_t>(indices, indices + num_indices);
+            rct_whitelist.Set(indices, num_indices);
             LogPrintf("RCT whitelist size %d\n", rct_whitelist.size());
             break;
         case 2:
-            rct_whitelist2 = std::set<int64_t>(indices, indices + num_indices);
+            rct_whitelist2.Set(indices, num_indices);
             LogPrintf("RCT whitelist2 size %d\n", rct_whitelist2.size());
             break;
         default:
@@ -171,8 +262,10 @@ void LoadCTWhitelist(const unsigned char *data, size_t data_length)
 
     ct_whitelist.clear();
     for (size_t i = 0; i < data_length; i += 32) {
-        ct_whitelist.insert(uint256(&data[i], 32));
+        ct_whitelist.emplace_back(&data[i], 32);
     }
+    std::sort(ct_whitelist.begin(), ct_whitelist.end());
+    ct_whitelist.erase(std::unique(ct_whitelist.begin(), ct_whitelist.end()), ct_whitelist.end());
     LogPrintf("CT whitelist size %d\n", ct_whitelist.size());
 }
 
@@ -194,23 +287,23 @@ void LoadBlindedOutputFilters()
 bool IsFrozenBlindOutput(const uint256 &txid)
 {
     if (ct_tainted_filter.contains(txid)) {
-        return !ct_whitelist.count(txid);
+        return !std::binary_search(ct_whitelist.begin(), ct_whitelist.end(), txid);
     }
     return false;
 }
 
 bool IsBlacklistedAnonOutput(int64_t anon_index)
 {
-    return rct_blacklist.count(anon_index);
+    return rct_blacklist.Contains(anon_index);
 }
 
 bool IsWhitelistedAnonOutput(int64_t anon_index, int64_t time, const Consensus::Params &consensus_params)
 {
     if (time >= consensus_params.exploit_fix_3_time &&
-        rct_whitelist2.count(anon_index)) {
+        rct_whitelist2.Contains(anon_index)) {
         return true;
     }
-    return rct_whitelist.count(anon_index);
+    return rct_whitelist.Contains(anon_index);
 }
 
 namespace globe {
@@ -231,8 +324,6 @@ void ECC_Start_Blinding()
 
     secp256k1_ctx_blind = ctx;
 
-    blind_scratch = secp256k1_scratch_space_create(secp256k1_ctx_blind, 1024 * 1024);
-    assert(blind_scratch);
     blind_gens = secp256k1_bulletproof_generators_create(secp256k1_ctx_blind, &secp256k1_generator_const_g, 128);
     assert(blind_gens);
 }
@@ -240,7 +331,6 @@ void ECC_Start_Blinding()
 void ECC_Stop_Blinding()
 {
     secp256k1_bulletproof_generators_destroy(secp256k1_ctx_blind, blind_gens);
-    secp256k1_scratch_space_destroy(secp256k1_ctx_blind, blind_scratch);
 
     secp256k1_context *ctx = secp256k1_ctx_blind;
     secp256k1_ctx_blind = nullptr;
@@ -16,9 +16,11 @@
 class uint256;
 
 extern secp256k1_context *secp256k1_ctx_blind;
-extern secp256k1_scratch_space *blind_scratch;
 extern secp256k1_bulletproof_generators *blind_gens;
 
+/** Bulletproof scratch space of the calling thread */
+secp256k1_scratch_space *GetBlindScratch();
+
 int SelectRangeProofParameters(uint64_t nValueIn, uint64_t &minValue, int &exponent, int &nBits);
 
 int GetRangeProofInfo(const std::vector<uint8_t> &vRangeproof, int &rexp, int &rmantissa, CAmount &min_value, CAmount &max_value);
@@ -14,18 +14,26 @@
 #include <validation.h>
 #include <util/system.h>
 
+#include <algorithm>
 #include <unordered_map>
 
-CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block) :
+CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const std::function<bool(const CTransaction&)>& prefill) :
         nonce(GetRand<uint64_t>()),
-        shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
+        header(block) {
     vchBlockSig = block.vchBlockSig;
     FillShortTxIDSelector();
-    //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
-    prefilledtxn[0] = {0, block.vtx[0]};
+    shorttxids.reserve(block.vtx.size() - 1);
+    prefilledtxn.push_back({0, block.vtx[0]});
+    size_t last_prefilled = 0;
     for (size_t i = 1; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(tx.GetWitnessHash());
+        if (prefill && prefill(tx)) {
+            // Prefilled indexes are differentially encoded
+            prefilledtxn.push_back({uint16_t(i - last_prefilled - 1), block.vtx[i]});
+            last_prefilled = i;
+            continue;
+        }
+        shorttxids.push_back(GetShortID(tx.GetWitnessHash()));
     }
 }
 
@@ -219,3 +227,35 @@ ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<
 
     return READ_STATUS_OK;
 }
+
+bool HasBlindedData(const CTransaction& tx) {
+    for (const auto& txin : tx.vin) {
+        if (txin.IsAnonInput())
+            return true;
+    }
+    for (const auto& txout : tx.vpout) {
+        if (txout->IsType(OUTPUT_CT) || txout->IsType(OUTPUT_RINGCT))
+            return true;
+    }
+    return false;
+}
+
+void ExtraTxnPool::Add(const CTransactionRef& tx) {
+    if (max_count == 0 || max_bytes == 0)
+        return;
+    const size_t tx_size = tx->GetTotalSize();
+    if (tx_size > max_bytes)
+        return;
+    txn.emplace_back(tx->GetWitnessHash(), tx);
+    total_bytes += tx_size;
+
+    while (txn.size() > max_count || total_bytes > max_bytes) {
+        auto evict = std::find_if(txn.begin(), txn.end(), [](const std::pair<uint256, CTransactionRef>& entry) {
+            return !HasBlindedData(*entry.second);
+        });
+        if (evict == txn.end())
+            evict = txn.begin();
+        total_bytes -= evict->second->GetTotalSize();
+        txn.erase(evict);
+    }
+}
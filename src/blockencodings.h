@@ -7,6 +7,7 @@
 
 #include <primitives/block.h>
 
+#include <functional>
 
 class CTxMemPool;
 
@@ -105,7 +106,8 @@ public:
     // Dummy for deserialization
     CBlockHeaderAndShortTxIDs() {}
 
-    CBlockHeaderAndShortTxIDs(const CBlock& block);
+    /** The coinbase is always prefilled, other transactions when prefill returns true for them */
+    CBlockHeaderAndShortTxIDs(const CBlock& block, const std::function<bool(const CTransaction&)>& prefill = {});
 
     uint64_t GetShortID(const uint256& txhash) const;
 
@@ -143,6 +145,38 @@ public:
     ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn);
     bool IsTxAvailable(size_t index) const;
     ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing);
+
+    size_t PrefilledCount() const { return prefilled_count; }
+    // Includes transactions found in extra_txn
+    size_t MempoolCount() const { return mempool_count; }
+    size_t ExtraCount() const { return extra_count; }
+};
+
+/** True if tx has CT or RingCT outputs or anon inputs, these carry large proofs */
+bool HasBlindedData(const CTransaction& tx);
+
+/**
+ * Orphan/conflicted/etc transactions that are kept for compact block reconstruction.
+ *
+ * Limited by count and by total size. When over a limit plain transactions
+ * are dropped oldest first before any blinded transaction, as a blinded
+ * transaction missing from a block costs the most to request again.
+ */
+class ExtraTxnPool {
+private:
+    // <witness hash, reference>, oldest first
+    std::vector<std::pair<uint256, CTransactionRef>> txn;
+    size_t max_count, max_bytes;
+    size_t total_bytes = 0;
+
+public:
+    ExtraTxnPool(size_t max_count_in, size_t max_bytes_in) : max_count(max_count_in), max_bytes(max_bytes_in) {}
+
+    void Add(const CTransactionRef& tx);
+
+    const std::vector<std::pair<uint256, CTransactionRef>>& Txns() const { return txn; }
+    size_t Size() const { return txn.size(); }
+    size_t Bytes() const { return total_bytes; }
 };
 
 #endif // GLOBE_BLOCKENCODINGS_H
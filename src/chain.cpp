@@ -7,11 +7,91 @@
 #include <tinyformat.h>
 #include <util/time.h>
 
+#include <stdexcept>
+
 std::string CBlockFileInfo::ToString() const
 {
     return strprintf("CBlockFileInfo(blocks=%u, size=%u, heights=%u...%u, time=%s...%s)", nBlocks, nSize, nHeightFirst, nHeightLast, FormatISO8601Date(nTimeFirst), FormatISO8601Date(nTimeLast));
 }
 
+std::function<bool(const CBlockIndex&, CBlockIndexStake&)> g_read_cold_block_stake;
+
+//! Guards the stake fields of all block index entries against writes under
+//! cs_main while they are read without it
+static GlobalMutex g_block_stake_mutex;
+
+CBlockIndex::StakePtr::StakePtr(const StakePtr& other)
+{
+    LOCK(g_block_stake_mutex);
+    if (other.m_ptr) m_ptr = std::make_unique<CBlockIndexStake>(*other.m_ptr);
+}
+
+CBlockIndex::StakePtr& CBlockIndex::StakePtr::operator=(const StakePtr& other)
+{
+    if (this != &other) {
+        LOCK(g_block_stake_mutex);
+        m_ptr = other.m_ptr ? std::make_unique<CBlockIndexStake>(*other.m_ptr) : nullptr;
+    }
+    return *this;
+}
+
+CBlockIndexStake CBlockIndex::GetStake() const
+{
+    {
+        LOCK(g_block_stake_mutex);
+        if (const CBlockIndexStake* stake = m_stake.get()) {
+            return *stake;
+        }
+        if (!m_stake_cold) {
+            return {};
+        }
+    }
+    // Cold fields are read without the lock, they are not written while cold
+    CBlockIndexStake stake;
+    if (!g_read_cold_block_stake || !g_read_cold_block_stake(*this, stake)) {
+        throw std::runtime_error(strprintf("%s: Failed to read stake fields of block %s", __func__, GetBlockHash().ToString()));
+    }
+    return stake;
+}
+
+CBlockIndexStake& CBlockIndex::StakeForWrite(const CBlockIndexStake& current)
+{
+    AssertLockHeld(g_block_stake_mutex);
+    if (!m_stake.get()) {
+        m_stake.reset(std::make_unique<CBlockIndexStake>(current));
+        m_stake_cold = false;
+    }
+    return *m_stake.get();
+}
+
+void CBlockIndex::SetStakeModifier(const uint256& modifier)
+{
+    // Read cold fields back before taking the lock
+    const CBlockIndexStake current{GetStake()};
+    LOCK(g_block_stake_mutex);
+    StakeForWrite(current).bnStakeModifier = modifier;
+}
+
+void CBlockIndex::SetPrevoutStake(const COutPoint& prevout)
+{
+    const CBlockIndexStake current{GetStake()};
+    LOCK(g_block_stake_mutex);
+    StakeForWrite(current).prevoutStake = prevout;
+}
+
+void CBlockIndex::SetStakeCold()
+{
+    LOCK(g_block_stake_mutex);
+    assert(!m_stake.get());
+    m_stake_cold = true;
+}
+
+bool CBlockIndex::HasStakeInMemory() const
+{
+    LOCK(g_block_stake_mutex);
+    return m_stake.get() != nullptr;
+}
+
 std::string CBlockIndex::ToString() const
 {
     return strprintf("CBlockIndex(pprev=%p, nHeight=%d, merkle=%s, hashBlock=%s)",
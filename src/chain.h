@@ -14,6 +14,8 @@
 #include <uint256.h>
 #include <util/time.h>
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 enum eBlockFlags
@@ -152,6 +154,21 @@ enum BlockStatus : uint32_t {
     BLOCK_ASSUMED_VALID      =   256,
 };
 
+/** Proof-of-stake fields of a block index entry, rarely read once the block is buried */
+struct CBlockIndexStake
+{
+    uint256 bnStakeModifier{}; // hash modifier for proof-of-stake
+    COutPoint prevoutStake{};
+};
+
+class CBlockIndex;
+
+/**
+ * Reads the stake fields of an entry that was loaded without them, see
+ * CBlockIndex::SetStakeCold(). Set by the BlockManager that loaded the index.
+ */
+extern std::function<bool(const CBlockIndex&, CBlockIndexStake&)> g_read_cold_block_stake;
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -204,8 +221,6 @@ public:
 
     // proof-of-stake specific fields
     unsigned int nFlags{0}; // pos: block index flags
-    uint256 bnStakeModifier{}; // hash modifier for proof-of-stake
-    COutPoint prevoutStake{};
     //uint256 hashProof;
     CAmount nMoneySupply{0};
     int64_t nAnonOutputs{0}; // last index
@@ -391,12 +406,48 @@ public:
         return false;
     }
 
+    //! Stake modifier and kernel, read back from the block tree db if not kept in memory
+    CBlockIndexStake GetStake() const;
+    uint256 GetStakeModifier() const { return GetStake().bnStakeModifier; }
+    COutPoint GetPrevoutStake() const { return GetStake().prevoutStake; }
+
+    void SetStakeModifier(const uint256& modifier);
+    void SetPrevoutStake(const COutPoint& prevout);
+
+    //! (memory only) Mark the stake fields as stored on disk only, they must not be in memory.
+    void SetStakeCold();
+    bool HasStakeInMemory() const;
+
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
+
+private:
+    /** Owns a copy of the stake fields, keeps CBlockIndex copyable */
+    class StakePtr
+    {
+    public:
+        StakePtr() = default;
+        StakePtr(const StakePtr& other);
+        StakePtr& operator=(const StakePtr& other);
+        CBlockIndexStake* get() const { return m_ptr.get(); }
+        void reset(std::unique_ptr<CBlockIndexStake> ptr) { m_ptr = std::move(ptr); }
+
+    private:
+        std::unique_ptr<CBlockIndexStake> m_ptr;
+    };
+
+    //! Stake fields, null while all zero or while cold.
+    //! Guarded by a mutex in chain.cpp, GetStake is called without cs_main.
+    StakePtr m_stake;
+    //! (memory only) Stake fields are only on disk
+    bool m_stake_cold{false};
+
+    //! Stake fields for writing, allocated from current as needed
+    CBlockIndexStake& StakeForWrite(const CBlockIndexStake& current);
 };
 
 arith_uint256 GetBlockProof(const CBlockIndex& block);
@@ -411,6 +462,7 @@ class CDiskBlockIndex : public CBlockIndex
 {
 public:
     uint256 hashPrev;
+    CBlockIndexStake stake;
 
     CDiskBlockIndex()
     {
@@ -420,6 +472,7 @@ public:
     explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex)
     {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
+        stake = pindex->GetStake();
     }
 
     SERIALIZE_METHODS(CDiskBlockIndex, obj)
@@ -436,8 +489,8 @@ public:
         if (obj.nStatus & BLOCK_HAVE_UNDO) READWRITE(VARINT(obj.nUndoPos));
 
         READWRITE(obj.nFlags);
-        READWRITE(obj.bnStakeModifier);
-        READWRITE(obj.prevoutStake);
+        READWRITE(obj.stake.bnStakeModifier);
+        READWRITE(obj.stake.prevoutStake);
         READWRITE(obj.nMoneySupply);
         READWRITE(obj.nAnonOutputs);
 
@@ -11,6 +11,7 @@
 #include <util/threadnames.h>
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 template <typename T>
@@ -140,7 +141,8 @@ public:
     }
 
     //! Create a pool of new worker threads.
-    void StartWorkerThreads(const int threads_num) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    void StartWorkerThreads(const int threads_num, const std::string& thread_name = "scriptch",
+                            SyscallSandboxPolicy policy = SyscallSandboxPolicy::VALIDATION_SCRIPT_CHECK) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         {
             LOCK(m_mutex);
@@ -150,9 +152,9 @@ public:
         }
         assert(m_worker_threads.empty());
         for (int n = 0; n < threads_num; ++n) {
-            m_worker_threads.emplace_back([this, n]() {
-                util::ThreadRename(strprintf("scriptch.%i", n));
-                SetSyscallSandboxPolicy(SyscallSandboxPolicy::VALIDATION_SCRIPT_CHECK);
+            m_worker_threads.emplace_back([this, n, thread_name, policy]() {
+                util::ThreadRename(strprintf("%s.%i", thread_name, n));
+                SetSyscallSandboxPolicy(policy);
                 Loop(false /* worker thread */);
             });
         }
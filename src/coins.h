@@ -243,6 +243,10 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get a cursor positioned at the first coin with a txid not below start,
+    //! for iterating over part of the state. Returns nullptr if not supported.
+    virtual std::unique_ptr<CCoinsViewCursor> SeekCursor(const uint256& start) const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() {}
 
@@ -266,6 +270,7 @@ public:
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::unique_ptr<CCoinsViewCursor> SeekCursor(const uint256& start) const override;
     size_t EstimateSize() const override;
     CCoinsView *GetBase() { return base; };
 };
@@ -337,6 +342,9 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    std::unique_ptr<CCoinsViewCursor> SeekCursor(const uint256& start) const override {
+        throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
+    }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
@@ -372,6 +380,12 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Add an unspent coin read from the base view ahead of use, as FetchCoin
+     * would have on a miss. Does nothing if the outpoint is already cached.
+     */
+    void AddFetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
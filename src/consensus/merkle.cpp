@@ -5,6 +5,9 @@
 #include <consensus/merkle.h>
 #include <hash.h>
 
+#include <cassert>
+#include <cstring>
+
 /*     WARNING! If you're reading this because you're learning about crypto
        and/or designing a new system that will use merkle trees, keep in mind
        that the following merkle tree algorithm has a serious flaw related to
@@ -62,32 +65,109 @@ uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated) {
 }
 
 
-uint256 BlockMerkleRoot(const CBlock& block, bool* mutated)
+static std::vector<uint256> BlockTxLeaves(const CBlock& block)
 {
     std::vector<uint256> leaves;
     leaves.resize(block.vtx.size());
     for (size_t s = 0; s < block.vtx.size(); s++) {
         leaves[s] = block.vtx[s]->GetHash();
     }
-    return ComputeMerkleRoot(std::move(leaves), mutated);
+    return leaves;
 }
 
-uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated)
+static uint256 BlockWitnessLeaf(const CBlock& block, size_t s)
+{
+    if (s == 0 && block.nVersion != GLOBE_BLOCK_VERSION) {
+        return uint256(); // The witness hash of the coinbase is 0.
+    }
+    return block.vtx[s]->GetWitnessHash();
+}
+
+static std::vector<uint256> BlockWitnessLeaves(const CBlock& block)
 {
     std::vector<uint256> leaves;
     leaves.resize(block.vtx.size());
+    for (size_t s = 0; s < block.vtx.size(); s++) {
+        leaves[s] = BlockWitnessLeaf(block, s);
+    }
+    return leaves;
+}
 
-    if (block.nVersion == GLOBE_BLOCK_VERSION)
-    {
-        for (size_t s = 0; s < block.vtx.size(); s++)
-            leaves[s] = block.vtx[s]->GetWitnessHash();
-        return ComputeMerkleRoot(leaves, mutated);
-    };
+uint256 BlockMerkleRoot(const CBlock& block, bool* mutated)
+{
+    return ComputeMerkleRoot(BlockTxLeaves(block), mutated);
+}
+
+uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated)
+{
+    return ComputeMerkleRoot(BlockWitnessLeaves(block), mutated);
+}
 
-    leaves[0].SetNull(); // The witness hash of the coinbase is 0.
-    for (size_t s = 1; s < block.vtx.size(); s++) {
-        leaves[s] = block.vtx[s]->GetWitnessHash();
+MerkleTree::MerkleTree(std::vector<uint256> leaves)
+{
+    m_levels.push_back(std::move(leaves));
+    while (m_levels.back().size() > 1) {
+        std::vector<uint256> level(m_levels.back());
+        if (level.size() & 1) {
+            level.push_back(level.back());
+        }
+        SHA256D64(level[0].begin(), level[0].begin(), level.size() / 2);
+        level.resize(level.size() / 2);
+        m_levels.push_back(std::move(level));
     }
-    return ComputeMerkleRoot(std::move(leaves), mutated);
 }
 
+uint256 MerkleTree::Root() const
+{
+    if (m_levels.back().empty()) return uint256();
+    return m_levels.back()[0];
+}
+
+void MerkleTree::Update(const std::vector<std::pair<MerkleTree*, uint256>>& updates, size_t pos)
+{
+    if (updates.empty()) return;
+    const size_t depth = updates.front().first->m_levels.size();
+    for (const auto& [tree, leaf] : updates) {
+        assert(tree->m_levels.size() == depth && pos < tree->Size());
+        tree->m_levels[0][pos] = leaf;
+    }
+
+    std::vector<unsigned char> in(64 * updates.size());
+    std::vector<uint256> out(updates.size());
+    for (size_t level = 0; level + 1 < depth; level++, pos >>= 1) {
+        const size_t left = pos & ~size_t{1};
+        for (size_t i = 0; i < updates.size(); i++) {
+            const std::vector<uint256>& hashes = updates[i].first->m_levels[level];
+            // An odd level hashes its last entry with itself
+            const uint256& right = left + 1 < hashes.size() ? hashes[left + 1] : hashes[left];
+            memcpy(&in[64 * i], hashes[left].begin(), 32);
+            memcpy(&in[64 * i + 32], right.begin(), 32);
+        }
+        SHA256D64(out[0].begin(), in.data(), updates.size());
+        for (size_t i = 0; i < updates.size(); i++) {
+            updates[i].first->m_levels[level + 1][pos >> 1] = out[i];
+        }
+    }
+}
+
+BlockMerkleTrees::BlockMerkleTrees(const CBlock& block)
+    : m_version(block.nVersion), m_tx(BlockTxLeaves(block)), m_witness(BlockWitnessLeaves(block))
+{
+}
+
+bool BlockMerkleTrees::Matches(const CBlock& block) const
+{
+    const size_t size = block.vtx.size();
+    if (block.nVersion != m_version || size != m_tx.Size() || size == 0) {
+        return false;
+    }
+    // Templates change only by replacing txn 0, spot check the rest
+    return size == 1 ||
+           (m_tx.Leaf(1) == block.vtx[1]->GetHash() && m_tx.Leaf(size - 1) == block.vtx[size - 1]->GetHash());
+}
+
+void BlockMerkleTrees::UpdateFirst(const CBlock& block)
+{
+    assert(Matches(block));
+    MerkleTree::Update({{&m_tx, block.vtx[0]->GetHash()}, {&m_witness, BlockWitnessLeaf(block, 0)}}, 0);
+}
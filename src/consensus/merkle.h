@@ -24,4 +24,52 @@ uint256 BlockMerkleRoot(const CBlock& block, bool* mutated = nullptr);
  */
 uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr);
 
+/*
+ * Merkle tree keeping every level, replacing a leaf rehashes only the branch
+ * above it. Hashes to the same root as ComputeMerkleRoot.
+ */
+class MerkleTree
+{
+public:
+    explicit MerkleTree(std::vector<uint256> leaves);
+
+    size_t Size() const { return m_levels.front().size(); }
+    const uint256& Leaf(size_t pos) const { return m_levels.front()[pos]; }
+    uint256 Root() const;
+
+    void Update(size_t pos, const uint256& leaf) { Update({{this, leaf}}, pos); }
+    /*
+     * Replace leaf pos in trees of the same size, the branches of all trees
+     * are hashed together level by level with the multi-way SHA256D64.
+     */
+    static void Update(const std::vector<std::pair<MerkleTree*, uint256>>& updates, size_t pos);
+
+private:
+    //! Leaves first, levels are not padded
+    std::vector<std::vector<uint256>> m_levels;
+};
+
+/*
+ * Transaction and witness merkle trees of a block, for block templates where
+ * only the first transaction changes.
+ */
+class BlockMerkleTrees
+{
+public:
+    explicit BlockMerkleTrees(const CBlock& block);
+
+    /* True if the trees were built from block, apart from its first transaction */
+    bool Matches(const CBlock& block) const;
+    /* Rehash the branches of the first transaction after it was replaced */
+    void UpdateFirst(const CBlock& block);
+
+    uint256 MerkleRoot() const { return m_tx.Root(); }
+    uint256 WitnessMerkleRoot() const { return m_witness.Root(); }
+
+private:
+    int32_t m_version;
+    MerkleTree m_tx;
+    MerkleTree m_witness;
+};
+
 #endif // GLOBE_CONSENSUS_MERKLE_H
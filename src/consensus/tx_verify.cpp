@@ -574,13 +574,18 @@ static bool CheckBlindOutput(TxValidationState &state, const CTxOutCT *p)
     if (state.m_skip_rangeproof) {
         return true;
     }
+    const uint256 cache_entry = RangeProofCacheEntry(p->commitment, p->vRangeproof, state.fBulletproofsActive);
+    if (PrevalidationCacheContains(cache_entry, /*erase=*/state.m_in_block)) {
+        return true;
+    }
 
+    const ValidationPhaseTimer timer{&ValidationPhaseTimes::rangeproof};
     uint64_t min_value = 0, max_value = 0;
     int rv = 0;
 
     if (state.fBulletproofsActive) {
         rv = secp256k1_bulletproof_rangeproof_verify(secp256k1_ctx_blind,
-            blind_scratch, blind_gens, p->vRangeproof.data(), p->vRangeproof.size(),
+            GetBlindScratch(), blind_gens, p->vRangeproof.data(), p->vRangeproof.size(),
             nullptr, &p->commitment, 1, 64, &secp256k1_generator_const_h, nullptr, 0);
     } else {
         rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value,
@@ -597,6 +602,9 @@ static bool CheckBlindOutput(TxValidationState &state, const CTxOutCT *p)
     if (rv != 1) {
         return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-ctout-rangeproof-verify");
     }
+    if (!state.m_in_block) {
+        PrevalidationCacheInsert(cache_entry);
+    }
 
     return true;
 }
@@ -618,13 +626,18 @@ bool CheckAnonOutput(TxValidationState &state, const CTxOutRingCT *p)
     if (state.m_skip_rangeproof) {
         return true;
     }
+    const uint256 cache_entry = RangeProofCacheEntry(p->commitment, p->vRangeproof, state.fBulletproofsActive);
+    if (PrevalidationCacheContains(cache_entry, /*erase=*/state.m_in_block)) {
+        return true;
+    }
 
+    const ValidationPhaseTimer timer{&ValidationPhaseTimes::rangeproof};
     uint64_t min_value = 0, max_value = 0;
     int rv = 0;
 
     if (state.fBulletproofsActive) {
         rv = secp256k1_bulletproof_rangeproof_verify(secp256k1_ctx_blind,
-            blind_scratch, blind_gens, p->vRangeproof.data(), p->vRangeproof.size(),
+            GetBlindScratch(), blind_gens, p->vRangeproof.data(), p->vRangeproof.size(),
             nullptr, &p->commitment, 1, 64, &secp256k1_generator_const_h, nullptr, 0);
     } else {
         rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value,
@@ -641,10 +654,25 @@ bool CheckAnonOutput(TxValidationState &state, const CTxOutRingCT *p)
     if (rv != 1) {
         return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-rctout-rangeproof-verify");
     }
+    if (!state.m_in_block) {
+        PrevalidationCacheInsert(cache_entry);
+    }
 
     return true;
 }
 
+bool CheckOutputRangeProof(TxValidationState &state, const CTxOutBase *txout)
+{
+    switch (txout->nVersion) {
+        case OUTPUT_CT:
+            return CheckBlindOutput(state, (const CTxOutCT*) txout);
+        case OUTPUT_RINGCT:
+            return CheckAnonOutput(state, (const CTxOutRingCT*) txout);
+        default:
+            return true;
+    }
+}
+
 static bool CheckDataOutput(TxValidationState &state, const CTxOutData *p)
 {
     if (p->vData.size() < 1) {
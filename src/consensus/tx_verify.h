@@ -13,6 +13,7 @@
 class CBlockIndex;
 class CCoinsViewCache;
 class CTransaction;
+class CTxOutBase;
 class TxValidationState;
 
 /** Transaction validation functions */
@@ -76,5 +77,7 @@ bool SequenceLocks(const CTransaction &tx, int flags, std::vector<int>& prevHeig
 
 
 bool CheckTransaction(const CTransaction& tx, TxValidationState& state);
+/** The checks CheckTransaction runs on a blind or anon output, including its rangeproof */
+bool CheckOutputRangeProof(TxValidationState& state, const CTxOutBase* txout);
 
 #endif // GLOBE_CONSENSUS_TX_VERIFY_H
@@ -32,6 +32,20 @@ enum class TxVerbosity {
     SHOW_DETAILS_AND_PREVOUT  //!< The same as previous option with information about prevouts if available
 };
 
+/**
+ * How much of the rangeproofs and input witnesses to include for a transaction.
+ * These make up most of the size of blinded and anon transactions, so the
+ * transaction hex is only included with FULL.
+ */
+enum class TxProofDetail {
+    FULL,      //!< Hex of every rangeproof and witness item
+    TRUNCATED, //!< Only the first PROOF_HEX_TRUNCATE_BYTES of each, with the full sizes
+    OMITTED    //!< Only the sizes
+};
+
+/** Bytes of each rangeproof and witness item kept by TxProofDetail::TRUNCATED */
+static constexpr size_t PROOF_HEX_TRUNCATE_BYTES{32};
+
 // core_read.cpp
 CScript ParseScript(const std::string& s);
 std::string ScriptToAsmStr(const CScript& script, const bool fAttemptSighashDecode = false);
@@ -50,6 +64,8 @@ bool DecodeHexBlockHeader(CBlockHeader&, const std::string& hex_header);
 bool ParseHashStr(const std::string& strHex, uint256& result);
 std::vector<unsigned char> ParseHexUV(const UniValue& v, const std::string& strName);
 int ParseSighashString(const UniValue& sighash);
+/** Parse "full", "truncate" or "omit", null gives TxProofDetail::FULL */
+TxProofDetail ParseProofDetailString(const UniValue& proofs);
 
 // core_write.cpp
 UniValue ValueFromAmount(const CAmount amount);
@@ -57,9 +73,10 @@ std::string FormatScript(const CScript& script);
 std::string EncodeHexTx(const CTransaction& tx, const int serializeFlags = 0);
 std::string SighashToStr(unsigned char sighash_type);
 void ScriptToUniv(const CScript& script, UniValue& out, bool include_hex = true, bool include_address = false);
-void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex = true, int serialize_flags = 0, const CTxUndo* txundo = nullptr, TxVerbosity verbosity = TxVerbosity::SHOW_DETAILS);
+void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex = true, int serialize_flags = 0, const CTxUndo* txundo = nullptr, TxVerbosity verbosity = TxVerbosity::SHOW_DETAILS, TxProofDetail proofs = TxProofDetail::FULL);
 
-void AddRangeproof(const std::vector<uint8_t> &vRangeproof, UniValue &entry);
-void OutputToJSON(uint256 &txid, int i, const CTxOutBase *baseOut, UniValue &entry);
+void AddRangeproof(const std::vector<uint8_t> &vRangeproof, UniValue &entry, TxProofDetail proofs = TxProofDetail::FULL);
+void AddWitness(const std::vector<std::vector<uint8_t>> &stack, UniValue &entry, TxProofDetail proofs = TxProofDetail::FULL);
+void OutputToJSON(uint256 &txid, int i, const CTxOutBase *baseOut, UniValue &entry, TxProofDetail proofs = TxProofDetail::FULL);
 
 #endif // GLOBE_CORE_IO_H
@@ -285,3 +285,15 @@ int ParseSighashString(const UniValue& sighash)
     }
     return hash_type;
 }
+
+TxProofDetail ParseProofDetailString(const UniValue& proofs)
+{
+    if (proofs.isNull()) {
+        return TxProofDetail::FULL;
+    }
+    const std::string& str_proofs = proofs.get_str();
+    if (str_proofs == "full") return TxProofDetail::FULL;
+    if (str_proofs == "truncate") return TxProofDetail::TRUNCATED;
+    if (str_proofs == "omit") return TxProofDetail::OMITTED;
+    throw std::runtime_error(str_proofs + " is not a valid proofs parameter.");
+}
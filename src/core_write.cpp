@@ -19,6 +19,7 @@
 #include <util/strencodings.h>
 #include <util/system.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -179,9 +180,22 @@ void ScriptToUniv(const CScript& script, UniValue& out, bool include_hex, bool i
     out.pushKV("type", GetTxnOutputType(type));
 }
 
-void AddRangeproof(const std::vector<uint8_t> &vRangeproof, UniValue &entry)
+static std::string ProofHex(Span<const uint8_t> proof, TxProofDetail proofs)
 {
-    entry.pushKV("rangeproof", HexStr(vRangeproof));
+    if (proofs == TxProofDetail::TRUNCATED) {
+        return HexStr(proof.first(std::min(proof.size(), PROOF_HEX_TRUNCATE_BYTES)));
+    }
+    return HexStr(proof);
+}
+
+void AddRangeproof(const std::vector<uint8_t> &vRangeproof, UniValue &entry, TxProofDetail proofs)
+{
+    if (proofs != TxProofDetail::OMITTED) {
+        entry.pushKV("rangeproof", ProofHex(vRangeproof, proofs));
+    }
+    if (proofs != TxProofDetail::FULL) {
+        entry.pushKV("rangeproof_size", (uint64_t)vRangeproof.size());
+    }
 
     if (vRangeproof.size() > 0) {
         int exponent, mantissa;
@@ -195,8 +209,26 @@ void AddRangeproof(const std::vector<uint8_t> &vRangeproof, UniValue &entry)
     }
 }
 
+void AddWitness(const std::vector<std::vector<uint8_t>> &stack, UniValue &entry, TxProofDetail proofs)
+{
+    if (proofs != TxProofDetail::OMITTED) {
+        UniValue txinwitness(UniValue::VARR);
+        for (const auto& item : stack) {
+            txinwitness.push_back(ProofHex(item, proofs));
+        }
+        entry.pushKV("txinwitness", txinwitness);
+    }
+    if (proofs != TxProofDetail::FULL) {
+        uint64_t witness_size = 0;
+        for (const auto& item : stack) {
+            witness_size += item.size();
+        }
+        entry.pushKV("witness_size", witness_size);
+    }
+}
+
 void OutputToJSON(uint256 &txid, int i,
-    const CTxOutBase *baseOut, UniValue &entry)
+    const CTxOutBase *baseOut, UniValue &entry, TxProofDetail proofs)
 {
     switch (baseOut->GetType()) {
         case OUTPUT_STANDARD:
@@ -249,7 +281,7 @@ void OutputToJSON(uint256 &txid, int i,
             entry.pushKV("scriptPubKey", o);
             entry.pushKV("data_hex", HexStr(s->vData));
 
-            AddRangeproof(s->vRangeproof, entry);
+            AddRangeproof(s->vRangeproof, entry, proofs);
             }
             break;
         case OUTPUT_RINGCT:
@@ -260,7 +292,7 @@ void OutputToJSON(uint256 &txid, int i,
             entry.pushKV("valueCommitment", HexStr(Span<const unsigned char>(s->commitment.data, 33)));
             entry.pushKV("data_hex", HexStr(s->vData));
 
-            AddRangeproof(s->vRangeproof, entry);
+            AddRangeproof(s->vRangeproof, entry, proofs);
             }
             break;
         default:
@@ -269,7 +301,7 @@ void OutputToJSON(uint256 &txid, int i,
     }
 }
 
-void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex, int serialize_flags, const CTxUndo* txundo, TxVerbosity verbosity)
+void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex, int serialize_flags, const CTxUndo* txundo, TxVerbosity verbosity, TxProofDetail proofs)
 {
     uint256 txid = tx.GetHash();
     entry.pushKV("txid", txid.GetHex());
@@ -311,11 +343,7 @@ void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry
             in.pushKV("scriptSig", o);
         }
         if (!tx.vin[i].scriptWitness.IsNull()) {
-            UniValue txinwitness(UniValue::VARR);
-            for (const auto& item : tx.vin[i].scriptWitness.stack) {
-                txinwitness.push_back(HexStr(item));
-            }
-            in.pushKV("txinwitness", txinwitness);
+            AddWitness(tx.vin[i].scriptWitness.stack, in, proofs);
         }
         if (have_undo) {
             const Coin& prev_coin = txundo->vprevout[i];
@@ -345,7 +373,7 @@ void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry
     {
         UniValue out(UniValue::VOBJ);
         out.pushKV("n", (int64_t)i);
-        OutputToJSON(txid, i, tx.vpout[i].get(), out);
+        OutputToJSON(txid, i, tx.vpout[i].get(), out, proofs);
         vout.push_back(out);
     }
 
@@ -380,7 +408,7 @@ void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry
         entry.pushKV("blockhash", block_hash.GetHex());
     }
 
-    if (include_hex) {
+    if (include_hex && proofs == TxProofDetail::FULL) {
         entry.pushKV("hex", EncodeHexTx(tx, serialize_flags)); // The hex-encoded transaction. Used the name "hex" to be consistent with the verbose output of "getrawtransaction".
     }
 }
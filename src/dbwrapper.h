@@ -156,6 +156,7 @@ public:
 
     void Next();
     void Prev() { piter->Prev(); }
+    void SeekToLast() { piter->SeekToLast(); }
 
     bool StartsWith(uint8_t b)
     {
@@ -44,6 +44,7 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-wallet=<path>",
         "-walletbroadcast",
         "-walletdir=<dir>",
+        "-walletloadthreads=<n>",
         "-walletnotify=<cmd>",
         "-walletrbf",
         "-dblogsize=<n>",
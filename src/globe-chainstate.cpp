@@ -16,42 +16,272 @@
 #include <kernel/validation_cache_sizes.h>
 
 #include <chainparams.h>
+#include <chainparamsbase.h>
+#include <clientversion.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <fs.h>
 #include <node/blockstorage.h>
 #include <node/caches.h>
 #include <node/chainstate.h>
+#include <protocol.h>
 #include <scheduler.h>
 #include <script/sigcache.h>
+#include <streams.h>
 #include <util/system.h>
 #include <util/thread.h>
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <algorithm>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iosfwd>
+#include <map>
+
+// Adapted from rpc/mining.cpp
+class submitblock_StateCatcher final : public CValidationInterface
+{
+public:
+    uint256 hash;
+    bool found;
+    BlockValidationState state;
+
+    explicit submitblock_StateCatcher(const uint256& hashIn) : hash(hashIn), found(false), state() {}
+
+protected:
+    void BlockChecked(const CBlock& block, const BlockValidationState& stateIn) override
+    {
+        if (block.GetHash() != hash)
+            return;
+        found = true;
+        state = stateIn;
+    }
+};
+
+static void SetupReplayArgs(ArgsManager& argsman)
+{
+    SetupChainParamsBaseOptions(argsman);
+    argsman.AddArg("-replay=<dir>", "Connect the blocks in the blk*.dat files of <dir> instead of reading hex-encoded blocks from standard input", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-replaycsv=<file>", "Write per block validation timings of -replay to <file>, each phase column excludes the phases nested in it (default: replay.csv in DATADIR)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
+        -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d)", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-addressindex", strprintf("Maintain a full address index (default: %u)", globe::DEFAULT_ADDRESSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-spentindex", strprintf("Maintain a full spent index (default: %u)", globe::DEFAULT_SPENTINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-timestampindex", strprintf("Maintain a timestamp index for block hashes (default: %u)", globe::DEFAULT_TIMESTAMPINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-balancesindex", strprintf("Maintain a balances index per block (default: %u)", globe::DEFAULT_BALANCESINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+}
+
+/** Cumulative phase times, to take the difference over one block */
+struct PhaseSnapshot
+{
+    int64_t check_block, prefetch, rangeproof, mlsag, coins, index, flush;
+
+    static PhaseSnapshot Now()
+    {
+        const ValidationPhaseTimes& t = g_validation_phase_times;
+        return {t.check_block, t.prefetch, t.rangeproof, t.mlsag, t.coins, t.index, t.flush};
+    }
+};
+
+struct ReplayBlock
+{
+    std::shared_ptr<CBlock> block;
+    unsigned int size;
+    int64_t deserialize_us;
+};
+
+/**
+ * Connect the blocks of the blk*.dat files in blocks_dir, writing one csv row
+ * of timings per connected block. The phase columns don't overlap, e.g.
+ * check_block_us leaves out the rangeproofs CheckBlock verifies. Blocks stored before their parent are kept
+ * in memory until the parent is connected.
+ */
+static bool ReplayBlockFiles(ChainstateManager& chainman, const fs::path& blocks_dir, std::ostream& csv)
+{
+    const CChainParams& chainparams = chainman.GetParams();
+    csv << "height,hash,size,txs,deserialize_us,check_block_us,prefetch_us,rangeproof_us,mlsag_us,coins_us,index_us,flush_us,total_us" << std::endl;
+    g_validation_phase_times.enabled = true;
+
+    std::multimap<uint256, ReplayBlock> pending;
+    int64_t replay_start = GetTimeMicros(), deserialize_total = 0;
+    int connected = 0;
+
+    const auto connect = [&](const ReplayBlock& replay) {
+        const CBlock& block = *replay.block;
+        const uint256 hash = block.GetHash();
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindex = chainman.m_blockman.LookupBlockIndex(hash);
+            if (pindex && pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+                // The genesis block, or a block stored twice
+                return true;
+            }
+            const CBlockIndex* pindex_prev = chainman.m_blockman.LookupBlockIndex(block.hashPrevBlock);
+            if (pindex_prev) {
+                chainman.UpdateUncommittedBlockStructures(*replay.block, pindex_prev);
+            }
+        }
+
+        const PhaseSnapshot before = PhaseSnapshot::Now();
+        const int64_t start = GetTimeMicros();
+        auto sc = std::make_shared<submitblock_StateCatcher>(hash);
+        RegisterSharedValidationInterface(sc);
+        const bool accepted = chainman.ProcessNewBlock(replay.block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr);
+        UnregisterSharedValidationInterface(sc);
+        const int64_t total = GetTimeMicros() - start;
+        const PhaseSnapshot after = PhaseSnapshot::Now();
+
+        if (!accepted || (sc->found && !sc->state.IsValid())) {
+            std::cerr << "Block " << hash.ToString() << " rejected: " << (sc->found ? sc->state.ToString() : "not accepted") << std::endl;
+            return false;
+        }
+        const int height = WITH_LOCK(cs_main, const CBlockIndex* pindex = chainman.m_blockman.LookupBlockIndex(hash); return pindex ? pindex->nHeight : -1);
+        csv << height << "," << hash.ToString() << "," << replay.size << "," << block.vtx.size() << ","
+            << replay.deserialize_us << ","
+            << after.check_block - before.check_block << ","
+            << after.prefetch - before.prefetch << ","
+            << after.rangeproof - before.rangeproof << ","
+            << after.mlsag - before.mlsag << ","
+            << after.coins - before.coins << ","
+            << after.index - before.index << ","
+            << after.flush - before.flush << ","
+            << total << "\n";
+        connected++;
+        if (connected % 10000 == 0) {
+            std::cout << "\t" << "Connected " << connected << " blocks, height " << height << std::endl;
+        }
+        return true;
+    };
+
+    for (int file_num = 0;; ++file_num) {
+        const fs::path path = blocks_dir / fs::u8path(strprintf("blk%05u.dat", file_num));
+        FILE* file_in = fsbridge::fopen(path, "rb");
+        if (!file_in) {
+            break;
+        }
+        try {
+            // Adapted from Chainstate::LoadExternalBlockFile
+            CBufferedFile blkdat(file_in, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8, SER_DISK, CLIENT_VERSION);
+            uint64_t rewind = blkdat.GetPos();
+            while (!blkdat.eof()) {
+                blkdat.SetPos(rewind);
+                rewind++;
+                blkdat.SetLimit();
+                unsigned int size = 0;
+                try {
+                    unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
+                    blkdat.FindByte(chainparams.MessageStart()[0]);
+                    rewind = blkdat.GetPos() + 1;
+                    blkdat >> buf;
+                    if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE)) {
+                        continue;
+                    }
+                    blkdat >> size;
+                    if (size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE) {
+                        continue;
+                    }
+                } catch (const std::exception&) {
+                    break;
+                }
+
+                ReplayBlock replay{std::make_shared<CBlock>(), size, 0};
+                const uint64_t block_pos = blkdat.GetPos();
+                blkdat.SetLimit(block_pos + size);
+                const int64_t start = GetTimeMicros();
+                try {
+                    blkdat >> *replay.block;
+                } catch (const std::exception& e) {
+                    std::cerr << "Deserialize failed in " << fs::PathToString(path) << ": " << e.what() << std::endl;
+                    continue;
+                }
+                replay.deserialize_us = GetTimeMicros() - start;
+                deserialize_total += replay.deserialize_us;
+                rewind = blkdat.GetPos();
+
+                const CBlock& block = *replay.block;
+                const bool have_prev = block.GetHash() == chainparams.GetConsensus().hashGenesisBlock ||
+                    WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(block.hashPrevBlock) != nullptr);
+                if (!have_prev) {
+                    pending.emplace(block.hashPrevBlock, std::move(replay));
+                    continue;
+                }
+                std::vector<ReplayBlock> queue{std::move(replay)};
+                while (!queue.empty()) {
+                    ReplayBlock next = std::move(queue.back());
+                    queue.pop_back();
+                    if (!connect(next)) {
+                        return false;
+                    }
+                    auto range = pending.equal_range(next.block->GetHash());
+                    for (auto it = range.first; it != range.second; ++it) {
+                        queue.push_back(std::move(it->second));
+                    }
+                    pending.erase(range.first, range.second);
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to read " << fs::PathToString(path) << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+    g_validation_phase_times.enabled = false;
+
+    const ValidationPhaseTimes& t = g_validation_phase_times;
+    std::cout
+        << "Replayed " << connected << " blocks in " << (GetTimeMicros() - replay_start) / 1000 << "ms";
+    if (!pending.empty()) {
+        std::cout << ", " << pending.size() << " blocks without a parent";
+    }
+    std::cout << std::endl
+        << "\t" << "Deserialize: " << deserialize_total / 1000 << "ms" << std::endl
+        << "\t" << "CheckBlock: " << t.check_block / 1000 << "ms" << std::endl
+        << "\t" << "Prefetch: " << t.prefetch / 1000 << "ms" << std::endl
+        << "\t" << "Rangeproofs: " << t.rangeproof / 1000 << "ms" << std::endl
+        << "\t" << "MLSAG: " << t.mlsag / 1000 << "ms" << std::endl
+        << "\t" << "Coins: " << t.coins / 1000 << "ms" << std::endl
+        << "\t" << "Index writes: " << t.index / 1000 << "ms" << std::endl
+        << "\t" << "Flush: " << t.flush / 1000 << "ms" << std::endl;
+    return true;
+}
 
 int main(int argc, char* argv[])
 {
     // SETUP: Argument parsing and handling
-    if (argc != 2) {
+    SetupReplayArgs(gArgs);
+    std::string parse_error;
+    if (!gArgs.ParseParameters(argc, argv, parse_error)) {
+        std::cerr << "Error parsing command line arguments: " << parse_error << std::endl;
+        return 1;
+    }
+    const auto command = gArgs.GetCommand();
+    if (!command || command->args.size() != 1) {
         std::cerr
-            << "Usage: " << argv[0] << " DATADIR" << std::endl
+            << "Usage: " << argv[0] << " [options] DATADIR" << std::endl
             << "Display DATADIR information, and process hex-encoded blocks on standard input." << std::endl
+            << "With -replay=<dir>, connect the blocks stored in <dir> and write per block timings to a csv file." << std::endl
+            << std::endl
+            << gArgs.GetHelpMessage()
             << std::endl
             << "IMPORTANT: THIS EXECUTABLE IS EXPERIMENTAL, FOR TESTING ONLY, AND EXPECTED TO" << std::endl
             << "           BREAK IN FUTURE VERSIONS. DO NOT USE ON YOUR ACTUAL DATADIR." << std::endl;
         return 1;
     }
-    std::filesystem::path abs_datadir = std::filesystem::absolute(argv[1]);
+    std::filesystem::path abs_datadir = std::filesystem::absolute(command->args[0]);
     std::filesystem::create_directories(abs_datadir);
     gArgs.ForceSetArg("-datadir", abs_datadir.string());
 
 
     // SETUP: Misc Globals
-    SelectParams(CBaseChainParams::MAIN);
+    try {
+        SelectParams(gArgs.GetChainName());
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
     const CChainParams& chainparams = Params();
 
     kernel::Context kernel_context{};
@@ -66,6 +296,7 @@ int main(int argc, char* argv[])
     kernel::ValidationCacheSizes validation_cache_sizes{};
     Assert(InitSignatureCache(validation_cache_sizes.signature_cache_bytes));
     Assert(InitScriptExecutionCache(validation_cache_sizes.script_execution_cache_bytes));
+    Assert(InitPrevalidationCache(validation_cache_sizes.prevalidation_cache_bytes));
 
 
     // SETUP: Scheduling and Background Signals
@@ -87,9 +318,22 @@ int main(int argc, char* argv[])
     ChainstateManager chainman{chainman_opts};
 
     node::CacheSizes cache_sizes;
-    cache_sizes.block_tree_db = 2 << 20;
-    cache_sizes.coins_db = 2 << 22;
-    cache_sizes.coins = (450 << 20) - (2 << 20) - (2 << 22);
+    if (gArgs.IsArgSet("-dbcache")) {
+        cache_sizes = node::CalculateCacheSizes(gArgs);
+    } else {
+        cache_sizes.block_tree_db = 2 << 20;
+        cache_sizes.coins_db = 2 << 22;
+        cache_sizes.coins = (450 << 20) - (2 << 20) - (2 << 22);
+    }
+    int script_threads = gArgs.GetIntArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
+    if (script_threads <= 0) {
+        script_threads += GetNumCores();
+    }
+    // The main thread verifies too
+    script_threads = std::clamp(script_threads - 1, 0, MAX_SCRIPTCHECK_THREADS);
+    if (script_threads >= 1) {
+        StartScriptCheckWorkerThreads(script_threads);
+    }
     node::ChainstateLoadOptions options;
     options.check_interrupt = [] { return false; };
     node::ChainstateLoadArgs csl_args;
@@ -135,6 +379,18 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (gArgs.IsArgSet("-replay")) {
+        const fs::path csv_path = gArgs.GetPathArg("-replaycsv", gArgs.GetDataDirNet() / "replay.csv");
+        std::ofstream csv{csv_path};
+        if (!csv) {
+            std::cerr << "Failed to open " << fs::PathToString(csv_path) << std::endl;
+            goto epilogue;
+        }
+        std::cout << "\t" << "Replaying blocks from " << gArgs.GetArg("-replay", "") << " with " << script_threads << " script check threads" << std::endl;
+        ReplayBlockFiles(chainman, fs::absolute(gArgs.GetPathArg("-replay")), csv);
+        goto epilogue;
+    }
+
     for (std::string line; std::getline(std::cin, line);) {
         if (line.empty()) {
             std::cerr << "Empty line found" << std::endl;
@@ -178,26 +434,6 @@ int main(int argc, char* argv[])
             }
         }
 
-        // Adapted from rpc/mining.cpp
-        class submitblock_StateCatcher final : public CValidationInterface
-        {
-        public:
-            uint256 hash;
-            bool found;
-            BlockValidationState state;
-
-            explicit submitblock_StateCatcher(const uint256& hashIn) : hash(hashIn), found(false), state() {}
-
-        protected:
-            void BlockChecked(const CBlock& block, const BlockValidationState& stateIn) override
-            {
-                if (block.GetHash() != hash)
-                    return;
-                found = true;
-                state = stateIn;
-            }
-        };
-
         bool new_block;
         auto sc = std::make_shared<submitblock_StateCatcher>(block.GetHash());
         RegisterSharedValidationInterface(sc);
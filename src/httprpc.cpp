@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -70,6 +71,8 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+/* Max threads used to run the read-only calls of a batch */
+static int g_rpc_batch_parallel = DEFAULT_HTTP_BATCH_PARALLEL;
 
 static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const UniValue& id)
 {
@@ -242,7 +245,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                     }
                 }
             }
-            strReply = JSONRPCExecBatch(jreq, valRequest.get_array());
+            strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), QueueHTTPWork, g_rpc_batch_parallel);
         }
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
@@ -318,10 +321,17 @@ bool StartHTTPRPC(const std::any& context)
     if (!InitRPCAuthentication())
         return false;
 
+    g_rpc_batch_parallel = std::clamp<int64_t>(gArgs.GetIntArg("-rpcbatchparallel", DEFAULT_HTTP_BATCH_PARALLEL), 1, std::numeric_limits<int>::max());
+
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
-    RegisterHTTPHandler("/", true, handle_rpc);
+    auto check_auth = [](HTTPRequest* req) {
+        const auto [present, auth] = req->GetHeader("authorization");
+        std::string user;
+        return present && RPCAuthorized(auth, user);
+    };
+    RegisterHTTPHandler("/", true, handle_rpc, check_auth);
     if (g_wallet_init_interface.HasWalletSupport()) {
-        RegisterHTTPHandler("/wallet/", false, handle_rpc);
+        RegisterHTTPHandler("/wallet/", false, handle_rpc, check_auth);
     }
     struct event_base* eventBase = EventBase();
     assert(eventBase);
@@ -20,14 +20,19 @@
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
 #include <util/threadnames.h>
+#include <util/time.h>
 #include <util/translation.h>
 
+#include <algorithm>
+#include <array>
 #include <deque>
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <string_view>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -64,34 +69,117 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Generic task run on the HTTP worker threads */
+class HTTPTaskItem final : public HTTPClosure
+{
+public:
+    explicit HTTPTaskItem(std::function<void()> _func) : func(std::move(_func))
+    {
+    }
+    void operator()() override
+    {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
+ *
+ * Items are queued by priority, each priority has its own depth limit so a
+ * flood of slow requests can't push out cheap ones. Workers take the first
+ * item of the highest priority that is allowed to run: low priority items
+ * leave at least one worker free when there is more than one, and a method
+ * may be limited to a number of concurrent calls.
  */
 template <typename WorkItem>
 class WorkQueue
 {
 private:
+    struct Entry {
+        std::unique_ptr<WorkItem> item;
+        std::string method;
+        SteadyClock::time_point queued_at;
+    };
+
     Mutex cs;
     std::condition_variable cond GUARDED_BY(cs);
-    std::deque<std::unique_ptr<WorkItem>> queue GUARDED_BY(cs);
+    std::array<std::deque<Entry>, NUM_HTTP_PRIORITIES> queues GUARDED_BY(cs);
+    std::map<std::string, size_t> method_running GUARDED_BY(cs);
+    size_t low_running GUARDED_BY(cs){0};
+    std::map<std::string, HTTPQueueStats> stats GUARDED_BY(cs);
     bool running GUARDED_BY(cs){true};
     const size_t maxDepth;
+    const size_t maxLowRunning;
+    const std::map<std::string, size_t> methodLimits;
+
+    bool Runnable(const Entry& entry, HTTPPriority priority) const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        if (priority == HTTPPriority::LOW && low_running >= maxLowRunning) {
+            return false;
+        }
+        auto limit = methodLimits.find(entry.method);
+        if (limit == methodLimits.end()) {
+            return true;
+        }
+        auto it = method_running.find(entry.method);
+        return it == method_running.end() || it->second < limit->second;
+    }
+
+    /** Take the first item allowed to run, highest priority first */
+    bool Pop(Entry& entry, HTTPPriority& priority) EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        for (size_t p = 0; p < queues.size(); ++p) {
+            auto& queue = queues[p];
+            for (auto it = queue.begin(); it != queue.end(); ++it) {
+                if (!Runnable(*it, HTTPPriority(p))) {
+                    continue;
+                }
+                entry = std::move(*it);
+                queue.erase(it);
+                priority = HTTPPriority(p);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Empty() const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        return std::all_of(queues.begin(), queues.end(), [](const auto& queue) { return queue.empty(); });
+    }
+
+    /** Stats are kept per priority and per configured method, not per requested name */
+    void AddStats(const std::string& key, int64_t wait_us, int running_change) EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        HTTPQueueStats& s = stats[key];
+        if (running_change > 0) {
+            s.count++;
+            s.total_wait_us += wait_us;
+            s.max_wait_us = std::max(s.max_wait_us, wait_us);
+        }
+        s.running += running_change;
+    }
 
 public:
-    explicit WorkQueue(size_t _maxDepth) : maxDepth(_maxDepth)
+    WorkQueue(size_t _maxDepth, size_t _maxLowRunning, std::map<std::string, size_t> _methodLimits)
+        : maxDepth(_maxDepth), maxLowRunning(std::max<size_t>(1, _maxLowRunning)), methodLimits(std::move(_methodLimits))
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
      */
     ~WorkQueue() = default;
-    /** Enqueue a work item */
-    bool Enqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    /** Enqueue a work item, method is the configured name or empty */
+    bool Enqueue(WorkItem* item, HTTPPriority priority = HTTPPriority::NORMAL, const std::string& method = "") EXCLUSIVE_LOCKS_REQUIRED(!cs)
     {
         LOCK(cs);
+        auto& queue = queues[size_t(priority)];
         if (!running || queue.size() >= maxDepth) {
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        queue.push_back(Entry{std::unique_ptr<WorkItem>(item), method, SteadyClock::now()});
         cond.notify_one();
         return true;
     }
@@ -99,17 +187,42 @@ public:
     void Run() EXCLUSIVE_LOCKS_REQUIRED(!cs)
     {
         while (true) {
-            std::unique_ptr<WorkItem> i;
+            Entry entry;
+            HTTPPriority priority;
             {
                 WAIT_LOCK(cs, lock);
-                while (running && queue.empty())
+                bool have_entry;
+                while (!(have_entry = Pop(entry, priority)) && (running || !Empty()))
                     cond.wait(lock);
-                if (!running && queue.empty())
+                if (!have_entry)
                     break;
-                i = std::move(queue.front());
-                queue.pop_front();
+                const int64_t wait_us{Ticks<std::chrono::microseconds>(SteadyClock::now() - entry.queued_at)};
+                AddStats(HTTPPriorityName(priority), wait_us, 1);
+                if (!entry.method.empty()) {
+                    AddStats(entry.method, wait_us, 1);
+                    method_running[entry.method]++;
+                }
+                if (priority == HTTPPriority::LOW) {
+                    low_running++;
+                }
+            }
+            (*entry.item)();
+            entry.item.reset();
+            {
+                LOCK(cs);
+                AddStats(HTTPPriorityName(priority), 0, -1);
+                if (!entry.method.empty()) {
+                    AddStats(entry.method, 0, -1);
+                    method_running[entry.method]--;
+                }
+                if (priority == HTTPPriority::LOW) {
+                    low_running--;
+                }
+                if (priority == HTTPPriority::LOW || methodLimits.count(entry.method)) {
+                    // Items held back by the limits may run now
+                    cond.notify_all();
+                }
             }
-            (*i)();
         }
     }
     /** Interrupt and exit loops */
@@ -119,17 +232,32 @@ public:
         running = false;
         cond.notify_all();
     }
+    std::map<std::string, HTTPQueueStats> GetStats() EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    {
+        LOCK(cs);
+        std::map<std::string, HTTPQueueStats> result{stats};
+        for (size_t p = 0; p < queues.size(); ++p) {
+            result[HTTPPriorityName(HTTPPriority(p))].queued = queues[p].size();
+            for (const auto& entry : queues[p]) {
+                if (!entry.method.empty()) {
+                    result[entry.method].queued++;
+                }
+            }
+        }
+        return result;
+    }
 };
 
 struct HTTPPathHandler
 {
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPAuthCheck _authCheck):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), authCheck(_authCheck)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPAuthCheck authCheck;
 };
 
 /** HTTP module state */
@@ -142,6 +270,8 @@ static struct evhttp* eventHTTP = nullptr;
 static std::vector<CSubNet> rpc_allow_subnets;
 //! Work queue for handling longer requests off the event loop thread
 static std::unique_ptr<WorkQueue<HTTPClosure>> g_work_queue{nullptr};
+//! Priority of JSON-RPC methods, set before the event loop starts
+static std::map<std::string, HTTPPriority> g_rpc_priorities;
 //! Handlers for (sub)paths
 static GlobalMutex g_httppathhandlers_mutex;
 static std::vector<HTTPPathHandler> pathHandlers GUARDED_BY(g_httppathhandlers_mutex);
@@ -187,6 +317,186 @@ static bool InitHTTPAllowList()
     return true;
 }
 
+std::string HTTPPriorityName(HTTPPriority priority)
+{
+    switch (priority) {
+    case HTTPPriority::HIGH:
+        return "high";
+    case HTTPPriority::NORMAL:
+        return "normal";
+    case HTTPPriority::LOW:
+        return "low";
+    }
+    assert(false);
+}
+
+static std::optional<HTTPPriority> ParseHTTPPriority(const std::string& name)
+{
+    for (size_t p = 0; p < NUM_HTTP_PRIORITIES; ++p) {
+        if (name == HTTPPriorityName(HTTPPriority(p))) {
+            return HTTPPriority(p);
+        }
+    }
+    return std::nullopt;
+}
+
+/** Read -rpcpriority and -rpcmethodlimit over the default priorities */
+static bool InitHTTPPriorities(std::map<std::string, size_t>& method_limits)
+{
+    g_rpc_priorities.clear();
+    for (const char* method : {"getbestblockhash", "getblockcount", "getblocktemplate", "getcoldstakinginfo",
+                               "getstakinginfo", "sendrawtransaction", "submitblock"}) {
+        g_rpc_priorities[method] = HTTPPriority::HIGH;
+    }
+    // Index and scan calls of block explorers
+    for (const char* method : {"getaddressbalance", "getaddressdeltas", "getaddressmempool", "getaddresstxids",
+                               "getaddressutxos", "getblockdeltas", "getspentinfo", "gettxoutsetinfo",
+                               "gettxoutsetinfobyscript", "listcoldstakeunspent", "rescanblockchain",
+                               "scantxoutset", "smsginbox", "smsgoutbox"}) {
+        g_rpc_priorities[method] = HTTPPriority::LOW;
+    }
+
+    auto split_arg = [](const std::string& arg, const std::string& name, std::string& method, std::string& value) {
+        const size_t pos = arg.find(':');
+        if (pos == std::string::npos || pos == 0 || pos + 1 == arg.size()) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf(Untranslated("Invalid %s specification: %s. Valid is <method>:<value>."), name, arg),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        method = arg.substr(0, pos);
+        value = arg.substr(pos + 1);
+        return true;
+    };
+    std::string method, value;
+    for (const std::string& arg : gArgs.GetArgs("-rpcpriority")) {
+        if (!split_arg(arg, "-rpcpriority", method, value)) {
+            return false;
+        }
+        const auto priority = ParseHTTPPriority(value);
+        if (!priority) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf(Untranslated("Invalid -rpcpriority level: %s. Valid are high, normal and low."), value),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        g_rpc_priorities[method] = *priority;
+    }
+    for (const std::string& arg : gArgs.GetArgs("-rpcmethodlimit")) {
+        if (!split_arg(arg, "-rpcmethodlimit", method, value)) {
+            return false;
+        }
+        const auto limit = ToIntegral<uint32_t>(value);
+        if (!limit || *limit < 1) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf(Untranslated("Invalid -rpcmethodlimit count: %s. Must be at least 1."), value),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        method_limits[method] = *limit;
+        // Limited methods are named in the queue stats
+        g_rpc_priorities.emplace(method, HTTPPriority::NORMAL);
+    }
+    return true;
+}
+
+/** Return the position after the JSON string starting at pos, or npos if it doesn't end */
+static size_t SkipJSONString(std::string_view json, size_t pos)
+{
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\') {
+            ++pos;
+        } else if (json[pos] == '"') {
+            return pos + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+/** Find the method of a single JSON-RPC request without consuming or parsing the body.
+ * Only the top level members of the request object are read, values are skipped.
+ * Returns an empty string for batches and requests without a plain "method" string,
+ * std::nullopt if the method is ambiguous: malformed JSON, escaped keys or a repeated
+ * "method" member. */
+static std::optional<std::string> PeekRPCMethod(struct evhttp_request* req)
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    const size_t size = buf ? evbuffer_get_length(buf) : 0;
+    const char* data = size ? (const char*)evbuffer_pullup(buf, size) : nullptr;
+    if (!data) {
+        return "";
+    }
+    std::string_view body(data, size);
+    constexpr std::string_view whitespace{" \t\r\n"};
+    size_t pos = body.find_first_not_of(whitespace);
+    if (pos == std::string_view::npos || body[pos] != '{') {
+        return "";
+    }
+
+    std::optional<std::string_view> method;
+    pos = body.find_first_not_of(whitespace, pos + 1);
+    if (pos != std::string_view::npos && body[pos] == '}') {
+        return "";
+    }
+    while (pos != std::string_view::npos) {
+        if (body[pos] != '"') {
+            return std::nullopt;
+        }
+        const size_t key_end = SkipJSONString(body, pos);
+        if (key_end == std::string_view::npos) {
+            return std::nullopt;
+        }
+        const std::string_view key = body.substr(pos + 1, key_end - pos - 2);
+        if (key.find('\\') != std::string_view::npos) {
+            return std::nullopt;
+        }
+        pos = body.find_first_not_of(whitespace, key_end);
+        if (pos == std::string_view::npos || body[pos] != ':') {
+            return std::nullopt;
+        }
+        const size_t value_start = body.find_first_not_of(whitespace, pos + 1);
+        // Skip the value up to the ',' or '}' ending it
+        int depth = 0;
+        for (pos = value_start; pos < body.size(); ++pos) {
+            const char c = body[pos];
+            if (c == '"') {
+                pos = SkipJSONString(body, pos);
+                if (pos == std::string_view::npos) {
+                    return std::nullopt;
+                }
+                --pos;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) break;
+                --depth;
+            } else if (c == ',' && depth == 0) {
+                break;
+            }
+        }
+        if (pos >= body.size() || body[pos] == ']') {
+            return std::nullopt;
+        }
+        if (key == "method") {
+            if (method) {
+                return std::nullopt;
+            }
+            const size_t value_end = body.find_last_not_of(whitespace, pos - 1);
+            const std::string_view value = body.substr(value_start, value_end - value_start + 1);
+            if (value.size() < 2 || value.front() != '"' || value.back() != '"' ||
+                value.find('\\') != std::string_view::npos) {
+                return std::nullopt;
+            }
+            method = value.substr(1, value.size() - 2);
+        }
+        if (body[pos] == '}') {
+            return std::string(method.value_or(""));
+        }
+        pos = body.find_first_not_of(whitespace, pos + 1);
+    }
+    return std::nullopt;
+}
+
 /** HTTP request method as string - use for logging only */
 std::string RequestMethodString(HTTPRequest::RequestMethod m)
 {
@@ -211,6 +521,21 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
     }
 }
 
+/** Re-enable reading from the socket once the reply to req is sent. This is
+ * the second part of the libevent workaround in http_request_cb. */
+static void ReenableConnectionRead(struct evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 /** HTTP request callback */
 static void http_request_cb(struct evhttp_request* req, void* arg)
 {
@@ -265,9 +590,22 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        HTTPPriority priority = HTTPPriority::NORMAL;
+        std::string method;
+        if (hreq->GetRequestMethod() == HTTPRequest::POST && i->authCheck) {
+            // Only authorized calls get the priority of their method, the
+            // rest would only be turned away by the worker
+            const auto rpc_method = i->authCheck(hreq.get()) ? PeekRPCMethod(req) : std::nullopt;
+            if (!rpc_method) {
+                priority = HTTPPriority::LOW;
+            } else if (auto it = g_rpc_priorities.find(*rpc_method); it != g_rpc_priorities.end()) {
+                method = it->first;
+                priority = it->second;
+            }
+        }
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
         assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
+        if (g_work_queue->Enqueue(item.get(), priority, method)) {
             item.release(); /* if true, queue took ownership */
         } else {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
@@ -406,11 +744,19 @@ bool InitHTTPServer()
         return false;
     }
 
+    std::map<std::string, size_t> method_limits;
+    if (!InitHTTPPriorities(method_limits)) {
+        return false;
+    }
+
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
     int workQueueDepth = std::max((long)gArgs.GetIntArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintfCategory(BCLog::HTTP, "creating work queue of depth %d\n", workQueueDepth);
+    int rpcThreads = std::max((long)gArgs.GetIntArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
+    LogPrintfCategory(BCLog::HTTP, "creating work queue of depth %d per priority\n", workQueueDepth);
 
-    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth);
+    // Low priority calls leave a worker free for everything else, a single
+    // worker must still run them
+    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth, rpcThreads - 1, std::move(method_limits));
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -484,6 +830,27 @@ void StopHTTPServer()
     LogPrint(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
+bool QueueHTTPWork(std::function<void()> func)
+{
+    if (!g_work_queue) {
+        return false;
+    }
+    std::unique_ptr<HTTPTaskItem> item(new HTTPTaskItem(std::move(func)));
+    if (g_work_queue->Enqueue(item.get())) {
+        item.release(); /* if true, queue took ownership */
+        return true;
+    }
+    return false;
+}
+
+std::map<std::string, HTTPQueueStats> GetHTTPQueueStats()
+{
+    if (!g_work_queue) {
+        return {};
+    }
+    return g_work_queue->GetStats();
+}
+
 struct event_base* EventBase()
 {
     return eventBase;
@@ -524,6 +891,9 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req, bool _replySent) : req(_re
 
 HTTPRequest::~HTTPRequest()
 {
+    if (startedChunkedReply && !replySent) {
+        WriteReplyEnd();
+    }
     if (!replySent && !startedChunkTransfer) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
@@ -695,17 +1065,45 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, nullptr, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
+        ReenableConnectionRead(req_copy);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+void HTTPRequest::WriteReplyChunk(const std::string& chunk)
+{
+    assert(!replySent && req && !startedChunkTransfer);
+    if (!startedChunkedReply) {
+        if (ShutdownRequested()) {
+            WriteHeader("Connection", "close");
         }
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, nullptr, [req_copy]{
+            evhttp_send_reply_start(req_copy, HTTP_OK, nullptr);
+        });
+        ev->trigger(nullptr);
+        startedChunkedReply = true;
+    }
+    if (chunk.empty()) {
+        // An empty chunk would end the reply
+        return;
+    }
+    auto databuf = evbuffer_new(); // HTTPEvent will free this buffer
+    evbuffer_add(databuf, chunk.data(), chunk.size());
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, databuf,
+            std::bind(evhttp_send_reply_chunk, req, databuf));
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::WriteReplyEnd()
+{
+    assert(startedChunkedReply && !replySent && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, nullptr, [req_copy]{
+        evhttp_send_reply_end(req_copy);
+        ReenableConnectionRead(req_copy);
     });
     ev->trigger(nullptr);
     replySent = true;
@@ -792,11 +1190,11 @@ std::optional<std::string> GetQueryParameterFromUri(const char* uri, const std::
     return result;
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPAuthCheck &authCheck)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
     LOCK(g_httppathhandlers_mutex);
-    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler));
+    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler, authCheck));
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -6,6 +6,7 @@
 #define GLOBE_HTTPSERVER_H
 
 #include <functional>
+#include <map>
 #include <optional>
 #include <string>
 #include <mutex>
@@ -14,6 +15,7 @@
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+static const int DEFAULT_HTTP_BATCH_PARALLEL=4;
 
 struct evhttp_request;
 struct event_base;
@@ -34,16 +36,44 @@ void InterruptHTTPServer();
 /** Stop HTTP server */
 void StopHTTPServer();
 
+/** Queue a task on the HTTP worker threads.
+ * Returns false if the work queue is full or the server is stopping.
+ */
+bool QueueHTTPWork(std::function<void()> func);
+
+/** Scheduling class of a work item, lower runs first */
+enum class HTTPPriority {
+    HIGH,
+    NORMAL,
+    LOW,
+};
+static constexpr size_t NUM_HTTP_PRIORITIES{3};
+std::string HTTPPriorityName(HTTPPriority priority);
+
+/** Work queue counters for a priority or a configured RPC method */
+struct HTTPQueueStats {
+    uint64_t count{0};
+    int64_t total_wait_us{0};
+    int64_t max_wait_us{0};
+    size_t queued{0};
+    size_t running{0};
+};
+std::map<std::string, HTTPQueueStats> GetHTTPQueueStats();
+
 /** Change logging level for libevent. */
 void UpdateHTTPServerLogging(bool enable);
 
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Check of the credentials of a request, run on the event loop thread */
+typedef std::function<bool(HTTPRequest* req)> HTTPAuthCheck;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
  * be invoked.
+ * JSON-RPC calls to a handler with an authCheck are queued at the priority
+ * of their method if they pass it, otherwise at low priority.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPAuthCheck &authCheck = nullptr);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
@@ -61,6 +91,7 @@ private:
     struct evhttp_request* req;
     bool replySent;
     bool startedChunkTransfer;
+    bool startedChunkedReply{false};
     bool connClosed;
 
     std::mutex cs;
@@ -140,6 +171,23 @@ public:
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
 
+    /**
+     * Write part of a HTTP_OK reply with chunked transfer encoding, the
+     * first call sends the headers.
+     *
+     * @note Unlike Chunk, the connection is kept open. Finish the reply with
+     * WriteReplyEnd.
+     */
+    void WriteReplyChunk(const std::string& chunk);
+
+    /**
+     * End a reply started by WriteReplyChunk.
+     *
+     * @note As this will give the request back to the main thread, do not
+     * call any other HTTPRequest methods after calling this.
+     */
+    void WriteReplyEnd();
+
     /**
      * Start chunk transfer. Assume to be 200.
      */
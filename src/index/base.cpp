@@ -315,7 +315,7 @@ void BaseIndex::BlockDisconnected(const std::shared_ptr<const CBlock> &pblock, c
     if (!m_synced) {
         return;
     }
-    if (!DisconnectBlock(*pblock)) {
+    if (!DisconnectBlock(*pblock, pindex->nHeight)) {
         FatalError("%s: Failed to erase block %s from index database",
                    __func__, pblock->GetHash().ToString());
         return;
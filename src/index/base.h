@@ -107,6 +107,8 @@ protected:
 
     void ChainStateFlushed(const CBlockLocator& locator) override;
 
+    std::string ValidationQueueName() const override { return m_name; }
+
     /// Initialize internal state from the database and block index.
     [[nodiscard]] virtual bool CustomInit(const std::optional<interfaces::BlockKey>& block) { return true; }
 
@@ -122,7 +124,7 @@ protected:
     [[nodiscard]] virtual bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) { return true; }
 
     /// Undo update index entries for a newly connected block.
-    virtual bool DisconnectBlock(const CBlock& block) { return true; }
+    virtual bool DisconnectBlock(const CBlock& block, int height) { return true; }
 
     virtual DB& GetDB() const = 0;
 
@@ -24,6 +24,10 @@ using node::UndoReadFromDisk;
 static constexpr uint8_t DB_BLOCK_HASH{'s'};
 static constexpr uint8_t DB_BLOCK_HEIGHT{'t'};
 static constexpr uint8_t DB_MUHASH{'M'};
+static constexpr uint8_t DB_VERSION{'V'};
+
+//! Version 1 added blinded outputs and the outputs of Globe transactions
+static constexpr int CURRENT_VERSION{1};
 
 namespace {
 
@@ -41,6 +45,7 @@ struct DBVal {
     CAmount total_unspendables_bip30;
     CAmount total_unspendables_scripts;
     CAmount total_unspendables_unclaimed_rewards;
+    uint64_t blind_transaction_output_count;
 
     SERIALIZE_METHODS(DBVal, obj)
     {
@@ -57,6 +62,7 @@ struct DBVal {
         READWRITE(obj.total_unspendables_bip30);
         READWRITE(obj.total_unspendables_scripts);
         READWRITE(obj.total_unspendables_unclaimed_rewards);
+        READWRITE(obj.blind_transaction_output_count);
     }
 };
 
@@ -100,6 +106,32 @@ struct DBHashKey {
     }
 };
 
+//! The coins tx adds to the UTXO set, matching AddCoins
+std::vector<std::pair<uint32_t, Coin>> GetTxCoins(const CTransaction& tx, int height)
+{
+    std::vector<std::pair<uint32_t, Coin>> coins;
+    const bool coinbase{tx.IsCoinBase() || tx.IsCoinStake()};
+    if (!tx.IsGlobeVersion()) {
+        for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+            coins.emplace_back(j, Coin{tx.vout[j], height, coinbase});
+        }
+        return coins;
+    }
+    for (uint32_t j = 0; j < tx.vpout.size(); ++j) {
+        const CTxOutBase* out{tx.vpout[j].get()};
+        if (out->IsType(OUTPUT_STANDARD)) {
+            coins.emplace_back(j, Coin{CTxOut{out->GetValue(), *out->GetPScriptPubKey()}, height, coinbase});
+        } else if (out->IsType(OUTPUT_CT)) {
+            Coin coin{CTxOut{0, *out->GetPScriptPubKey()}, height, coinbase};
+            coin.nType = OUTPUT_CT;
+            coin.commitment = static_cast<const CTxOutCT*>(out)->commitment;
+            coins.emplace_back(j, std::move(coin));
+        }
+        // Data and anon outputs are not in the UTXO set
+    }
+    return coins;
+}
+
 }; // namespace
 
 std::unique_ptr<CoinStatsIndex> g_coin_stats_index;
@@ -111,6 +143,16 @@ CoinStatsIndex::CoinStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t
     fs::create_directories(path);
 
     m_db = std::make_unique<CoinStatsIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+
+    // An index built before version 1 lacks the blinded outputs, rebuild it from the genesis block
+    CBlockLocator locator;
+    int version{0};
+    if (!f_wipe && m_db->ReadBestBlock(locator) && !locator.IsNull() &&
+        (!m_db->Read(DB_VERSION, version) || version < CURRENT_VERSION)) {
+        LogPrintf("%s: %s was built by an older version without blinded outputs, rebuilding it\n", __func__, GetName());
+        m_db.reset();
+        m_db = std::make_unique<CoinStatsIndex::DB>(path / "db", n_cache_size, f_memory, /*f_wipe=*/true);
+    }
 }
 
 bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
@@ -150,6 +192,7 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
         // Add the new utxos created from the block
         assert(block.data);
+        size_t n_undo{0};
         for (size_t i = 0; i < block.data->vtx.size(); ++i) {
             const auto& tx{block.data->vtx.at(i)};
 
@@ -160,10 +203,8 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                 continue;
             }
 
-            for (uint32_t j = 0; j < tx->vout.size(); ++j) {
-                const CTxOut& out{tx->vout[j]};
-                Coin coin{out, block.height, tx->IsCoinBase()};
-                COutPoint outpoint{tx->GetHash(), j};
+            for (auto& [n, coin] : GetTxCoins(*tx, block.height)) {
+                COutPoint outpoint{tx->GetHash(), n};
 
                 // Skip unspendable coins
                 if (coin.out.scriptPubKey.IsUnspendable()) {
@@ -180,24 +221,37 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                     m_total_new_outputs_ex_coinbase_amount += coin.out.nValue;
                 }
 
-                ++m_transaction_output_count;
+                if (coin.nType == OUTPUT_CT) {
+                    ++m_blind_transaction_output_count;
+                } else {
+                    ++m_transaction_output_count;
+                }
                 m_total_amount += coin.out.nValue;
                 m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
             }
 
             // The coinbase tx has no undo data since no former output is spent
             if (!tx->IsCoinBase()) {
-                const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+                const auto& tx_undo{block_undo.vtxundo.at(n_undo++)};
 
-                for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
-                    Coin coin{tx_undo.vprevout[j]};
-                    COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
+                // Anon inputs spend no coins and have no undo data
+                size_t n_prevout{0};
+                for (const CTxIn& txin : tx->vin) {
+                    if (txin.IsAnonInput()) {
+                        continue;
+                    }
+                    Coin coin{tx_undo.vprevout.at(n_prevout++)};
+                    COutPoint outpoint{txin.prevout.hash, txin.prevout.n};
 
                     m_muhash.Remove(MakeUCharSpan(TxOutSer(outpoint, coin)));
 
                     m_total_prevout_spent_amount += coin.out.nValue;
 
-                    --m_transaction_output_count;
+                    if (coin.nType == OUTPUT_CT) {
+                        --m_blind_transaction_output_count;
+                    } else {
+                        --m_transaction_output_count;
+                    }
                     m_total_amount -= coin.out.nValue;
                     m_bogo_size -= GetBogoSize(coin.out.scriptPubKey);
                 }
@@ -231,6 +285,7 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
     value.second.total_unspendables_bip30 = m_total_unspendables_bip30;
     value.second.total_unspendables_scripts = m_total_unspendables_scripts;
     value.second.total_unspendables_unclaimed_rewards = m_total_unspendables_unclaimed_rewards;
+    value.second.blind_transaction_output_count = m_blind_transaction_output_count;
 
     uint256 out;
     m_muhash.Finalize(out);
@@ -346,6 +401,7 @@ std::optional<CCoinsStats> CoinStatsIndex::LookUpStats(const CBlockIndex& block_
     stats.total_unspendables_bip30 = entry.total_unspendables_bip30;
     stats.total_unspendables_scripts = entry.total_unspendables_scripts;
     stats.total_unspendables_unclaimed_rewards = entry.total_unspendables_unclaimed_rewards;
+    stats.nBlindTransactionOutputs = entry.blind_transaction_output_count;
 
     return stats;
 }
@@ -388,6 +444,7 @@ bool CoinStatsIndex::CustomInit(const std::optional<interfaces::BlockKey>& block
         m_total_unspendables_bip30 = entry.total_unspendables_bip30;
         m_total_unspendables_scripts = entry.total_unspendables_scripts;
         m_total_unspendables_unclaimed_rewards = entry.total_unspendables_unclaimed_rewards;
+        m_blind_transaction_output_count = entry.blind_transaction_output_count;
     }
 
     return true;
@@ -398,6 +455,7 @@ bool CoinStatsIndex::CustomCommit(CDBBatch& batch)
     // DB_MUHASH should always be committed in a batch together with DB_BEST_BLOCK
     // to prevent an inconsistent state of the DB.
     batch.Write(DB_MUHASH, m_muhash);
+    batch.Write(DB_VERSION, CURRENT_VERSION);
     return true;
 }
 
@@ -433,13 +491,12 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
     }
 
     // Remove the new UTXOs that were created from the block
+    size_t n_undo{0};
     for (size_t i = 0; i < block.vtx.size(); ++i) {
         const auto& tx{block.vtx.at(i)};
 
-        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
-            const CTxOut& out{tx->vout[j]};
-            COutPoint outpoint{tx->GetHash(), j};
-            Coin coin{out, pindex->nHeight, tx->IsCoinBase()};
+        for (auto& [n, coin] : GetTxCoins(*tx, pindex->nHeight)) {
+            COutPoint outpoint{tx->GetHash(), n};
 
             // Skip unspendable coins
             if (coin.out.scriptPubKey.IsUnspendable()) {
@@ -456,24 +513,36 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
                 m_total_new_outputs_ex_coinbase_amount -= coin.out.nValue;
             }
 
-            --m_transaction_output_count;
+            if (coin.nType == OUTPUT_CT) {
+                --m_blind_transaction_output_count;
+            } else {
+                --m_transaction_output_count;
+            }
             m_total_amount -= coin.out.nValue;
             m_bogo_size -= GetBogoSize(coin.out.scriptPubKey);
         }
 
         // The coinbase tx has no undo data since no former output is spent
         if (!tx->IsCoinBase()) {
-            const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+            const auto& tx_undo{block_undo.vtxundo.at(n_undo++)};
 
-            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
-                Coin coin{tx_undo.vprevout[j]};
-                COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
+            size_t n_prevout{0};
+            for (const CTxIn& txin : tx->vin) {
+                if (txin.IsAnonInput()) {
+                    continue;
+                }
+                Coin coin{tx_undo.vprevout.at(n_prevout++)};
+                COutPoint outpoint{txin.prevout.hash, txin.prevout.n};
 
                 m_muhash.Insert(MakeUCharSpan(TxOutSer(outpoint, coin)));
 
                 m_total_prevout_spent_amount -= coin.out.nValue;
 
-                m_transaction_output_count++;
+                if (coin.nType == OUTPUT_CT) {
+                    m_blind_transaction_output_count++;
+                } else {
+                    m_transaction_output_count++;
+                }
                 m_total_amount += coin.out.nValue;
                 m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
             }
@@ -490,6 +559,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
     Assert(read_out.second.muhash == out);
 
     Assert(m_transaction_output_count == read_out.second.transaction_output_count);
+    Assert(m_blind_transaction_output_count == read_out.second.blind_transaction_output_count);
     Assert(m_total_amount == read_out.second.total_amount);
     Assert(m_bogo_size == read_out.second.bogo_size);
     Assert(m_total_subsidy == read_out.second.total_subsidy);
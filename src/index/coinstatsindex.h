@@ -24,6 +24,7 @@ private:
 
     MuHash3072 m_muhash;
     uint64_t m_transaction_output_count{0};
+    uint64_t m_blind_transaction_output_count{0};
     uint64_t m_bogo_size{0};
     CAmount m_total_amount{0};
     CAmount m_total_subsidy{0};
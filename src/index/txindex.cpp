@@ -24,6 +24,10 @@ constexpr uint8_t DB_TXINDEX{'t'};
 constexpr uint8_t DB_TXINDEX_CSOUTPUT{'O'};
 constexpr uint8_t DB_TXINDEX_CSLINK{'L'};
 constexpr uint8_t DB_TXINDEX_CSBESTBLOCK{'C'};
+constexpr uint8_t DB_TXINDEX_CSPAIR{'P'};
+constexpr uint8_t DB_TXINDEX_CSWEIGHT{'W'};
+constexpr uint8_t DB_TXINDEX_CSWEIGHTTIP{'T'};
+constexpr uint8_t DB_TXINDEX_CSVERSION{'V'};
 */
 
 std::unique_ptr<TxIndex> g_txindex;
@@ -74,7 +78,10 @@ bool TxIndex::CustomInit(const std::optional<interfaces::BlockKey>& block)
     CChain &active_chain = m_chainstate->m_chain;
     if (m_cs_index) {
         CBlockLocator locator;
-        if (!GetDB().Read(DB_TXINDEX_CSBESTBLOCK, locator)) {
+        int cs_version{0};
+        if (!GetDB().Read(DB_TXINDEX_CSVERSION, cs_version) || cs_version != CSINDEX_VERSION ||
+            !GetDB().Read(DB_TXINDEX_CSBESTBLOCK, locator)) {
+            // Rebuild from genesis when the coldstake weight records are missing or outdated
             locator.SetNull();
         }
         const CBlockIndex *best_cs_block_index = m_chainstate->FindForkInGlobalIndex(locator);
@@ -112,13 +119,14 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
     return m_db->WriteTxs(vPos);
 }
 
-bool TxIndex::DisconnectBlock(const CBlock& block)
+bool TxIndex::DisconnectBlock(const CBlock& block, int height)
 {
     if (!m_cs_index) {
         return true;
     }
 
     std::set<COutPoint> erasedCSOuts;
+    std::set<ColdStakeIndexPairKey> touchedPairs;
     CDBBatch batch(*m_db);
     for (const auto &tx : block.vtx) {
         int n = -1;
@@ -134,7 +142,13 @@ bool TxIndex::DisconnectBlock(const CBlock& block)
 
             ColdStakeIndexOutputKey ok(tx->GetHash(), n);
             batch.Erase(std::make_pair(DB_TXINDEX_CSOUTPUT, ok));
+            batch.Erase(std::make_pair(DB_TXINDEX_CSPAIR, ok));
             erasedCSOuts.insert(COutPoint(ok.m_txnid, ok.m_n));
+
+            ColdStakeIndexLinkKey lk;
+            if (ExtractCSLinkKey(*ps, lk)) {
+                touchedPairs.insert(ColdStakeIndexPairKey(lk));
+            }
         }
         for (const auto &in : tx->vin) {
             ColdStakeIndexOutputKey ok(in.prevout.hash, in.prevout.n);
@@ -147,10 +161,39 @@ bool TxIndex::DisconnectBlock(const CBlock& block)
                 ov.m_spend_height = -1;
                 ov.m_spend_txid.SetNull();
                 batch.Write(std::make_pair(DB_TXINDEX_CSOUTPUT, ok), ov);
+
+                ColdStakeIndexPairKey pair;
+                if (m_db->Read(std::make_pair(DB_TXINDEX_CSPAIR, ok), pair)) {
+                    touchedPairs.insert(pair);
+                }
             }
         }
     }
 
+    // Drop the checkpoints of the touched pairs at the block height and any left above it,
+    // a pair with its tip below the block height wasn't checkpointed by this block and keeps it.
+    for (const auto &pair : touchedPairs) {
+        int tip_height;
+        if (!m_db->Read(std::make_pair(DB_TXINDEX_CSWEIGHTTIP, pair), tip_height) ||
+            tip_height < height) {
+            continue;
+        }
+        ColdStakeIndexWeightValue wv;
+        while (tip_height >= height) {
+            ColdStakeIndexWeightKey wk(pair, tip_height);
+            if (!m_db->Read(std::make_pair(DB_TXINDEX_CSWEIGHT, wk), wv)) {
+                return error("%s: Missing coldstake weight checkpoint at height %d.", __func__, tip_height);
+            }
+            batch.Erase(std::make_pair(DB_TXINDEX_CSWEIGHT, wk));
+            tip_height = wv.m_prev_height;
+        }
+        if (wv.m_prev_height < 0) {
+            batch.Erase(std::make_pair(DB_TXINDEX_CSWEIGHTTIP, pair));
+        } else {
+            batch.Write(std::make_pair(DB_TXINDEX_CSWEIGHTTIP, pair), wv.m_prev_height);
+        }
+    }
+
     if (!m_db->WriteBatch(batch)) {
         return error("%s: WriteBatch failed.", __func__);
     }
@@ -158,11 +201,53 @@ bool TxIndex::DisconnectBlock(const CBlock& block)
     return true;
 }
 
+bool TxIndex::ExtractCSLinkKey(const CScript &script, ColdStakeIndexLinkKey &lk) const
+{
+    CScript scriptStake, scriptSpend;
+    if (!SplitConditionalCoinstakeScript(script, scriptStake, scriptSpend)) {
+        return false;
+    }
+
+    std::vector<valtype> vSolutions;
+    lk.m_stake_type = Solver(scriptStake, vSolutions);
+
+    if (m_cs_index_whitelist.size() > 0 &&
+        (vSolutions.empty() || !m_cs_index_whitelist.count(vSolutions[0]))) {
+        return false;
+    }
+
+    if (lk.m_stake_type == TxoutType::PUBKEYHASH) {
+        memcpy(lk.m_stake_id.begin(), vSolutions[0].data(), 20);
+    } else
+    if (lk.m_stake_type == TxoutType::PUBKEYHASH256) {
+        lk.m_stake_id = CKeyID256(uint256(vSolutions[0]));
+    } else {
+        LogPrint(BCLog::COINDB, "%s: Ignoring unexpected stakescript type=%d.\n", __func__, globe::FromTxoutType(lk.m_stake_type));
+        return false;
+    }
+
+    lk.m_spend_type = Solver(scriptSpend, vSolutions);
+
+    if (lk.m_spend_type == TxoutType::PUBKEYHASH || lk.m_spend_type == TxoutType::SCRIPTHASH) {
+        memcpy(lk.m_spend_id.begin(), vSolutions[0].data(), 20);
+    } else
+    if (lk.m_spend_type == TxoutType::PUBKEYHASH256 || lk.m_spend_type == TxoutType::SCRIPTHASH256) {
+        lk.m_spend_id = CKeyID256(uint256(vSolutions[0]));
+    } else {
+        LogPrint(BCLog::COINDB, "%s: Ignoring unexpected spendscript type=%d.\n", __func__, globe::FromTxoutType(lk.m_spend_type));
+        return false;
+    }
+
+    return true;
+}
+
 bool TxIndex::IndexCSOutputs(const interfaces::BlockInfo& block)
 {
     CDBBatch batch(*m_db);
     std::map<ColdStakeIndexOutputKey, ColdStakeIndexOutputValue> newCSOuts;
+    std::map<ColdStakeIndexOutputKey, ColdStakeIndexPairKey> newCSPairs;
     std::map<ColdStakeIndexLinkKey, std::vector<ColdStakeIndexOutputKey> > newCSLinks;
+    std::map<ColdStakeIndexPairKey, std::pair<CAmount, int> > weightChanges;
 
     if (!block.data) {
         return error("%s: Block data missing.", __func__);
@@ -180,44 +265,11 @@ bool TxIndex::IndexCSOutputs(const interfaces::BlockInfo& block)
                 continue;
             }
 
-            CScript scriptStake, scriptSpend;
-            if (!SplitConditionalCoinstakeScript(*ps, scriptStake, scriptSpend)) {
-                continue;
-            }
-
-            std::vector<valtype> vSolutions;
-
             ColdStakeIndexOutputKey ok;
             ColdStakeIndexOutputValue ov;
             ColdStakeIndexLinkKey lk;
             lk.m_height = block.height;
-            lk.m_stake_type = Solver(scriptStake, vSolutions);
-
-            if (m_cs_index_whitelist.size() > 0 &&
-                !m_cs_index_whitelist.count(vSolutions[0])) {
-                continue;
-            }
-
-            if (lk.m_stake_type == TxoutType::PUBKEYHASH) {
-                memcpy(lk.m_stake_id.begin(), vSolutions[0].data(), 20);
-            } else
-            if (lk.m_stake_type == TxoutType::PUBKEYHASH256) {
-                lk.m_stake_id = CKeyID256(uint256(vSolutions[0]));
-            } else {
-                LogPrint(BCLog::COINDB, "%s: Ignoring unexpected stakescript type=%d.\n", __func__, globe::FromTxoutType(lk.m_stake_type));
-                continue;
-            }
-
-
-            lk.m_spend_type = Solver(scriptSpend, vSolutions);
-
-            if (lk.m_spend_type == TxoutType::PUBKEYHASH || lk.m_spend_type == TxoutType::SCRIPTHASH) {
-                memcpy(lk.m_spend_id.begin(), vSolutions[0].data(), 20);
-            } else
-            if (lk.m_spend_type == TxoutType::PUBKEYHASH256 || lk.m_spend_type == TxoutType::SCRIPTHASH256) {
-                lk.m_spend_id = CKeyID256(uint256(vSolutions[0]));
-            } else {
-                LogPrint(BCLog::COINDB, "%s: Ignoring unexpected spendscript type=%d.\n", __func__, globe::FromTxoutType(lk.m_spend_type));
+            if (!ExtractCSLinkKey(*ps, lk)) {
                 continue;
             }
 
@@ -229,7 +281,13 @@ bool TxIndex::IndexCSOutputs(const interfaces::BlockInfo& block)
                 ov.m_flags |= CSI_FROM_STAKE;
             }
 
+            ColdStakeIndexPairKey pair(lk);
+            auto &change = weightChanges[pair];
+            change.first += ov.m_value;
+            change.second++;
+
             newCSOuts[ok] = ov;
+            newCSPairs[ok] = pair;
             newCSLinks[lk].push_back(ok);
         }
 
@@ -239,16 +297,25 @@ bool TxIndex::IndexCSOutputs(const interfaces::BlockInfo& block)
             }
             ColdStakeIndexOutputKey ok(in.prevout.hash, (int)in.prevout.n);
             ColdStakeIndexOutputValue ov;
+            ColdStakeIndexPairKey pair;
 
             auto it = newCSOuts.find(ok);
             if (it != newCSOuts.end()) {
                 it->second.m_spend_height = block.height;
                 it->second.m_spend_txid = tx->GetHash();
+                auto &change = weightChanges[newCSPairs[ok]];
+                change.first -= it->second.m_value;
+                change.second--;
             } else
             if (m_db->Read(std::make_pair(DB_TXINDEX_CSOUTPUT, ok), ov)) {
                 ov.m_spend_height = block.height;
                 ov.m_spend_txid = tx->GetHash();
                 batch.Write(std::make_pair(DB_TXINDEX_CSOUTPUT, ok), ov);
+                if (m_db->Read(std::make_pair(DB_TXINDEX_CSPAIR, ok), pair)) {
+                    auto &change = weightChanges[pair];
+                    change.first -= ov.m_value;
+                    change.second--;
+                }
             }
         }
     }
@@ -256,11 +323,44 @@ bool TxIndex::IndexCSOutputs(const interfaces::BlockInfo& block)
     for (const auto &it : newCSOuts) {
         batch.Write(std::make_pair(DB_TXINDEX_CSOUTPUT, it.first), it.second);
     }
+    for (const auto &it : newCSPairs) {
+        batch.Write(std::make_pair(DB_TXINDEX_CSPAIR, it.first), it.second);
+    }
     for (const auto &it : newCSLinks) {
         batch.Write(std::make_pair(DB_TXINDEX_CSLINK, it.first), it.second);
     }
 
+    // Append a running total checkpoint for every pair touched, even if the net change is zero,
+    // DisconnectBlock relies on the checkpoint existing at the block height.
+    for (const auto &it : weightChanges) {
+        ColdStakeIndexWeightValue prev, wv;
+        int prev_height;
+        if (m_db->Read(std::make_pair(DB_TXINDEX_CSWEIGHTTIP, it.first), prev_height)) {
+            // Skip checkpoints left by a block that was written but not committed as best block
+            while (prev_height >= block.height) {
+                if (!m_db->Read(std::make_pair(DB_TXINDEX_CSWEIGHT, ColdStakeIndexWeightKey(it.first, prev_height)), prev)) {
+                    return error("%s: Missing coldstake weight checkpoint at height %d.", __func__, prev_height);
+                }
+                prev_height = prev.m_prev_height;
+            }
+            if (prev_height >= 0 &&
+                !m_db->Read(std::make_pair(DB_TXINDEX_CSWEIGHT, ColdStakeIndexWeightKey(it.first, prev_height)), prev)) {
+                return error("%s: Missing coldstake weight checkpoint at height %d.", __func__, prev_height);
+            }
+            wv.m_prev_height = prev_height;
+        }
+        if (wv.m_prev_height >= 0) {
+            wv.m_value = prev.m_value;
+            wv.m_num_outputs = prev.m_num_outputs;
+        }
+        wv.m_value += it.second.first;
+        wv.m_num_outputs += it.second.second;
+        batch.Write(std::make_pair(DB_TXINDEX_CSWEIGHT, ColdStakeIndexWeightKey(it.first, block.height)), wv);
+        batch.Write(std::make_pair(DB_TXINDEX_CSWEIGHTTIP, it.first), block.height);
+    }
+
     batch.Write(DB_TXINDEX_CSBESTBLOCK, GetLocator(*m_chain, block.hash));
+    batch.Write(DB_TXINDEX_CSVERSION, CSINDEX_VERSION);
 
     if (!m_db->WriteBatch(batch)) {
         return error("%s: WriteBatch failed.", __func__);
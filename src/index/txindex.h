@@ -8,6 +8,8 @@
 #include <index/base.h>
 
 class CBlockHeader;
+class CScript;
+class ColdStakeIndexLinkKey;
 
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
@@ -27,9 +29,11 @@ private:
 protected:
     bool CustomInit(const std::optional<interfaces::BlockKey>& block) override;
     bool CustomAppend(const interfaces::BlockInfo& block) override;
-    bool DisconnectBlock(const CBlock& block) override;
+    bool DisconnectBlock(const CBlock& block, int height) override;
 
     bool IndexCSOutputs(const interfaces::BlockInfo& block);
+    /** Parse a coldstake script into stake and spend ids, false if not indexed */
+    bool ExtractCSLinkKey(const CScript &script, ColdStakeIndexLinkKey &lk) const;
 
 public:
     BaseIndex::DB& GetDB() const override;
@@ -35,6 +35,12 @@ void AddLoggingArgs(ArgsManager& argsman)
     argsman.AddArg("-logthreadnames", strprintf("Prepend debug output with name of the originating thread (only available on platforms supporting thread_local) (default: %u)", DEFAULT_LOGTHREADNAMES), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
 #else
     argsman.AddHiddenArgs({"-logthreadnames"});
+#endif
+#ifdef HAVE_THREAD_LOCAL
+    argsman.AddArg("-logasync", strprintf("Write debug output from a background thread, logging threads only append to a per-thread buffer (default: %u)", DEFAULT_LOGASYNC), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-logasyncbuffer=<n>", strprintf("Size of the per-thread buffer in KiB used with -logasync, messages are dropped and counted when it's full (default: %u)", DEFAULT_LOGASYNCBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+#else
+    argsman.AddHiddenArgs({"-logasync", "-logasyncbuffer"});
 #endif
     argsman.AddArg("-logsourcelocations", strprintf("Prepend debug output with name of the originating source location (source file, line number and function name) (default: %u)", DEFAULT_LOGSOURCELOCATIONS), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -51,6 +57,8 @@ void SetLoggingOptions(const ArgsManager& args)
     LogInstance().m_log_time_micros = args.GetBoolArg("-logtimemicros", DEFAULT_LOGTIMEMICROS);
 #ifdef HAVE_THREAD_LOCAL
     LogInstance().m_log_threadnames = args.GetBoolArg("-logthreadnames", DEFAULT_LOGTHREADNAMES);
+    LogInstance().m_async = args.GetBoolArg("-logasync", DEFAULT_LOGASYNC);
+    LogInstance().m_async_buffer_size = std::max<int64_t>(1, args.GetIntArg("-logasyncbuffer", DEFAULT_LOGASYNCBUFFER)) * 1024;
 #endif
     LogInstance().m_log_sourcelocations = args.GetBoolArg("-logsourcelocations", DEFAULT_LOGSOURCELOCATIONS);
 
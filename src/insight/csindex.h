@@ -10,6 +10,13 @@
 constexpr uint8_t DB_TXINDEX_CSOUTPUT{'O'};
 constexpr uint8_t DB_TXINDEX_CSLINK{'L'};
 constexpr uint8_t DB_TXINDEX_CSBESTBLOCK{'C'};
+constexpr uint8_t DB_TXINDEX_CSPAIR{'P'};
+constexpr uint8_t DB_TXINDEX_CSWEIGHT{'W'};
+constexpr uint8_t DB_TXINDEX_CSWEIGHTTIP{'T'};
+constexpr uint8_t DB_TXINDEX_CSVERSION{'V'};
+
+/** Bump to force the coldstake part of the txindex to be rebuilt */
+constexpr int CSINDEX_VERSION{1};
 
 enum CSIndexFlags
 {
@@ -98,4 +105,92 @@ public:
     }
 };
 
+/** Stake and spend address an indexed coldstake output pays to */
+class ColdStakeIndexPairKey
+{
+public:
+    TxoutType m_stake_type = TxoutType::NONSTANDARD, m_spend_type = TxoutType::NONSTANDARD;
+    CKeyID256 m_stake_id, m_spend_id;
+
+    ColdStakeIndexPairKey() {};
+    explicit ColdStakeIndexPairKey(const ColdStakeIndexLinkKey &lk)
+        : m_stake_type(lk.m_stake_type), m_spend_type(lk.m_spend_type), m_stake_id(lk.m_stake_id), m_spend_id(lk.m_spend_id) {};
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata8(s, globe::FromTxoutType(m_stake_type));
+        s.write(AsBytes(Span{(char*)m_stake_id.begin(), size_t((m_stake_type == TxoutType::PUBKEYHASH256) ? 32 : 20)}));
+        ser_writedata8(s, globe::FromTxoutType(m_spend_type));
+        s.write(AsBytes(Span{(char*)m_spend_id.begin(), size_t((m_spend_type == TxoutType::PUBKEYHASH256 || m_spend_type == TxoutType::SCRIPTHASH256) ? 32 : 20)}));
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        uint8_t stake_type = ser_readdata8(s);
+        m_stake_type = globe::ToTxoutType(stake_type);
+        m_stake_id.SetNull();
+        s.read(AsWritableBytes(Span{m_stake_id.begin(), size_t((m_stake_type == TxoutType::PUBKEYHASH256) ? 32 : 20)}));
+        uint8_t spend_type = ser_readdata8(s);
+        m_spend_type = globe::ToTxoutType(spend_type);
+        m_spend_id.SetNull();
+        s.read(AsWritableBytes(Span{m_spend_id.begin(), size_t((m_spend_type == TxoutType::PUBKEYHASH256 || m_spend_type == TxoutType::SCRIPTHASH256) ? 32 : 20)}));
+    }
+
+    friend bool operator<(const ColdStakeIndexPairKey& a, const ColdStakeIndexPairKey& b) {
+        if (a.m_stake_type != b.m_stake_type) {
+            return globe::FromTxoutType(a.m_stake_type) < globe::FromTxoutType(b.m_stake_type);
+        }
+        int cmp = a.m_stake_id.Compare(b.m_stake_id);
+        if (cmp < 0) return true;
+        if (cmp > 0) return false;
+        if (a.m_spend_type != b.m_spend_type) {
+            return globe::FromTxoutType(a.m_spend_type) < globe::FromTxoutType(b.m_spend_type);
+        }
+        return a.m_spend_id.Compare(b.m_spend_id) < 0;
+    }
+    friend bool operator==(const ColdStakeIndexPairKey& a, const ColdStakeIndexPairKey& b) {
+        return a.m_stake_type == b.m_stake_type && a.m_stake_id == b.m_stake_id &&
+               a.m_spend_type == b.m_spend_type && a.m_spend_id == b.m_spend_id;
+    }
+};
+
+/** Running total checkpoint per (stake address, spend address), keyed by height.
+ *  Height is serialised last, big endian, so all checkpoints for a stake address
+ *  are contiguous and ordered by spend address then height.
+ */
+class ColdStakeIndexWeightKey
+{
+public:
+    ColdStakeIndexPairKey m_pair;
+    unsigned int m_height = 0;
+
+    ColdStakeIndexWeightKey() {};
+    ColdStakeIndexWeightKey(const ColdStakeIndexPairKey &pair, unsigned int height) : m_pair(pair), m_height(height) {};
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        m_pair.Serialize(s);
+        ser_writedata32be(s, m_height);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        m_pair.Unserialize(s);
+        m_height = ser_readdata32be(s);
+    }
+};
+
+class ColdStakeIndexWeightValue
+{
+public:
+    CAmount m_value = 0;            // Total unspent value delegated after the block at the checkpoint height
+    uint32_t m_num_outputs = 0;     // Number of unspent outputs
+    int m_prev_height = -1;         // Height of the previous checkpoint, -1 if none
+
+    SERIALIZE_METHODS(ColdStakeIndexWeightValue, obj)
+    {
+        READWRITE(obj.m_value);
+        READWRITE(obj.m_num_outputs);
+        READWRITE(obj.m_prev_height);
+    }
+};
+
 #endif // GLOBE_INSIGHT_CSINDEX_H
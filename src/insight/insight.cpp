@@ -9,6 +9,7 @@
 #include <validation.h>
 #include <txdb.h>
 #include <txmempool.h>
+#include <undo.h>
 #include <uint256.h>
 #include <script/script.h>
 #include <script/standard.h>
@@ -82,6 +83,79 @@ bool ExtractIndexInfo(const CTxOutBase *out, int &scriptType, std::vector<uint8_
     return true;
 };
 
+bool CIndexEntryCheck::operator()()
+{
+    const CTransaction &tx = *ptx;
+    const uint256 txhash = tx.GetHash();
+
+    if (ptxundo) {
+        size_t n_prevout = 0;
+        for (size_t j = 0; j < tx.vin.size(); j++) {
+            const CTxIn &input = tx.vin[j];
+            if (input.IsAnonInput()) {
+                continue;
+            }
+            assert(n_prevout < ptxundo->vprevout.size());
+            const Coin &coin = ptxundo->vprevout[n_prevout++];
+
+            const CScript *pScript = &coin.out.scriptPubKey;
+            CAmount nValue = coin.nType == OUTPUT_CT ? 0 : coin.out.nValue;
+            std::vector<uint8_t> hashBytes;
+            int scriptType = 0;
+
+            if (!ExtractIndexInfo(pScript, scriptType, hashBytes)) {
+                continue;
+            }
+
+            uint256 hashAddress;
+            if (scriptType > 0) {
+                hashAddress = uint256(hashBytes.data(), hashBytes.size());
+            }
+            if (fAddressIndex && scriptType > 0) {
+                // record spending activity
+                pentries->addressIndex.push_back(std::make_pair(CAddressIndexKey(scriptType, hashAddress, nHeight, nTx, txhash, j, true), nValue * -1));
+                // remove address from unspent index
+                pentries->addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(scriptType, hashAddress, input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
+            }
+            if (fSpentIndex) {
+                CAmount nValue = coin.nType == OUTPUT_CT ? -1 : coin.out.nValue;
+                // add the spent index to determine the txid and input that spent an output
+                // and to find the amount and address from an input
+                pentries->spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, nHeight, nValue, scriptType, hashAddress)));
+            }
+        }
+    }
+
+    if (fAddressIndex) {
+        // Update outputs for insight
+        for (unsigned int k = 0; k < tx.vpout.size(); k++) {
+            const CTxOutBase *out = tx.vpout[k].get();
+
+            if (!out->IsType(OUTPUT_STANDARD)
+                && !out->IsType(OUTPUT_CT)) {
+                continue;
+            }
+
+            const CScript *pScript;
+            std::vector<unsigned char> hashBytes;
+            int scriptType = 0;
+            CAmount nValue;
+            if (!ExtractIndexInfo(out, scriptType, hashBytes, nValue, pScript)
+                || scriptType == 0) {
+                continue;
+            }
+
+            const uint256 hashAddress(hashBytes.data(), hashBytes.size());
+            // Record receiving activity
+            pentries->addressIndex.push_back(std::make_pair(CAddressIndexKey(scriptType, hashAddress, nHeight, nTx, txhash, k, false), nValue));
+            // Record unspent output
+            pentries->addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(scriptType, hashAddress, txhash, k), CAddressUnspentValue(nValue, *pScript, nHeight)));
+        }
+    }
+
+    return true;
+};
+
 static bool HashOnchainActive(ChainstateManager &chainman, const uint256 &hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     CBlockIndex* pblockindex = chainman.m_blockman.LookupBlockIndex(hash);
@@ -10,6 +10,8 @@
 #include <threadsafety.h>
 
 #include <consensus/amount.h>
+#include <insight/addressindex.h>
+#include <insight/spentindex.h>
 #include <sync.h>
 #include <stdint.h>
 #include <vector>
@@ -28,16 +30,52 @@ class CTxOutBase;
 class CScript;
 class uint256;
 class CTxMemPool;
+class CTransaction;
+class CTxUndo;
 class BlockBalances;
-struct CAddressIndexKey;
-struct CAddressUnspentKey;
-struct CAddressUnspentValue;
-struct CSpentIndexKey;
-struct CSpentIndexValue;
 
 bool ExtractIndexInfo(const CScript *pScript, int &scriptType, std::vector<uint8_t> &hashBytes);
 bool ExtractIndexInfo(const CTxOutBase *out, int &scriptType, std::vector<uint8_t> &hashBytes, CAmount &nValue, const CScript *&pScript);
 
+/** Address and spent index entries of a connected transaction */
+struct TxIndexEntries {
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
+    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
+};
+
+/**
+ * Closure collecting the index entries of one transaction in a block,
+ * queued by ConnectBlock to run alongside the script checks.
+ * Spent coins are read from the transaction's undo data, which lists the
+ * non anon inputs in order.
+ */
+class CIndexEntryCheck
+{
+private:
+    const CTransaction *ptx = nullptr;
+    const CTxUndo *ptxundo = nullptr; // nullptr to skip inputs
+    unsigned int nTx = 0;
+    int nHeight = 0;
+    TxIndexEntries *pentries = nullptr;
+
+public:
+    CIndexEntryCheck() {}
+    CIndexEntryCheck(const CTransaction &tx, const CTxUndo *txundo, unsigned int n_tx, int height, TxIndexEntries &entries) :
+        ptx(&tx), ptxundo(txundo), nTx(n_tx), nHeight(height), pentries(&entries) {}
+
+    bool operator()();
+
+    void swap(CIndexEntryCheck &check) noexcept
+    {
+        std::swap(ptx, check.ptx);
+        std::swap(ptxundo, check.ptxundo);
+        std::swap(nTx, check.nTx);
+        std::swap(nHeight, check.nHeight);
+        std::swap(pentries, check.pentries);
+    }
+};
+
 /** Functions for insight block explorer */
 bool GetTimestampIndex(ChainstateManager &chainman, const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 bool GetSpentIndex(ChainstateManager &chainman, const CSpentIndexKey &key, CSpentIndexValue &value, const CTxMemPool *pmempool);
@@ -1281,6 +1281,49 @@ return RPCHelpMan{"getblockbalances",
     };
 }
 
+static std::string EncodeCSSpendAddress(TxoutType spend_type, const CKeyID256 &spend_id)
+{
+    switch (spend_type) {
+        case TxoutType::PUBKEYHASH: {
+            PKHash idk;
+            memcpy(idk.begin(), spend_id.begin(), 20);
+            return EncodeDestination(idk);
+            }
+        case TxoutType::PUBKEYHASH256:
+            return EncodeDestination(spend_id);
+        case TxoutType::SCRIPTHASH: {
+            ScriptHash ids;
+            memcpy(ids.begin(), spend_id.begin(), 20);
+            return EncodeDestination(ids);
+            }
+        case TxoutType::SCRIPTHASH256: {
+            CScriptID256 ids;
+            memcpy(ids.begin(), spend_id.begin(), 32);
+            return EncodeDestination(ids);
+            }
+        default:
+            break;
+    }
+    return "unknown_type";
+}
+
+static void ParseCSStakeAddress(const std::string &address, TxoutType &stake_type, CKeyID256 &stake_id)
+{
+    CTxDestination stake_dest = DecodeDestination(address, true);
+    stake_id.SetNull();
+    if (stake_dest.index() == DI::_PKHash) {
+        stake_type = TxoutType::PUBKEYHASH;
+        PKHash id = std::get<PKHash>(stake_dest);
+        memcpy(stake_id.begin(), id.begin(), 20);
+    } else
+    if (stake_dest.index() == DI::_CKeyID256) {
+        stake_type = TxoutType::PUBKEYHASH256;
+        stake_id = std::get<CKeyID256>(stake_dest);
+    } else {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unrecognised stake address type.");
+    }
+}
+
 static RPCHelpMan listcoldstakeunspent()
 {
     return RPCHelpMan{"listcoldstakeunspent",
@@ -1325,18 +1368,7 @@ static RPCHelpMan listcoldstakeunspent()
     ChainstateManager &chainman = EnsureAnyChainman(request.context);
 
     ColdStakeIndexLinkKey seek_key;
-    CTxDestination stake_dest = DecodeDestination(request.params[0].get_str(), true);
-    if (stake_dest.index() == DI::_PKHash) {
-        seek_key.m_stake_type = TxoutType::PUBKEYHASH;
-        PKHash id = std::get<PKHash>(stake_dest);
-        memcpy(seek_key.m_stake_id.begin(), id.begin(), 20);
-    } else
-    if (stake_dest.index() == DI::_CKeyID256) {
-        seek_key.m_stake_type = TxoutType::PUBKEYHASH256;
-        seek_key.m_stake_id = std::get<CKeyID256>(stake_dest);
-    } else {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unrecognised stake address type.");
-    }
+    ParseCSStakeAddress(request.params[0].get_str(), seek_key.m_stake_type, seek_key.m_stake_id);
 
     CDBWrapper &db = g_txindex->GetDB();
 
@@ -1412,32 +1444,7 @@ static RPCHelpMan listcoldstakeunspent()
                         output.pushKV("n", ok.m_n);
                     }
 
-                    switch (lk.m_spend_type) {
-                        case TxoutType::PUBKEYHASH: {
-                            PKHash idk;
-                            memcpy(idk.begin(), lk.m_spend_id.begin(), 20);
-                            output.pushKV("addrspend", EncodeDestination(idk));
-                            }
-                            break;
-                        case TxoutType::PUBKEYHASH256:
-                            output.pushKV("addrspend", EncodeDestination(lk.m_spend_id));
-                            break;
-                        case TxoutType::SCRIPTHASH: {
-                            ScriptHash ids;
-                            memcpy(ids.begin(), lk.m_spend_id.begin(), 20);
-                            output.pushKV("addrspend", EncodeDestination(ids));
-                            }
-                            break;
-                        case TxoutType::SCRIPTHASH256: {
-                            CScriptID256 ids;
-                            memcpy(ids.begin(), lk.m_spend_id.begin(), 32);
-                            output.pushKV("addrspend", EncodeDestination(ids));
-                            }
-                            break;
-                        default:
-                            output.pushKV("addrspend", "unknown_type");
-                            break;
-                    }
+                    output.pushKV("addrspend", EncodeCSSpendAddress(lk.m_spend_type, lk.m_spend_id));
 
                     rv.push_back(output);
                 }
@@ -1451,6 +1458,190 @@ static RPCHelpMan listcoldstakeunspent()
     };
 }
 
+static RPCHelpMan getcoldstakeweights()
+{
+    return RPCHelpMan{"getcoldstakeweights",
+                "\nReturns the value delegated to \"stakeaddress\" per spend address at height.\n"
+                "Read from running total checkpoints in the coldstake index, maturity is not considered.\n",
+                {
+                    {"stakeaddress", RPCArg::Type::STR, RPCArg::Optional::NO, "The stakeaddress to return delegations for."},
+                    {"height", RPCArg::Type::NUM, RPCArg::DefaultHint{"index height"}, "The block height to return weights at, -1 or a height above the index height for the index height."},
+                    {"options", RPCArg::Type::OBJ, RPCArg::Default{UniValue::VOBJ}, "",
+                        {
+                            {"count", RPCArg::Type::NUM, RPCArg::Default{1000}, "Maximum number of spend addresses to return, 0 for all."},
+                            {"page", RPCArg::Type::STR_HEX, RPCArg::Default{""}, "Continue from the \"next_page\" value of a previous call."},
+                            {"hex", RPCArg::Type::BOOL, RPCArg::Default{false}, "Return the delegations serialised as hex instead of as objects.\n"
+                                "Each record is: spend type (uint8), spend id (20 or 32 bytes), value (int64), num_outputs (uint32), checkpoint height (uint32)."},
+                        },
+                        "options"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::NUM, "height", "The height weights are returned for"},
+                        {RPCResult::Type::NUM, "total", "The total value of the returned delegations"},
+                        {RPCResult::Type::NUM, "num_delegators", "The number of spend addresses returned"},
+                        {RPCResult::Type::ARR, "delegators", /*optional=*/true, "", {
+                            {RPCResult::Type::OBJ, "", "", {
+                                {RPCResult::Type::STR, "addrspend", "The spending address"},
+                                {RPCResult::Type::NUM, "value", "The unspent value delegated at height"},
+                                {RPCResult::Type::NUM, "num_outputs", "The number of unspent outputs at height"},
+                                {RPCResult::Type::NUM, "checkpoint_height", "The height the value last changed"},
+                            }}
+                        }},
+                        {RPCResult::Type::STR_HEX, "hex", /*optional=*/true, "The serialised delegations, if hex was set"},
+                        {RPCResult::Type::STR_HEX, "next_page", /*optional=*/true, "Pass as \"page\" to continue, if more spend addresses may remain"},
+                    }
+                },
+                RPCExamples{
+            HelpExampleCli("getcoldstakeweights", "\"Pb7FLL3DyaAVP2eGfRiEkj4U8ZJ3RHLY9g\" 1000") +
+            "\nAs a JSON-RPC call\n"
+            + HelpExampleRpc("getcoldstakeweights", "\"Pb7FLL3DyaAVP2eGfRiEkj4U8ZJ3RHLY9g\", 1000")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    RPCTypeCheck(request.params, {UniValue::VSTR, UniValue::VNUM}, true);
+
+    if (!g_txindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires -txindex enabled");
+    }
+    if (!g_txindex->m_cs_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires -csindex enabled");
+    }
+    ChainstateManager &chainman = EnsureAnyChainman(request.context);
+
+    ColdStakeIndexWeightKey seek_key;
+    ParseCSStakeAddress(request.params[0].get_str(), seek_key.m_pair.m_stake_type, seek_key.m_pair.m_stake_id);
+
+    size_t max_count = 1000;
+    bool output_hex = false;
+    if (request.params[2].isObject()) {
+        const UniValue &options = request.params[2];
+        RPCTypeCheckObj(options,
+            {
+                {"count", UniValueType(UniValue::VNUM)},
+                {"page", UniValueType(UniValue::VSTR)},
+                {"hex", UniValueType(UniValue::VBOOL)},
+            },
+            true, true);
+        if (options["count"].isNum()) {
+            int count = options["count"].getInt<int>();
+            if (count < 0) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid count.");
+            }
+            max_count = count;
+        }
+        if (options["hex"].isBool()) {
+            output_hex = options["hex"].get_bool();
+        }
+        if (options["page"].isStr() && !options["page"].get_str().empty()) {
+            std::vector<uint8_t> page_data = ParseHexO(options, "page");
+            ColdStakeIndexPairKey page_pair;
+            try {
+                CDataStream ss(page_data, SER_DISK, CLIENT_VERSION);
+                ss >> page_pair;
+            } catch (const std::exception&) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid page.");
+            }
+            if (page_pair.m_stake_type != seek_key.m_pair.m_stake_type ||
+                page_pair.m_stake_id != seek_key.m_pair.m_stake_id) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Page does not match stakeaddress.");
+            }
+            // Start after all checkpoints of the last returned spend address
+            seek_key.m_pair = page_pair;
+            seek_key.m_height = std::numeric_limits<uint32_t>::max();
+        }
+    }
+
+    CDBWrapper &db = g_txindex->GetDB();
+
+    LOCK(cs_main);
+
+    int height = !request.params[1].isNull() ? request.params[1].getInt<int>() : -1;
+    if (height < -1) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height.");
+    }
+    // Checkpoints above the index height are not written yet
+    const int index_height = std::min(g_txindex->GetSummary().best_block_height, chainman.ActiveChain().Height());
+    if (height == -1 || height > index_height) {
+        height = index_height;
+    }
+
+    UniValue delegators(UniValue::VARR);
+    CDataStream ss_out(SER_DISK, CLIENT_VERSION);
+    CAmount total = 0;
+    size_t num_found = 0;
+    bool more = false;
+
+    std::unique_ptr<CDBIterator> it(db.NewIterator());
+    it->Seek(std::make_pair(DB_TXINDEX_CSWEIGHT, seek_key));
+
+    std::pair<uint8_t, ColdStakeIndexWeightKey> key;
+    while (it->Valid() && it->StartsWith(DB_TXINDEX_CSWEIGHT) && it->GetKey(key)) {
+        if (key.first != DB_TXINDEX_CSWEIGHT ||
+            key.second.m_pair.m_stake_type != seek_key.m_pair.m_stake_type ||
+            key.second.m_pair.m_stake_id != seek_key.m_pair.m_stake_id) {
+            break;
+        }
+        if (max_count > 0 && num_found >= max_count) {
+            more = true;
+            break;
+        }
+        const ColdStakeIndexPairKey pair = key.second.m_pair;
+
+        // The last checkpoint at or below height holds the running total, reach it by seeking one past and stepping back
+        it->Seek(std::make_pair(DB_TXINDEX_CSWEIGHT, ColdStakeIndexWeightKey(pair, (unsigned int)height + 1)));
+        if (it->Valid()) {
+            it->Prev();
+        } else {
+            it->SeekToLast();
+        }
+
+        ColdStakeIndexWeightValue wv;
+        if (it->Valid() && it->GetKey(key) &&
+            key.first == DB_TXINDEX_CSWEIGHT && key.second.m_pair == pair &&
+            (int)key.second.m_height <= height && it->GetValue(wv) &&
+            wv.m_num_outputs > 0) {
+            total += wv.m_value;
+            num_found++;
+            if (output_hex) {
+                ser_writedata8(ss_out, globe::FromTxoutType(pair.m_spend_type));
+                ss_out.write(AsBytes(Span{(char*)pair.m_spend_id.begin(), size_t((pair.m_spend_type == TxoutType::PUBKEYHASH256 || pair.m_spend_type == TxoutType::SCRIPTHASH256) ? 32 : 20)}));
+                ss_out << wv.m_value << wv.m_num_outputs << (uint32_t)key.second.m_height;
+            } else {
+                UniValue delegator(UniValue::VOBJ);
+                delegator.pushKV("addrspend", EncodeCSSpendAddress(pair.m_spend_type, pair.m_spend_id));
+                delegator.pushKV("value", wv.m_value);
+                delegator.pushKV("num_outputs", (int)wv.m_num_outputs);
+                delegator.pushKV("checkpoint_height", (int)key.second.m_height);
+                delegators.push_back(delegator);
+            }
+        }
+
+        // Skip the remaining checkpoints of this spend address
+        it->Seek(std::make_pair(DB_TXINDEX_CSWEIGHT, ColdStakeIndexWeightKey(pair, std::numeric_limits<uint32_t>::max())));
+        seek_key.m_pair = pair;
+    }
+
+    UniValue rv(UniValue::VOBJ);
+    rv.pushKV("height", height);
+    rv.pushKV("total", total);
+    rv.pushKV("num_delegators", (uint64_t)num_found);
+    if (output_hex) {
+        rv.pushKV("hex", HexStr(ss_out));
+    } else {
+        rv.pushKV("delegators", delegators);
+    }
+    if (more) {
+        CDataStream ss_page(SER_DISK, CLIENT_VERSION);
+        ss_page << seek_key.m_pair;
+        rv.pushKV("next_page", HexStr(ss_page));
+    }
+
+    return rv;
+},
+    };
+}
+
 static RPCHelpMan getinsightinfo()
 {
     return RPCHelpMan{"getinsightinfo",
@@ -1491,20 +1682,21 @@ static RPCHelpMan getinsightinfo()
 void RegisterInsightRPCCommands(CRPCTable &t)
 {
     static const CRPCCommand commands[]{
-        {"addressindex", &getaddressmempool},
-        {"addressindex", &getaddressutxos},
-        {"addressindex", &getaddressdeltas},
-        {"addressindex", &getaddresstxids},
-        {"addressindex", &getaddressbalance},
-
-        {"blockchain", &getspentinfo},
-        {"blockchain", &getblockdeltas},
-        {"blockchain", &getblockhashes},
+        {"addressindex", &getaddressmempool, /*batch_parallel_safe=*/true},
+        {"addressindex", &getaddressutxos, /*batch_parallel_safe=*/true},
+        {"addressindex", &getaddressdeltas, /*batch_parallel_safe=*/true},
+        {"addressindex", &getaddresstxids, /*batch_parallel_safe=*/true},
+        {"addressindex", &getaddressbalance, /*batch_parallel_safe=*/true},
+
+        {"blockchain", &getspentinfo, /*batch_parallel_safe=*/true},
+        {"blockchain", &getblockdeltas, /*batch_parallel_safe=*/true},
+        {"blockchain", &getblockhashes, /*batch_parallel_safe=*/true},
         {"blockchain", &gettxoutsetinfobyscript},
-        {"blockchain", &getblockreward},
-        {"blockchain", &getblockbalances},
+        {"blockchain", &getblockreward, /*batch_parallel_safe=*/true},
+        {"blockchain", &getblockbalances, /*batch_parallel_safe=*/true},
 
-        {"csindex", &listcoldstakeunspent},
+        {"csindex", &listcoldstakeunspent, /*batch_parallel_safe=*/true},
+        {"csindex", &getcoldstakeweights, /*batch_parallel_safe=*/true},
 
         {"blockchain", &getinsightinfo},
     };
@@ -303,6 +303,8 @@ public:
         virtual void updatedBlockTip() {}
         virtual void chainStateFlushed(const CBlockLocator& locator) {}
         virtual void leavingIBD() {}
+        //! Name shown for the client's validation notification queue.
+        virtual std::string notificationsName() const { return "chain client"; }
     };
 
     //! Register handler for notifications.
@@ -4,6 +4,7 @@
 
 #include <kernel/coinstats.h>
 
+#include <blind.h>
 #include <chain.h>
 #include <coins.h>
 #include <crypto/muhash.h>
@@ -20,16 +21,20 @@
 #include <util/check.h>
 #include <util/overflow.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <validation.h>
 #include <version.h>
 
+#include <algorithm>
 #include <cassert>
+#include <future>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -122,7 +127,72 @@ static void ApplyHash(MuHash3072& muhash, const uint256& hash, const std::map<ui
     }
 }
 
-static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+/** Sum of the commitments of blinded coins, added up in batches */
+class CommitmentSum
+{
+    static constexpr size_t BATCH_SIZE{1024};
+
+    std::vector<secp256k1_pedersen_commitment> m_pending;
+    std::optional<secp256k1_pedersen_commitment> m_sum;
+    bool m_failed{false};
+
+    void Flush()
+    {
+        if (m_pending.empty() || m_failed) {
+            m_pending.clear();
+            return;
+        }
+        if (!secp256k1_ctx_blind) {
+            m_failed = true;
+            return;
+        }
+        std::vector<const secp256k1_pedersen_commitment*> commits;
+        commits.reserve(m_pending.size() + 1);
+        if (m_sum) {
+            commits.push_back(&*m_sum);
+        }
+        for (const auto& commitment : m_pending) {
+            commits.push_back(&commitment);
+        }
+        secp256k1_pedersen_commitment sum;
+        if (!secp256k1_pedersen_commitment_sum(secp256k1_ctx_blind, &sum, commits.data(), commits.size())) {
+            m_failed = true;
+        }
+        m_sum = sum;
+        m_pending.clear();
+    }
+
+public:
+    void Add(const secp256k1_pedersen_commitment& commitment)
+    {
+        m_pending.push_back(commitment);
+        if (m_pending.size() >= BATCH_SIZE) {
+            Flush();
+        }
+    }
+
+    //! Add the sum of other, the total is unknown if other failed
+    void Add(CommitmentSum& other)
+    {
+        const auto sum = other.Get();
+        if (other.m_failed) {
+            m_failed = true;
+        } else if (sum) {
+            Add(*sum);
+        }
+    }
+
+    std::optional<secp256k1_pedersen_commitment> Get()
+    {
+        Flush();
+        if (m_failed) {
+            return std::nullopt;
+        }
+        return m_sum;
+    }
+};
+
+static void ApplyStats(CCoinsStats& stats, CommitmentSum& blind_sum, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
 {
     assert(!outputs.empty());
     stats.nTransactions++;
@@ -136,6 +206,7 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
                 break;
             case OUTPUT_CT:
                 stats.nBlindTransactionOutputs++;
+                blind_sum.Add(it->second.commitment);
                 break;
             default:
                 break;
@@ -144,24 +215,23 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Read coins from the cursor until the first byte of a txid reaches end_byte,
+//! all outputs of a transaction are read in the same range.
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ApplyCoins(CCoinsViewCursor& cursor, int end_byte, CCoinsStats& stats, T& hash_obj, CommitmentSum& blind_sum, const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
-    PrepareHash(hash_obj, stats);
-
     uint256 prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
-        interruption_point();
+    while (cursor.Valid()) {
+        if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
+            if (*key.hash.begin() >= end_byte) {
+                break;
+            }
             if (!outputs.empty() && key.hash != prevkey) {
-                ApplyStats(stats, prevkey, outputs);
+                ApplyStats(stats, blind_sum, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
                 outputs.clear();
             }
@@ -171,12 +241,28 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
         } else {
             return error("%s: unable to read value", __func__);
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
-        ApplyStats(stats, prevkey, outputs);
+        ApplyStats(stats, blind_sum, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, std::unique_ptr<CCoinsViewCursor> pcursor, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+{
+    assert(pcursor);
+
+    PrepareHash(hash_obj, stats);
+
+    CommitmentSum blind_sum;
+    if (!ApplyCoins(*pcursor, /*end_byte=*/256, stats, hash_obj, blind_sum, interruption_point)) {
+        return false;
+    }
+    stats.blind_commitment_sum = blind_sum.Get();
 
     FinalizeHash(hash_obj, stats);
 
@@ -185,23 +271,118 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+static void CombineHash(MuHash3072& muhash, const MuHash3072& range_muhash)
 {
-    CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
+    muhash *= range_muhash;
+}
+static void CombineHash(std::nullptr_t, std::nullptr_t) {}
+
+//! Calculate statistics about the unspent transaction output set, reading one
+//! txid range per cursor in parallel. Only for hashes that can be combined.
+template <typename T>
+static bool ComputeUTXOStatsParallel(CCoinsView* view, const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+{
+    const int ranges = cursors.size();
+    std::vector<CCoinsStats> range_stats(ranges);
+    std::vector<T> range_hashes(ranges);
+    std::vector<CommitmentSum> range_sums(ranges);
+
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < ranges; ++i) {
+        results.push_back(std::async(std::launch::async, [&, i] {
+            util::ThreadRename(strprintf("coinstats.%i", i));
+            return ApplyCoins(*cursors[i], /*end_byte=*/(i + 1) * 256 / ranges, range_stats[i], range_hashes[i], range_sums[i], interruption_point);
+        }));
+    }
+    bool success = true;
+    for (auto& result : results) {
+        success &= result.get();
+    }
+    if (!success) {
+        return false;
+    }
+
+    PrepareHash(hash_obj, stats);
+    CommitmentSum blind_sum;
+    for (int i = 0; i < ranges; ++i) {
+        const CCoinsStats& range = range_stats[i];
+        stats.nTransactions += range.nTransactions;
+        stats.nTransactionOutputs += range.nTransactionOutputs;
+        stats.nBlindTransactionOutputs += range.nBlindTransactionOutputs;
+        stats.nBogoSize += range.nBogoSize;
+        stats.coins_count += range.coins_count;
+        if (stats.total_amount.has_value()) {
+            stats.total_amount = range.total_amount.has_value() ? CheckedAdd(*stats.total_amount, *range.total_amount) : std::nullopt;
+        }
+        CombineHash(hash_obj, range_hashes[i]);
+        blind_sum.Add(range_sums[i]);
+    }
+    stats.blind_commitment_sum = blind_sum.Get();
+    FinalizeHash(hash_obj, stats);
+
+    stats.nDiskSize = view->EstimateSize();
+
+    return true;
+}
+
+//! One cursor per txid range, empty if the view can not be read in ranges
+static std::vector<std::unique_ptr<CCoinsViewCursor>> RangeCursors(CCoinsView* view, int ranges)
+{
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    for (int i = 0; i < ranges; ++i) {
+        uint256 start;
+        *start.begin() = i * 256 / ranges;
+        auto cursor = view->SeekCursor(start);
+        if (!cursor) {
+            return {};
+        }
+        cursors.push_back(std::move(cursor));
+    }
+    return cursors;
+}
+
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int max_threads)
+{
+    if (max_threads <= 0) {
+        max_threads = GetNumCores();
+    }
+    const int ranges = hash_type == CoinStatsHashType::HASH_SERIALIZED ? 1 : std::clamp(max_threads, 1, MAX_COINSTATS_THREADS);
+
+    // Create all cursors under cs_main, chainstate flushes hold it, so every
+    // range is read from the same state as the best block.
+    std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    CBlockIndex* pindex;
+    {
+        LOCK(::cs_main);
+        pindex = blockman.LookupBlockIndex(view->GetBestBlock());
+        if (ranges > 1) {
+            cursors = RangeCursors(view, ranges);
+        }
+        if (cursors.empty()) {
+            pcursor = view->Cursor();
+        }
+    }
     CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
 
     bool success = [&]() -> bool {
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return ComputeUTXOStats(view, std::move(pcursor), stats, ss, interruption_point);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            if (!cursors.empty()) {
+                return ComputeUTXOStatsParallel(view, cursors, stats, muhash, interruption_point);
+            }
+            return ComputeUTXOStats(view, std::move(pcursor), stats, muhash, interruption_point);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            if (!cursors.empty()) {
+                return ComputeUTXOStatsParallel(view, cursors, stats, nullptr, interruption_point);
+            }
+            return ComputeUTXOStats(view, std::move(pcursor), stats, nullptr, interruption_point);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
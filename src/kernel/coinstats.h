@@ -9,6 +9,8 @@
 #include <streams.h>
 #include <uint256.h>
 
+#include <secp256k1_commitment.h>
+
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -39,6 +41,9 @@ struct CCoinsStats {
     //! The total amount, or nullopt if an overflow occurred calculating it
     std::optional<CAmount> total_amount{0};
     uint64_t nBlindTransactionOutputs{0};
+    //! Sum of the commitments of the blinded outputs, nullopt if there are none
+    //! or coinstatsindex was used
+    std::optional<secp256k1_pedersen_commitment> blind_commitment_sum;
 
     //! The number of coins contained.
     uint64_t coins_count{0};
@@ -75,7 +80,17 @@ uint64_t GetBogoSize(const CScript& script_pub_key);
 
 CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+//! Maximum number of threads hashing ranges of the UTXO set
+static constexpr int MAX_COINSTATS_THREADS{16};
+
+/**
+ * Calculate statistics about the unspent transaction output set.
+ *
+ * With MUHASH or NONE the set is split into txid ranges read in parallel by
+ * up to max_threads threads, 0 picks one per core. HASH_SERIALIZED depends on
+ * the order of the coins and is always computed on one thread.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, int max_threads = 0);
 } // namespace kernel
 
 #endif // GLOBE_KERNEL_COINSTATS_H
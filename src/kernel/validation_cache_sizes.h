@@ -12,8 +12,9 @@
 
 namespace kernel {
 struct ValidationCacheSizes {
-    size_t signature_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES / 2};
-    size_t script_execution_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES / 2};
+    size_t signature_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES * 3 / 8};
+    size_t script_execution_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES * 3 / 8};
+    size_t prevalidation_cache_bytes{DEFAULT_MAX_SIG_CACHE_BYTES / 4};
 };
 }
 
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <mutex>
 #include <optional>
 
@@ -64,7 +65,9 @@ bool BCLog::Logger::StartLogging()
             return false;
         }
 
-        setbuf(m_fileout, nullptr); // unbuffered
+        if (!m_async) {
+            setbuf(m_fileout, nullptr); // unbuffered
+        }
 
         // Add newlines to the logfile to distinguish this execution from the
         // last one.
@@ -89,11 +92,16 @@ bool BCLog::Logger::StartLogging()
     }
     if (m_print_to_console) fflush(stdout);
 
+    if (m_async) {
+        StartAsyncWriter();
+    }
+
     return true;
 }
 
 void BCLog::Logger::DisconnectTestLogger()
 {
+    StopAsyncWriter();
     StdLockGuard scoped_lock(m_cs);
     m_buffering = true;
     if (m_fileout != nullptr) fclose(m_fileout);
@@ -358,14 +366,14 @@ std::string BCLog::Logger::LogLevelsString() const
     return Join(std::vector<BCLog::Level>{levels.begin(), levels.end()}, ", ", [this](BCLog::Level level) { return LogLevelToStr(level); });
 }
 
-std::string BCLog::Logger::LogTimestampStr(const std::string& str)
+std::string BCLog::Logger::LogTimestampStr(const std::string& str, bool started_new_line)
 {
     std::string strStamped;
 
     if (!m_log_timestamps)
         return str;
 
-    if (m_started_new_line) {
+    if (started_new_line) {
         int64_t nTimeMicros = GetTimeMicros();
         strStamped = FormatISO8601DateTime(nTimeMicros/1000000);
         if (m_log_time_micros) {
@@ -405,12 +413,11 @@ namespace BCLog {
     }
 } // namespace BCLog
 
-void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line, BCLog::LogFlags category, BCLog::Level level, bool useVMLog)
+std::string BCLog::Logger::FormatLogStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line, BCLog::LogFlags category, BCLog::Level level, bool useVMLog, bool started_new_line)
 {
-    StdLockGuard scoped_lock(m_cs);
     std::string str_prefixed = LogEscapeMessage(str);
 
-    if ((category != LogFlags::NONE || level != Level::None) && m_started_new_line) {
+    if ((category != LogFlags::NONE || level != Level::None) && started_new_line) {
         std::string s{"["};
 
         if (category != LogFlags::NONE) {
@@ -430,7 +437,7 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
         str_prefixed.insert(0, s);
     }
 
-    if (m_log_sourcelocations && m_started_new_line) {
+    if (m_log_sourcelocations && started_new_line) {
         if(useVMLog) {
              str_prefixed.insert(0, "[" + logging_function + "] ");
          }
@@ -439,14 +446,41 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
          }
     }
 
-    if (m_log_threadnames && m_started_new_line) {
+    if (m_log_threadnames && started_new_line) {
         const auto& threadname = util::ThreadGetInternalName();
         str_prefixed.insert(0, "[" + (threadname.empty() ? "unknown" : threadname) + "] ");
     }
 
-    str_prefixed = LogTimestampStr(str_prefixed);
+    return LogTimestampStr(str_prefixed, started_new_line);
+}
+
+namespace {
+/** Line state of the asynchronous path, a thread's partial lines are only continued by that thread */
+thread_local bool g_thread_log_started_new_line = true;
+
+bool EndsWithNewLine(const std::string& str)
+{
+    return !str.empty() && str[str.size()-1] == '\n';
+}
+} // namespace
+
+void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line, BCLog::LogFlags category, BCLog::Level level, bool useVMLog)
+{
+    if (m_async_active.load()) {
+        // Formatted and numbered without m_cs, the writer takes it for the write only
+        std::string str_prefixed = FormatLogStr(str, logging_function, source_file, source_line, category, level, useVMLog, g_thread_log_started_new_line);
+        g_thread_log_started_new_line = EndsWithNewLine(str);
+        PushAsync(str_prefixed, useVMLog);
+        // StopAsyncWriter may have drained for the last time before the push
+        if (!m_async_active.load()) {
+            DrainAsync();
+        }
+        return;
+    }
 
-    m_started_new_line = !str.empty() && str[str.size()-1] == '\n';
+    StdLockGuard scoped_lock(m_cs);
+    std::string str_prefixed = FormatLogStr(str, logging_function, source_file, source_line, category, level, useVMLog, m_started_new_line);
+    m_started_new_line = EndsWithNewLine(str);
 
     if (m_buffering) {
         // buffer if we haven't started logging yet
@@ -455,23 +489,25 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
         return;
     }
 
+    WriteLogStr(str_prefixed, useVMLog);
+}
+
+void BCLog::Logger::WriteLogStr(const std::string& str_prefixed, bool useVMLog)
+{
     bool print_to_console = m_print_to_console;
      if(print_to_console && useVMLog && !m_show_evm_logs) print_to_console = false;
 
     if (m_print_to_console) {
         // print to console
         fwrite(str_prefixed.data(), 1, str_prefixed.size(), stdout);
-        fflush(stdout);
+        if (!m_async_active) fflush(stdout);
     }
     for (const auto& cb : m_print_callbacks) {
         cb(str_prefixed);
     }
     if (m_print_to_file) {
          //////////////////////////////// // globe smart contracts
-         FILE* file = m_fileout;
-         if(useVMLog){
-             file = m_fileoutVM;
-         }
+         FILE*& file = useVMLog ? m_fileoutVM : m_fileout;
          ////////////////////////////////
          assert(file != nullptr);
 
@@ -483,7 +519,9 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
                 file_path = m_file_pathVM;
             FILE* new_fileout = fsbridge::fopen(file_path, "a");
             if (new_fileout) {
-                setbuf(new_fileout, nullptr); // unbuffered
+                if (!m_async_active) {
+                    setbuf(new_fileout, nullptr); // unbuffered
+                }
                 fclose(file);
                 file = new_fileout;
             }
@@ -492,6 +530,235 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
     }
 }
 
+namespace BCLog {
+/**
+ * Single producer, single consumer byte ring owned by one logging thread.
+ * Records are laid out as [sequence (8)][length (4)][vm flag (1)][message],
+ * possibly wrapping around the end of the buffer.
+ */
+class LogRingBuffer
+{
+public:
+    static constexpr size_t HEADER_SIZE{8 + 4 + 1};
+
+    explicit LogRingBuffer(size_t capacity) : m_buf(std::max(capacity, HEADER_SIZE)) {}
+
+    //! Producer side, returns false and counts a drop if the message doesn't fit
+    bool Push(uint64_t seq, bool vm, const std::string& str)
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        const uint64_t tail = m_tail.load(std::memory_order_acquire);
+        const uint64_t need = HEADER_SIZE + str.size();
+        if (need > m_buf.size() - (head - tail)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        const uint32_t len = str.size();
+        const uint8_t flags = vm ? 1 : 0;
+        CopyIn(head, &seq, 8);
+        CopyIn(head + 8, &len, 4);
+        CopyIn(head + 12, &flags, 1);
+        CopyIn(head + HEADER_SIZE, str.data(), str.size());
+        m_head.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    //! Consumer side, calls fn(seq, vm, message) for every pending record
+    template <typename Fn>
+    void Drain(Fn&& fn)
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        while (tail < head) {
+            uint64_t seq;
+            uint32_t len;
+            uint8_t flags;
+            CopyOut(tail, &seq, 8);
+            CopyOut(tail + 8, &len, 4);
+            CopyOut(tail + 12, &flags, 1);
+            std::string str(len, '\0');
+            CopyOut(tail + HEADER_SIZE, str.data(), len);
+            tail += HEADER_SIZE + len;
+            fn(seq, flags & 1, std::move(str));
+        }
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    bool Empty() const { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire); }
+    bool MoreThanHalfFull() const { return 2 * (m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed)) > m_buf.size(); }
+
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_orphaned{false}; //!< Set when the owning thread exits
+
+private:
+    void CopyIn(uint64_t pos, const void* src, size_t n)
+    {
+        const size_t offset = pos % m_buf.size();
+        const size_t first = std::min(n, m_buf.size() - offset);
+        std::memcpy(m_buf.data() + offset, src, first);
+        std::memcpy(m_buf.data(), (const char*)src + first, n - first);
+    }
+    void CopyOut(uint64_t pos, void* dst, size_t n) const
+    {
+        const size_t offset = pos % m_buf.size();
+        const size_t first = std::min(n, m_buf.size() - offset);
+        std::memcpy(dst, m_buf.data() + offset, first);
+        std::memcpy((char*)dst + first, m_buf.data(), n - first);
+    }
+
+    std::vector<char> m_buf;
+    std::atomic<uint64_t> m_head{0}; //!< Total bytes written, only modified by the producer
+    std::atomic<uint64_t> m_tail{0}; //!< Total bytes read, only modified by the consumer
+};
+} // namespace BCLog
+
+namespace {
+/** Marks the ring buffer of an exiting thread so the writer can release it once drained */
+struct ThreadLogRingBuffer
+{
+    std::shared_ptr<BCLog::LogRingBuffer> ring;
+    ~ThreadLogRingBuffer()
+    {
+        if (ring) ring->m_orphaned = true;
+    }
+};
+thread_local ThreadLogRingBuffer g_thread_log_ring;
+} // namespace
+
+BCLog::LogRingBuffer& BCLog::Logger::GetThreadRingBuffer()
+{
+    if (!g_thread_log_ring.ring) {
+        g_thread_log_ring.ring = std::make_shared<LogRingBuffer>(m_async_buffer_size);
+        StdLockGuard scoped_lock(m_async_rings_mutex);
+        m_async_rings.push_back(g_thread_log_ring.ring);
+    }
+    return *g_thread_log_ring.ring;
+}
+
+void BCLog::Logger::PushAsync(const std::string& str_prefixed, bool useVMLog)
+{
+    LogRingBuffer& ring = GetThreadRingBuffer();
+    const uint64_t seq = m_async_seq.fetch_add(1, std::memory_order_relaxed);
+    if (ring.Push(seq, useVMLog, str_prefixed) && !ring.MoreThanHalfFull()) {
+        return;
+    }
+    // Wake the writer early rather than wait for the interval
+    {
+        std::lock_guard<std::mutex> lock(m_async_wake_mutex);
+        m_async_wake = true;
+    }
+    m_async_wake_cv.notify_one();
+}
+
+void BCLog::Logger::DrainAsync()
+{
+    StdLockGuard drain_lock(m_async_drain_mutex);
+
+    std::vector<std::shared_ptr<LogRingBuffer>> rings;
+    {
+        StdLockGuard scoped_lock(m_async_rings_mutex);
+        rings = m_async_rings;
+    }
+
+    struct PendingMsg {
+        uint64_t seq;
+        bool vm;
+        std::string msg;
+    };
+    std::vector<PendingMsg> pending;
+    uint64_t dropped = 0;
+    bool have_orphans = false;
+    for (const auto& ring : rings) {
+        // Read m_orphaned first, an orphaned ring can receive no more messages after this drain
+        const bool orphaned = ring->m_orphaned.load();
+        ring->Drain([&](uint64_t seq, bool vm, std::string&& msg) {
+            pending.push_back({seq, vm, std::move(msg)});
+        });
+        dropped += ring->m_dropped.exchange(0);
+        have_orphans |= orphaned;
+    }
+    if (have_orphans) {
+        StdLockGuard scoped_lock(m_async_rings_mutex);
+        m_async_rings.erase(std::remove_if(m_async_rings.begin(), m_async_rings.end(),
+            [](const std::shared_ptr<LogRingBuffer>& ring) { return ring->m_orphaned && ring->Empty(); }), m_async_rings.end());
+    }
+
+    // Restore the order messages were logged in across threads
+    std::sort(pending.begin(), pending.end(), [](const PendingMsg& a, const PendingMsg& b) { return a.seq < b.seq; });
+
+    // Logging threads don't take m_cs on this path, hold it for the whole batch
+    StdLockGuard scoped_lock(m_cs);
+    for (const auto& p : pending) {
+        WriteLogStr(p.msg, p.vm);
+    }
+    if (dropped > 0) {
+        m_async_dropped_total += dropped;
+        WriteLogStr(strprintf("[logging] Dropped %u messages, per-thread log buffer full (%u total). Consider raising -logasyncbuffer.\n",
+                              dropped, m_async_dropped_total.load()), false);
+    }
+    if (m_print_to_console) fflush(stdout);
+    if (m_fileout) fflush(m_fileout);
+    if (m_fileoutVM) fflush(m_fileoutVM);
+}
+
+void BCLog::Logger::AsyncWriterThread()
+{
+    util::ThreadRename("logwriter");
+    while (true) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(m_async_wake_mutex);
+            m_async_wake_cv.wait_for(lock, m_async_interval, [&] { return m_async_wake || m_async_stop; });
+            m_async_wake = false;
+            stop = m_async_stop;
+        }
+        DrainAsync();
+        if (stop) break;
+    }
+}
+
+void BCLog::Logger::StartAsyncWriter()
+{
+    if (m_async_writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_async_wake_mutex);
+        m_async_stop = false;
+        m_async_wake = false;
+    }
+    m_async_active = true;
+    m_async_writer = std::thread(&BCLog::Logger::AsyncWriterThread, this);
+}
+
+void BCLog::Logger::StopAsyncWriter()
+{
+    if (!m_async_writer.joinable()) {
+        return;
+    }
+    // New messages take the synchronous path from here, messages pushed
+    // after the last drain below are drained by their logging thread
+    m_async_active = false;
+    {
+        std::lock_guard<std::mutex> lock(m_async_wake_mutex);
+        m_async_stop = true;
+    }
+    m_async_wake_cv.notify_one();
+    m_async_writer.join();
+    DrainAsync();
+}
+
+void BCLog::Logger::Flush()
+{
+    if (m_async_active) {
+        DrainAsync();
+        return;
+    }
+    StdLockGuard scoped_lock(m_cs);
+    if (m_fileout) fflush(m_fileout);
+    if (m_fileoutVM) fflush(m_fileoutVM);
+}
+
 void BCLog::Logger::ShrinkDebugFile()
 {
     // Amount of debug.log to save at end when shrinking (must fit in memory)
@@ -12,11 +12,15 @@
 #include <util/string.h>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -26,6 +30,8 @@ static const bool DEFAULT_LOGTIMESTAMPS = true;
 static const bool DEFAULT_LOGTHREADNAMES = false;
 static const bool DEFAULT_LOGSOURCELOCATIONS = false;
 static const bool DEFAULT_SHOWEVMLOGS = false;
+static const bool DEFAULT_LOGASYNC = false;
+static const unsigned int DEFAULT_LOGASYNCBUFFER = 256; // KiB per logging thread
 extern const char * const DEFAULT_DEBUGLOGFILE;
 extern const char * const DEFAULT_DEBUGVMLOGFILE;
 
@@ -96,6 +102,8 @@ namespace BCLog {
          bool useVMLog;
      };
 
+    class LogRingBuffer;
+
     class Logger
     {
     private:
@@ -123,11 +131,37 @@ namespace BCLog {
         /** Log categories bitfield. */
         std::atomic<uint32_t> m_categories{0};
 
-        std::string LogTimestampStr(const std::string& str);
+        std::string LogTimestampStr(const std::string& str, bool started_new_line);
 
         /** Slots that connect to the print signal */
         std::list<std::function<void(const std::string&)>> m_print_callbacks GUARDED_BY(m_cs) {};
 
+        /** Prefix, escape and timestamp a message, the prefixes are skipped when continuing a line */
+        std::string FormatLogStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line, BCLog::LogFlags category, BCLog::Level level, bool useVMLog, bool started_new_line);
+        /** Write a formatted message to the console, callbacks and log files */
+        void WriteLogStr(const std::string& str_prefixed, bool useVMLog) EXCLUSIVE_LOCKS_REQUIRED(m_cs);
+
+        /**
+         * Asynchronous logging: each logging thread formats into its own lock-free
+         * ring buffer and a background thread batches the writes to the outputs.
+         */
+        std::atomic<bool> m_async_active{false};
+        std::atomic<uint64_t> m_async_seq{0};
+        std::atomic<uint64_t> m_async_dropped_total{0};
+        StdMutex m_async_rings_mutex;
+        std::vector<std::shared_ptr<LogRingBuffer>> m_async_rings GUARDED_BY(m_async_rings_mutex);
+        StdMutex m_async_drain_mutex; //!< Serialises draining between the writer thread and Flush()
+        std::mutex m_async_wake_mutex;
+        std::condition_variable m_async_wake_cv;
+        bool m_async_wake = false; //!< Guarded by m_async_wake_mutex
+        bool m_async_stop = false; //!< Guarded by m_async_wake_mutex
+        std::thread m_async_writer;
+
+        LogRingBuffer& GetThreadRingBuffer();
+        void PushAsync(const std::string& str_prefixed, bool useVMLog);
+        void DrainAsync();
+        void AsyncWriterThread();
+
     public:
         bool m_print_to_console = false;
         bool m_print_to_file = false;
@@ -142,6 +176,13 @@ namespace BCLog {
         fs::path m_file_pathVM;
         std::atomic<bool> m_reopen_file{false};
 
+        /** Write log files from a background thread, set before StartLogging() */
+        bool m_async = DEFAULT_LOGASYNC;
+        /** Size of the per-thread ring buffer in bytes, messages are dropped when it's full */
+        size_t m_async_buffer_size = DEFAULT_LOGASYNCBUFFER * 1024;
+        /** How often the background thread writes out buffered messages */
+        std::chrono::milliseconds m_async_interval{100};
+
         /** Send a string to the log output */
         void LogPrintStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line, BCLog::LogFlags category, BCLog::Level level, bool useVMLog = false);
 
@@ -172,6 +213,15 @@ namespace BCLog {
         /** Only for testing */
         void DisconnectTestLogger();
 
+        /** Start the asynchronous writer thread, no-op if already running */
+        void StartAsyncWriter();
+        /** Write out all pending asynchronous messages and stop the writer thread */
+        void StopAsyncWriter();
+        /** Write out all pending asynchronous messages and flush the log files */
+        void Flush();
+        /** Number of messages dropped because a per-thread ring buffer was full */
+        uint64_t AsyncDroppedCount() const { return m_async_dropped_total.load(); }
+
         void ShrinkDebugFile();
 
         std::unordered_map<LogFlags, Level> CategoryLevels() const
@@ -20,6 +20,7 @@
 #include <netbase.h>
 #include <netmessagemaker.h>
 #include <node/blockstorage.h>
+#include <node/txrelaycache.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/settings.h>
@@ -124,6 +125,11 @@ static const unsigned int MAX_HEADERS_RESULTS = 2000;
 static const int MAX_CMPCTBLOCK_DEPTH = 5;
 /** Maximum depth of blocks we're willing to respond to GETBLOCKTXN requests for. */
 static const int MAX_BLOCKTXN_DEPTH = 10;
+/** Blinded transactions that entered our mempool this recently may not have reached
+ *  our peers yet, they are prefilled in the compact blocks we announce. */
+static constexpr auto CMPCTBLOCK_PREFILL_RECENT{5s};
+/** Maximum size of the blinded transactions prefilled in one compact block. */
+static constexpr size_t MAX_CMPCTBLOCK_PREFILL_BYTES{100000};
 /** Size of the "block download window": how far ahead of our current height do we fetch?
  *  Larger windows tolerate larger download speed differences between peer, but increase the potential
  *  degree of disordering of blocks on disk (which make reindexing and pruning harder). We'll probably
@@ -504,6 +510,9 @@ struct CNodeState {
     //! A rolling bloom filter of all announced tx CInvs to this peer.
     CRollingBloomFilter m_recently_announced_invs = CRollingBloomFilter{INVENTORY_MAX_RECENT_RELAY, 0.000001};
 
+    //! How well compact blocks from this peer could be reconstructed
+    CompactBlockStats m_cmpctblock_stats;
+
     CNodeState(CAddress address, bool is_inbound) : m_address(address), m_is_inbound(is_inbound) {}
 };
 
@@ -927,6 +936,8 @@ private:
     MapRelay mapRelay GUARDED_BY(cs_main);
     /** Expiration-time ordered list of (expire time, relay map entry) pairs. */
     std::deque<std::pair<std::chrono::microseconds, MapRelay::iterator>> g_relay_expiration GUARDED_BY(cs_main);
+    /** Witness serializations of transactions recently requested by peers */
+    node::TxRelayCache m_tx_relay_cache{node::DEFAULT_TX_RELAY_CACHE_BYTES};
 
     /**
      * When a peer sends us a valid block, instruct it to announce blocks to us
@@ -947,12 +958,12 @@ private:
 
     void AddToCompactExtraTransactions(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans);
 
-    /** Orphan/conflicted/etc transactions that are kept for compact block reconstruction.
-     *  The last -blockreconstructionextratxn/DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN of
-     *  these are kept in a ring buffer */
-    std::vector<std::pair<uint256, CTransactionRef>> vExtraTxnForCompact GUARDED_BY(g_cs_orphans);
-    /** Offset into vExtraTxnForCompact to insert the next tx */
-    size_t vExtraTxnForCompactIt GUARDED_BY(g_cs_orphans) = 0;
+    /** Orphan/conflicted/etc transactions that are kept for compact block reconstruction,
+     *  limited by -blockreconstructionextratxn and -blockreconstructionextratxnsize */
+    ExtraTxnPool m_extra_txn_for_compact GUARDED_BY(g_cs_orphans);
+
+    /** Predicate for prefilling the blinded transactions of a block our peers are likely to miss */
+    std::function<bool(const CTransaction&)> CompactBlockPrefill() const;
 
     /** Check whether the last unknown block a peer advertised is not yet known. */
     void ProcessBlockAvailability(NodeId nodeid) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -1634,6 +1645,7 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
             stats.nDuplicateCount = it->second.m_duplicate_count;
             stats.nLooseHeadersCount = (int)it->second.m_map_loose_headers.size();
         }
+        stats.m_cmpctblock_stats = state->m_cmpctblock_stats;
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -1679,13 +1691,28 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
 
 void PeerManagerImpl::AddToCompactExtraTransactions(const CTransactionRef& tx)
 {
-    size_t max_extra_txn = gArgs.GetIntArg("-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN);
-    if (max_extra_txn <= 0)
-        return;
-    if (!vExtraTxnForCompact.size())
-        vExtraTxnForCompact.resize(max_extra_txn);
-    vExtraTxnForCompact[vExtraTxnForCompactIt] = std::make_pair(tx->GetWitnessHash(), tx);
-    vExtraTxnForCompactIt = (vExtraTxnForCompactIt + 1) % max_extra_txn;
+    m_extra_txn_for_compact.Add(tx);
+}
+
+std::function<bool(const CTransaction&)> PeerManagerImpl::CompactBlockPrefill() const
+{
+    const auto now{GetTime<std::chrono::seconds>()};
+    return [this, now, prefilled_bytes = size_t{0}](const CTransaction& tx) mutable {
+        if (!HasBlindedData(tx)) {
+            return false;
+        }
+        const size_t tx_size = tx.GetTotalSize();
+        if (prefilled_bytes + tx_size > MAX_CMPCTBLOCK_PREFILL_BYTES) {
+            return false;
+        }
+        // Transactions that were in our mempool for a while have most likely reached our peers
+        const TxMempoolInfo info = m_mempool.info(GenTxid::Wtxid(tx.GetWitnessHash()));
+        if (info.tx && info.m_time + CMPCTBLOCK_PREFILL_RECENT < now) {
+            return false;
+        }
+        prefilled_bytes += tx_size;
+        return true;
+    };
 }
 
 void PeerManagerImpl::Misbehaving(Peer& peer, int howmuch, const std::string& message)
@@ -2127,7 +2154,9 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
       m_banman(banman),
       m_chainman(chainman),
       m_mempool(pool),
-      m_ignore_incoming_txs(ignore_incoming_txs)
+      m_ignore_incoming_txs(ignore_incoming_txs),
+      m_extra_txn_for_compact(std::max<int64_t>(0, gArgs.GetIntArg("-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN)),
+                              std::max<int64_t>(0, gArgs.GetIntArg("-blockreconstructionextratxnsize", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN_SIZE)) * 1000000)
 {
 }
 
@@ -2195,7 +2224,7 @@ void PeerManagerImpl::BlockDisconnected(const std::shared_ptr<const CBlock> &blo
  */
 void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock)
 {
-    auto pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs>(*pblock);
+    auto pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs>(*pblock, CompactBlockPrefill());
     const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
 
     LOCK(cs_main);
@@ -2646,8 +2675,12 @@ void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic
         CTransactionRef tx = FindTxForGetData(pfrom, ToGenTxid(inv), mempool_req, now);
         if (tx) {
             // WTX and WITNESS_TX imply we serialize with witness
-            int nSendFlags = (inv.IsMsgTx() ? SERIALIZE_TRANSACTION_NO_WITNESS : 0);
-            m_connman.PushMessage(&pfrom, msgMaker.Make(nSendFlags, NetMsgType::TX, *tx));
+            if (!inv.IsMsgTx()) {
+                // Served from the cache when other peers fetched it already
+                m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::TX, Span{*m_tx_relay_cache.Get(*tx)}));
+            } else {
+                m_connman.PushMessage(&pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *tx));
+            }
             m_mempool.RemoveUnbroadcastTx(tx->GetHash());
             // As we're going to send tx, make sure its unconfirmed parents are made requestable.
             std::vector<uint256> parent_ids_to_add;
@@ -4316,6 +4349,12 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             AddKnownTx(*peer, txid);
         }
 
+        // Verify rangeproofs and ring signatures before cs_main is taken,
+        // transactions already known are dropped below without the checks
+        if (WITH_LOCK(cs_main, return !AlreadyHaveTx(GenTxid::Wtxid(wtxid)))) {
+            m_chainman.PrevalidateTransaction(ptx);
+        }
+
         LOCK2(cs_main, g_cs_orphans);
 
         m_txrequest.ReceivedResponse(pfrom.GetId(), txid);
@@ -4611,12 +4650,13 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
 
                 PartiallyDownloadedBlock& partialBlock = *(*queuedBlockIt)->partialBlock;
-                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = partialBlock.InitData(cmpctblock, m_extra_txn_for_compact.Txns());
                 if (status == READ_STATUS_INVALID) {
                     RemoveBlockRequest(pindex->GetBlockHash()); // Reset in-flight state in case Misbehaving does not result in a disconnect
                     Misbehaving(*peer, 100, "invalid compact block");
                     return;
                 } else if (status == READ_STATUS_FAILED) {
+                    nodestate->m_cmpctblock_stats.full_block_fallbacks++;
                     // Duplicate txindexes, the block is now in-flight, so just request it
                     std::vector<CInv> vInv(1);
                     vInv[0] = CInv(MSG_BLOCK | GetFetchFlags(*peer), cmpctblock.header.GetHash());
@@ -4624,18 +4664,27 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                     return;
                 }
 
+                CompactBlockStats& cmpct_stats = nodestate->m_cmpctblock_stats;
+                cmpct_stats.received++;
+                cmpct_stats.txn_prefilled += partialBlock.PrefilledCount();
+                cmpct_stats.txn_from_mempool += partialBlock.MempoolCount() - partialBlock.ExtraCount();
+                cmpct_stats.txn_from_extra += partialBlock.ExtraCount();
+
                 BlockTransactionsRequest req;
                 for (size_t i = 0; i < cmpctblock.BlockTxCount(); i++) {
                     if (!partialBlock.IsTxAvailable(i))
                         req.indexes.push_back(i);
                 }
                 if (req.indexes.empty()) {
+                    cmpct_stats.reconstructed++;
                     // Dirty hack to jump to BLOCKTXN code (TODO: move message handling into their own functions)
                     BlockTransactions txn;
                     txn.blockhash = cmpctblock.header.GetHash();
                     blockTxnMsg << txn;
                     fProcessBLOCKTXN = true;
                 } else {
+                    cmpct_stats.blocktxn_requests++;
+                    cmpct_stats.txn_requested += req.indexes.size();
                     req.blockhash = pindex->GetBlockHash();
                     m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::GETBLOCKTXN, req));
                 }
@@ -4646,7 +4695,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
                 PartiallyDownloadedBlock tempBlock(&m_mempool);
-                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = tempBlock.InitData(cmpctblock, m_extra_txn_for_compact.Txns());
                 if (status != READ_STATUS_OK) {
                     // TODO: don't ignore failures
                     return;
@@ -4738,12 +4787,17 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             }
 
             PartiallyDownloadedBlock& partialBlock = *it->second.second->partialBlock;
+            CompactBlockStats& cmpct_stats = State(pfrom.GetId())->m_cmpctblock_stats;
+            for (const auto& tx : resp.txn) {
+                cmpct_stats.txn_requested_bytes += tx->GetTotalSize();
+            }
             ReadStatus status = partialBlock.FillBlock(*pblock, resp.txn);
             if (status == READ_STATUS_INVALID) {
                 RemoveBlockRequest(resp.blockhash); // Reset in-flight state in case Misbehaving does not result in a disconnect
                 Misbehaving(*peer, 100, "invalid compact block/non-matching block transactions");
                 return;
             } else if (status == READ_STATUS_FAILED) {
+                cmpct_stats.full_block_fallbacks++;
                 // Might have collided, fall back to getdata now :(
                 std::vector<CInv> invs;
                 invs.push_back(CInv(MSG_BLOCK | GetFetchFlags(*peer), resp.blockhash));
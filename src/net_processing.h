@@ -20,6 +20,8 @@ class Peer;
 static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 100;
 /** Default number of orphan+recently-replaced txn to keep around for block reconstruction */
 static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
+/** Default for -blockreconstructionextratxnsize, maximum size in megabytes of the txn kept for block reconstruction */
+static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN_SIZE = 10;
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Threshold for marking a node to be discouraged, e.g. disconnected and added to the discouragement filter. */
@@ -41,6 +43,21 @@ static const bool DEFAULT_CLEANBLOCKINDEX = true;
 /** Default for -cleanblockindextimeout. */
 static const unsigned int DEFAULT_CLEANBLOCKINDEXTIMEOUT = 600;
 
+/** Compact block reconstruction counters for blocks received from a peer */
+struct CompactBlockStats {
+    uint64_t received = 0;
+    //! Blocks completed without a getblocktxn round trip
+    uint64_t reconstructed = 0;
+    uint64_t blocktxn_requests = 0;
+    //! Blocks requested in full after reconstruction failed
+    uint64_t full_block_fallbacks = 0;
+    uint64_t txn_prefilled = 0;
+    uint64_t txn_from_mempool = 0;
+    uint64_t txn_from_extra = 0;
+    uint64_t txn_requested = 0;
+    uint64_t txn_requested_bytes = 0;
+};
+
 struct CNodeStateStats {
     int m_misbehavior_score = 0;
     int nSyncHeight = -1;
@@ -61,6 +78,7 @@ struct CNodeStateStats {
     int m_chain_height = -1;
     int nDuplicateCount = 0;
     int nLooseHeadersCount = 0;
+    CompactBlockStats m_cmpctblock_stats;
 };
 
 class PeerManager : public CValidationInterface, public NetEventsInterface
@@ -71,6 +89,8 @@ public:
                                              CTxMemPool& pool, bool ignore_incoming_txs);
     virtual ~PeerManager() { }
 
+    std::string ValidationQueueName() const override { return "peerman"; }
+
     /**
      * Attempt to manually fetch block from a given peer. We must already have the header.
      *
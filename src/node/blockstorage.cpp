@@ -12,6 +12,7 @@
 #include <fs.h>
 #include <hash.h>
 #include <pow.h>
+#include <random.h>
 #include <reverse_iterator.h>
 #include <shutdown.h>
 #include <signet.h>
@@ -19,8 +20,10 @@
 #include <undo.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
+#include <util/time.h>
 #include <validation.h>
 
+#include <chrono>
 #include <map>
 #include <unordered_map>
 
@@ -59,6 +62,21 @@ bool CBlockIndexHeightOnlyComparator::operator()(const CBlockIndex* pa, const CB
     return pa->nHeight < pb->nHeight;
 }
 
+/** Format version of the block index snapshot file */
+static constexpr uint32_t BLOCK_INDEX_SNAPSHOT_VERSION{1};
+
+static fs::path BlockIndexSnapshotPath()
+{
+    return gArgs.GetBlocksDirPath() / "blockindex.dat";
+}
+
+BlockManager::~BlockManager()
+{
+    if (m_cold_stake_reader) {
+        g_read_cold_block_stake = nullptr;
+    }
+}
+
 static FILE* OpenUndoFile(const FlatFilePos& pos, bool fReadOnly = false);
 static FlatFileSeq BlockFileSeq();
 static FlatFileSeq UndoFileSeq();
@@ -261,17 +279,185 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
     return pindex;
 }
 
-bool BlockManager::LoadBlockIndex(const Consensus::Params& consensus_params)
+bool BlockManager::LoadBlockIndexSnapshot(const uint256& id, const Consensus::Params& consensus_params, const BlockIndexStakeFn& set_stake)
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); })) {
+    AssertLockHeld(cs_main);
+
+    CAutoFile file{fsbridge::fopen(BlockIndexSnapshotPath(), "rb"), SER_DISK, CLIENT_VERSION};
+    if (file.IsNull()) {
+        return error("%s: failed to open %s", __func__, fs::PathToString(BlockIndexSnapshotPath()));
+    }
+
+    try {
+        CHashVerifier<CAutoFile> verifier(&file);
+        uint32_t version;
+        uint256 file_id;
+        verifier >> version >> file_id;
+        if (version != BLOCK_INDEX_SNAPSHOT_VERSION || file_id != id) {
+            return error("%s: snapshot does not match the block tree db", __func__);
+        }
+
+        const auto insert = [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); };
+        std::vector<unsigned char> data;
+        for (;;) {
+            uint256 hash;
+            verifier >> hash;
+            if (hash.IsNull()) {
+                break;
+            }
+            verifier >> data;
+            CDataStream stream(data, SER_DISK, CLIENT_VERSION);
+            CDiskBlockIndex diskindex;
+            stream >> diskindex;
+            if (!LoadDiskBlockIndex(hash, diskindex, consensus_params, insert, set_stake)) {
+                return false;
+            }
+        }
+
+        uint256 checksum;
+        file >> checksum;
+        if (checksum != verifier.GetHash()) {
+            return error("%s: checksum mismatch", __func__);
+        }
+    } catch (const std::exception& e) {
+        return error("%s: %s", __func__, e.what());
+    }
+    return true;
+}
+
+bool BlockManager::WriteBlockIndexSnapshot()
+{
+    AssertLockHeld(::cs_main);
+
+    if (!gArgs.GetBoolArg("-blockindexsnapshot", DEFAULT_BLOCK_INDEX_SNAPSHOT) || fReindex || !m_block_tree_db) {
         return false;
     }
+    if (!m_dirty_blockindex.empty() || !m_dirty_fileinfo.empty()) {
+        return error("%s: block index is not flushed", __func__);
+    }
+    if (m_loaded_snapshot_id && !m_block_tree_db->BlockIndexChanged()) {
+        // The file still matches the db, only its id was erased on loading
+        if (!m_block_tree_db->WriteBlockIndexSnapshotId(*m_loaded_snapshot_id)) {
+            return error("%s: failed to write snapshot id", __func__);
+        }
+        LogPrintf("Block index unchanged, kept %s\n", fs::PathToString(BlockIndexSnapshotPath()));
+        return true;
+    }
+
+    const auto start{SteadyClock::now()};
+    const fs::path path = BlockIndexSnapshotPath();
+    const fs::path path_new = fs::PathFromString(fs::PathToString(path) + ".new");
+    const uint256 id = GetRandHash();
+    size_t count{0};
+    try {
+        CAutoFile file{fsbridge::fopen(path_new, "wb"), SER_DISK, CLIENT_VERSION};
+        if (file.IsNull()) {
+            return error("%s: failed to open %s", __func__, fs::PathToString(path_new));
+        }
+        CHashWriter hasher(SER_DISK, CLIENT_VERSION);
+        file << BLOCK_INDEX_SNAPSHOT_VERSION << id;
+        hasher << BLOCK_INDEX_SNAPSHOT_VERSION << id;
+
+        // Copy the records as stored, without reading stake fields of cold entries back in
+        if (!m_block_tree_db->ForEachBlockIndexRecord([&](const uint256& hash, Span<const std::byte> record) {
+                file << hash;
+                hasher << hash;
+                WriteCompactSize(file, record.size());
+                WriteCompactSize(hasher, record.size());
+                file.write(record);
+                hasher.write(record);
+                count++;
+                return true;
+            })) {
+            return false;
+        }
+        file << uint256();
+        hasher << uint256();
+        file << hasher.GetHash();
+
+        if (!FileCommit(file.Get())) {
+            return error("%s: FileCommit failed", __func__);
+        }
+        file.fclose();
+        if (!RenameOver(path_new, path)) {
+            return error("%s: rename failed", __func__);
+        }
+    } catch (const std::exception& e) {
+        return error("%s: %s", __func__, e.what());
+    }
+
+    if (!m_block_tree_db->WriteBlockIndexSnapshotId(id)) {
+        return error("%s: failed to write snapshot id", __func__);
+    }
+    LogPrintf("Wrote %u block index entries to %s in %dms\n", count, fs::PathToString(path),
+              Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    return true;
+}
+
+bool BlockManager::LoadBlockIndex(const Consensus::Params& consensus_params)
+{
+    const auto start{SteadyClock::now()};
+
+    // Collected while loading, applied once heights are known
+    std::vector<std::pair<CBlockIndex*, CBlockIndexStake>> stakes;
+    const BlockIndexStakeFn set_stake = [&stakes](CBlockIndex* pindex, const CBlockIndexStake& stake) {
+        if (!stake.bnStakeModifier.IsNull() || !stake.prevoutStake.IsNull()) {
+            stakes.emplace_back(pindex, stake);
+        }
+    };
+
+    // The snapshot only matches the db until the next write, its id is
+    // erased on every start, also when the snapshot is not used.
+    uint256 snapshot_id;
+    const bool have_snapshot = m_block_tree_db->ReadBlockIndexSnapshotId(snapshot_id);
+    if (have_snapshot && !m_block_tree_db->EraseBlockIndexSnapshotId()) {
+        return error("%s: failed to erase the block index snapshot id", __func__);
+    }
+
+    const char* source = "snapshot";
+    m_loaded_snapshot_id = snapshot_id;
+    if (!have_snapshot || !gArgs.GetBoolArg("-blockindexsnapshot", DEFAULT_BLOCK_INDEX_SNAPSHOT) ||
+        !LoadBlockIndexSnapshot(snapshot_id, consensus_params, set_stake)) {
+        m_loaded_snapshot_id.reset();
+        m_block_index.clear();
+        stakes.clear();
+        source = "database";
+        if (!m_block_tree_db->LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, set_stake)) {
+            return false;
+        }
+    }
 
     // Calculate nChainWork
     std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
     std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
               CBlockIndexHeightOnlyComparator());
 
+    // Stake fields of buried blocks are only needed again on a deep reorg or
+    // rpc lookup, leave them in the block tree db.
+    const int64_t stake_depth = gArgs.GetIntArg("-blockindexstakedepth", DEFAULT_BLOCK_INDEX_STAKE_DEPTH);
+    const int max_height = vSortedByHeight.empty() ? 0 : vSortedByHeight.back()->nHeight;
+    const int64_t keep_from = stake_depth > 0 ? int64_t{max_height} - stake_depth : 0;
+    size_t cold{0};
+    for (const auto& [pindex, stake] : stakes) {
+        if (pindex->nHeight < keep_from) {
+            pindex->SetStakeCold();
+            cold++;
+        } else {
+            pindex->SetPrevoutStake(stake.prevoutStake);
+            pindex->SetStakeModifier(stake.bnStakeModifier);
+        }
+    }
+    if (cold > 0 && !m_cold_stake_reader) {
+        g_read_cold_block_stake = [this](const CBlockIndex& index, CBlockIndexStake& stake) {
+            LOCK(::cs_main);
+            return m_block_tree_db && m_block_tree_db->ReadBlockIndexStake(index.GetBlockHash(), stake);
+        };
+        m_cold_stake_reader = true;
+    }
+    LogPrintf("Loaded %u block index entries from %s in %dms, %u with stake fields on disk (%.1fMiB)\n",
+              m_block_index.size(), source, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start),
+              cold, cold * sizeof(CBlockIndexStake) / (1024.0 * 1024.0));
+
     for (CBlockIndex* pindex : vSortedByHeight) {
         if (ShutdownRequested()) return false;
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
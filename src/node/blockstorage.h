@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +40,10 @@ typedef std::shared_ptr<const CTransaction> CTransactionRef;
 
 namespace node {
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+/** Default for -blockindexsnapshot, write the block index to a flat file on shutdown and load it on startup */
+static constexpr bool DEFAULT_BLOCK_INDEX_SNAPSHOT{true};
+/** Default for -blockindexstakedepth, blocks deeper below the best header keep their stake fields on disk only */
+static constexpr int DEFAULT_BLOCK_INDEX_STAKE_DEPTH{10000};
 
 /** The pre-allocation chunk size for blk?????.dat files (since 0.8) */
 static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
@@ -88,6 +93,8 @@ class BlockManager
 
 //private:
 public:
+    ~BlockManager();
+
     /**
      * Load the blocktree off disk and into memory. Populate certain metadata
      * per index entry (nStatus, nChainWork, nTimeMax, etc.) as well as peripheral
@@ -95,6 +102,9 @@ public:
      */
     bool LoadBlockIndex(const Consensus::Params& consensus_params)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    /** Load the entries from the snapshot file if it has the id read from the block tree db */
+    bool LoadBlockIndexSnapshot(const uint256& id, const Consensus::Params& consensus_params, const BlockIndexStakeFn& set_stake)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void FlushBlockFile(bool fFinalize = false, bool finalize_undo = false);
     void FlushUndoFile(int block_file, bool finalize = false);
     bool FindBlockPos(FlatFilePos& pos, unsigned int nAddSize, unsigned int nHeight, CChain& active_chain, uint64_t nTime, bool fKnown);
@@ -159,6 +169,19 @@ public:
     bool WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool LoadBlockIndexDB(const Consensus::Params& consensus_params) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    /**
+     * Write the stored block index entries to a flat file, read on the next
+     * start instead of iterating the block tree db. Call after the last
+     * WriteBlockIndexDB(), the snapshot is dropped when the db is loaded.
+     * If no entry was stored since the snapshot was loaded, it is kept.
+     */
+    bool WriteBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! True while entries loaded by this manager read their stake fields from disk
+    bool m_cold_stake_reader{false};
+    //! Id of the snapshot the block index was loaded from
+    std::optional<uint256> m_loaded_snapshot_id GUARDED_BY(::cs_main);
+
     CBlockIndex* AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Create a new block index entry for a given block hash */
     CBlockIndex* InsertBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
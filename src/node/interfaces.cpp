@@ -474,6 +474,7 @@ public:
     }
     void ChainStateFlushed(const CBlockLocator& locator) override { m_notifications->chainStateFlushed(locator); }
     void LeavingIBD() override { m_notifications->leavingIBD(); }
+    std::string ValidationQueueName() const override { return m_notifications->notificationsName(); }
     std::shared_ptr<Chain::Notifications> m_notifications;
 };
 
@@ -6,6 +6,7 @@
 #ifndef GLOBE_NODE_MINER_H
 #define GLOBE_NODE_MINER_H
 
+#include <consensus/merkle.h>
 #include <primitives/block.h>
 #include <txmempool.h>
 
@@ -32,6 +33,8 @@ struct CBlockTemplate
     std::vector<CAmount> vTxFees;
     std::vector<int64_t> vTxSigOpsCost;
     std::vector<unsigned char> vchCoinbaseCommitment;
+    //! Merkle trees of block, built by the staking thread when it creates the template
+    std::unique_ptr<BlockMerkleTrees> merkle_trees;
 };
 
 // Container for tracking updates to ancestor feerate as we include (parent)
@@ -44,6 +44,9 @@ TransactionError BroadcastTransaction(NodeContext& node, const CTransactionRef t
     uint256 wtxid = tx->GetWitnessHash();
     bool callback_set = false;
 
+    // Verify rangeproofs and ring signatures before cs_main is taken
+    node.chainman->PrevalidateTransaction(tx);
+
     {
         assert(node.chainman);
         LOCK(cs_main);
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/txrelaycache.h>
+
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <streams.h>
+#include <version.h>
+
+namespace node {
+TxRelayCache::SerializedTx TxRelayCache::Get(const CTransaction& tx)
+{
+    const uint256& wtxid = tx.GetWitnessHash();
+    {
+        LOCK(m_mutex);
+        auto it = m_index.find(wtxid);
+        if (it != m_index.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->second;
+        }
+    }
+
+    auto serialized = std::make_shared<std::vector<unsigned char>>();
+    serialized->reserve(::GetSerializeSize(tx, PROTOCOL_VERSION));
+    CVectorWriter{SER_NETWORK, PROTOCOL_VERSION, *serialized, 0} << tx;
+    const size_t size = serialized->size();
+    if (size > m_max_bytes) {
+        return serialized;
+    }
+
+    LOCK(m_mutex);
+    if (m_index.count(wtxid)) {
+        return serialized;
+    }
+    while (m_bytes + size > m_max_bytes) {
+        m_bytes -= m_entries.back().second->size();
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+    m_entries.emplace_front(wtxid, serialized);
+    m_index.emplace(wtxid, m_entries.begin());
+    m_bytes += size;
+    return serialized;
+}
+
+size_t TxRelayCache::Size() const
+{
+    LOCK(m_mutex);
+    return m_entries.size();
+}
+
+size_t TxRelayCache::Bytes() const
+{
+    LOCK(m_mutex);
+    return m_bytes;
+}
+} // namespace node
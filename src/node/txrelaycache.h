@@ -0,0 +1,57 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBE_NODE_TXRELAYCACHE_H
+#define GLOBE_NODE_TXRELAYCACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CTransaction;
+
+namespace node {
+/** Bytes of serializations kept for relay, a few hundred transactions with rangeproofs */
+static constexpr size_t DEFAULT_TX_RELAY_CACHE_BYTES{4 << 20};
+
+/**
+ * Witness serializations of transactions recently requested by peers, by
+ * wtxid. A transaction fetched by many peers after an announcement is
+ * serialized once, rangeproofs included. The least recently used entries are
+ * evicted to stay within max_bytes. The buffers are not counted against
+ * -maxmempool, the limit bounds them instead.
+ */
+class TxRelayCache
+{
+public:
+    using SerializedTx = std::shared_ptr<const std::vector<unsigned char>>;
+
+    explicit TxRelayCache(size_t max_bytes) : m_max_bytes{max_bytes} {}
+
+    /** Serialization of tx with witness, kept if it fits */
+    SerializedTx Get(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    size_t Bytes() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    using Entry = std::pair<uint256, SerializedTx>;
+
+    const size_t m_max_bytes;
+    mutable Mutex m_mutex;
+    //! Most recently used first
+    std::list<Entry> m_entries GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, std::list<Entry>::iterator, SaltedTxidHasher> m_index GUARDED_BY(m_mutex);
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+};
+} // namespace node
+
+#endif // GLOBE_NODE_TXRELAYCACHE_H
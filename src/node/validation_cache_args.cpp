@@ -20,14 +20,16 @@ namespace node {
 void ApplyArgsManOptions(const ArgsManager& argsman, ValidationCacheSizes& cache_sizes)
 {
     if (auto max_size = argsman.GetIntArg("-maxsigcachesize")) {
-        // 1. When supplied with a max_size of 0, both InitSignatureCache and
-        //    InitScriptExecutionCache create the minimum possible cache (2
-        //    elements). Therefore, we can use 0 as a floor here.
+        // 1. When supplied with a max_size of 0, InitSignatureCache,
+        //    InitScriptExecutionCache and InitPrevalidationCache create the
+        //    minimum possible cache (2 elements). Therefore, we can use 0 as a
+        //    floor here.
         // 2. Multiply first, divide after to avoid integer truncation.
-        size_t clamped_size_each = std::max<int64_t>(*max_size, 0) * (1 << 20) / 2;
+        size_t clamped_size = std::max<int64_t>(*max_size, 0) * (1 << 20);
         cache_sizes = {
-            .signature_cache_bytes = clamped_size_each,
-            .script_execution_cache_bytes = clamped_size_each,
+            .signature_cache_bytes = clamped_size * 3 / 8,
+            .script_execution_cache_bytes = clamped_size * 3 / 8,
+            .prevalidation_cache_bytes = clamped_size / 4,
         };
     }
 }
@@ -282,6 +282,12 @@ void ThreadStakeMiner(size_t nThreadID, std::vector<std::shared_ptr<wallet::CWal
     const bool check_peer_height = gArgs.GetBoolArg("-checkpeerheight", true);
     LogPrint(BCLog::POS, "Stake thread conditional delay set to %d.\n", stake_thread_cond_delay_ms);
 
+    // Kept across search times with the merkle trees SignBlock builds in it
+    std::unique_ptr<node::CBlockTemplate> pblocktemplate;
+    uint256 template_prev_hash;
+    unsigned int template_txns_updated{0};
+    int64_t template_time{0};
+
     while (!fStopMinerProc) {
         if (node::fReindex || node::fImporting || globe::fBusyImporting) {
             fIsStaking = false;
@@ -291,10 +297,12 @@ void ThreadStakeMiner(size_t nThreadID, std::vector<std::shared_ptr<wallet::CWal
         }
 
         int num_blocks_of_peers, num_nodes;
+        uint256 best_hash;
         {
             LOCK(cs_main);
             nBestHeight = chainman->ActiveChain().Height();
             nBestTime = chainman->ActiveChain().Tip()->nTime;
+            best_hash = chainman->ActiveChain().Tip()->GetBlockHash();
             num_blocks_of_peers = globe::GetNumBlocksOfPeers();
             num_nodes = globe::GetNumPeers();
         }
@@ -345,7 +353,15 @@ void ThreadStakeMiner(size_t nThreadID, std::vector<std::shared_ptr<wallet::CWal
             continue;
         }
 
-        std::unique_ptr<node::CBlockTemplate> pblocktemplate;
+        // Rebuild the template for a new tip, and for new mempool transactions
+        // at most every 5 seconds, as getblocktemplate does
+        const CTxMemPool *mempool = chainman->ActiveChainstate().GetMempool();
+        const unsigned int txns_updated = mempool ? mempool->GetTransactionsUpdated() : 0;
+        if (pblocktemplate &&
+            (template_prev_hash != best_hash ||
+             (txns_updated != template_txns_updated && GetTime() - template_time > 5))) {
+            pblocktemplate.reset();
+        }
 
         size_t nWaitFor = stake_thread_cond_delay_ms;
         CAmount reserve_balance;
@@ -400,11 +416,18 @@ void ThreadStakeMiner(size_t nThreadID, std::vector<std::shared_ptr<wallet::CWal
 
                 if (nBestHeight + 1 <= nLastImportHeight &&
                     !ImportOutputs(pblocktemplate.get(), nBestHeight + 1)) {
+                    pblocktemplate.reset();
                     fIsStaking = false;
                     nWaitFor = std::min(nWaitFor, (size_t)30000);
                     LogPrint(BCLog::POS, "%s: ImportOutputs failed.\n", __func__);
                     continue;
                 }
+                // Hash the template once, SignBlock then rehashes only the
+                // branches of the coinstake when a kernel is found
+                pblocktemplate->merkle_trees = std::make_unique<BlockMerkleTrees>(pblocktemplate->block);
+                template_prev_hash = best_hash;
+                template_txns_updated = txns_updated;
+                template_time = GetTime();
             }
             pwallet->m_is_staking = CHDWallet::IS_STAKING;
 
@@ -412,7 +435,10 @@ void ThreadStakeMiner(size_t nThreadID, std::vector<std::shared_ptr<wallet::CWal
             fIsStaking = true;
             if (pwallet->SignBlock(pblocktemplate.get(), nBestHeight + 1, nSearchTime)) {
                 CBlock *pblock = &pblocktemplate->block;
-                if (CheckStake(*chainman, pblock)) {
+                const bool accepted = CheckStake(*chainman, pblock);
+                // A rejected template may hold an invalid transaction
+                pblocktemplate.reset();
+                if (accepted) {
                      nTimeLastStake = GetTime();
                      break;
                 }
@@ -7,6 +7,9 @@
 
 #include <primitives/transaction.h>
 
+#include <array>
+#include <optional>
+
 class CAnonOutput
 {
 // Stored in txdb, key is 64bit index
@@ -20,6 +23,8 @@ public:
     COutPoint outpoint;
     int nBlockHeight;
     uint8_t nCompromised;
+    //! H(pubkey) as uncompressed x and y, set when read from txdb, not serialized with the output
+    std::optional<std::array<uint8_t, 64>> key_image_base;
 
     SERIALIZE_METHODS(CAnonOutput, obj)
     {
@@ -36,6 +41,33 @@ public:
     }
 };
 
+/** Txdb value of an anon output, the key image base is appended when known.
+ *  Records written before the base was stored end after the output.
+ */
+struct AnonOutputDBFormatter
+{
+    template<typename Stream>
+    void Ser(Stream &s, const CAnonOutput &ao)
+    {
+        s << ao;
+        if (ao.key_image_base) {
+            s.write(AsBytes(Span{*ao.key_image_base}));
+        }
+    }
+
+    template<typename Stream>
+    void Unser(Stream &s, CAnonOutput &ao)
+    {
+        s >> ao;
+        ao.key_image_base.reset();
+        if (s.size() >= 64) {
+            std::array<uint8_t, 64> base;
+            s.read(AsWritableBytes(Span{base}));
+            ao.key_image_base = base;
+        }
+    }
+};
+
 class CAnonKeyImageInfo
 {
 public:
@@ -181,6 +181,18 @@ static bool CheckWarmup(HTTPRequest* req)
     return true;
 }
 
+/** Read the optional ?proofs=full|truncate|omit query parameter of a JSON reply */
+static bool ParseProofsQuery(HTTPRequest* req, TxProofDetail& proofs)
+{
+    try {
+        const std::optional<std::string> raw_proofs{req->GetQueryParameter("proofs")};
+        proofs = ParseProofDetailString(raw_proofs ? UniValue{*raw_proofs} : NullUniValue);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
 static bool rest_headers(const std::any& context,
                          HTTPRequest* req,
                          const std::string& strURIPart)
@@ -329,10 +341,22 @@ static bool rest_block(const std::any& context,
     }
 
     case RESTResponseFormat::JSON: {
-        UniValue objBlock = blockToJSON(chainman.m_blockman, block, tip, pblockindex, tx_verbosity);
-        std::string strJSON = objBlock.write() + "\n";
+        TxProofDetail proofs;
+        if (!ParseProofsQuery(req, proofs)) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid proofs parameter");
+        }
+        // Send each transaction as a chunk of the reply as it is converted
+        // rather than building the JSON for the whole block first
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        std::string strJSON;
+        blockToJSONString(chainman.m_blockman, block, tip, pblockindex, tx_verbosity, /*coinstakeDetails=*/false, proofs, strJSON,
+            [&](std::string& json) {
+                req->WriteReplyChunk(json);
+                json.clear();
+            });
+        strJSON += "\n";
+        req->WriteReplyChunk(strJSON);
+        req->WriteReplyEnd();
         return true;
     }
 
@@ -668,8 +692,12 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     }
 
     case RESTResponseFormat::JSON: {
+        TxProofDetail proofs;
+        if (!ParseProofsQuery(req, proofs)) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid proofs parameter");
+        }
         UniValue objTx(UniValue::VOBJ);
-        TxToUniv(*tx, /*block_hash=*/hashBlock, /*entry=*/ objTx);
+        TxToUniv(*tx, /*block_hash=*/hashBlock, /*entry=*/ objTx, /*include_hex=*/true, /*serialize_flags=*/0, /*txundo=*/nullptr, TxVerbosity::SHOW_DETAILS, proofs);
         std::string strJSON = objTx.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
@@ -143,6 +143,78 @@ static RPCHelpMan checkkeyimage()
     };
 }
 
+static constexpr size_t MAX_CHECK_KEYIMAGES{100000};
+
+static RPCHelpMan checkkeyimages()
+{
+    return RPCHelpMan{"checkkeyimages",
+            "\nCheck if keyimages are spent in the chain.\n"
+            "Looks up all keyimages in one pass over the index, at most " + ToString(MAX_CHECK_KEYIMAGES) + " per call.\n",
+            {
+                {"keyimages", RPCArg::Type::ARR, RPCArg::Optional::NO, "Hex encoded keyimages.",
+                    {
+                        {"keyimage", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "Hex encoded keyimage."},
+                    },
+                },
+            },
+            RPCResult{
+                RPCResult::Type::ARR, "", "In the order of the keyimages parameter", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::STR_HEX, "keyimage", "The keyimage"},
+                        {RPCResult::Type::BOOL, "spent", "Keyimage found in chain or not"},
+                        {RPCResult::Type::STR_HEX, "txid", /*optional=*/true, "ID of spending transaction"},
+                        {RPCResult::Type::NUM, "height", /*optional=*/true, "Chain height of containing block"},
+                    }},
+            }},
+            RPCExamples{
+        HelpExampleCli("checkkeyimages", "\"[\\\"keyimage\\\",...]\"")
+        + HelpExampleRpc("checkkeyimages", "[\"keyimage\",...]")
+        },
+    [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    auto& pblocktree{chainman.m_blockman.m_block_tree_db};
+
+    RPCTypeCheck(request.params, {UniValue::VARR}, true);
+
+    const UniValue &keyimages = request.params[0].get_array();
+    if (keyimages.size() > MAX_CHECK_KEYIMAGES) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Too many keyimages, maximum is %d.", MAX_CHECK_KEYIMAGES));
+    }
+
+    std::vector<CCmpPubKey> kis;
+    kis.reserve(keyimages.size());
+    for (size_t i = 0; i < keyimages.size(); ++i) {
+        const std::string &s = keyimages[i].get_str();
+        if (!IsHex(s) || !(s.size() == 66)) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Keyimage %d must be 33 bytes and hex encoded.", i));
+        }
+        std::vector<uint8_t> v = ParseHex(s);
+        kis.emplace_back(v.begin(), v.end());
+    }
+
+    std::vector<std::optional<CAnonKeyImageInfo>> spent;
+    pblocktree->ReadRCTKeyImages(kis, spent);
+
+    UniValue result(UniValue::VARR);
+    for (size_t i = 0; i < kis.size(); ++i) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("keyimage", keyimages[i].get_str());
+        entry.pushKV("spent", spent[i].has_value());
+        if (spent[i]) {
+            entry.pushKV("txid", spent[i]->txid.ToString());
+            if (spent[i]->height > 0) {
+                entry.pushKV("height", spent[i]->height);
+            }
+        }
+        result.push_back(entry);
+    }
+
+    return result;
+},
+    };
+}
+
 static RPCHelpMan rollbackrctindex()
 {
     return RPCHelpMan{"rollbackrctindex",
@@ -180,6 +252,7 @@ void RegisterAnonRPCCommands(CRPCTable &t)
     static const CRPCCommand commands[]{
         {"anon", &anonoutput},
         {"anon", &checkkeyimage},
+        {"anon", &checkkeyimages},
         {"anon", &rollbackrctindex},
     };
     for (const auto& c : commands) {
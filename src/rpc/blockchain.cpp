@@ -51,6 +51,7 @@
 #include <stdint.h>
 
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 
@@ -172,19 +173,25 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails)
+/** Header fields and sizes of a block, the part of blockToJSON before "tx" */
+static UniValue BlockSummaryToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex)
 {
     UniValue result = blockheaderToJSON(tip, blockindex);
 
     result.pushKV("strippedsize", (int)::GetSerializeSize(block, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS));
     result.pushKV("size", (int)::GetSerializeSize(block, PROTOCOL_VERSION));
     result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
+    return result;
+}
 
+/** Pass the "tx" entry of each transaction in block to fn, in order */
+static void ForEachTxToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex* blockindex, TxVerbosity verbosity, TxProofDetail proofs,
+                            const std::function<void(UniValue&&)>& fn)
+{
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                fn(UniValue{tx->GetHash().GetHex()});
             }
             break;
 
@@ -198,30 +205,78 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 // coinbase transaction (i.e. i == 0) doesn't have undo data
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
-                TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, RPCSerializationFlags(), txundo, verbosity);
-                txs.push_back(objTx);
+                TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, RPCSerializationFlags(), txundo, verbosity, proofs);
+                fn(std::move(objTx));
             }
             break;
     }
+}
+
+/** Proof of stake fields of blockToJSON, following "tx" */
+static void PushCoinstakeDetails(UniValue& result, const CBlock& block, const CBlockIndex* blockindex)
+{
+    if (!blockindex->pprev) {
+        return;
+    }
+    result.pushKV("blocksig", HexStr(block.vchBlockSig));
+    result.pushKV("prevstakemodifier", blockindex->pprev->GetStakeModifier().GetHex());
+    uint256 kernelhash, kernelblockhash;
+    CAmount kernelvalue;
+    CScript kernelscript;
+    if (GetKernelInfo(blockindex, *block.vtx[0], kernelhash, kernelvalue, kernelscript, kernelblockhash)) {
+        result.pushKV("hashproofofstake", kernelhash.GetHex());
+        result.pushKV("stakekernelvalue", ValueFromAmount(kernelvalue));
+        result.pushKV("stakekernelscript", HexStr(kernelscript));
+        result.pushKV("stakekernelblockhash", kernelblockhash.GetHex());
+    }
+}
+
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails, TxProofDetail proofs)
+{
+    UniValue result = BlockSummaryToJSON(block, tip, blockindex);
+
+    UniValue txs(UniValue::VARR);
+    ForEachTxToJSON(blockman, block, blockindex, verbosity, proofs, [&](UniValue&& tx) {
+        txs.push_back(std::move(tx));
+    });
 
     result.pushKV("tx", txs);
-    if (coinstakeDetails && blockindex->pprev) {
-        result.pushKV("blocksig", HexStr(block.vchBlockSig));
-        result.pushKV("prevstakemodifier", blockindex->pprev->bnStakeModifier.GetHex());
-        uint256 kernelhash, kernelblockhash;
-        CAmount kernelvalue;
-        CScript kernelscript;
-        if (GetKernelInfo(blockindex, *block.vtx[0], kernelhash, kernelvalue, kernelscript, kernelblockhash)) {
-            result.pushKV("hashproofofstake", kernelhash.GetHex());
-            result.pushKV("stakekernelvalue", ValueFromAmount(kernelvalue));
-            result.pushKV("stakekernelscript", HexStr(kernelscript));
-            result.pushKV("stakekernelblockhash", kernelblockhash.GetHex());
-        }
+    if (coinstakeDetails) {
+        PushCoinstakeDetails(result, block, blockindex);
     }
 
     return result;
 }
 
+void blockToJSONString(BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails, TxProofDetail proofs, std::string& out,
+                       const std::function<void(std::string&)>& flush)
+{
+    // Write the summary object without its closing brace, then the members that follow it
+    const std::string summary = BlockSummaryToJSON(block, tip, blockindex).write();
+    out.append(summary, 0, summary.size() - 1);
+
+    out += ",\"tx\":[";
+    bool first = true;
+    ForEachTxToJSON(blockman, block, blockindex, verbosity, proofs, [&](UniValue&& tx) {
+        if (!first) out += ',';
+        first = false;
+        out += tx.write();
+        if (flush) flush(out);
+    });
+    out += ']';
+
+    if (coinstakeDetails) {
+        UniValue details(UniValue::VOBJ);
+        PushCoinstakeDetails(details, block, blockindex);
+        if (!details.empty()) {
+            const std::string members = details.write();
+            out += ',';
+            out.append(members, 1, members.size() - 2);
+        }
+    }
+    out += '}';
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{"getblockcount",
@@ -712,6 +767,9 @@ static RPCHelpMan getblock()
                     {"blockhash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The block hash"},
                     {"verbosity|verbose", RPCArg::Type::NUM, RPCArg::Default{1}, "0 for hex-encoded data, 1 for a JSON object, 2 for JSON object with transaction data, and 3 for JSON object with transaction data including prevout information for inputs"},
                     {"coinstakeinfo", RPCArg::Type::BOOL, RPCArg::Default{false}, "Display more Proof of Stake info"},
+                    {"proofs", RPCArg::Type::STR, RPCArg::Default{"full"}, "For verbosity 2 and 3, how much of the rangeproofs and input witnesses to return.\n"
+                        "\"full\", \"truncate\" to the first " + ToString(PROOF_HEX_TRUNCATE_BYTES) + " bytes of each, or \"omit\".\n"
+                        "The transaction \"hex\" is only returned when full."},
                 },
                 {
                     RPCResult{"for verbosity = 0",
@@ -773,6 +831,7 @@ static RPCHelpMan getblock()
                 RPCExamples{
                     HelpExampleCli("getblock", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\"")
             + HelpExampleRpc("getblock", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\"")
+            + HelpExampleCli("-named getblock", "blockhash=\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\" verbosity=2 proofs=omit")
                 },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -789,6 +848,13 @@ static RPCHelpMan getblock()
 
     bool with_coinstakeinfo = !request.params[2].isNull() ? request.params[2].get_bool() : false;
 
+    TxProofDetail proofs;
+    try {
+        proofs = ParseProofDetailString(request.params[3]);
+    } catch (const std::runtime_error& e) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, e.what());
+    }
+
     CBlock block;
     const CBlockIndex* pblockindex;
     const CBlockIndex* tip;
@@ -822,7 +888,7 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
-    return blockToJSON(chainman.m_blockman, block, tip, pblockindex, tx_verbosity, with_coinstakeinfo);
+    return blockToJSON(chainman.m_blockman, block, tip, pblockindex, tx_verbosity, with_coinstakeinfo, proofs);
 },
     };
 }
@@ -933,7 +999,8 @@ static RPCHelpMan gettxoutsetinfo()
 {
     return RPCHelpMan{"gettxoutsetinfo",
                 "\nReturns statistics about the unspent transaction output set.\n"
-                "Note this call may take some time if you are not using coinstatsindex.\n",
+                "Note this call may take some time if you are not using coinstatsindex.\n"
+                "Without coinstatsindex the 'muhash' and 'none' hash types read the UTXO set on multiple threads.\n",
                 {
                     {"hash_type", RPCArg::Type::STR, RPCArg::Default{"hash_serialized_2"}, "Which UTXO set hash should be calculated. Options: 'hash_serialized_2' (the legacy algorithm), 'muhash', 'none'."},
                     {"hash_or_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the current best block"}, "The block hash or height of the target height (only available with coinstatsindex).", "", {"", "string or numeric"}},
@@ -946,6 +1013,7 @@ static RPCHelpMan gettxoutsetinfo()
                         {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block at which these statistics are calculated"},
                         {RPCResult::Type::NUM, "txouts", "The number of unspent transaction outputs"},
                         {RPCResult::Type::NUM, "txouts_blinded", /*optional=*/true, "The number of blinded unspent transaction outputs"},
+                        {RPCResult::Type::STR_HEX, "blinded_commitment_sum", /*optional=*/true, "The sum of the commitments of the blinded unspent transaction outputs (not available when coinstatsindex is used)"},
                         {RPCResult::Type::NUM, "bogosize", "Database-independent, meaningless metric indicating the UTXO set size"},
                         {RPCResult::Type::STR_HEX, "hash_serialized_2", /*optional=*/true, "The serialized hash (only present if 'hash_serialized_2' hash_type is chosen)"},
                         {RPCResult::Type::STR_HEX, "muhash", /*optional=*/true, "The serialized hash (only present if 'muhash' hash_type is chosen)"},
@@ -1036,6 +1104,9 @@ static RPCHelpMan gettxoutsetinfo()
         ret.pushKV("txouts", (int64_t)stats.nTransactionOutputs);
         if (fGlobeMode) {
             ret.pushKV("txouts_blinded", (int64_t)stats.nBlindTransactionOutputs);
+            if (stats.blind_commitment_sum) {
+                ret.pushKV("blinded_commitment_sum", HexStr(stats.blind_commitment_sum->data));
+            }
         }
         ret.pushKV("bogosize", (int64_t)stats.nBogoSize);
         if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
@@ -2559,20 +2630,20 @@ UniValue CreateUTXOSnapshot(
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
-        {"blockchain", &getblockchaininfo},
+        {"blockchain", &getblockchaininfo, /*batch_parallel_safe=*/true},
         {"blockchain", &getchaintxstats},
-        {"blockchain", &getblockstats},
-        {"blockchain", &getbestblockhash},
-        {"blockchain", &getblockcount},
-        {"blockchain", &getblock},
+        {"blockchain", &getblockstats, /*batch_parallel_safe=*/true},
+        {"blockchain", &getbestblockhash, /*batch_parallel_safe=*/true},
+        {"blockchain", &getblockcount, /*batch_parallel_safe=*/true},
+        {"blockchain", &getblock, /*batch_parallel_safe=*/true},
         {"blockchain", &getblockfrompeer},
-        {"blockchain", &getblockhash},
+        {"blockchain", &getblockhash, /*batch_parallel_safe=*/true},
         {"blockchain", &getblockhashafter},
-        {"blockchain", &getblockheader},
-        {"blockchain", &getchaintips},
-        {"blockchain", &getdifficulty},
+        {"blockchain", &getblockheader, /*batch_parallel_safe=*/true},
+        {"blockchain", &getchaintips, /*batch_parallel_safe=*/true},
+        {"blockchain", &getdifficulty, /*batch_parallel_safe=*/true},
         {"blockchain", &getdeploymentinfo},
-        {"blockchain", &gettxout},
+        {"blockchain", &gettxout, /*batch_parallel_safe=*/true},
         {"blockchain", &gettxoutsetinfo},
         {"blockchain", &pruneblockchain},
         {"blockchain", &verifychain},
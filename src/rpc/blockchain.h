@@ -13,6 +13,7 @@
 #include <validation.h>
 
 #include <any>
+#include <functional>
 #include <stdint.h>
 #include <vector>
 
@@ -40,7 +41,13 @@ double GetDifficulty(const CBlockIndex* blockindex);
 void RPCNotifyBlockChange(const CBlockIndex*);
 
 /** Block description to JSON */
-UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails = false) LOCKS_EXCLUDED(cs_main);
+UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails = false, TxProofDetail proofs = TxProofDetail::FULL) LOCKS_EXCLUDED(cs_main);
+
+/** Append the JSON text of blockToJSON(...) to out, converting one transaction at a
+ * time instead of building a UniValue tree for the whole block first.
+ * If set, flush is called with out after each transaction and may consume it. */
+void blockToJSONString(node::BlockManager& blockman, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, TxVerbosity verbosity, bool coinstakeDetails, TxProofDetail proofs, std::string& out,
+                       const std::function<void(std::string&)>& flush = {}) LOCKS_EXCLUDED(cs_main);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex) LOCKS_EXCLUDED(cs_main);
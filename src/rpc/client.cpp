@@ -235,6 +235,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "clearwallettransactions", 0, "remove_all" },
     { "deriverangekeys", 3, "hardened" },
     { "rehashblock", 2, "addtxns" },
+    { "checkkeyimages", 0, "keyimages" },
     { "verifycommitment", 2, "amount" },
     { "getposdifficulty", 0, "height" },
     { "filteraddresses", 2, "sort_code" },
@@ -360,6 +361,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getaddressmempool", 0, "addresses"},
     { "listcoldstakeunspent", 1, "height"},
     { "listcoldstakeunspent", 2, "options"},
+    { "getcoldstakeweights", 1, "height"},
+    { "getcoldstakeweights", 2, "options"},
     { "getblockreward", 0, "height"},
     { "getblockbalances", 1, "options"},
     { "getaddresstxids", 0, "addresses"},
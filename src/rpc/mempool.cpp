@@ -898,10 +898,10 @@ void RegisterMempoolRPCCommands(CRPCTable& t)
         {"rawtransactions", &testmempoolaccept},
         {"blockchain", &getmempoolancestors},
         {"blockchain", &getmempooldescendants},
-        {"blockchain", &getmempoolentry},
+        {"blockchain", &getmempoolentry, /*batch_parallel_safe=*/true},
         {"blockchain", &gettxspendingprevout},
         {"blockchain", &getmempoolinfo},
-        {"blockchain", &getrawmempool},
+        {"blockchain", &getrawmempool, /*batch_parallel_safe=*/true},
         {"blockchain", &savemempool},
         {"hidden", &submitpackage},
     };
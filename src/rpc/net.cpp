@@ -143,6 +143,18 @@ static RPCHelpMan getpeerinfo()
                     {
                         {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                     }},
+                    {RPCResult::Type::OBJ, "compact_blocks", /*optional=*/true, "Reconstruction of the compact blocks received from this peer",
+                    {
+                        {RPCResult::Type::NUM, "received", "The number of compact blocks received"},
+                        {RPCResult::Type::NUM, "reconstructed", "The number of blocks reconstructed without requesting transactions"},
+                        {RPCResult::Type::NUM, "blocktxn_requests", "The number of getblocktxn requests sent"},
+                        {RPCResult::Type::NUM, "full_block_fallbacks", "The number of blocks requested in full after reconstruction failed"},
+                        {RPCResult::Type::NUM, "txn_prefilled", "The number of transactions prefilled by the peer"},
+                        {RPCResult::Type::NUM, "txn_from_mempool", "The number of transactions found in the mempool"},
+                        {RPCResult::Type::NUM, "txn_from_extra", "The number of transactions found in the extra transactions kept for reconstruction"},
+                        {RPCResult::Type::NUM, "txn_requested", "The number of transactions requested"},
+                        {RPCResult::Type::NUM, "txn_requested_bytes", "The total size in bytes of the requested transactions received"},
+                    }},
                     {RPCResult::Type::BOOL, "addr_relay_enabled", /*optional=*/true, "Whether we participate in address relay with this peer"},
                     {RPCResult::Type::NUM, "addr_processed", /*optional=*/true, "The total number of addresses processed, excluding those dropped due to rate limiting"},
                     {RPCResult::Type::NUM, "addr_rate_limited", /*optional=*/true, "The total number of addresses dropped due to rate limiting"},
@@ -254,6 +266,18 @@ static RPCHelpMan getpeerinfo()
                 heights.push_back(height);
             }
             obj.pushKV("inflight", heights);
+            const CompactBlockStats& cmpct_stats = statestats.m_cmpctblock_stats;
+            UniValue compact_blocks(UniValue::VOBJ);
+            compact_blocks.pushKV("received", cmpct_stats.received);
+            compact_blocks.pushKV("reconstructed", cmpct_stats.reconstructed);
+            compact_blocks.pushKV("blocktxn_requests", cmpct_stats.blocktxn_requests);
+            compact_blocks.pushKV("full_block_fallbacks", cmpct_stats.full_block_fallbacks);
+            compact_blocks.pushKV("txn_prefilled", cmpct_stats.txn_prefilled);
+            compact_blocks.pushKV("txn_from_mempool", cmpct_stats.txn_from_mempool);
+            compact_blocks.pushKV("txn_from_extra", cmpct_stats.txn_from_extra);
+            compact_blocks.pushKV("txn_requested", cmpct_stats.txn_requested);
+            compact_blocks.pushKV("txn_requested_bytes", cmpct_stats.txn_requested_bytes);
+            obj.pushKV("compact_blocks", compact_blocks);
             obj.pushKV("relaytxes", statestats.m_relay_txs);
             obj.pushKV("minfeefilter", ValueFromAmount(statestats.m_fee_filter_received));
             obj.pushKV("addr_relay_enabled", statestats.m_addr_relay_enabled);
@@ -21,6 +21,7 @@
 #include <util/check.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
+#include <validationinterface.h>
 
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
@@ -209,6 +210,46 @@ static std::string RPCMallocInfo()
 }
 #endif
 
+static RPCHelpMan getvalidationqueueinfo()
+{
+    return RPCHelpMan{"getvalidationqueueinfo",
+                "\nReturns the state of the validation notification queues.\n"
+                "With -validationqueues each subscriber has its own queue, otherwise a single \"shared\" queue is listed.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "name", "Name of the subscriber"},
+                            {RPCResult::Type::NUM, "pending", "Number of notifications not yet processed"},
+                            {RPCResult::Type::NUM, "max_pending", "Highest number of pending notifications seen"},
+                            {RPCResult::Type::NUM, "processed", "Number of notifications processed"},
+                            {RPCResult::Type::NUM, "lag_ms", "Age in milliseconds of the oldest notification not yet processed"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getvalidationqueueinfo", "")
+            + HelpExampleRpc("getvalidationqueueinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue result(UniValue::VARR);
+    for (const auto& info : GetMainSignals().GetQueueInfo()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("name", info.name);
+        entry.pushKV("pending", (uint64_t)info.pending);
+        entry.pushKV("max_pending", (uint64_t)info.max_pending);
+        entry.pushKV("processed", info.processed);
+        entry.pushKV("lag_ms", info.lag_ms);
+        result.push_back(entry);
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan getmemoryinfo()
 {
     /* Please, avoid using the word "pool" here in the RPC interface or help,
@@ -539,10 +580,11 @@ void RegisterNodeRPCCommands(CRPCTable& t)
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
+        {"control", &getvalidationqueueinfo},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
-        {"hidden", &echo},
+        {"hidden", &echo, /*batch_parallel_safe=*/true},
         {"hidden", &echojson},
         {"hidden", &echoipc},
 #if defined(USE_SYSCALL_SANDBOX)
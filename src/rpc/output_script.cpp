@@ -337,7 +337,7 @@ static RPCHelpMan deriveaddresses()
 void RegisterOutputScriptRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
-        {"util", &validateaddress},
+        {"util", &validateaddress, /*batch_parallel_safe=*/true},
         {"util", &createmultisig},
         {"util", &deriveaddresses},
         {"util", &getdescriptorinfo},
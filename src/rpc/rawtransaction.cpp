@@ -54,7 +54,8 @@ using node::NodeContext;
 using node::PSBTAnalysis;
 
 void TxToJSONExpanded(ChainstateManager& chainman, const CTransaction& tx, const uint256 hashBlock,
-                      const CTxMemPool *pmempool, UniValue& entry, int nHeight = 0, int nConfirmations = 0, int nBlockTime = 0)
+                      const CTxMemPool *pmempool, UniValue& entry, int nHeight = 0, int nConfirmations = 0, int nBlockTime = 0,
+                      TxProofDetail proofs = TxProofDetail::FULL)
 {
     uint256 txid = tx.GetHash();
     entry.pushKV("txid", txid.GetHex());
@@ -133,12 +134,7 @@ void TxToJSONExpanded(ChainstateManager& chainman, const CTransaction& tx, const
 
         if (tx.HasWitness()) {
             if (!txin.scriptWitness.IsNull()) {
-                UniValue txinwitness(UniValue::VARR);
-                for (unsigned int j = 0; j < txin.scriptWitness.stack.size(); j++) {
-                    std::vector<unsigned char> item = txin.scriptWitness.stack[j];
-                    txinwitness.push_back(HexStr(item));
-                }
-                in.pushKV("txinwitness", txinwitness);
+                AddWitness(txin.scriptWitness.stack, in, proofs);
             }
         }
         in.pushKV("sequence", (int64_t)txin.nSequence);
@@ -150,7 +146,7 @@ void TxToJSONExpanded(ChainstateManager& chainman, const CTransaction& tx, const
     for (unsigned int i = 0; i < tx.vpout.size(); i++) {
         UniValue out(UniValue::VOBJ);
         out.pushKV("n", (int64_t)i);
-        OutputToJSON(txid, i, tx.vpout[i].get(), out);
+        OutputToJSON(txid, i, tx.vpout[i].get(), out, proofs);
         auto txo_type = tx.vpout[i].get()->GetType();
         if (txo_type == OUTPUT_STANDARD || txo_type == OUTPUT_CT) {
             CSpentIndexValue spentInfo;
@@ -181,14 +177,14 @@ void TxToJSONExpanded(ChainstateManager& chainman, const CTransaction& tx, const
     }
 }
 
-static void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry, Chainstate& active_chainstate)
+static void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry, Chainstate& active_chainstate, TxProofDetail proofs)
 {
     // Call into TxToUniv() in globe-common to decode the transaction hex.
     //
     // Blockchain contextual information (confirmations and blocktime) is not
     // available to code in globe-common, so we query them here and push the
     // data into the returned UniValue.
-    TxToUniv(tx, /*block_hash=*/uint256(), entry, /*include_hex=*/true, RPCSerializationFlags());
+    TxToUniv(tx, /*block_hash=*/uint256(), entry, /*include_hex=*/true, RPCSerializationFlags(), /*txundo=*/nullptr, TxVerbosity::SHOW_DETAILS, proofs);
 
     if (!hashBlock.IsNull()) {
         LOCK(cs_main);
@@ -236,6 +232,7 @@ static std::vector<RPCResult> DecodeTxDoc(const std::string& txid_field_doc)
                 {
                     {RPCResult::Type::STR_HEX, "hex", "hex-encoded witness data (if any)"},
                 }},
+                {RPCResult::Type::NUM, "witness_size", /*optional=*/true, "Total bytes of the witness items (only if proofs is not full)"},
                 {RPCResult::Type::NUM, "sequence", "The script sequence number"},
                 // Globe
                 {RPCResult::Type::STR, "type", /*optional=*/true, "anon"},
@@ -281,6 +278,7 @@ static std::vector<RPCResult> DecodeTxDoc(const std::string& txid_field_doc)
                 {RPCResult::Type::STR_HEX, "pubkey", /*optional=*/true, "pubkey for anon output"},
                 {RPCResult::Type::STR_HEX, "valueCommitment", /*optional=*/true, "value commitment for blinded output"},
                 {RPCResult::Type::STR_HEX, "rangeproof", /*optional=*/true, "rangeproof for blinded output"},
+                {RPCResult::Type::NUM, "rangeproof_size", /*optional=*/true, "Size of the rangeproof in bytes (only if proofs is not full)"},
                 {RPCResult::Type::STR_HEX, "spentTxId", /*optional=*/true, "Txid of spending transaction"},
                 // Insight
                 {RPCResult::Type::NUM, "spentIndex", /*optional=*/true, "offset of input in spending transaction"},
@@ -345,6 +343,9 @@ static RPCHelpMan getrawtransaction()
                     {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The transaction id"},
                     {"verbose", RPCArg::Type::BOOL, RPCArg::Default{false}, "If false, return a string, otherwise return a json object"},
                     {"blockhash", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED_NAMED_ARG, "The block in which to look for the transaction"},
+                    {"proofs", RPCArg::Type::STR, RPCArg::Default{"full"}, "With verbose, how much of the rangeproofs and input witnesses to return.\n"
+                        "\"full\", \"truncate\" to the first " + ToString(PROOF_HEX_TRUNCATE_BYTES) + " bytes of each, or \"omit\".\n"
+                        "\"hex\" is only returned when full."},
                 },
                 {
                     RPCResult{"if verbose is not set or set to false",
@@ -360,7 +361,7 @@ static RPCHelpMan getrawtransaction()
                              {RPCResult::Type::NUM, "height", /*optional=*/true, "The height of the containing block"},
                              {RPCResult::Type::NUM_TIME, "blocktime", /*optional=*/true, "The block time expressed in " + UNIX_EPOCH_TIME},
                              {RPCResult::Type::NUM, "time", /*optional=*/true, "Same as \"blocktime\""},
-                             {RPCResult::Type::STR_HEX, "hex", "The serialized, hex-encoded data for 'txid'"},
+                             {RPCResult::Type::STR_HEX, "hex", /*optional=*/true, "The serialized, hex-encoded data for 'txid' (only if proofs is full)"},
                          },
                          DecodeTxDoc(/*txid_field_doc=*/"The transaction id (same as provided)")),
                     },
@@ -371,6 +372,7 @@ static RPCHelpMan getrawtransaction()
             + HelpExampleRpc("getrawtransaction", "\"mytxid\", true")
             + HelpExampleCli("getrawtransaction", "\"mytxid\" false \"myblockhash\"")
             + HelpExampleCli("getrawtransaction", "\"mytxid\" true \"myblockhash\"")
+            + HelpExampleCli("-named getrawtransaction", "txid=\"mytxid\" verbose=true proofs=omit")
                 },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -393,6 +395,13 @@ static RPCHelpMan getrawtransaction()
         fVerbose = request.params[1].isNum() ? (request.params[1].getInt<int>() != 0) : request.params[1].get_bool();
     }
 
+    TxProofDetail proofs;
+    try {
+        proofs = ParseProofDetailString(request.params[3]);
+    } catch (const std::runtime_error& e) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, e.what());
+    }
+
     if (!request.params[2].isNull()) {
         LOCK(cs_main);
 
@@ -450,19 +459,20 @@ static RPCHelpMan getrawtransaction()
         }
     }
 
-    std::string strHex = EncodeHexTx(*tx, RPCSerializationFlags());
     if (!fVerbose) {
-        return strHex;
+        return EncodeHexTx(*tx, RPCSerializationFlags());
     }
 
     UniValue result(UniValue::VOBJ);
     if (blockindex) result.pushKV("in_active_chain", in_active_chain);
-    result.pushKV("hex", strHex);
+    if (proofs == TxProofDetail::FULL) {
+        result.pushKV("hex", EncodeHexTx(*tx, RPCSerializationFlags()));
+    }
 
     if (fGlobeMode) {
-        TxToJSONExpanded(chainman, *tx, hash_block, node.mempool.get(), result, nHeight, nConfirmations, nBlockTime);
+        TxToJSONExpanded(chainman, *tx, hash_block, node.mempool.get(), result, nHeight, nConfirmations, nBlockTime, proofs);
     } else {
-        TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate());
+        TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate(), proofs);
     }
     return result;
 },
@@ -2186,10 +2196,10 @@ static RPCHelpMan analyzepsbt()
 void RegisterRawTransactionRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
-        {"rawtransactions", &getrawtransaction},
+        {"rawtransactions", &getrawtransaction, /*batch_parallel_safe=*/true},
         {"rawtransactions", &createrawtransaction},
-        {"rawtransactions", &decoderawtransaction},
-        {"rawtransactions", &decodescript},
+        {"rawtransactions", &decoderawtransaction, /*batch_parallel_safe=*/true},
+        {"rawtransactions", &decodescript, /*batch_parallel_safe=*/true},
         {"rawtransactions", &combinerawtransaction},
         {"rawtransactions", &signrawtransactionwithkey},
         {"rawtransactions", &decodepsbt},
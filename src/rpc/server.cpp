@@ -16,10 +16,14 @@
 
 #include <boost/signals2/signal.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <unordered_map>
 #include <time.h>
 
@@ -223,6 +227,17 @@ static RPCHelpMan getrpcinfo()
                             }},
                         }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
+                        {RPCResult::Type::OBJ_DYN, "work_queue", "HTTP work queue counters by priority and by method with a configured priority or limit",
+                        {
+                            {RPCResult::Type::OBJ, "name", "",
+                            {
+                                {RPCResult::Type::NUM, "count", "Items started since startup"},
+                                {RPCResult::Type::NUM, "total_wait", "Sum of the time started items were queued in microseconds"},
+                                {RPCResult::Type::NUM, "max_wait", "Longest time an item was queued in microseconds"},
+                                {RPCResult::Type::NUM, "queued", "Items waiting"},
+                                {RPCResult::Type::NUM, "running", "Items running"},
+                            }},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -246,6 +261,18 @@ static RPCHelpMan getrpcinfo()
     UniValue log_path(UniValue::VSTR, path);
     result.pushKV("logpath", log_path);
 
+    UniValue work_queue(UniValue::VOBJ);
+    for (const auto& [name, stats] : GetHTTPQueueStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("count", stats.count);
+        entry.pushKV("total_wait", stats.total_wait_us);
+        entry.pushKV("max_wait", stats.max_wait_us);
+        entry.pushKV("queued", (uint64_t)stats.queued);
+        entry.pushKV("running", (uint64_t)stats.running);
+        work_queue.pushKV(name, entry);
+    }
+    result.pushKV("work_queue", work_queue);
+
     return result;
 }
     };
@@ -286,6 +313,15 @@ bool CRPCTable::removeCommand(const std::string& name, const CRPCCommand* pcmd)
     return false;
 }
 
+bool CRPCTable::isBatchParallelSafe(const std::string& method) const
+{
+    auto it = mapCommands.find(method);
+    if (it == mapCommands.end() || it->second.empty()) {
+        return false;
+    }
+    return std::all_of(it->second.begin(), it->second.end(), [](const CRPCCommand* command) { return command->batch_parallel_safe; });
+}
+
 void StartRPC()
 {
     LogPrint(BCLog::RPC, "Starting RPC\n");
@@ -416,11 +452,91 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
+static bool IsBatchParallelSafe(const UniValue& req)
+{
+    if (!req.isObject()) {
+        return false;
+    }
+    const UniValue& method = find_value(req, "method");
+    return method.isStr() && tableRPC.isBatchParallelSafe(method.get_str());
+}
+
+namespace {
+/** A run of batch elements shared between the calling thread and its helpers */
+struct ParallelBatch
+{
+    JSONRPCRequest jreq;
+    std::vector<UniValue> requests;
+    std::vector<UniValue> results;
+    std::atomic<size_t> next{0};
+
+    Mutex cs;
+    std::condition_variable cond;
+    size_t num_done GUARDED_BY(cs){0};
+};
+} // namespace
+
+/** Claim and execute elements until none are left */
+static void RunParallelBatch(ParallelBatch& batch)
+{
+    while (true) {
+        const size_t idx = batch.next.fetch_add(1);
+        if (idx >= batch.requests.size()) {
+            return;
+        }
+        UniValue result = JSONRPCExecOne(batch.jreq, batch.requests[idx]);
+        LOCK(batch.cs);
+        batch.results[idx] = std::move(result);
+        if (++batch.num_done == batch.requests.size()) {
+            batch.cond.notify_all();
+        }
+    }
+}
+
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, const RPCWorkSubmitter& submit, int max_parallel)
 {
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+    size_t reqIdx = 0;
+    while (reqIdx < vReq.size()) {
+        size_t end = reqIdx;
+        if (submit && max_parallel > 1) {
+            while (end < vReq.size() && IsBatchParallelSafe(vReq[end])) {
+                end++;
+            }
+        }
+        if (end - reqIdx < 2) {
+            // Elements that may have side effects run alone and in order
+            ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+            reqIdx++;
+            continue;
+        }
+
+        // The batch state is shared as helpers may still be queued when this thread returns.
+        // This thread works through the elements too, so it never waits on a helper that
+        // hasn't started, and the batch completes even when the work queue is full.
+        auto batch = std::make_shared<ParallelBatch>();
+        batch->jreq = jreq;
+        batch->requests.assign(vReq.getValues().begin() + reqIdx, vReq.getValues().begin() + end);
+        batch->results.resize(batch->requests.size());
+
+        const size_t num_helpers = std::min<size_t>(max_parallel - 1, batch->requests.size() - 1);
+        for (size_t i = 0; i < num_helpers; ++i) {
+            if (!submit([batch] { RunParallelBatch(*batch); })) {
+                break;
+            }
+        }
+        RunParallelBatch(*batch);
+        {
+            WAIT_LOCK(batch->cs, lock);
+            while (batch->num_done < batch->requests.size()) {
+                batch->cond.wait(lock);
+            }
+        }
+        for (auto& result : batch->results) {
+            ret.push_back(std::move(result));
+        }
+        reqIdx = end;
+    }
 
     return ret.write() + "\n";
 }
@@ -141,7 +141,7 @@ public:
     }
 
     //! Simplified constructor taking plain RpcMethodFnType function pointer.
-    CRPCCommand(std::string category, RpcMethodFnType fn)
+    CRPCCommand(std::string category, RpcMethodFnType fn, bool batch_parallel_safe = false)
         : CRPCCommand(
               category,
               fn().m_name,
@@ -149,6 +149,7 @@ public:
               fn().GetArgNames(),
               intptr_t(fn))
     {
+        this->batch_parallel_safe = batch_parallel_safe;
     }
 
     std::string category;
@@ -156,6 +157,8 @@ public:
     Actor actor;
     std::vector<std::string> argNames;
     intptr_t unique_id;
+    //! Read-only, consecutive calls in a JSON-RPC batch may run concurrently
+    bool batch_parallel_safe{false};
 };
 
 /**
@@ -188,6 +191,11 @@ public:
      */
     UniValue dumpArgMap(const JSONRPCRequest& request) const;
 
+    /**
+     * Returns whether every handler of a method was registered as batch_parallel_safe.
+     */
+    bool isBatchParallelSafe(const std::string& method) const;
+
     /**
      * Appends a CRPCCommand to the dispatch table.
      *
@@ -211,7 +219,15 @@ extern CRPCTable tableRPC;
 void StartRPC();
 void InterruptRPC();
 void StopRPC();
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq);
+/** Runs a task on another thread, returns false if it could not be queued */
+using RPCWorkSubmitter = std::function<bool(std::function<void()>)>;
+
+/**
+ * Execute a batch of requests, the replies keep the order of the requests.
+ * Consecutive read-only requests are spread over up to max_parallel threads,
+ * the calling thread and tasks passed to submit.
+ */
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, const RPCWorkSubmitter& submit = {}, int max_parallel = 1);
 
 // Retrieves any serialization flags requested in command line argument
 int RPCSerializationFlags();
@@ -15,15 +15,35 @@ int secp256k1_prepare_mlsag(uint8_t *m, uint8_t *sk,
 
 int secp256k1_get_keyimage(uint8_t *ki, const uint8_t *pk, const uint8_t *sk);
 
+/* hp[64] = H(pk) as uncompressed x and y, the base point of pk's key image.
+   Callers can store hp and pass it to the _hp functions below to skip
+   recomputing H(pk).
+*/
+int secp256k1_get_keyimage_base(uint8_t *hp, const uint8_t *pk);
+
 int secp256k1_generate_mlsag(const secp256k1_context *ctx,
     uint8_t *ki, uint8_t *pc, uint8_t *ps,
     const uint8_t *nonce, const uint8_t *preimage, size_t nCols,
     size_t nRows, size_t index, const uint8_t **sk, const uint8_t *pk);
 
+/* hp[i + k*nCols] is the key image base of pk[k][i] for the nRows-1 rows
+   with key images, or NULL to compute it. Any entry may be NULL, as may hp.
+*/
+int secp256k1_generate_mlsag_hp(const secp256k1_context *ctx,
+    uint8_t *ki, uint8_t *pc, uint8_t *ps,
+    const uint8_t *nonce, const uint8_t *preimage, size_t nCols,
+    size_t nRows, size_t index, const uint8_t **sk, const uint8_t *pk,
+    const uint8_t **hp);
+
 int secp256k1_verify_mlsag(const uint8_t *preimage,
     size_t nCols, size_t nRows,
     const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps);
 
+int secp256k1_verify_mlsag_hp(const uint8_t *preimage,
+    size_t nCols, size_t nRows,
+    const uint8_t *pk, const uint8_t **hp,
+    const uint8_t *ki, const uint8_t *pc, const uint8_t *ps);
+
 #ifdef __cplusplus
 }
 #endif
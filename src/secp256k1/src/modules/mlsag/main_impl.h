@@ -165,6 +165,41 @@ static int hash_to_curve(secp256k1_ge *ge, const uint8_t *pd, size_t len)
     return 0;
 }
 
+/* ge = H(pk), read from hp if set. hp is H(pk) as stored by
+   secp256k1_get_keyimage_base, if it is not a point with even y the
+   point is recomputed.
+*/
+static int load_keyimage_base(secp256k1_ge *ge, const uint8_t *pk, const uint8_t *hp)
+{
+    secp256k1_fe x, y;
+
+    if (hp
+        && secp256k1_fe_set_b32(&x, hp)
+        && secp256k1_fe_set_b32(&y, hp + 32)
+        && !secp256k1_fe_is_odd(&y)) {
+        secp256k1_ge_set_xy(ge, &x, &y);
+        if (secp256k1_ge_is_valid_var(ge)) {
+            return 0;
+        }
+    }
+    return hash_to_curve(ge, pk, 33);
+}
+
+int secp256k1_get_keyimage_base(uint8_t *hp, const uint8_t *pk)
+{
+    secp256k1_ge ge1;
+
+    if (0 != hash_to_curve(&ge1, pk, 33)) { /* H(pk) */
+        return 1;
+    }
+    secp256k1_fe_normalize_var(&ge1.x);
+    secp256k1_fe_normalize_var(&ge1.y);
+    secp256k1_fe_get_b32(hp, &ge1.x);
+    secp256k1_fe_get_b32(hp + 32, &ge1.y);
+
+    return 0;
+}
+
 int secp256k1_get_keyimage(uint8_t *ki, const uint8_t *pk, const uint8_t *sk)
 {
     secp256k1_ge ge1;
@@ -193,10 +228,11 @@ int secp256k1_get_keyimage(uint8_t *ki, const uint8_t *pk, const uint8_t *sk)
 }
 
 #define MLSAG_MAX_ROWS 33 /* arbitrary max rows, max inputs 32 */
-int secp256k1_generate_mlsag(const secp256k1_context *ctx,
+int secp256k1_generate_mlsag_hp(const secp256k1_context *ctx,
     uint8_t *ki, uint8_t *pc, uint8_t *ps,
     const uint8_t *nonce, const uint8_t *preimage, size_t nCols,
-    size_t nRows, size_t index, const uint8_t **sk, const uint8_t *pk)
+    size_t nRows, size_t index, const uint8_t **sk, const uint8_t *pk,
+    const uint8_t **hp)
 {
     /* nRows == nInputs + 1, last row sums commitments
     */
@@ -255,7 +291,7 @@ int secp256k1_generate_mlsag(const secp256k1_context *ctx,
             continue;
         }
 
-        if (0 != hash_to_curve(&ge1, &pk[(index + k*nCols)*33], 33)) { /* H(pk_ind[col]) */
+        if (0 != load_keyimage_base(&ge1, &pk[(index + k*nCols)*33], hp ? hp[index + k*nCols] : NULL)) { /* H(pk_ind[col]) */
             return 1;
         }
 
@@ -314,7 +350,7 @@ int secp256k1_generate_mlsag(const secp256k1_context *ctx,
             }
 
             /* R = H(pk[k][i]) * ss + ki[k] * clast */
-            if (0 != hash_to_curve(&ge1, &pk[(i + k*nCols)*33], 33)) { /* H(pk[k][i]) */
+            if (0 != load_keyimage_base(&ge1, &pk[(i + k*nCols)*33], hp ? hp[i + k*nCols] : NULL)) { /* H(pk[k][i]) */
                 return 1;
             }
             secp256k1_gej_set_ge(&gej1, &ge1);
@@ -365,7 +401,17 @@ int secp256k1_generate_mlsag(const secp256k1_context *ctx,
     return 0;
 }
 
-int secp256k1_verify_mlsag(
+int secp256k1_generate_mlsag(const secp256k1_context *ctx,
+    uint8_t *ki, uint8_t *pc, uint8_t *ps,
+    const uint8_t *nonce, const uint8_t *preimage, size_t nCols,
+    size_t nRows, size_t index, const uint8_t **sk, const uint8_t *pk)
+{
+    return secp256k1_generate_mlsag_hp(ctx, ki, pc, ps, nonce, preimage,
+        nCols, nRows, index, sk, pk, NULL);
+}
+
+/* One ecmult and one field inversion per point, kept to check secp256k1_verify_mlsag against */
+static int secp256k1_verify_mlsag_reference(
     const uint8_t *preimage, size_t nCols, size_t nRows,
     const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
 {
@@ -450,4 +496,131 @@ int secp256k1_verify_mlsag(
     return secp256k1_scalar_is_zero(&zero) ? 0 : 2; /* return 0 on success, 2 on failure */
 }
 
+/* r = na[0] * a[0] + na[1] * a[1], sharing the doublings of one Strauss pass */
+static void secp256k1_mlsag_ecmult2(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na) {
+    secp256k1_fe aux[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_ge pre_a[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    struct secp256k1_strauss_point_state ps[2];
+    struct secp256k1_strauss_state state;
+
+    state.aux = aux;
+    state.pre_a = pre_a;
+    state.ps = ps;
+    secp256k1_ecmult_strauss_wnaf(&state, r, 2, a, na, NULL);
+}
+
+int secp256k1_verify_mlsag_hp(
+    const uint8_t *preimage, size_t nCols, size_t nRows,
+    const uint8_t *pk, const uint8_t **hp,
+    const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+{
+    /* Same hashes as secp256k1_verify_mlsag_reference, the L and R points of a
+       column are converted to affine together with one field inversion and
+       each R is a single two point multiplication.
+    */
+    secp256k1_sha256 sha256_m, sha256_pre;
+    secp256k1_scalar zero, clast, cSig, ss, rs[2];
+    secp256k1_ge ge1;
+    secp256k1_gej gej1, ra[2];
+    secp256k1_gej kij[MLSAG_MAX_ROWS];
+    secp256k1_gej lr[2 * MLSAG_MAX_ROWS];
+    secp256k1_ge lr_ge[2 * MLSAG_MAX_ROWS];
+    size_t dsRows = nRows-1;
+    uint8_t tmp[33];
+    size_t i, k, clen;
+    int overflow;
+
+    if (nRows < 1 || nRows > MLSAG_MAX_ROWS) {
+        return secp256k1_verify_mlsag_reference(preimage, nCols, nRows, pk, ki, pc, ps);
+    }
+
+    secp256k1_scalar_set_int(&zero, 0);
+
+    secp256k1_scalar_set_b32(&clast, pc, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&clast)) {
+        return 1;
+    }
+
+    cSig = clast;
+
+    /* Key images are the same for every column */
+    for (k = 0; nCols > 0 && k < dsRows; ++k) {
+        if (!secp256k1_eckey_pubkey_parse(&ge1, &ki[k * 33], 33) ||
+            secp256k1_ge_is_infinity(&ge1)) {
+            return 1;
+        }
+        secp256k1_gej_set_ge(&kij[k], &ge1);
+    }
+
+    secp256k1_sha256_initialize(&sha256_m);
+    secp256k1_sha256_write(&sha256_m, preimage, 32);
+    sha256_pre = sha256_m;
+
+    for (i = 0; i < nCols; ++i) {
+        sha256_m = sha256_pre; /* Set to after preimage hashed */
+
+        /* lr holds L then R of each row, R only for the rows with key images */
+        for (k = 0; k < nRows; ++k) {
+            /* L = G * ss + pk[k][i] * clast */
+            secp256k1_scalar_set_b32(&ss, &ps[(i + k*nCols)*32], &overflow);
+            if (overflow || secp256k1_scalar_is_zero(&ss)) {
+                return 1;
+            }
+            if (!secp256k1_eckey_pubkey_parse(&ge1, &pk[(i + k*nCols)*33], 33) ||
+                secp256k1_ge_is_infinity(&ge1)) {
+                return 1;
+            }
+            secp256k1_gej_set_ge(&gej1, &ge1);
+            secp256k1_ecmult(&lr[2 * k], &gej1, &clast, &ss);
+
+            if (k >= dsRows) {
+                continue;
+            }
+
+            /* R = H(pk[k][i]) * ss + ki[k] * clast */
+            if (0 != load_keyimage_base(&ge1, &pk[(i + k*nCols)*33], hp ? hp[i + k*nCols] : NULL)) { /* H(pk[k][i]) */
+                return 1;
+            }
+            secp256k1_gej_set_ge(&ra[0], &ge1);
+            ra[1] = kij[k];
+            rs[0] = ss;
+            rs[1] = clast;
+            secp256k1_mlsag_ecmult2(&lr[2 * k + 1], ra, rs);
+        }
+
+        /* The last row has no R */
+        secp256k1_ge_set_all_gej_var(lr_ge, lr, 2 * nRows - 1);
+
+        for (k = 0; k < nRows; ++k) {
+            secp256k1_sha256_write(&sha256_m, &pk[(i + k*nCols)*33], 33); /* pk[k][i] */
+            secp256k1_eckey_pubkey_serialize(&lr_ge[2 * k], tmp, &clen, 1);
+            secp256k1_sha256_write(&sha256_m, tmp, 33); /* L */
+
+            if (k >= dsRows) {
+                continue;
+            }
+            secp256k1_eckey_pubkey_serialize(&lr_ge[2 * k + 1], tmp, &clen, 1);
+            secp256k1_sha256_write(&sha256_m, tmp, 33); /* R */
+        }
+
+        secp256k1_sha256_finalize(&sha256_m, tmp);
+        secp256k1_scalar_set_b32(&clast, tmp, &overflow);
+        if (overflow || secp256k1_scalar_is_zero(&clast)) {
+            return 1;
+        }
+    }
+
+    secp256k1_scalar_negate(&cSig, &cSig);
+    secp256k1_scalar_add(&zero, &clast, &cSig);
+
+    return secp256k1_scalar_is_zero(&zero) ? 0 : 2; /* return 0 on success, 2 on failure */
+}
+
+int secp256k1_verify_mlsag(
+    const uint8_t *preimage, size_t nCols, size_t nRows,
+    const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+{
+    return secp256k1_verify_mlsag_hp(preimage, nCols, nRows, pk, NULL, ki, pc, ps);
+}
+
 #endif
@@ -14,6 +14,16 @@ static int mlsag_count = 32;
 #define MAX_N_INPUTS  32
 #define MAX_N_OUTPUTS 32
 #define MAX_N_COLUMNS 32
+
+/* The batched verifier must give the reference result for every signature */
+static int verify_mlsag_both(const uint8_t *preimage, size_t nCols, size_t nRows,
+    const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+{
+    int rv = secp256k1_verify_mlsag(preimage, nCols, nRows, pk, ki, pc, ps);
+    CHECK(rv == secp256k1_verify_mlsag_reference(preimage, nCols, nRows, pk, ki, pc, ps));
+    return rv;
+}
+
 void test_mlsag(void)
 {
     const size_t n_inputs = (secp256k1_testrand32() % (MAX_N_INPUTS))+1;
@@ -40,6 +50,12 @@ void test_mlsag(void)
     secp256k1_ge ge;
     uint8_t pc[32];
     uint8_t ki[MAX_N_INPUTS * 33];
+    uint8_t ki_prefix;
+    uint8_t hp[MAX_N_INPUTS * MAX_N_COLUMNS * 64];
+    const uint8_t *php[MAX_N_INPUTS * MAX_N_COLUMNS];
+    uint8_t pc_hp[32];
+    uint8_t ki_hp[MAX_N_INPUTS * 33];
+    uint8_t ss_hp[(MAX_N_INPUTS+1) * MAX_N_COLUMNS * 33];
     uint8_t ss[(MAX_N_INPUTS+1) * MAX_N_COLUMNS * 33]; /* max_rows * max_cols */
 
     secp256k1_testrand256(preimage);
@@ -116,7 +132,7 @@ void test_mlsag(void)
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
 
-    CHECK(0 == secp256k1_verify_mlsag(
+    CHECK(0 == verify_mlsag_both(
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 
@@ -124,13 +140,13 @@ void test_mlsag(void)
     /* --- Test for failure --- */
 
     /* Bad preimage */
-    CHECK(2 == secp256k1_verify_mlsag(
+    CHECK(2 == verify_mlsag_both(
         tmp32, n_columns, n_rows,
         m, ki, pc, ss));
 
 
     /* Bad c */
-    CHECK(2 == secp256k1_verify_mlsag(
+    CHECK(2 == verify_mlsag_both(
         preimage, n_columns, n_rows,
         m, ki, tmp32, ss));
 
@@ -144,7 +160,7 @@ void test_mlsag(void)
     CHECK(0 == secp256k1_generate_mlsag(ctx, ki, pc, ss,
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
-    CHECK(2 == secp256k1_verify_mlsag(
+    CHECK(2 == verify_mlsag_both(
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 
@@ -157,11 +173,58 @@ void test_mlsag(void)
     CHECK(0 == secp256k1_generate_mlsag(ctx, ki, pc, ss,
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
-    CHECK(0 == secp256k1_verify_mlsag(
+    CHECK(0 == verify_mlsag_both(
+        preimage, n_columns, n_rows,
+        m, ki, pc, ss));
+
+
+    /* Bad key image */
+    ki_prefix = ki[(n_rows - 2) * 33];
+    ki[(n_rows - 2) * 33] = 0x04;
+    CHECK(1 == verify_mlsag_both(
+        preimage, n_columns, n_rows,
+        m, ki, pc, ss));
+    ki[(n_rows - 2) * 33] = ki_prefix;
+    CHECK(0 == verify_mlsag_both(
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 
 
+    /* Precomputed key image bases */
+    for (k = 0; k < n_inputs; k++) {
+        for (i = 0; i < n_columns; i++) {
+            CHECK(0 == secp256k1_get_keyimage_base(&hp[(i+k*n_columns)*64], &m[(i+k*n_columns)*33]));
+            php[i+k*n_columns] = &hp[(i+k*n_columns)*64];
+        }
+    }
+    CHECK(0 == secp256k1_generate_mlsag_hp(ctx, ki_hp, pc_hp, ss_hp,
+        tmp32, preimage, n_columns, n_rows, n_real_col,
+        (const uint8_t**)pkeys, m, php));
+    CHECK(0 == memcmp(ki_hp, ki, n_inputs * 33));
+    CHECK(0 == memcmp(pc_hp, pc, 32));
+    CHECK(0 == memcmp(ss_hp, ss, n_rows * n_columns * 32));
+    CHECK(0 == secp256k1_verify_mlsag_hp(
+        preimage, n_columns, n_rows,
+        m, php, ki, pc, ss));
+    php[0] = NULL;
+    CHECK(0 == secp256k1_verify_mlsag_hp(
+        preimage, n_columns, n_rows,
+        m, php, ki, pc, ss));
+    /* A base that is not a point is recomputed */
+    memset(&hp[0], 0xff, 64);
+    php[0] = &hp[0];
+    CHECK(0 == secp256k1_verify_mlsag_hp(
+        preimage, n_columns, n_rows,
+        m, php, ki, pc, ss));
+    /* A base of another pubkey fails */
+    if (n_columns > 1) {
+        php[0] = &hp[64];
+        CHECK(2 == secp256k1_verify_mlsag_hp(
+            preimage, n_columns, n_rows,
+            m, php, ki, pc, ss));
+    }
+
+
     /* Bad secretkey */
     random_scalar_order(&s);
     secp256k1_scalar_get_b32(&keys_in[0], &s);
@@ -169,7 +232,7 @@ void test_mlsag(void)
     CHECK(0 == secp256k1_generate_mlsag(ctx, ki, pc, ss,
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
-    CHECK(2 == secp256k1_verify_mlsag(
+    CHECK(2 == verify_mlsag_both(
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 }
@@ -24,6 +24,7 @@ const std::string DBK_PURGED_TOKEN      = "pm";
 const std::string DBK_FUNDING_TX_DATA   = "fd";
 const std::string DBK_FUNDING_TX_LINK   = "fl";
 const std::string DBK_BEST_BLOCK        = "bb";
+const std::string DBK_METADATA          = "md";
 
 RecursiveMutex cs_smsgDB;
 leveldb::DB *smsgDB = nullptr;
@@ -442,6 +443,15 @@ bool SecMsgDB::WriteSmesg(const uint8_t *chKey, const SecMsgStored &smsgStored)
     CDataStream ssValue(SER_DISK, CLIENT_VERSION);
     ssValue << smsgStored;
 
+    // Keep the read flag in the metadata index in step
+    SecMsgMetadataEntry entry;
+    if (ReadMetadata(chKey, entry) && entry.status != smsgStored.status) {
+        entry.status = smsgStored.status;
+        if (!WriteMetadata(chKey, entry)) {
+            return false;
+        }
+    }
+
     if (activeBatch) {
         activeBatch->Put(ssKey.str(), ssValue.str());
         return true;
@@ -457,6 +467,14 @@ bool SecMsgDB::WriteSmesg(const uint8_t *chKey, const SecMsgStored &smsgStored)
     return true;
 };
 
+static std::string MetadataKey(const uint8_t *chKey)
+{
+    // Prefixed by the full 30 byte message key, longer than message keys so NextSmesg skips them
+    std::string key = DBK_METADATA;
+    key.append((const char*)chKey, 30);
+    return key;
+}
+
 bool SecMsgDB::ExistsSmesg(const uint8_t *chKey)
 {
     if (!pdb) {
@@ -485,12 +503,16 @@ bool SecMsgDB::EraseSmesg(const uint8_t *chKey)
 
     if (activeBatch) {
         activeBatch->Delete(ssKey.str());
+        activeBatch->Delete(MetadataKey(chKey));
         return true;
     }
 
+    leveldb::WriteBatch batch;
+    batch.Delete(ssKey.str());
+    batch.Delete(MetadataKey(chKey));
     leveldb::WriteOptions writeOptions;
     writeOptions.sync = true;
-    leveldb::Status s = pdb->Delete(writeOptions, ssKey.str());
+    leveldb::Status s = pdb->Write(writeOptions, &batch);
 
     if (s.ok() || s.IsNotFound()) {
         return true;
@@ -498,6 +520,71 @@ bool SecMsgDB::EraseSmesg(const uint8_t *chKey)
     return error("SecMsgDB erase failed: %s\n", s.ToString());
 };
 
+bool SecMsgDB::ReadMetadata(const uint8_t *chKey, SecMsgMetadataEntry &entry)
+{
+    if (!pdb) {
+        return false;
+    }
+
+    const std::string key = MetadataKey(chKey);
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey.write(AsBytes(Span{key}));
+    std::string strValue;
+
+    bool readFromDb = true;
+    if (activeBatch) {
+        bool deleted = false;
+        readFromDb = ScanBatch(ssKey, &strValue, &deleted) == false;
+        if (deleted) {
+            return false;
+        }
+    }
+
+    if (readFromDb) {
+        leveldb::Status s = pdb->Get(leveldb::ReadOptions(), ssKey.str(), &strValue);
+        if (!s.ok()) {
+            if (s.IsNotFound()) {
+                return false;
+            }
+            return error("LevelDB read failure: %s\n", s.ToString());
+        }
+    }
+
+    try {
+        CDataStream ssValue(MakeUCharSpan(strValue), SER_DISK, CLIENT_VERSION);
+        ssValue >> entry;
+    } catch (std::exception &e) {
+        LogPrintf("%s unserialize threw: %s.\n", __func__, e.what());
+        return false;
+    }
+
+    return true;
+};
+
+bool SecMsgDB::WriteMetadata(const uint8_t *chKey, const SecMsgMetadataEntry &entry)
+{
+    if (!pdb) {
+        return false;
+    }
+
+    CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+    ssValue << entry;
+
+    if (activeBatch) {
+        activeBatch->Put(MetadataKey(chKey), ssValue.str());
+        return true;
+    }
+
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    leveldb::Status s = pdb->Put(writeOptions, MetadataKey(chKey), ssValue.str());
+    if (!s.ok()) {
+        return error("SecMsgDB write failed: %s\n", s.ToString());
+    }
+
+    return true;
+};
+
 bool SecMsgDB::ReadPurged(const uint8_t *chKey, SecMsgPurged &smsgPurged)
 {
     if (!pdb) {
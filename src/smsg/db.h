@@ -19,6 +19,7 @@ namespace smsg {
 class SecMsgKey;
 class SecMsgStored;
 class SecMsgPurged;
+class SecMsgMetadataEntry;
 
 extern RecursiveMutex cs_smsgDB;
 extern leveldb::DB *smsgDB;
@@ -32,6 +33,7 @@ extern const std::string DBK_STASHED;
 extern const std::string DBK_PURGED_TOKEN;
 extern const std::string DBK_FUNDING_TX_DATA;
 extern const std::string DBK_FUNDING_TX_LINK;
+extern const std::string DBK_METADATA;
 
 class SecMsgDB
 {
@@ -73,6 +75,9 @@ public:
     bool ExistsSmesg(const uint8_t *chKey);
     bool EraseSmesg(const uint8_t *chKey);
 
+    bool ReadMetadata(const uint8_t *chKey, SecMsgMetadataEntry &entry);
+    bool WriteMetadata(const uint8_t *chKey, const SecMsgMetadataEntry &entry);
+
     bool NextPrivKey(leveldb::Iterator *it, const std::string &prefix, CKeyID &idk, SecMsgKey &key);
 
     bool ReadPurged(const uint8_t *chKey, SecMsgPurged &smsgPurged);
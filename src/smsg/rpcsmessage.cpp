@@ -1431,6 +1431,7 @@ static RPCHelpMan smsginbox()
             int fCheckReadStatus = mode == "unread" ? 1 : 0;
 
             smsg::SecMsgStored smsgStored;
+            smsg::SecMsgMetadata metadata;
             smsg::MessageData msg;
 
             dbInbox.TxnBegin();
@@ -1438,10 +1439,20 @@ static RPCHelpMan smsginbox()
             leveldb::Iterator *it = dbInbox.pdb->NewIterator(leveldb::ReadOptions());
             UniValue messageList(UniValue::VARR);
 
-            while (dbInbox.NextSmesg(it, smsg::DBK_INBOX, chKey, smsgStored)) {
-                if (fCheckReadStatus &&
-                    !(smsgStored.status & SMSG_MASK_UNREAD)) {
-                    continue;
+            // Select from the metadata index, only messages on the returned page are decrypted
+            while (dbInbox.NextSmesgKey(it, smsg::DBK_INBOX, chKey)) {
+                int rv = 0;
+                if (fCheckReadStatus || filter.size() > 0) {
+                    uint8_t status = 0;
+                    rv = smsgModule.GetMetadata(dbInbox, chKey, metadata, status);
+                    if (fCheckReadStatus &&
+                        !(status & SMSG_MASK_UNREAD)) {
+                        continue;
+                    }
+                    if (filter.size() > 0 &&
+                        (rv != 0 || !smsgModule.MatchStored(dbInbox, chKey, metadata, filter))) {
+                        continue;
+                    }
                 }
                 if (offset > 0) {
                     offset--;
@@ -1450,6 +1461,9 @@ static RPCHelpMan smsginbox()
                 if (max_results >= 0 && (int)nMessages >= max_results) {
                     break;
                 }
+                if (!dbInbox.ReadSmesg(chKey, smsgStored)) {
+                    continue;
+                }
                 const unsigned char *pHeader = smsgStored.vchMessage.data();
                 smsg::SecureMessage smsg(pHeader);
                 const smsg::SecureMessage *psmsg = &smsg;
@@ -1459,16 +1473,10 @@ static RPCHelpMan smsginbox()
                 objM.pushKV("version", strprintf("%02x%02x", psmsg->version[0], psmsg->version[1]));
 
                 uint32_t nPayload = smsgStored.vchMessage.size() - smsg::SMSG_HDR_LEN;
-                int rv = smsgModule.Decrypt(false, smsgStored.addrTo, pHeader, pHeader + smsg::SMSG_HDR_LEN, nPayload, msg);
+                rv = smsgModule.Decrypt(false, smsgStored.addrTo, pHeader, pHeader + smsg::SMSG_HDR_LEN, nPayload, msg);
                 if (rv == 0) {
                     std::string sAddrTo = EncodeDestination(PKHash(smsgStored.addrTo));
                     std::string sText = std::string((char*)msg.vchMessage.data());
-                    if (filter.size() > 0 &&
-                        !(part::stringsMatchI(msg.sFromAddress, filter, 3) ||
-                          part::stringsMatchI(sAddrTo, filter, 3) ||
-                          part::stringsMatchI(sText, filter, 3))) {
-                        continue;
-                    }
 
                     PushTime(objM, "received", smsgStored.timeReceived);
                     PushTime(objM, "sent", msg.timestamp);
@@ -1496,10 +1504,6 @@ static RPCHelpMan smsginbox()
                         objM.pushKV("unknown_encoding", sEnc);
                     }
                 } else {
-                    if (filter.size() > 0) {
-                        continue;
-                    }
-
                     objM.pushKV("status", "Decrypt failed");
                     objM.pushKV("error", smsg::GetString(rv));
                 }
@@ -1657,12 +1661,24 @@ static RPCHelpMan smsgoutbox()
         } else
         if (mode == "all") {
             smsg::SecMsgStored smsgStored;
+            smsg::SecMsgMetadata metadata;
             smsg::MessageData msg;
-            leveldb::Iterator *it = dbOutbox.pdb->NewIterator(leveldb::ReadOptions());
 
+            // Batch the metadata index entries written while filtering
+            dbOutbox.TxnBegin();
+
+            leveldb::Iterator *it = dbOutbox.pdb->NewIterator(leveldb::ReadOptions());
             UniValue messageList(UniValue::VARR);
 
-            while (dbOutbox.NextSmesg(it, db_prefix, chKey, smsgStored)) {
+            // Select from the metadata index, only messages on the returned page are decrypted
+            while (dbOutbox.NextSmesgKey(it, db_prefix, chKey)) {
+                if (filter.size() > 0) {
+                    uint8_t status = 0;
+                    if (smsgModule.GetMetadata(dbOutbox, chKey, metadata, status) != 0 ||
+                        !smsgModule.MatchStored(dbOutbox, chKey, metadata, filter)) {
+                        continue;
+                    }
+                }
                 if (offset > 0) {
                     offset--;
                     continue;
@@ -1670,6 +1686,9 @@ static RPCHelpMan smsgoutbox()
                 if (max_results >= 0 && (int)nMessages >= max_results) {
                     break;
                 }
+                if (!dbOutbox.ReadSmesg(chKey, smsgStored)) {
+                    continue;
+                }
                 const unsigned char *pHeader = smsgStored.vchMessage.data();
                 smsg::SecureMessage smsg(pHeader);
                 const smsg::SecureMessage *psmsg = &smsg;
@@ -1683,12 +1702,6 @@ static RPCHelpMan smsgoutbox()
                 if (rv == 0) {
                     std::string sAddrTo = EncodeDestination(PKHash(smsgStored.addrTo));
                     std::string sText = std::string((char*)msg.vchMessage.data());
-                    if (filter.size() > 0 &&
-                        !(part::stringsMatchI(msg.sFromAddress, filter, 3) ||
-                          part::stringsMatchI(sAddrTo, filter, 3) ||
-                          part::stringsMatchI(sText, filter, 3))) {
-                        continue;
-                    }
 
                     PushTime(objM, "sent", msg.timestamp);
                     objM.pushKV("paid", UniValue(psmsg->IsPaidVersion()));
@@ -1715,10 +1728,6 @@ static RPCHelpMan smsgoutbox()
                         objM.pushKV("unknown_encoding", sEnc);
                     }
                 } else {
-                    if (filter.size() > 0) {
-                        continue;
-                    }
-
                     objM.pushKV("status", "Decrypt failed");
                     objM.pushKV("error", smsg::GetString(rv));
                 }
@@ -1726,6 +1735,7 @@ static RPCHelpMan smsgoutbox()
                 nMessages++;
             }
             delete it;
+            dbOutbox.TxnCommit();
 
             result.pushKV("messages" ,messageList);
             result.pushKV("result", strprintf("%u", nMessages));
@@ -428,6 +428,73 @@ void ThreadSecureMsgPow(smsg::CSMSG *smsg_module)
     return;
 };
 
+/** Per address key for the metadata index, never used to encrypt messages */
+static void GetMetadataKey(const CKey &key, uint8_t *out)
+{
+    static const std::string tag = "smsg metadata";
+    CHMAC_SHA256(key.begin(), key.size()).Write((const uint8_t*)tag.data(), tag.size()).Finalize(out);
+}
+
+bool EncryptMetadata(const CKey &key, const SecMsgMetadata &metadata, SecMsgMetadataEntry &entry)
+{
+    if (!key.IsValid()) {
+        return false;
+    }
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << metadata;
+
+    uint8_t vchKey[CHMAC_SHA256::OUTPUT_SIZE];
+    GetMetadataKey(key, vchKey);
+    entry.vchIV.resize(SMSG_CRYPTO_IV_SIZE);
+    GetStrongRandBytes(entry.vchIV);
+
+    SecMsgCrypter crypter;
+    crypter.SetKey(vchKey, entry.vchIV.data());
+    memory_cleanse(vchKey, sizeof(vchKey));
+    bool rv = crypter.Encrypt(UCharCast(ss.data()), ss.size(), entry.vchCiphertext);
+    memory_cleanse(ss.data(), ss.size());
+    return rv;
+};
+
+bool DecryptMetadata(const CKey &key, const SecMsgMetadataEntry &entry, SecMsgMetadata &metadata)
+{
+    if (!key.IsValid() || entry.vchIV.size() != SMSG_CRYPTO_IV_SIZE) {
+        return false;
+    }
+
+    uint8_t vchKey[CHMAC_SHA256::OUTPUT_SIZE];
+    GetMetadataKey(key, vchKey);
+    SecMsgCrypter crypter;
+    crypter.SetKey(vchKey, entry.vchIV.data());
+    memory_cleanse(vchKey, sizeof(vchKey));
+
+    std::vector<uint8_t> vchPlaintext;
+    if (!crypter.Decrypt(entry.vchCiphertext.data(), entry.vchCiphertext.size(), vchPlaintext)) {
+        return false;
+    }
+    try {
+        CDataStream ss(vchPlaintext, SER_DISK, CLIENT_VERSION);
+        ss >> metadata;
+    } catch (std::exception &e) {
+        return false;
+    }
+    return true;
+};
+
+std::optional<bool> MatchMetadata(const SecMsgMetadata &metadata, const std::string &filter)
+{
+    if (part::stringsMatchI(metadata.sFromAddress, filter, 3) ||
+        part::stringsMatchI(metadata.sToAddress, filter, 3) ||
+        part::stringsMatchI(metadata.sText, filter, 3)) {
+        return true;
+    }
+    if (metadata.fTextComplete) {
+        return false;
+    }
+    return std::nullopt;
+};
+
 void AddOptions(ArgsManager& argsman)
 {
     argsman.AddArg("-smsg", "Enable secure messaging. (default: true)", ArgsManager::ALLOW_ANY, OptionsCategory::SMSG);
@@ -437,6 +504,7 @@ void AddOptions(ArgsManager& argsman)
     argsman.AddArg("-smsgsaddnewkeys", "Scan for incoming messages on new wallet keys. (default: false)", ArgsManager::ALLOW_ANY, OptionsCategory::SMSG);
     argsman.AddArg("-smsgbantime=<n>", strprintf("Number of seconds to ignore misbehaving peers for (default: %u)", SMSG_DEFAULT_BANTIME), ArgsManager::ALLOW_ANY, OptionsCategory::SMSG);
     argsman.AddArg("-smsgmaxreceive=<n>", strprintf("Max number of data messages to tolerate from peers, counter decreases over time (default: %u)", SMSG_DEFAULT_MAXRCV), ArgsManager::ALLOW_ANY, OptionsCategory::SMSG);
+    argsman.AddArg("-smsgindextext", strprintf("Keep the start of message texts in the encrypted metadata index so filtering can skip decrypting messages (default: %u)", SMSG_DEFAULT_INDEX_TEXT), ArgsManager::ALLOW_ANY, OptionsCategory::SMSG);
     argsman.AddArg("-smsgsregtestadjust", "Adjust durations in regtest (default: true)", ArgsManager::ALLOW_ANY, OptionsCategory::HIDDEN);
     return;
 };
@@ -500,6 +568,7 @@ static void ListenWalletAdded(CSMSG *ps, const std::shared_ptr<wallet::CWallet>&
 void CSMSG::ParseArgs(const ArgsManager& args)
 {
     m_track_funding_txns = args.GetBoolArg("-smsg", true);
+    m_index_text = args.GetBoolArg("-smsgindextext", SMSG_DEFAULT_INDEX_TEXT);
 }
 
 /* Build the bucket set by scanning the files in the smsgstore dir.
@@ -4713,6 +4782,83 @@ int CSMSG::Decrypt(bool fTestOnly, const CKeyID &address, const SecureMessage &s
     return CSMSG::Decrypt(fTestOnly, address, header_buffer, smsg.pPayload, smsg.nPayload, msg);
 };
 
+int CSMSG::GetMetadata(SecMsgDB &db, const uint8_t *chKey, SecMsgMetadata &metadata, uint8_t &status)
+{
+    SecMsgMetadataEntry entry;
+    CKey key;
+    if (db.ReadMetadata(chKey, entry)) {
+        status = entry.status;
+        if (GetLocalKey(entry.addrKey, key) != SMSG_NO_ERROR) {
+            return SMSG_WALLET_NO_KEY;
+        }
+        if (DecryptMetadata(key, entry, metadata)) {
+            return SMSG_NO_ERROR;
+        }
+        LogPrint(BCLog::SMSG, "%s: Rebuilding metadata for %s.\n", __func__, HexStr(Span<const uint8_t>(&chKey[2], 28)));
+    }
+
+    SecMsgStored smsgStored;
+    if (!db.ReadSmesg(chKey, smsgStored)) {
+        return SMSG_GENERAL_ERROR;
+    }
+    status = smsgStored.status;
+    if (smsgStored.vchMessage.size() < SMSG_HDR_LEN) {
+        return SMSG_GENERAL_ERROR;
+    }
+
+    // Received messages are encrypted to addrTo, sent copies to addrOutbox
+    const bool inbox = memcmp(chKey, DBK_INBOX.data(), 2) == 0;
+    const CKeyID &addrKey = inbox ? smsgStored.addrTo : smsgStored.addrOutbox;
+    const uint8_t *pHeader = smsgStored.vchMessage.data();
+    MessageData msg;
+    int rv = Decrypt(false, addrKey, pHeader, pHeader + SMSG_HDR_LEN, smsgStored.vchMessage.size() - SMSG_HDR_LEN, msg);
+    if (rv != SMSG_NO_ERROR) {
+        return rv;
+    }
+
+    metadata.timestamp = msg.timestamp;
+    metadata.sFromAddress = msg.sFromAddress;
+    metadata.sToAddress = EncodeDestination(PKHash(smsgStored.addrTo));
+    metadata.sText.clear();
+    metadata.fTextComplete = false;
+    if (m_index_text) {
+        std::string sText = std::string((char*)msg.vchMessage.data());
+        metadata.fTextComplete = sText.size() <= SMSG_METADATA_TEXT_BYTES;
+        metadata.sText = sText.substr(0, SMSG_METADATA_TEXT_BYTES);
+    }
+
+    entry.status = smsgStored.status;
+    entry.addrKey = addrKey;
+    if (GetLocalKey(addrKey, key) != SMSG_NO_ERROR ||
+        !EncryptMetadata(key, metadata, entry) ||
+        !db.WriteMetadata(chKey, entry)) {
+        LogPrintf("%s: Failed to index message %s.\n", __func__, HexStr(Span<const uint8_t>(&chKey[2], 28)));
+    }
+    return SMSG_NO_ERROR;
+};
+
+bool CSMSG::MatchStored(SecMsgDB &db, const uint8_t *chKey, const SecMsgMetadata &metadata, const std::string &filter)
+{
+    std::optional<bool> match = MatchMetadata(metadata, filter);
+    if (match) {
+        return *match;
+    }
+
+    SecMsgStored smsgStored;
+    if (!db.ReadSmesg(chKey, smsgStored) ||
+        smsgStored.vchMessage.size() < SMSG_HDR_LEN) {
+        return false;
+    }
+    const bool inbox = memcmp(chKey, DBK_INBOX.data(), 2) == 0;
+    const uint8_t *pHeader = smsgStored.vchMessage.data();
+    MessageData msg;
+    if (Decrypt(false, inbox ? smsgStored.addrTo : smsgStored.addrOutbox, pHeader, pHeader + SMSG_HDR_LEN,
+                smsgStored.vchMessage.size() - SMSG_HDR_LEN, msg) != SMSG_NO_ERROR) {
+        return false;
+    }
+    return part::stringsMatchI(std::string((char*)msg.vchMessage.data()), filter, 3);
+};
+
 double GetDifficulty(uint32_t compact)
 {
     int nShift = (compact >> 24) & 0xff;
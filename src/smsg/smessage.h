@@ -20,6 +20,7 @@
 
 
 #include <atomic>
+#include <optional>
 #include <boost/signals2/signal.hpp>
 
 class UniValue;
@@ -96,6 +97,8 @@ const uint32_t SMSG_TIME_LEEWAY    = 24;
 const uint32_t SMSG_TIME_IGNORE    = 90;                // seconds a peer is ignored for if they fail to deliver messages for a smsgWant
 const uint32_t SMSG_DEFAULT_BANTIME = 8 * 60 * 60;
 const uint32_t SMSG_DEFAULT_MAXRCV = 4000;
+const uint32_t SMSG_METADATA_TEXT_BYTES = 256;          // leading message text kept in the metadata index
+const bool SMSG_DEFAULT_INDEX_TEXT  = true;
 
 const uint32_t SMSG_MAX_MSG_BYTES  = 24000;             // the user input part
 const uint32_t SMSG_MAX_AMSG_BYTES = 512;               // the user input part (ANON)
@@ -420,6 +423,42 @@ public:
     };
 };
 
+/** Fields a message is listed and filtered by, stored encrypted in the metadata index */
+class SecMsgMetadata
+{
+public:
+    int64_t              timestamp{0};
+    std::string          sFromAddress;
+    std::string          sToAddress;
+    std::string          sText;          // leading SMSG_METADATA_TEXT_BYTES of the text, empty if not indexed
+    bool                 fTextComplete{false};
+
+    SERIALIZE_METHODS(SecMsgMetadata, obj)
+    {
+        READWRITE(obj.timestamp, obj.sFromAddress, obj.sToAddress, obj.sText, obj.fTextComplete);
+    }
+};
+
+class SecMsgMetadataEntry
+{
+public:
+    uint8_t              status{0};      // copy of SecMsgStored::status, in the clear so marking read needs no key
+    CKeyID               addrKey;        // owned address the encryption key is derived from
+    std::vector<uint8_t> vchIV;
+    std::vector<uint8_t> vchCiphertext;  // serialised SecMsgMetadata
+
+    SERIALIZE_METHODS(SecMsgMetadataEntry, obj)
+    {
+        READWRITE(obj.status, obj.addrKey, obj.vchIV, obj.vchCiphertext);
+    }
+};
+
+bool EncryptMetadata(const CKey &key, const SecMsgMetadata &metadata, SecMsgMetadataEntry &entry);
+bool DecryptMetadata(const CKey &key, const SecMsgMetadataEntry &entry, SecMsgMetadata &metadata);
+
+/** Match filter against from, to and the indexed text, nullopt if only the full text can decide */
+std::optional<bool> MatchMetadata(const SecMsgMetadata &metadata, const std::string &filter);
+
 void AddOptions(ArgsManager& argsman);
 const char *GetString(size_t errorCode);
 
@@ -536,6 +575,11 @@ public:
     int Decrypt(bool fTestOnly, const CKeyID &address, const uint8_t *pHeader, const uint8_t *pPayload, uint32_t nPayload, MessageData &msg);
     int Decrypt(bool fTestOnly, const CKeyID &address, const SecureMessage &smsg, MessageData &msg);
 
+    /** Read the metadata of a stored message, decrypting and indexing the message if it has no entry */
+    int GetMetadata(SecMsgDB &db, const uint8_t *chKey, SecMsgMetadata &metadata, uint8_t &status);
+    /** Match filter against a stored message, the message is decrypted only if its indexed text is incomplete */
+    bool MatchStored(SecMsgDB &db, const uint8_t *chKey, const SecMsgMetadata &metadata, const std::string &filter);
+
     RecursiveMutex cs_smsg; // All except inbox and outbox
 
     SecMsgKeyStore keyStore;
@@ -562,6 +606,7 @@ public:
     std::thread thread_smsg_pow;
 
     bool m_track_funding_txns{false};
+    bool m_index_text{SMSG_DEFAULT_INDEX_TEXT};
     leveldb::WriteBatch *m_connect_block_batch{nullptr};
     SecMsgDB m_chain_sync_db;
 
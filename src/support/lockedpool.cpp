@@ -293,6 +293,28 @@ void* LockedPool::alloc(size_t size)
     if (size == 0 || size > ARENA_SIZE)
         return nullptr;
 
+    for (size_t c = 0; c < std::size(SLAB_CLASSES); ++c) {
+        if (size <= SLAB_CLASSES[c]) {
+            if (void *addr = alloc_slab(c)) {
+                return addr;
+            }
+            break;
+        }
+    }
+    return alloc_arena(size);
+}
+
+void LockedPool::free(void *ptr)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free_slab(ptr)) {
+        return;
+    }
+    free_arena(ptr);
+}
+
+void* LockedPool::alloc_arena(size_t size)
+{
     // Try allocating from each current arena
     for (auto &arena: arenas) {
         void *addr = arena.alloc(size);
@@ -307,9 +329,8 @@ void* LockedPool::alloc(size_t size)
     return nullptr;
 }
 
-void LockedPool::free(void *ptr)
+void LockedPool::free_arena(void *ptr)
 {
-    std::lock_guard<std::mutex> lock(mutex);
     // TODO we can do better than this linear search by keeping a map of arena
     // extents to arena, and looking up the address.
     for (auto &arena: arenas) {
@@ -321,6 +342,73 @@ void LockedPool::free(void *ptr)
     throw std::runtime_error("LockedPool: invalid address not pointing to any arena");
 }
 
+void* LockedPool::alloc_slab(size_t size_class)
+{
+    std::set<char*> &partial = slabs_partial[size_class];
+    if (partial.empty()) {
+        char *base = static_cast<char*>(alloc_arena(SLAB_SIZE));
+        if (!base) {
+            return nullptr;
+        }
+        const size_t slot_size = SLAB_CLASSES[size_class];
+        const size_t num_slots = SLAB_SIZE / slot_size;
+        Slab &slab = slabs[base];
+        slab.slot_size = slot_size;
+        slab.size_class = size_class;
+        slab.in_use.assign(num_slots, false);
+        slab.free_slots.reserve(num_slots);
+        // Hand out the lowest addresses first
+        for (size_t i = num_slots; i-- > 0;) {
+            slab.free_slots.push_back(i);
+        }
+        partial.insert(base);
+    }
+    // Fill the lowest slab first so the higher ones can drain and be released
+    char *base = *partial.begin();
+    Slab &slab = slabs.find(base)->second;
+    const size_t slot = slab.free_slots.back();
+    slab.free_slots.pop_back();
+    slab.in_use[slot] = true;
+    if (slab.free_slots.empty()) {
+        partial.erase(partial.begin());
+    }
+    return base + slot * slab.slot_size;
+}
+
+bool LockedPool::free_slab(void *ptr)
+{
+    char *p = static_cast<char*>(ptr);
+    auto it = slabs.upper_bound(p);
+    if (it == slabs.begin()) {
+        return false;
+    }
+    --it;
+    char *base = it->first;
+    Slab &slab = it->second;
+    if (p >= base + SLAB_SIZE) {
+        return false;
+    }
+    const size_t offset = p - base;
+    const size_t slot = offset / slab.slot_size;
+    if (offset % slab.slot_size != 0 || !slab.in_use[slot]) {
+        throw std::runtime_error("LockedPool: invalid or double free of slab slot");
+    }
+    slab.in_use[slot] = false;
+    slab.free_slots.push_back(slot);
+
+    std::set<char*> &partial = slabs_partial[slab.size_class];
+    if (slab.free_slots.size() == 1) {
+        partial.insert(base);
+    } else if (slab.free_slots.size() == slab.in_use.size() && partial.size() > 1) {
+        // Keep one empty slab per class around to avoid churning the arena,
+        // release the others
+        partial.erase(base);
+        slabs.erase(it);
+        free_arena(base);
+    }
+    return true;
+}
+
 LockedPool::Stats LockedPool::stats() const
 {
     std::lock_guard<std::mutex> lock(mutex);
@@ -333,6 +421,16 @@ LockedPool::Stats LockedPool::stats() const
         r.chunks_used += i.chunks_used;
         r.chunks_free += i.chunks_free;
     }
+    // Report the slots of slabs rather than the slabs themselves
+    for (const auto &[base, slab]: slabs) {
+        const size_t slots_free = slab.free_slots.size();
+        const size_t slots_used = slab.in_use.size() - slots_free;
+        r.used -= slots_free * slab.slot_size;
+        r.free += slots_free * slab.slot_size;
+        r.chunks_used += slots_used;
+        r.chunks_used -= 1;
+        r.chunks_free += slots_free;
+    }
     return r;
 }
 
@@ -6,11 +6,14 @@
 #define GLOBE_SUPPORT_LOCKEDPOOL_H
 
 #include <stdint.h>
+#include <iterator>
 #include <list>
 #include <map>
 #include <mutex>
 #include <memory>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 /**
  * OS-dependent allocation and deallocation of locked/pinned memory pages.
@@ -136,6 +139,13 @@ public:
      * memory, setting it too low will facilitate fragmentation.
      */
     static const size_t ARENA_ALIGN = 16;
+    /** Size of the chunks carved into equally sized slots for small
+     * allocations. Keys, blinding factors and keying material are 32 or 64
+     * bytes, and are served from these slabs without touching the arena maps.
+     */
+    static const size_t SLAB_SIZE = 4096;
+    /** Slot sizes of the slab classes; requests up to the largest use a slab. */
+    static constexpr size_t SLAB_CLASSES[] = {32, 64};
 
     /** Callback when allocation succeeds but locking fails.
      */
@@ -194,9 +204,31 @@ private:
         LockedPageAllocator *allocator;
     };
 
+    /** A chunk of one arena divided into slots of slot_size bytes.
+     * The bookkeeping lives outside the locked memory, as for arenas.
+     */
+    struct Slab
+    {
+        size_t slot_size;
+        size_t size_class;
+        /** Indices of the free slots, the next allocation pops the back */
+        std::vector<uint16_t> free_slots;
+        std::vector<bool> in_use;
+    };
+
     bool new_arena(size_t size, size_t align);
+    /** Allocate from the first arena with room, adding an arena if none has */
+    void* alloc_arena(size_t size);
+    void free_arena(void *ptr);
+    void* alloc_slab(size_t size_class);
+    /** Free ptr if it points into a slab, return false if it does not */
+    bool free_slab(void *ptr);
 
     std::list<LockedPageArena> arenas;
+    /** Slabs by base address */
+    std::map<char*, Slab> slabs;
+    /** Base addresses of the slabs with free slots, per size class */
+    std::set<char*> slabs_partial[std::size(SLAB_CLASSES)];
     LockingFailed_Callback lf_cb;
     size_t cumulative_bytes_locked;
     /** Mutex protects access to this pool's data structures, including arenas.
@@ -208,6 +208,47 @@ BOOST_AUTO_TEST_CASE(lockedpool_tests_mock)
     BOOST_CHECK(pool.stats().used == 0);
 }
 
+BOOST_AUTO_TEST_CASE(lockedpool_tests_slabs)
+{
+    std::unique_ptr<LockedPageAllocator> x = std::make_unique<TestLockedPageAllocator>(1, 1);
+    LockedPool pool(std::move(x));
+
+    // Small allocations share a slab of their size class
+    const size_t slots32 = LockedPool::SLAB_SIZE / 32;
+    std::vector<void*> keys;
+    for (size_t i = 0; i < slots32; ++i) {
+        void *p = pool.alloc(32);
+        BOOST_CHECK(p);
+        keys.push_back(p);
+        BOOST_CHECK_EQUAL(static_cast<char*>(p) - static_cast<char*>(keys[0]), ptrdiff_t(i * 32));
+    }
+
+    // Double frees of slots are detected, a freed slot is handed out again
+    pool.free(keys[3]);
+    BOOST_CHECK_THROW(pool.free(keys[3]), std::runtime_error);
+    BOOST_CHECK_THROW(pool.free(static_cast<char*>(keys[4]) + 16), std::runtime_error);
+    BOOST_CHECK(pool.alloc(17) == keys[3]);
+
+    // A full slab makes room for another
+    keys.push_back(pool.alloc(32));
+    BOOST_CHECK(keys.back());
+    void *k64 = pool.alloc(40);
+    BOOST_CHECK(k64);
+    void *big = pool.alloc(1000);
+    BOOST_CHECK(big);
+    BOOST_CHECK_EQUAL(pool.stats().used, (slots32 + 1) * 32 + 64 + 1008);
+    BOOST_CHECK_EQUAL(pool.stats().chunks_used, slots32 + 1 + 1 + 1);
+
+    for (void *p: keys) {
+        pool.free(p);
+    }
+    pool.free(k64);
+    pool.free(big);
+    BOOST_CHECK_EQUAL(pool.stats().used, 0U);
+    BOOST_CHECK(pool.stats().free == LockedPool::ARENA_SIZE);
+    BOOST_CHECK_EQUAL(pool.stats().chunks_used, 0U);
+}
+
 // These tests used the live LockedPoolManager object, this is also used
 // by other tests so the conditions are somewhat less controllable and thus the
 // tests are somewhat more error-prone.
@@ -8,8 +8,10 @@
 
 #include <chain.h>
 #include <rpc/blockchain.h>
+#include <streams.h>
 #include <test/util/setup_common.h>
 #include <util/string.h>
+#include <version.h>
 
 /* Equality between doubles is imprecise. Comparison should be done
  * with a small threshold of tolerance, rather than exact equality.
@@ -74,4 +76,45 @@ BOOST_AUTO_TEST_CASE(get_difficulty_for_very_high_target)
     TestDifficulty(0x12345678, 5913134931067755359633408.0);
 }
 
+BOOST_AUTO_TEST_CASE(block_index_cold_stake)
+{
+    CBlockIndexStake stake;
+    stake.bnStakeModifier = uint256::ONE;
+    stake.prevoutStake = COutPoint(uint256::ONE, 2);
+
+    CBlockIndex hot;
+    BOOST_CHECK(hot.GetStakeModifier().IsNull());
+    BOOST_CHECK(!hot.HasStakeInMemory());
+    hot.SetPrevoutStake(stake.prevoutStake);
+    hot.SetStakeModifier(stake.bnStakeModifier);
+    BOOST_CHECK(hot.HasStakeInMemory());
+
+    // The disk format is unchanged
+    CDataStream stream(SER_DISK, CLIENT_VERSION);
+    stream << CDiskBlockIndex{&hot};
+    CDiskBlockIndex diskindex;
+    stream >> diskindex;
+    BOOST_CHECK(diskindex.stake.bnStakeModifier == stake.bnStakeModifier);
+    BOOST_CHECK(diskindex.stake.prevoutStake == stake.prevoutStake);
+
+    int reads{0};
+    g_read_cold_block_stake = [&](const CBlockIndex&, CBlockIndexStake& out) {
+        reads++;
+        out = stake;
+        return true;
+    };
+    const uint256 hash{uint256::ONE};
+    CBlockIndex cold;
+    cold.phashBlock = &hash;
+    cold.SetStakeCold();
+    BOOST_CHECK(!cold.HasStakeInMemory());
+    BOOST_CHECK(cold.GetStakeModifier() == stake.bnStakeModifier);
+    BOOST_CHECK(cold.GetPrevoutStake() == stake.prevoutStake);
+    BOOST_CHECK_EQUAL(reads, 2);
+
+    g_read_cold_block_stake = [](const CBlockIndex&, CBlockIndexStake&) { return false; };
+    BOOST_CHECK_THROW(cold.GetStakeModifier(), std::runtime_error);
+    g_read_cold_block_stake = nullptr;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -304,6 +304,114 @@ BOOST_AUTO_TEST_CASE(EmptyBlockRoundTripTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(PrefillPredicateRoundTripTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    CBlock block(BuildBlockTestCase());
+
+    LOCK2(cs_main, pool.cs);
+    {
+        CBlockHeaderAndShortTxIDs shortIDs{block, [&](const CTransaction& tx) {
+            return tx.GetHash() == block.vtx[2]->GetHash();
+        }};
+        BOOST_CHECK_EQUAL(shortIDs.BlockTxCount(), 3U);
+
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << shortIDs;
+
+        CBlockHeaderAndShortTxIDs shortIDs2;
+        stream >> shortIDs2;
+
+        PartiallyDownloadedBlock partialBlock(&pool);
+        BOOST_CHECK(partialBlock.InitData(shortIDs2, extra_txn) == READ_STATUS_OK);
+        BOOST_CHECK( partialBlock.IsTxAvailable(0));
+        BOOST_CHECK(!partialBlock.IsTxAvailable(1));
+        BOOST_CHECK( partialBlock.IsTxAvailable(2));
+        BOOST_CHECK_EQUAL(partialBlock.PrefilledCount(), 2U);
+        BOOST_CHECK_EQUAL(partialBlock.MempoolCount(), 0U);
+
+        CBlock block2;
+        BOOST_CHECK(partialBlock.FillBlock(block2, {block.vtx[1]}) == READ_STATUS_OK);
+        BOOST_CHECK_EQUAL(block.GetHash().ToString(), block2.GetHash().ToString());
+    }
+}
+
+static CTransactionRef MakeExtraTxnTestTx(bool blinded, size_t script_size)
+{
+    CMutableTransaction tx;
+    tx.nVersion = GLOBE_TXN_VERSION;
+    tx.vin.resize(1);
+    tx.vin[0].prevout.hash = InsecureRand256();
+    tx.vin[0].scriptSig.resize(script_size);
+    if (blinded) {
+        tx.vpout.push_back(MAKE_OUTPUT<CTxOutCT>());
+    } else {
+        tx.vpout.push_back(MAKE_OUTPUT<CTxOutStandard>());
+    }
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(ExtraTxnPoolTest)
+{
+    const CTransactionRef plain_a = MakeExtraTxnTestTx(false, 100);
+    const CTransactionRef blinded_a = MakeExtraTxnTestTx(true, 1000);
+    const CTransactionRef plain_b = MakeExtraTxnTestTx(false, 100);
+    const CTransactionRef blinded_b = MakeExtraTxnTestTx(true, 1000);
+    BOOST_CHECK(!HasBlindedData(*plain_a));
+    BOOST_CHECK(HasBlindedData(*blinded_a));
+
+    const auto contains = [](const ExtraTxnPool& pool, const CTransactionRef& tx) {
+        for (const auto& entry : pool.Txns()) {
+            if (entry.first == tx->GetWitnessHash()) return true;
+        }
+        return false;
+    };
+
+    // Count limit, plain transactions are dropped before older blinded ones
+    {
+        ExtraTxnPool pool(3, 1000000);
+        pool.Add(blinded_a);
+        pool.Add(plain_a);
+        pool.Add(plain_b);
+        pool.Add(blinded_b);
+        BOOST_CHECK_EQUAL(pool.Size(), 3U);
+        BOOST_CHECK(contains(pool, blinded_a));
+        BOOST_CHECK(!contains(pool, plain_a));
+        BOOST_CHECK(contains(pool, plain_b));
+        BOOST_CHECK(contains(pool, blinded_b));
+        BOOST_CHECK_EQUAL(pool.Bytes(), blinded_a->GetTotalSize() + plain_b->GetTotalSize() + blinded_b->GetTotalSize());
+    }
+
+    // Size limit, with only blinded transactions left the oldest goes
+    {
+        const size_t max_bytes = blinded_a->GetTotalSize() + blinded_b->GetTotalSize() + plain_a->GetTotalSize() / 2;
+        ExtraTxnPool pool(100, max_bytes);
+        pool.Add(blinded_a);
+        pool.Add(blinded_b);
+        pool.Add(plain_a);
+        BOOST_CHECK_EQUAL(pool.Size(), 2U);
+        BOOST_CHECK(!contains(pool, plain_a));
+
+        const CTransactionRef blinded_c = MakeExtraTxnTestTx(true, 1000);
+        pool.Add(blinded_c);
+        BOOST_CHECK_EQUAL(pool.Size(), 2U);
+        BOOST_CHECK(!contains(pool, blinded_a));
+        BOOST_CHECK(contains(pool, blinded_c));
+        BOOST_CHECK(pool.Bytes() <= max_bytes);
+    }
+
+    // Disabled pools and transactions larger than the whole budget keep nothing
+    {
+        ExtraTxnPool pool(0, 1000000);
+        pool.Add(plain_a);
+        BOOST_CHECK_EQUAL(pool.Size(), 0U);
+        ExtraTxnPool small_pool(100, 10);
+        small_pool.Add(plain_a);
+        BOOST_CHECK_EQUAL(small_pool.Size(), 0U);
+        BOOST_CHECK_EQUAL(small_pool.Bytes(), 0U);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = InsecureRand256();
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <blind.h>
 #include <chainparams.h>
 #include <index/coinstatsindex.h>
 #include <interfaces/chain.h>
@@ -11,6 +12,8 @@
 #include <util/time.h>
 #include <validation.h>
 
+#include <secp256k1_rangeproof.h>
+
 #include <boost/test/unit_test.hpp>
 
 #include <chrono>
@@ -122,4 +125,73 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(coinstats_parallel_ranges, TestChain100Setup)
+{
+    Chainstate& chainstate = Assert(m_node.chainman)->ActiveChainstate();
+    CCoinsView* view;
+    {
+        LOCK(cs_main);
+        chainstate.ForceFlushStateToDisk();
+        view = &chainstate.CoinsDB();
+    }
+
+    const auto single{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, view, chainstate.m_blockman, {}, /*max_threads=*/1)};
+    BOOST_REQUIRE(single);
+    BOOST_CHECK(single->coins_count > 0);
+
+    // Ranges of any size add up to the same statistics
+    for (const int threads : {2, 3, 16}) {
+        const auto parallel{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, view, chainstate.m_blockman, {}, threads)};
+        BOOST_REQUIRE(parallel);
+        BOOST_CHECK_EQUAL(parallel->hashSerialized, single->hashSerialized);
+        BOOST_CHECK_EQUAL(parallel->coins_count, single->coins_count);
+        BOOST_CHECK_EQUAL(parallel->nTransactions, single->nTransactions);
+        BOOST_CHECK_EQUAL(parallel->nTransactionOutputs, single->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(parallel->nBlindTransactionOutputs, single->nBlindTransactionOutputs);
+        BOOST_CHECK_EQUAL(parallel->nBogoSize, single->nBogoSize);
+        BOOST_CHECK(parallel->total_amount == single->total_amount);
+    }
+
+    CoinStatsIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Start());
+    IndexWaitSynced(index);
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip())};
+    const auto indexed{index.LookUpStats(*tip)};
+    BOOST_REQUIRE(indexed);
+    BOOST_CHECK_EQUAL(indexed->hashSerialized, single->hashSerialized);
+    BOOST_CHECK_EQUAL(indexed->nTransactionOutputs, single->nTransactionOutputs);
+    BOOST_CHECK_EQUAL(indexed->nBlindTransactionOutputs, single->nBlindTransactionOutputs);
+    index.Stop();
+
+    // Blinded outputs spread over all ranges sum to the same commitment, the
+    // serial sum takes more than one batch of commitments
+    constexpr int NUM_BLINDED{3000};
+    {
+        LOCK(cs_main);
+        CCoinsViewCache& coins_tip = chainstate.CoinsTip();
+        for (int i = 0; i < NUM_BLINDED; ++i) {
+            Coin coin;
+            coin.nType = OUTPUT_CT;
+            coin.nHeight = 1;
+            coin.out.scriptPubKey = CScript() << OP_TRUE;
+            const uint256 blind = InsecureRand256();
+            BOOST_REQUIRE(secp256k1_pedersen_commit(secp256k1_ctx_blind, &coin.commitment, blind.begin(), InsecureRandRange(COIN), &secp256k1_generator_const_h, &secp256k1_generator_const_g));
+            coins_tip.AddCoin(COutPoint(InsecureRand256(), 0), std::move(coin), /*possible_overwrite=*/false);
+        }
+        chainstate.ForceFlushStateToDisk();
+    }
+    const auto blinded_single{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, view, chainstate.m_blockman, {}, /*max_threads=*/1)};
+    BOOST_REQUIRE(blinded_single);
+    BOOST_CHECK_EQUAL(blinded_single->nBlindTransactionOutputs, single->nBlindTransactionOutputs + NUM_BLINDED);
+    BOOST_REQUIRE(blinded_single->blind_commitment_sum);
+    for (const int threads : {2, 3, 16}) {
+        const auto parallel{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, view, chainstate.m_blockman, {}, threads)};
+        BOOST_REQUIRE(parallel);
+        BOOST_CHECK_EQUAL(parallel->hashSerialized, blinded_single->hashSerialized);
+        BOOST_CHECK_EQUAL(parallel->nBlindTransactionOutputs, blinded_single->nBlindTransactionOutputs);
+        BOOST_REQUIRE(parallel->blind_commitment_sum);
+        BOOST_CHECK(memcmp(parallel->blind_commitment_sum->data, blinded_single->blind_commitment_sum->data, sizeof(secp256k1_pedersen_commitment)) == 0);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include <blind.h>
+#include <consensus/params.h>
+
+#include <algorithm>
+#include <limits>
 
 BOOST_FIXTURE_TEST_SUITE(ct_tests, BasicTestingSetup)
 
@@ -313,4 +317,51 @@ BOOST_AUTO_TEST_CASE(ct_commitment_test)
     secp256k1_context_destroy(ctx);
 }
 
+BOOST_AUTO_TEST_CASE(blinded_output_lists)
+{
+    Consensus::Params params;
+    params.exploit_fix_3_time = 100;
+
+    // Unsorted with duplicates, as in chain/tx_blacklist.h
+    int64_t blacklist[] = {5735, 2221, 8170, 5735, 64, 63, 2221};
+    LoadRCTBlacklist(blacklist, std::size(blacklist));
+    for (int64_t i = -5; i < 9000; ++i) {
+        bool expect = std::find(std::begin(blacklist), std::end(blacklist), i) != std::end(blacklist);
+        BOOST_CHECK_EQUAL(IsBlacklistedAnonOutput(i), expect);
+    }
+    BOOST_CHECK(!IsBlacklistedAnonOutput(std::numeric_limits<int64_t>::min()));
+    BOOST_CHECK(!IsBlacklistedAnonOutput(std::numeric_limits<int64_t>::max()));
+
+    // Sparse set
+    int64_t sparse[] = {std::numeric_limits<int64_t>::max(), 7, -1};
+    LoadRCTBlacklist(sparse, std::size(sparse));
+    BOOST_CHECK(IsBlacklistedAnonOutput(std::numeric_limits<int64_t>::max()));
+    BOOST_CHECK(IsBlacklistedAnonOutput(7));
+    BOOST_CHECK(IsBlacklistedAnonOutput(-1));
+    BOOST_CHECK(!IsBlacklistedAnonOutput(0));
+
+    // Spanning the whole int64 range
+    int64_t full_range[] = {std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()};
+    LoadRCTBlacklist(full_range, std::size(full_range));
+    BOOST_CHECK(IsBlacklistedAnonOutput(std::numeric_limits<int64_t>::min()));
+    BOOST_CHECK(IsBlacklistedAnonOutput(std::numeric_limits<int64_t>::max()));
+    BOOST_CHECK(!IsBlacklistedAnonOutput(0));
+
+    LoadRCTBlacklist(nullptr, 0);
+    BOOST_CHECK(!IsBlacklistedAnonOutput(0));
+    BOOST_CHECK(!IsBlacklistedAnonOutput(7));
+
+    int64_t whitelist[] = {10, 12};
+    int64_t whitelist2[] = {11};
+    LoadRCTWhitelist(whitelist, std::size(whitelist), 1);
+    LoadRCTWhitelist(whitelist2, std::size(whitelist2), 2);
+    BOOST_CHECK(IsWhitelistedAnonOutput(10, 0, params));
+    BOOST_CHECK(!IsWhitelistedAnonOutput(11, 0, params));
+    BOOST_CHECK(IsWhitelistedAnonOutput(11, 100, params));
+    BOOST_CHECK(IsWhitelistedAnonOutput(12, 100, params));
+    BOOST_CHECK(!IsWhitelistedAnonOutput(13, 100, params));
+
+    LoadBlindedOutputFilters();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
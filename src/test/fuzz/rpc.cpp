@@ -141,6 +141,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrpcinfo",
     "gettxout",
     "gettxoutsetinfo",
+    "getvalidationqueueinfo",
     "help",
     "invalidateblock",
     "joinpsbts",
@@ -11,6 +11,7 @@
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -256,4 +257,52 @@ BOOST_FIXTURE_TEST_CASE(logging_Conf, LogSetup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(logging_async, LogSetup)
+{
+    const size_t prev_buffer_size = LogInstance().m_async_buffer_size;
+    LogInstance().m_async_buffer_size = 1 << 16;
+    LogInstance().StartAsyncWriter();
+
+    constexpr int NUM_THREADS{4}, NUM_MESSAGES{100};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < NUM_MESSAGES; ++i) {
+                LogPrintf("async %d %d\n", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    LogInstance().StopAsyncWriter();
+
+    std::ifstream file{tmp_log_path};
+    std::vector<int> next_expected(NUM_THREADS, 0);
+    int num_found = 0;
+    for (std::string log; std::getline(file, log);) {
+        int t, i;
+        if (sscanf(log.c_str(), "async %d %d", &t, &i) != 2) continue;
+        BOOST_REQUIRE(t >= 0 && t < NUM_THREADS);
+        // Messages from one thread must keep their order
+        BOOST_CHECK_EQUAL(i, next_expected[t]++);
+        num_found++;
+    }
+    BOOST_CHECK_EQUAL(num_found, NUM_THREADS * NUM_MESSAGES);
+
+    // Messages that can't fit in the buffer are dropped and counted
+    LogInstance().m_async_buffer_size = 64;
+    LogInstance().StartAsyncWriter();
+    const uint64_t dropped_before = LogInstance().AsyncDroppedCount();
+    std::thread([] {
+        for (int i = 0; i < 10; ++i) {
+            LogPrintf("async message longer than the sixty four byte ring buffer capacity\n");
+        }
+    }).join();
+    LogInstance().StopAsyncWriter();
+    BOOST_CHECK_EQUAL(LogInstance().AsyncDroppedCount() - dropped_before, 10U);
+
+    LogInstance().m_async_buffer_size = prev_buffer_size;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -349,4 +349,66 @@ BOOST_AUTO_TEST_CASE(merkle_test_BlockWitness)
 
     BOOST_CHECK_EQUAL(merkleRootofHashes, blockWitness);
 }
+
+BOOST_AUTO_TEST_CASE(merkle_test_MerkleTree)
+{
+    BOOST_CHECK_EQUAL(MerkleTree(std::vector<uint256>{}).Root(), uint256());
+    for (int ntx = 1; ntx <= 65; ntx += (ntx < 17 ? 1 : 8)) {
+        std::vector<uint256> leaves(ntx), witness_leaves(ntx);
+        for (int i = 0; i < ntx; i++) {
+            leaves[i] = InsecureRand256();
+            witness_leaves[i] = InsecureRand256();
+        }
+        MerkleTree tree(leaves), witness_tree(witness_leaves);
+        BOOST_CHECK_EQUAL(tree.Root(), ComputeMerkleRoot(leaves));
+
+        for (int i = 0; i < 4; i++) {
+            const size_t pos = InsecureRandRange(ntx);
+            leaves[pos] = InsecureRand256();
+            tree.Update(pos, leaves[pos]);
+            BOOST_CHECK_EQUAL(tree.Root(), ComputeMerkleRoot(leaves));
+
+            // Both trees are rehashed together
+            const size_t last = ntx - 1;
+            leaves[last] = InsecureRand256();
+            witness_leaves[last] = InsecureRand256();
+            MerkleTree::Update({{&tree, leaves[last]}, {&witness_tree, witness_leaves[last]}}, last);
+            BOOST_CHECK_EQUAL(tree.Root(), ComputeMerkleRoot(leaves));
+            BOOST_CHECK_EQUAL(witness_tree.Root(), ComputeMerkleRoot(witness_leaves));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_test_BlockMerkleTrees)
+{
+    CBlock block;
+    block.vtx.resize(7);
+    for (std::size_t pos = 0; pos < block.vtx.size(); pos++) {
+        CMutableTransaction mtx;
+        mtx.nLockTime = pos;
+        block.vtx[pos] = MakeTransactionRef(std::move(mtx));
+    }
+
+    for (int32_t version : {int32_t{GLOBE_BLOCK_VERSION}, 4}) {
+        block.nVersion = version;
+        BlockMerkleTrees trees(block);
+        BOOST_CHECK_EQUAL(trees.MerkleRoot(), BlockMerkleRoot(block));
+        BOOST_CHECK_EQUAL(trees.WitnessMerkleRoot(), BlockWitnessMerkleRoot(block));
+
+        CMutableTransaction mtx;
+        mtx.nLockTime = 100;
+        block.vtx[0] = MakeTransactionRef(std::move(mtx));
+        BOOST_CHECK(trees.Matches(block));
+        trees.UpdateFirst(block);
+        BOOST_CHECK_EQUAL(trees.MerkleRoot(), BlockMerkleRoot(block));
+        BOOST_CHECK_EQUAL(trees.WitnessMerkleRoot(), BlockWitnessMerkleRoot(block));
+
+        CBlock other = block;
+        other.vtx.pop_back();
+        BOOST_CHECK(!trees.Matches(other));
+        other = block;
+        other.nVersion = version + 1;
+        BOOST_CHECK(!trees.Matches(other));
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,15 +5,20 @@
 #include <test/util/setup_common.h>
 #include <test/data/ringct.json.h>
 
+#include <anon.h>
 #include <crypto/sha256.h>
 #include <key/stealth.h>
+#include <rctindex.h>
+#include <streams.h>
 #include <util/strencodings.h>
+#include <version.h>
 
 #include <secp256k1.h>
 #include <secp256k1_rangeproof.h>
 #include <secp256k1_mlsag.h>
 #include <stdint.h>
 #include <univalue.h>
+#include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -756,9 +761,76 @@ BOOST_AUTO_TEST_CASE(ringct_test_deterministic)
                  .Finalize(result_hash);
 
         BOOST_CHECK(memcmp(expect_hash.data(), result_hash, 32) == 0);
+
+        // Same signature from precomputed key image bases
+        std::vector<uint8_t> bases(cols * (rows - 1) * 64);
+        std::vector<const uint8_t*> hp(cols * (rows - 1));
+        for (size_t i = 0; i < hp.size(); ++i) {
+            BOOST_CHECK(0 == secp256k1_get_keyimage_base(&bases[i * 64], &pubkey_matrix[i * 33]));
+            hp[i] = &bases[i * 64];
+        }
+        BOOST_CHECK(0 == secp256k1_generate_mlsag_hp(ctx, ki.data(), sigc, sigs.data(),
+            nonce.data(), preimage.data(), cols, rows, real_column,
+            &sk[0], pubkey_matrix.data(), hp.data()));
+        CSHA256().Write(ki.data(), ki.size())
+                 .Write(sigc, 32)
+                 .Write(sigs.data(), sigs.size())
+                 .Finalize(result_hash);
+        BOOST_CHECK(memcmp(expect_hash.data(), result_hash, 32) == 0);
+        BOOST_CHECK(0 == secp256k1_verify_mlsag_hp(preimage.data(), cols, rows,
+            pubkey_matrix.data(), hp.data(), ki.data(), sigc, sigs.data()));
     }
 
     secp256k1_context_destroy(ctx);
 }
 
+BOOST_AUTO_TEST_CASE(ringct_test_anon_output_record)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pk = key.GetPubKey();
+    COutPoint op(uint256::ONE, 1);
+    secp256k1_pedersen_commitment commitment;
+    memset(commitment.data, 0x08, 33);
+    CAnonOutput ao(CCmpPubKey(pk.begin(), pk.end()), commitment, op, 100, 0);
+
+    // Records written before the key image base was stored read without it
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << ao;
+    CAnonOutput ao_read;
+    ao_read.key_image_base = std::array<uint8_t, 64>{};
+    ss >> Using<AnonOutputDBFormatter>(ao_read);
+    BOOST_CHECK(!ao_read.key_image_base);
+    BOOST_CHECK(ao_read.pubkey == ao.pubkey);
+    BOOST_CHECK_EQUAL(ao_read.nBlockHeight, 100);
+
+    BOOST_REQUIRE(SetKeyImageBase(ao));
+    ss << Using<AnonOutputDBFormatter>(ao);
+    ss >> Using<AnonOutputDBFormatter>(ao_read);
+    BOOST_REQUIRE(ao_read.key_image_base);
+    BOOST_CHECK(*ao_read.key_image_base == *ao.key_image_base);
+    BOOST_CHECK(ss.empty());
+
+    // The wallet cache keeps the plain serialization
+    ss << ao;
+    BOOST_CHECK_EQUAL(ss.size(), 33U + 33U + 36U + 4U + 1U);
+}
+
+BOOST_AUTO_TEST_CASE(ringct_test_prevalidation_cache)
+{
+    secp256k1_pedersen_commitment commitment;
+    memset(commitment.data, 0x08, sizeof(commitment.data));
+    std::vector<uint8_t> proof(64, 0x01);
+
+    const uint256 entry = RangeProofCacheEntry(commitment, proof, /*bulletproof=*/true);
+    BOOST_CHECK(entry != RangeProofCacheEntry(commitment, proof, /*bulletproof=*/false));
+    proof[0] = 0x02;
+    BOOST_CHECK(entry != RangeProofCacheEntry(commitment, proof, /*bulletproof=*/true));
+
+    BOOST_CHECK(!PrevalidationCacheContains(entry, /*erase=*/false));
+    PrevalidationCacheInsert(entry);
+    BOOST_CHECK(PrevalidationCacheContains(entry, /*erase=*/false));
+    BOOST_CHECK(PrevalidationCacheContains(entry, /*erase=*/true));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
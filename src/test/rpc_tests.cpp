@@ -4,6 +4,7 @@
 
 #include <core_io.h>
 #include <interfaces/chain.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
 #include <rpc/client.h>
@@ -243,6 +244,28 @@ BOOST_AUTO_TEST_CASE(json_parse_errors)
     BOOST_CHECK_THROW(ParseNonRFCJSONValue("3J98t1WpEZ73CNmQviecrnyiWrnqRhWNL"), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_getblock_proofs)
+{
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const std::string hash{tip->GetBlockHash().GetHex()};
+
+    UniValue full = CallRPC("getblock " + hash + " 2");
+    BOOST_CHECK(find_value(full["tx"][0], "hex").isStr());
+    UniValue omitted = CallRPC("getblock " + hash + " 2 false omit");
+    BOOST_CHECK(find_value(omitted["tx"][0], "hex").isNull());
+    BOOST_CHECK_EQUAL(find_value(omitted["tx"][0], "txid").get_str(), find_value(full["tx"][0], "txid").get_str());
+    BOOST_CHECK_THROW(CallRPC("getblock " + hash + " 2 false all"), std::runtime_error);
+
+    // The text built without a UniValue tree matches the document
+    CBlock block;
+    BOOST_REQUIRE(node::ReadBlockFromDisk(block, tip, Params().GetConsensus()));
+    for (const TxProofDetail proofs : {TxProofDetail::FULL, TxProofDetail::TRUNCATED, TxProofDetail::OMITTED}) {
+        std::string str;
+        blockToJSONString(m_node.chainman->m_blockman, block, tip, tip, TxVerbosity::SHOW_DETAILS, /*coinstakeDetails=*/true, proofs, str);
+        BOOST_CHECK_EQUAL(str, blockToJSON(m_node.chainman->m_blockman, block, tip, tip, TxVerbosity::SHOW_DETAILS, /*coinstakeDetails=*/true, proofs).write());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(rpc_ban)
 {
     BOOST_CHECK_NO_THROW(CallRPC(std::string("clearbanned")));
@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <smsg/smessage.h>
+#include <smsg/crypter.h>
+#include <smsg/db.h>
 
 #include <test/util/setup_common.h>
 #include <net.h>
@@ -129,6 +131,119 @@ BOOST_AUTO_TEST_CASE(smsg_test)
 
     smsgModule.Shutdown();
 }
+
+BOOST_AUTO_TEST_CASE(smsg_test_metadata)
+{
+    CKey key, key_other;
+    key.MakeNewKey(true);
+    key_other.MakeNewKey(true);
+
+    smsg::SecMsgMetadata metadata;
+    metadata.timestamp = 1700000000;
+    metadata.sFromAddress = EncodeDestination(PKHash(key.GetPubKey().GetID()));
+    metadata.sToAddress = EncodeDestination(PKHash(key_other.GetPubKey().GetID()));
+    metadata.sText = sTestMessage;
+    metadata.fTextComplete = true;
+
+    smsg::SecMsgMetadataEntry entry;
+    entry.status = SMSG_MASK_UNREAD;
+    BOOST_REQUIRE(smsg::EncryptMetadata(key, metadata, entry));
+    BOOST_CHECK(entry.vchIV.size() == SMSG_CRYPTO_IV_SIZE);
+
+    smsg::SecMsgMetadata decrypted;
+    BOOST_REQUIRE(smsg::DecryptMetadata(key, entry, decrypted));
+    BOOST_CHECK_EQUAL(decrypted.timestamp, metadata.timestamp);
+    BOOST_CHECK_EQUAL(decrypted.sFromAddress, metadata.sFromAddress);
+    BOOST_CHECK_EQUAL(decrypted.sToAddress, metadata.sToAddress);
+    BOOST_CHECK_EQUAL(decrypted.sText, metadata.sText);
+    BOOST_CHECK(!smsg::DecryptMetadata(key_other, entry, decrypted) || decrypted.sText != metadata.sText);
+
+    // Case insensitive contains, like listing from the decrypted messages
+    BOOST_CHECK(*smsg::MatchMetadata(metadata, "SHORT TEST"));
+    BOOST_CHECK(*smsg::MatchMetadata(metadata, metadata.sToAddress.substr(3, 10)));
+    BOOST_CHECK(!*smsg::MatchMetadata(metadata, "not in the message"));
+
+    // Only the full text can rule out a truncated message
+    metadata.sText = sTestMessage.substr(0, 10);
+    metadata.fTextComplete = false;
+    BOOST_CHECK(*smsg::MatchMetadata(metadata, "a short"));
+    BOOST_CHECK(!smsg::MatchMetadata(metadata, "0123456789").has_value());
+}
+
+BOOST_AUTO_TEST_CASE(smsg_test_metadata_db)
+{
+    CKey key;
+    key.MakeNewKey(true);
+
+    smsg::SecMsgMetadata metadata;
+    metadata.timestamp = 1700000000;
+    metadata.sText = sTestMessage;
+    metadata.fTextComplete = true;
+
+    LOCK(smsg::cs_smsgDB);
+    {
+        smsg::SecMsgDB db;
+        BOOST_REQUIRE(db.Open("cr+"));
+
+        std::vector<std::array<uint8_t, 30>> keys(2);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i].fill(0);
+            memcpy(keys[i].data(), smsg::DBK_INBOX.data(), 2);
+            keys[i][29] = i + 1;
+
+            smsg::SecMsgStored stored;
+            stored.timeReceived = metadata.timestamp;
+            stored.status = SMSG_MASK_UNREAD;
+            stored.folderId = 0;
+            stored.addrTo = key.GetPubKey().GetID();
+            stored.vchMessage.resize(smsg::SMSG_HDR_LEN);
+            BOOST_CHECK(db.WriteSmesg(keys[i].data(), stored));
+
+            smsg::SecMsgMetadataEntry entry;
+            BOOST_CHECK(!db.ReadMetadata(keys[i].data(), entry)); // Indexed when first listed
+            entry.status = stored.status;
+            entry.addrKey = stored.addrTo;
+            BOOST_REQUIRE(smsg::EncryptMetadata(key, metadata, entry));
+            BOOST_CHECK(db.WriteMetadata(keys[i].data(), entry));
+        }
+
+        // Marking read updates the index, visible inside the transaction
+        smsg::SecMsgStored stored;
+        smsg::SecMsgMetadataEntry entry;
+        BOOST_REQUIRE(db.ReadSmesg(keys[0].data(), stored));
+        stored.status &= ~SMSG_MASK_UNREAD;
+        BOOST_CHECK(db.TxnBegin());
+        BOOST_CHECK(db.WriteSmesg(keys[0].data(), stored));
+        BOOST_REQUIRE(db.ReadMetadata(keys[0].data(), entry));
+        BOOST_CHECK_EQUAL(entry.status, stored.status);
+        BOOST_CHECK(db.TxnCommit());
+        BOOST_REQUIRE(db.ReadMetadata(keys[0].data(), entry));
+        BOOST_CHECK_EQUAL(entry.status, 0);
+        smsg::SecMsgMetadata decrypted;
+        BOOST_CHECK(smsg::DecryptMetadata(key, entry, decrypted));
+        BOOST_CHECK_EQUAL(decrypted.sText, metadata.sText);
+
+        // And outside one
+        stored.status |= SMSG_MASK_UNREAD;
+        BOOST_CHECK(db.WriteSmesg(keys[0].data(), stored));
+        BOOST_REQUIRE(db.ReadMetadata(keys[0].data(), entry));
+        BOOST_CHECK_EQUAL(entry.status, SMSG_MASK_UNREAD);
+
+        // Erasing a message drops its index entry, in a transaction and without
+        BOOST_CHECK(db.TxnBegin());
+        BOOST_CHECK(db.EraseSmesg(keys[0].data()));
+        BOOST_CHECK(!db.ReadMetadata(keys[0].data(), entry));
+        BOOST_CHECK(db.TxnCommit());
+        BOOST_CHECK(!db.ReadSmesg(keys[0].data(), stored));
+        BOOST_CHECK(!db.ReadMetadata(keys[0].data(), entry));
+
+        BOOST_CHECK(db.ReadMetadata(keys[1].data(), entry));
+        BOOST_CHECK(db.EraseSmesg(keys[1].data()));
+        BOOST_CHECK(!db.ReadSmesg(keys[1].data(), stored));
+        BOOST_CHECK(!db.ReadMetadata(keys[1].data(), entry));
+    }
+    smsgModule.Finalise();
+}
 #endif
 
 BOOST_AUTO_TEST_SUITE_END()
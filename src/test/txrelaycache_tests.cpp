@@ -0,0 +1,74 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/txrelaycache.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <version.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using node::TxRelayCache;
+
+BOOST_FIXTURE_TEST_SUITE(txrelaycache_tests, BasicTestingSetup)
+
+static CTransactionRef MakeCTTx(uint8_t tag, size_t rangeproof_size)
+{
+    CMutableTransaction tx;
+    tx.nVersion = GLOBE_TXN_VERSION;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(uint256{tag}, 0);
+    tx.vin[0].scriptWitness.stack.push_back({1, 2, 3});
+    auto out = MAKE_OUTPUT<CTxOutCT>();
+    out->vRangeproof.assign(rangeproof_size, tag);
+    tx.vpout.push_back(out);
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(txrelaycache_serialization)
+{
+    const CTransactionRef tx = MakeCTTx(1, 1000);
+    TxRelayCache cache{10000};
+
+    // Peers are sent the witness serialization, rangeproofs included
+    const TxRelayCache::SerializedTx serialized = cache.Get(*tx);
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << *tx;
+    const std::vector<unsigned char> expected{UCharCast(ss.data()), UCharCast(ss.data() + ss.size())};
+    BOOST_CHECK(*serialized == expected);
+    BOOST_CHECK_GT(serialized->size(), ::GetSerializeSize(*tx, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS));
+
+    // Later requests share the buffer
+    BOOST_CHECK(cache.Get(*tx) == serialized);
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK_EQUAL(cache.Bytes(), serialized->size());
+}
+
+BOOST_AUTO_TEST_CASE(txrelaycache_eviction)
+{
+    const CTransactionRef tx1 = MakeCTTx(1, 1000);
+    const CTransactionRef tx2 = MakeCTTx(2, 1000);
+    const CTransactionRef tx3 = MakeCTTx(3, 1000);
+    const size_t size = ::GetSerializeSize(*tx1, PROTOCOL_VERSION);
+    TxRelayCache cache{2 * size};
+
+    const auto s1 = cache.Get(*tx1);
+    const auto s2 = cache.Get(*tx2);
+    // tx1 becomes the most recently used, tx2 is evicted for tx3
+    BOOST_CHECK(cache.Get(*tx1) == s1);
+    cache.Get(*tx3);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+    BOOST_CHECK(cache.Bytes() <= 2 * size);
+    BOOST_CHECK(cache.Get(*tx1) == s1);
+    BOOST_CHECK(cache.Get(*tx2) != s2);
+
+    // Transactions larger than the cache are serialized but not kept
+    const CTransactionRef large = MakeCTTx(4, 3 * size);
+    BOOST_CHECK(cache.Get(*large)->size() > 2 * size);
+    BOOST_CHECK(cache.Bytes() <= 2 * size);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -161,6 +161,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     ApplyArgsManOptions(*m_node.args, validation_cache_sizes);
     Assert(InitSignatureCache(validation_cache_sizes.signature_cache_bytes));
     Assert(InitScriptExecutionCache(validation_cache_sizes.script_execution_cache_bytes));
+    Assert(InitPrevalidationCache(validation_cache_sizes.prevalidation_cache_bytes));
 
     m_node.chain = interfaces::MakeChain(m_node);
     fCheckBlockIndex = true;
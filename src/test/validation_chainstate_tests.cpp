@@ -147,4 +147,42 @@ BOOST_FIXTURE_TEST_CASE(chainstate_update_tip, TestChain100Setup)
     BOOST_CHECK_EQUAL(curr_tip, ::g_best_block);
 }
 
+//! Test that the coins spent by a block are read into the tip cache before it is connected.
+BOOST_FIXTURE_TEST_CASE(chainstate_prefetch_inputs, TestChain100Setup)
+{
+    Chainstate& chainstate = m_node.chainman->ActiveChainstate();
+    LOCK(::cs_main);
+    chainstate.ForceFlushStateToDisk();
+    CCoinsViewCache& tip = chainstate.CoinsTip();
+
+    COutPoint stored;
+    Coin stored_coin;
+    {
+        std::unique_ptr<CCoinsViewCursor> cursor = chainstate.CoinsDB().Cursor();
+        BOOST_REQUIRE(cursor->Valid() && cursor->GetKey(stored) && cursor->GetValue(stored_coin));
+    }
+    BOOST_REQUIRE(!tip.HaveCoinInCache(stored));
+    const COutPoint missing{InsecureRand256(), 0};
+
+    CMutableTransaction coinbase, spend, child;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(1 * COIN, CScript() << OP_TRUE);
+    spend.vin.emplace_back(stored);
+    spend.vin.emplace_back(missing);
+    spend.vout.emplace_back(1 * COIN, CScript() << OP_TRUE);
+    child.vin.emplace_back(COutPoint{spend.GetHash(), 0});
+    child.vout.emplace_back(1 * COIN, CScript() << OP_TRUE);
+    CBlock block;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(spend), MakeTransactionRef(child)};
+
+    const size_t usage = tip.DynamicMemoryUsage();
+    chainstate.PrefetchInputs(block);
+    BOOST_CHECK(tip.HaveCoinInCache(stored));
+    BOOST_CHECK(tip.AccessCoin(stored).out == stored_coin.out);
+    BOOST_CHECK(!tip.HaveCoinInCache(missing));
+    BOOST_CHECK(!tip.HaveCoinInCache(child.vin[0].prevout));
+    BOOST_CHECK_GT(tip.DynamicMemoryUsage(), usage);
+    BOOST_CHECK_EQUAL(tip.GetCacheSize(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <net.h>
 #include <signet.h>
 #include <uint256.h>
+#include <util/time.h>
 #include <validation.h>
 
 #include <test/util/setup_common.h>
@@ -144,4 +145,29 @@ BOOST_AUTO_TEST_CASE(test_assumeutxo)
     BOOST_CHECK_EQUAL(out210.nChainTx, 200U);
 }
 
+//! Nested phase timers don't count the inner phase for the outer one.
+BOOST_AUTO_TEST_CASE(validation_phase_timer_nesting)
+{
+    g_validation_phase_times.enabled = true;
+    g_validation_phase_times.check_block = 0;
+    g_validation_phase_times.rangeproof = 0;
+
+    const int64_t start = GetTimeMicros();
+    {
+        const ValidationPhaseTimer outer{&ValidationPhaseTimes::check_block};
+        {
+            const ValidationPhaseTimer inner{&ValidationPhaseTimes::rangeproof};
+            UninterruptibleSleep(std::chrono::milliseconds{10});
+        }
+    }
+    const int64_t elapsed = GetTimeMicros() - start;
+    g_validation_phase_times.enabled = false;
+
+    const int64_t check_block{g_validation_phase_times.check_block}, rangeproof{g_validation_phase_times.rangeproof};
+    BOOST_CHECK_GE(rangeproof, 10000);
+    BOOST_CHECK_LE(check_block + rangeproof, elapsed);
+    g_validation_phase_times.check_block = 0;
+    g_validation_phase_times.rangeproof = 0;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
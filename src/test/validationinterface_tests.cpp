@@ -10,6 +10,9 @@
 #include <util/check.h>
 #include <validationinterface.h>
 
+#include <atomic>
+#include <future>
+
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, TestingSetup)
 
 struct TestSubscriberNoop final : public CValidationInterface {
@@ -91,4 +94,114 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+class FlushRecorder : public CValidationInterface
+{
+public:
+    explicit FlushRecorder(std::string name, std::shared_future<void> wait = {})
+        : m_name(std::move(name)), m_wait(std::move(wait)) {}
+    void ChainStateFlushed(const CBlockLocator& locator) override
+    {
+        if (m_wait.valid()) m_wait.wait();
+        LOCK(m_mutex);
+        m_seen.push_back(locator.vHave.empty() ? uint256() : locator.vHave.front());
+    }
+    std::string ValidationQueueName() const override { return m_name; }
+    std::vector<uint256> Seen() { return WITH_LOCK(m_mutex, return m_seen); }
+
+    Mutex m_mutex;
+    std::vector<uint256> m_seen GUARDED_BY(m_mutex);
+    const std::string m_name;
+    std::shared_future<void> m_wait;
+};
+
+/** Signals once its callback has started, then blocks until released */
+class BlockingFlush : public CValidationInterface
+{
+public:
+    explicit BlockingFlush(std::shared_future<void> release) : m_release(std::move(release)) {}
+    void ChainStateFlushed(const CBlockLocator& locator) override
+    {
+        m_started.set_value();
+        m_release.wait();
+        m_done = true;
+    }
+    std::string ValidationQueueName() const override { return "blocking"; }
+
+    std::promise<void> m_started;
+    std::shared_future<void> m_release;
+    std::atomic<bool> m_done{false};
+};
+
+BOOST_AUTO_TEST_CASE(subscriber_queues)
+{
+    // Switch to one queue per subscriber
+    GetMainSignals().FlushBackgroundCallbacks();
+    UnregisterAllValidationInterfaces();
+    GetMainSignals().UnregisterBackgroundSignalScheduler();
+    GetMainSignals().RegisterBackgroundSignalScheduler(*m_node.scheduler, /*queue_depth=*/4);
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPendingLimit(), 4U);
+
+    std::promise<void> release;
+    auto slow = std::make_shared<FlushRecorder>("slow", release.get_future().share());
+    auto fast = std::make_shared<FlushRecorder>("fast");
+    RegisterSharedValidationInterface(slow);
+    RegisterSharedValidationInterface(fast);
+
+    std::vector<uint256> expected;
+    for (int i = 0; i < 8; ++i) {
+        expected.push_back(InsecureRand256());
+        GetMainSignals().ChainStateFlushed(CBlockLocator({expected.back()}));
+    }
+
+    // The fast subscriber isn't held up by the slow one
+    for (int i = 0; i < 1000 && fast->Seen().size() < expected.size(); ++i) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+    BOOST_CHECK(fast->Seen() == expected);
+    BOOST_CHECK(slow->Seen().empty());
+
+    const auto infos = GetMainSignals().GetQueueInfo();
+    BOOST_REQUIRE_EQUAL(infos.size(), 2U);
+    for (const auto& info : infos) {
+        BOOST_CHECK(info.name == "slow" || info.name == "fast");
+        if (info.name == "slow") {
+            BOOST_CHECK_EQUAL(info.pending, expected.size());
+            BOOST_CHECK_EQUAL(info.processed, 0U);
+        } else {
+            BOOST_CHECK_EQUAL(info.pending, 0U);
+            BOOST_CHECK_EQUAL(info.processed, expected.size());
+            BOOST_CHECK_EQUAL(info.lag_ms, 0);
+        }
+    }
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPending(), expected.size());
+
+    release.set_value();
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(slow->Seen() == expected);
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPending(), 0U);
+
+    // Notifications queued for an unregistered subscriber are dropped
+    UnregisterSharedValidationInterface(slow);
+    GetMainSignals().ChainStateFlushed(CBlockLocator({InsecureRand256()}));
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(slow->Seen().size(), expected.size());
+    BOOST_CHECK_EQUAL(fast->Seen().size(), expected.size() + 1);
+    BOOST_CHECK_EQUAL(GetMainSignals().GetQueueInfo().size(), 1U);
+
+    // Syncing waits for a callback still running for an unregistered subscriber
+    std::promise<void> release_blocking;
+    auto blocking = std::make_shared<BlockingFlush>(release_blocking.get_future().share());
+    auto started = blocking->m_started.get_future();
+    RegisterSharedValidationInterface(blocking);
+    GetMainSignals().ChainStateFlushed(CBlockLocator({InsecureRand256()}));
+    started.wait();
+    UnregisterSharedValidationInterface(blocking);
+    auto sync = std::async(std::launch::async, [] { SyncWithValidationInterfaceQueue(); });
+    BOOST_CHECK(sync.wait_for(std::chrono::milliseconds{100}) == std::future_status::timeout);
+    release_blocking.set_value();
+    sync.get();
+    BOOST_CHECK(blocking->m_done);
+    BOOST_CHECK_EQUAL(GetMainSignals().GetQueueInfo().size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,7 @@
 #include <insight/insight.h>
 #include <chainparams.h>
 
+#include <algorithm>
 #include <stdint.h>
 
 static constexpr uint8_t DB_COIN{'C'};
@@ -38,6 +39,7 @@ static constexpr uint8_t DB_HEAD_BLOCKS{'H'};
 static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
+static constexpr uint8_t DB_BLOCK_INDEX_SNAPSHOT{'N'};
 
 /*
 static constexpr uint8_t DB_RCTOUTPUT = 'A';
@@ -239,6 +241,9 @@ private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
+    //! Cache the key of the record the iterator was positioned at
+    void ReadFirstKey();
+
     friend class CCoinsViewDB;
 };
 
@@ -250,15 +255,30 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        only need read operations on it, use a const-cast to get around
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
+    i->ReadFirstKey();
+    return i;
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::SeekCursor(const uint256& start) const
+{
+    auto i = std::make_unique<CCoinsViewDBCursor>(
+        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
+    const COutPoint first(start, 0);
+    i->pcursor->Seek(CoinEntry(&first));
+    i->ReadFirstKey();
+    return i;
+}
+
+void CCoinsViewDBCursor::ReadFirstKey()
+{
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    if (pcursor->Valid()) {
+        CoinEntry entry(&keyTmp.second);
+        pcursor->GetKey(entry);
+        keyTmp.first = entry.key;
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -301,6 +321,7 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
     }
+    m_block_index_changed |= !blockinfo.empty();
     return WriteBatch(batch, true);
 }
 
@@ -472,7 +493,56 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+bool LoadDiskBlockIndex(const uint256& hash, const CDiskBlockIndex& diskindex, const Consensus::Params& consensusParams,
+                        const std::function<CBlockIndex*(const uint256&)>& insertBlockIndex, const BlockIndexStakeFn& set_stake)
+{
+    AssertLockHeld(::cs_main);
+
+    // Construct block index object
+    CBlockIndex* pindexNew = insertBlockIndex(hash);
+    pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+    pindexNew->nHeight        = diskindex.nHeight;
+    pindexNew->nFile          = diskindex.nFile;
+    pindexNew->nDataPos       = diskindex.nDataPos;
+    pindexNew->nUndoPos       = diskindex.nUndoPos;
+    pindexNew->nVersion       = diskindex.nVersion;
+    pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+    pindexNew->nTime          = diskindex.nTime;
+    pindexNew->nBits          = diskindex.nBits;
+    pindexNew->nNonce         = diskindex.nNonce;
+    pindexNew->nStatus        = diskindex.nStatus;
+    pindexNew->nTx            = diskindex.nTx;
+    pindexNew->hashStateRoot  = diskindex.hashStateRoot; // globe
+    pindexNew->hashUTXORoot   = diskindex.hashUTXORoot; // globe
+
+    pindexNew->hashWitnessMerkleRoot    = diskindex.hashWitnessMerkleRoot;
+    pindexNew->nFlags                   = diskindex.nFlags & (uint32_t)~BLOCK_DELAYED;
+    //pindexNew->hashProof                = diskindex.hashProof;
+
+    pindexNew->nMoneySupply             = diskindex.nMoneySupply;
+    pindexNew->nAnonOutputs             = diskindex.nAnonOutputs;
+
+    // The caller decides which stake fields stay in memory
+    set_stake(pindexNew, diskindex.stake);
+
+    if (pindexNew->nHeight == 0
+        && pindexNew->GetBlockHash() != Params().GetConsensus().hashGenesisBlock)
+        return error("LoadBlockIndex(): Genesis block hash incorrect: %s", pindexNew->ToString());
+
+    if (fGlobeMode) {
+        // only CheckProofOfWork for genesis blocks
+        if (diskindex.hashPrev.IsNull() && !CheckProofOfWork(pindexNew->GetBlockHash(),
+            pindexNew->nBits, Params().GetConsensus(), 0, Params().GetLastImportHeight()))
+            return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+    } else
+    if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
+        return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+    }
+
+    return true;
+}
+
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const BlockIndexStakeFn& set_stake)
 {
     AssertLockHeld(::cs_main);
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -485,46 +555,9 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
             CDiskBlockIndex diskindex;
             if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.ConstructBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-                pindexNew->hashStateRoot  = diskindex.hashStateRoot; // globe
-                pindexNew->hashUTXORoot   = diskindex.hashUTXORoot; // globe
-
-                pindexNew->hashWitnessMerkleRoot    = diskindex.hashWitnessMerkleRoot;
-                pindexNew->nFlags                   = diskindex.nFlags & (uint32_t)~BLOCK_DELAYED;
-                pindexNew->bnStakeModifier          = diskindex.bnStakeModifier;
-                pindexNew->prevoutStake             = diskindex.prevoutStake;
-                //pindexNew->hashProof                = diskindex.hashProof;
-
-                pindexNew->nMoneySupply             = diskindex.nMoneySupply;
-                pindexNew->nAnonOutputs             = diskindex.nAnonOutputs;
-
-                if (pindexNew->nHeight == 0
-                    && pindexNew->GetBlockHash() != Params().GetConsensus().hashGenesisBlock)
-                    return error("LoadBlockIndex(): Genesis block hash incorrect: %s", pindexNew->ToString());
-
-                if (fGlobeMode) {
-                    // only CheckProofOfWork for genesis blocks
-                    if (diskindex.hashPrev.IsNull() && !CheckProofOfWork(pindexNew->GetBlockHash(),
-                        pindexNew->nBits, Params().GetConsensus(), 0, Params().GetLastImportHeight()))
-                        return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
-                } else
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+                if (!LoadDiskBlockIndex(diskindex.ConstructBlockHash(), diskindex, consensusParams, insertBlockIndex, set_stake)) {
+                    return false;
                 }
-
                 pcursor->Next();
             } else {
                 return error("%s: failed to read value", __func__);
@@ -537,11 +570,74 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
     return true;
 }
 
+bool CBlockTreeDB::ReadBlockIndexStake(const uint256& hash, CBlockIndexStake& stake)
+{
+    CDiskBlockIndex diskindex;
+    if (!Read(std::make_pair(DB_BLOCK_INDEX, hash), diskindex)) {
+        return false;
+    }
+    stake = diskindex.stake;
+    return true;
+}
+
+namespace {
+/** A record kept serialized */
+struct RawRecord
+{
+    std::vector<std::byte> data;
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        data.resize(s.size());
+        s.read(data);
+    }
+};
+} // namespace
+
+bool CBlockTreeDB::ForEachBlockIndexRecord(const std::function<bool(const uint256&, Span<const std::byte>)>& fn)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+
+    RawRecord record;
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, uint256> key;
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX) {
+            break;
+        }
+        if (!pcursor->GetValue(record)) {
+            return error("%s: failed to read value", __func__);
+        }
+        if (!fn(key.second, record.data)) {
+            return false;
+        }
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool CBlockTreeDB::WriteBlockIndexSnapshotId(const uint256& id)
+{
+    return Write(DB_BLOCK_INDEX_SNAPSHOT, id, true);
+}
+
+bool CBlockTreeDB::ReadBlockIndexSnapshotId(uint256& id)
+{
+    return Read(DB_BLOCK_INDEX_SNAPSHOT, id);
+}
+
+bool CBlockTreeDB::EraseBlockIndexSnapshotId()
+{
+    return Erase(DB_BLOCK_INDEX_SNAPSHOT, true);
+}
+
 bool CBlockTreeDB::EraseBlockIndex(const std::vector<uint256> &vect)
  {
      CDBBatch batch(*this);
      for (std::vector<uint256>::const_iterator it=vect.begin(); it!=vect.end(); it++)
          batch.Erase(std::make_pair(DB_BLOCK_INDEX, *it));
+     m_block_index_changed |= !vect.empty();
      return WriteBatch(batch);
  }
 
@@ -570,14 +666,15 @@ size_t CBlockTreeDB::CountBlockIndex()
 bool CBlockTreeDB::ReadRCTOutput(int64_t i, CAnonOutput &ao)
 {
     std::pair<uint8_t, int64_t> key = std::make_pair(DB_RCTOUTPUT, i);
-    return Read(key, ao);
+    auto record = Using<AnonOutputDBFormatter>(ao);
+    return Read(key, record);
 };
 
 bool CBlockTreeDB::WriteRCTOutput(int64_t i, const CAnonOutput &ao)
 {
     std::pair<uint8_t, int64_t> key = std::make_pair(DB_RCTOUTPUT, i);
     CDBBatch batch(*this);
-    batch.Write(key, ao);
+    batch.Write(key, Using<AnonOutputDBFormatter>(ao));
     return WriteBatch(batch);
 };
 
@@ -633,6 +730,52 @@ bool CBlockTreeDB::ReadRCTKeyImage(const CCmpPubKey &ki, CAnonKeyImageInfo &data
     return true;
 };
 
+void CBlockTreeDB::ReadRCTKeyImages(const std::vector<CCmpPubKey> &kis, std::vector<std::optional<CAnonKeyImageInfo>> &results)
+{
+    results.assign(kis.size(), std::nullopt);
+
+    // Visit the key images in db order so the iterator only moves forward
+    std::vector<size_t> order;
+    order.reserve(kis.size());
+    for (size_t i = 0; i < kis.size(); ++i) {
+        if (kis[i].size() == 33) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&kis](size_t a, size_t b) { return kis[a] < kis[b]; });
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    std::pair<uint8_t, CCmpPubKey> key;
+    bool positioned = false;
+    for (size_t i : order) {
+        const CCmpPubKey &ki = kis[i];
+        // The cursor is at the first key image >= the previous one looked up,
+        // if that is not below ki it is also the first >= ki.
+        if (!positioned || key.second < ki) {
+            pcursor->Seek(std::make_pair(DB_RCTKEYIMAGE, ki));
+            if (!pcursor->Valid() || !pcursor->GetKey(key) || key.first != DB_RCTKEYIMAGE) {
+                break; // No key images at or after ki
+            }
+            positioned = true;
+        }
+        if (key.second != ki) {
+            continue;
+        }
+        CAnonKeyImageInfo data;
+        // Versions before 0.19.2.15 store only the txid
+        if (pcursor->GetValueSize() < 36) {
+            if (!pcursor->GetValue(data.txid)) {
+                continue;
+            }
+            data.height = -1; // unset
+        } else
+        if (!pcursor->GetValue(data)) {
+            continue;
+        }
+        results[i] = data;
+    }
+};
+
 bool CBlockTreeDB::EraseRCTKeyImage(const CCmpPubKey &ki)
 {
     std::pair<uint8_t, CCmpPubKey> key = std::make_pair(DB_RCTKEYIMAGE, ki);
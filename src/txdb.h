@@ -27,6 +27,8 @@
 
 class CBlockFileInfo;
 class CBlockIndex;
+class CDiskBlockIndex;
+struct CBlockIndexStake;
 class uint256;
 namespace Consensus {
 struct Params;
@@ -81,6 +83,7 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::unique_ptr<CCoinsViewCursor> SeekCursor(const uint256& start) const override;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -90,6 +93,14 @@ public:
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 };
 
+/** Receives the stake fields of a loaded block index entry */
+using BlockIndexStakeFn = std::function<void(CBlockIndex*, const CBlockIndexStake&)>;
+
+/** Fill the entry for a block index record read from disk, linking it to its predecessor */
+bool LoadDiskBlockIndex(const uint256& hash, const CDiskBlockIndex& diskindex, const Consensus::Params& consensusParams,
+                        const std::function<CBlockIndex*(const uint256&)>& insertBlockIndex, const BlockIndexStakeFn& set_stake)
+    EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
@@ -122,9 +133,19 @@ public:
 
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const BlockIndexStakeFn& set_stake)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     size_t CountBlockIndex();
+    bool ReadBlockIndexStake(const uint256& hash, CBlockIndexStake& stake);
+    /** Pass the hash and serialized CDiskBlockIndex of every block index record to fn, stops if fn returns false */
+    bool ForEachBlockIndexRecord(const std::function<bool(const uint256&, Span<const std::byte>)>& fn);
+
+    //! Id of the block index snapshot matching the db, erased before the db changes
+    bool WriteBlockIndexSnapshotId(const uint256& id);
+    bool ReadBlockIndexSnapshotId(uint256& id);
+    bool EraseBlockIndexSnapshotId();
+    //! Whether block index records were written or erased since the db was opened
+    bool BlockIndexChanged() const { return m_block_index_changed; }
 
 
     bool ReadRCTOutput(int64_t i, CAnonOutput &ao);
@@ -136,6 +157,8 @@ public:
     bool EraseRCTOutputLink(const CCmpPubKey &pk);
 
     bool ReadRCTKeyImage(const CCmpPubKey &ki, CAnonKeyImageInfo &data);
+    /** Look up many key images in one forward iterator pass, results[i] is set if kis[i] is spent */
+    void ReadRCTKeyImages(const std::vector<CCmpPubKey> &kis, std::vector<std::optional<CAnonKeyImageInfo>> &results);
     bool EraseRCTKeyImage(const CCmpPubKey &ki);
     bool EraseRCTKeyImagesAfterHeight(int height);
 
@@ -145,6 +168,9 @@ public:
     //bool WriteRCTOutputBatch(std::vector<std::pair<int64_t, CAnonOutput> > &vao);
 
     bool EraseBlockIndex(const std::vector<uint256>&vect);
+
+private:
+    bool m_block_index_changed{false};
 };
 
 std::optional<bilingual_str> CheckLegacyTxindex(CBlockTreeDB& block_tree_db);
@@ -82,6 +82,63 @@ static usb_device::CUSBDevice *SelectDevice(std::vector<std::unique_ptr<usb_devi
     return rv;
 };
 
+#ifdef ENABLE_WALLET
+static std::string GetDeviceUsbId(const usb_device::CUSBDevice *pDevice)
+{
+    return strprintf("%04x:%04x:%s", pDevice->pType->nVendorId, pDevice->pType->nProductId, pDevice->cSerialNo);
+};
+
+/**
+ * Get the wallet's cache of device xpubs, emptied if another device is
+ * connected or the device was reseeded.
+ * The device is identified by its usb ids and the fingerprint of its master
+ * key, read as the parent fingerprint of the purpose level xpub, so a cache
+ * filled from another seed is never used.
+ * Reading the fingerprint costs a round trip, call once per RPC before any
+ * loop and pass the cache down.
+ */
+static DeviceKeyCache &GetDeviceKeyCache(CHDWallet *pwallet, usb_device::CUSBDevice *pDevice)
+{
+    CExtPubKey ekp;
+    std::string sError;
+    if (0 != pDevice->GetXPub({WithHardenedBit(44)}, ekp, sError)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("GetXPub failed %s.", sError));
+    }
+    DeviceKeyCache &device_keys = pwallet->m_device_key_cache;
+    device_keys.CountDeviceCall("devicefingerprint");
+
+    std::string device_id = GetDeviceUsbId(pDevice) + ":" + HexStr(ekp.vchFingerprint);
+    if (device_keys.SetDevice(device_id)) {
+        LogPrint(BCLog::HDWALLET, "%s: Device changed to %s, cleared device key cache.\n", pwallet->GetDisplayName(), device_id);
+    }
+    return device_keys;
+};
+
+/** Empty the caches of device xpubs of all loaded wallets linked to pDevice */
+static void ClearDeviceKeyCaches(const JSONRPCRequest &request, const usb_device::CUSBDevice *pDevice)
+{
+    const std::string usb_id = GetDeviceUsbId(pDevice) + ":";
+    for (const auto &wallet : GetWallets(EnsureWalletContext(request.context))) {
+        if (!IsGlobeWallet(wallet.get())) {
+            continue;
+        }
+        CHDWallet *const pwallet = GetGlobeWallet(wallet.get());
+        if (pwallet->m_device_key_cache.GetDeviceId().compare(0, usb_id.size(), usb_id) != 0) {
+            continue;
+        }
+        pwallet->m_device_key_cache.Clear();
+        pwallet->FlushDeviceKeyCache();
+    }
+};
+
+static DeviceKeyCache::XPubFetcher DeviceXPubFetcher(usb_device::CUSBDevice *pDevice)
+{
+    return [pDevice](const std::vector<uint32_t> &vPath, CExtPubKey &ekp, std::string &sError) {
+        return pDevice->GetXPub(vPath, ekp, sError);
+    };
+};
+#endif
+
 static RPCHelpMan deviceloadmnemonic()
 {
     return RPCHelpMan{"deviceloadmnemonic",
@@ -118,6 +175,10 @@ static RPCHelpMan deviceloadmnemonic()
     } else {
         result.pushKV("error", sError);
     }
+#ifdef ENABLE_WALLET
+    // The device may hold a new seed even if loading did not complete
+    ClearDeviceKeyCaches(request, pDevice);
+#endif
 
     return result;
 },
@@ -832,7 +893,8 @@ static RPCHelpMan initaccountfromdevice()
 
     std::string sError;
     CExtPubKey ekp;
-    if (0 != pDevice->GetXPub(vPath, ekp, sError)) {
+    DeviceKeyCache &device_keys = GetDeviceKeyCache(pwallet, pDevice);
+    if (0 != device_keys.GetXPub("initaccountfromdevice", vPath, ekp, sError, DeviceXPubFetcher(pDevice))) {
         throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("GetXPub failed %s.", sError));
     }
 
@@ -936,7 +998,7 @@ static RPCHelpMan initaccountfromdevice()
             CExtPubKey epStealthSpend;
             uint32_t nStealthSpend = WithHardenedBit(CHAIN_NO_STEALTH_SPEND);
             vPath.push_back(nStealthSpend);
-            if (0 != pDevice->GetXPub(vPath, epStealthSpend, sError)) {
+            if (0 != device_keys.GetXPub("initaccountfromdevice", vPath, epStealthSpend, sError, DeviceXPubFetcher(pDevice))) {
                 sea->FreeChains();
                 throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("GetXPub failed %s.", sError));
             }
@@ -991,6 +1053,7 @@ static RPCHelpMan initaccountfromdevice()
             throw JSONRPCError(RPC_INTERNAL_ERROR, "TxnCommit failed.");
         }
     }
+    pwallet->FlushDeviceKeyCache();
 
     if (nScanFrom >= 0) {
         pwallet->RescanFromTime(nScanFrom, reserver, true /* update */);
@@ -1105,9 +1168,10 @@ static RPCHelpMan devicegetnewstealthaddress()
         usb_device::CUSBDevice *pDevice = SelectDevice(vDevices);
 
         CPubKey pkSpend;
-        if (0 != pDevice->GetPubKey(vSpendPath, pkSpend, false, sError)) {
+        if (0 != GetDeviceKeyCache(pwallet, pDevice).GetPubKey("devicegetnewstealthaddress", vSpendPath, pkSpend, sError, DeviceXPubFetcher(pDevice))) {
             throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Device GetPubKey failed %s.", sError));
         }
+        pwallet->FlushDeviceKeyCache();
 
         sekSpend->nHGenerated = nSpendGenerated+1;
 
@@ -1274,17 +1338,24 @@ static RPCHelpMan devicesignrawtransactionwithwallet()
     if (!request.params[2].isNull()) {
         fGivenKeys = true;
         UniValue paths = request.params[2].get_array();
+        DeviceKeyCache *device_keys = pwallet ? &GetDeviceKeyCache(pwallet, pDevice) : nullptr;
         for (unsigned int idx = 0; idx < paths.size(); idx++) {
             usb_device::CPathKey pathkey;
             GetPath(pathkey.vPath, paths[idx], request.params[4]);
 
             std::string sError;
-            if (0 != pDevice->GetPubKey(pathkey.vPath, pathkey.pk, false, sError)) {
+            int rv = device_keys
+                ? device_keys->GetPubKey("devicesignrawtransactionwithwallet", pathkey.vPath, pathkey.pk, sError, DeviceXPubFetcher(pDevice))
+                : pDevice->GetPubKey(pathkey.vPath, pathkey.pk, false, sError);
+            if (0 != rv) {
                 throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Device GetPubKey failed %s.", sError));
             }
 
             tempKeystore.AddKey(pathkey);
         }
+        if (pwallet) {
+            pwallet->FlushDeviceKeyCache();
+        }
     }
 
     // Add previous txouts given in the RPC call:
@@ -897,6 +897,12 @@ void SetSyscallSandboxPolicy(SyscallSandboxPolicy syscall_policy)
         break;
     case SyscallSandboxPolicy::VALIDATION_SCRIPT_CHECK: // Thread: scriptch.<N>
         break;
+    case SyscallSandboxPolicy::VALIDATION_PREFETCH: // Thread: prefetch.<N>
+        seccomp_policy_builder.AllowFileSystem();
+        break;
+    case SyscallSandboxPolicy::VALIDATION_PREVALIDATE: // Thread: prevalid.<N>
+        seccomp_policy_builder.AllowFileSystem();
+        break;
     case SyscallSandboxPolicy::SHUTOFF: // Thread: main thread (state: shutoff)
         seccomp_policy_builder.AllowFileSystem();
         break;
@@ -23,6 +23,8 @@ enum class SyscallSandboxPolicy {
     TOR_CONTROL,
     TX_INDEX,
     VALIDATION_SCRIPT_CHECK,
+    VALIDATION_PREFETCH,
+    VALIDATION_PREVALIDATE,
 
     // 3. Shutdown
     SHUTOFF,
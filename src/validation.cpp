@@ -74,6 +74,7 @@
 #include <deque>
 #include <numeric>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 
 using kernel::CCoinsStats;
@@ -1828,6 +1829,61 @@ bool InitScriptExecutionCache(size_t max_size_bytes)
     return true;
 }
 
+static CuckooCache::cache<uint256, SignatureCacheHasher> g_prevalidationCache;
+static CSHA256 g_prevalidationCacheHasher;
+static std::shared_mutex g_prevalidationCacheMutex;
+
+bool InitPrevalidationCache(size_t max_size_bytes)
+{
+    uint256 nonce = GetRandHash();
+    g_prevalidationCacheHasher.Write(nonce.begin(), 32);
+    g_prevalidationCacheHasher.Write(nonce.begin(), 32);
+
+    auto setup_results = g_prevalidationCache.setup_bytes(max_size_bytes);
+    if (!setup_results) return false;
+
+    const auto [num_elems, approx_size_bytes] = *setup_results;
+    LogPrintf("Using %zu MiB out of %zu MiB requested for rct check cache, able to store %zu elements\n",
+              approx_size_bytes >> 20, max_size_bytes >> 20, num_elems);
+    return true;
+}
+
+uint256 RangeProofCacheEntry(const secp256k1_pedersen_commitment& commitment, const std::vector<uint8_t>& rangeproof, bool bulletproof)
+{
+    uint256 entry;
+    const uint8_t tag[2] = {'R', bulletproof};
+    CSHA256 hasher = g_prevalidationCacheHasher;
+    hasher.Write(tag, 2).Write(commitment.data, 33).Write(rangeproof.data(), rangeproof.size()).Finalize(entry.begin());
+    return entry;
+}
+
+uint256 MLSAGCacheEntry(const uint256& wtxid, size_t input, Span<const uint8_t> ring_pubkeys, const std::vector<secp256k1_pedersen_commitment>& ring_commitments)
+{
+    uint256 entry;
+    const uint8_t tag[1] = {'M'};
+    const uint32_t n = input;
+    CSHA256 hasher = g_prevalidationCacheHasher;
+    hasher.Write(tag, 1).Write(wtxid.begin(), 32).Write((const uint8_t*)&n, sizeof(n));
+    hasher.Write(ring_pubkeys.data(), ring_pubkeys.size());
+    for (const auto& commitment : ring_commitments) {
+        hasher.Write(commitment.data, 33);
+    }
+    hasher.Finalize(entry.begin());
+    return entry;
+}
+
+bool PrevalidationCacheContains(const uint256& entry, bool erase)
+{
+    std::shared_lock<std::shared_mutex> lock(g_prevalidationCacheMutex);
+    return g_prevalidationCache.contains(entry, erase);
+}
+
+void PrevalidationCacheInsert(const uint256& entry)
+{
+    std::unique_lock<std::shared_mutex> lock(g_prevalidationCacheMutex);
+    g_prevalidationCache.insert(entry);
+}
+
 /**
  * Check whether all of this transaction's input scripts succeed.
  *
@@ -1947,9 +2003,11 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState &state,
         }
     }
 
-    if (m_has_anon_input && fAnonChecks
-        && !VerifyMLSAG(tx, state)) {
-        return false;
+    if (m_has_anon_input && fAnonChecks) {
+        const ValidationPhaseTimer timer{&ValidationPhaseTimes::mlsag};
+        if (!VerifyMLSAG(tx, state)) {
+            return false;
+        }
     }
 
     if (cacheFullScriptStore && !pvChecks) {
@@ -2240,16 +2298,183 @@ DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIn
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
+/**
+ * Closure reading one input of a block ahead of ConnectBlock, queued by
+ * Chainstate::PrefetchInputs.
+ * Coins are returned to be added to the coins cache, anon ring members are
+ * only read to bring them into the database cache for VerifyMLSAG.
+ */
+class CPrefetchCheck
+{
+private:
+    const CCoinsView *pcoinsdb = nullptr;
+    CBlockTreeDB *pblocktree = nullptr;
+    const COutPoint *poutpoint = nullptr; // nullptr for a ring member
+    int64_t nAnonIndex = 0;
+    std::optional<Coin> *pcoin = nullptr;
+
+public:
+    CPrefetchCheck() {}
+    CPrefetchCheck(const CCoinsView &coinsdb, const COutPoint &outpoint, std::optional<Coin> &coin) :
+        pcoinsdb(&coinsdb), poutpoint(&outpoint), pcoin(&coin) {}
+    CPrefetchCheck(CBlockTreeDB &blocktree, int64_t anon_index) :
+        pblocktree(&blocktree), nAnonIndex(anon_index) {}
+
+    bool operator()()
+    {
+        if (poutpoint) {
+            Coin coin;
+            if (pcoinsdb->GetCoin(*poutpoint, coin)) {
+                *pcoin = std::move(coin);
+            }
+        } else {
+            CAnonOutput ao;
+            pblocktree->ReadRCTOutput(nAnonIndex, ao);
+        }
+        // A miss is left for ConnectBlock to report
+        return true;
+    }
+
+    void swap(CPrefetchCheck &check) noexcept
+    {
+        std::swap(pcoinsdb, check.pcoinsdb);
+        std::swap(pblocktree, check.pblocktree);
+        std::swap(poutpoint, check.poutpoint);
+        std::swap(nAnonIndex, check.nAnonIndex);
+        std::swap(pcoin, check.pcoin);
+    }
+};
+
+/**
+ * Closure running one context free rct check of a transaction before
+ * cs_main is taken, queued by ChainstateManager::PrevalidateTransaction.
+ * Passing checks are added to the prevalidation cache, failures are left
+ * for the locked path to report.
+ */
+class CPrevalidationCheck
+{
+private:
+    const CTransaction *ptx = nullptr;
+    const TxValidationState *pstate = nullptr;
+    CBlockTreeDB *pblocktree = nullptr; // nullptr for a rangeproof
+    size_t n = 0; // Output index of a rangeproof, input index of an MLSAG
+
+public:
+    CPrevalidationCheck() {}
+    CPrevalidationCheck(const CTransaction &tx, const TxValidationState &state, size_t output) :
+        ptx(&tx), pstate(&state), n(output) {}
+    CPrevalidationCheck(const CTransaction &tx, const TxValidationState &state, CBlockTreeDB &blocktree, size_t input) :
+        ptx(&tx), pstate(&state), pblocktree(&blocktree), n(input) {}
+
+    bool operator()()
+    {
+        TxValidationState state;
+        state.CopyStateInfo(*pstate);
+        if (pblocktree) {
+            PrevalidateMLSAG(*ptx, n, *pblocktree, state);
+        } else {
+            CheckOutputRangeProof(state, ptx->vpout[n].get());
+        }
+        return true;
+    }
+
+    void swap(CPrevalidationCheck &check) noexcept
+    {
+        std::swap(ptx, check.ptx);
+        std::swap(pstate, check.pstate);
+        std::swap(pblocktree, check.pblocktree);
+        std::swap(n, check.n);
+    }
+};
+
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
+static CCheckQueue<CIndexEntryCheck> indexentryqueue(16);
+static CCheckQueue<CPrefetchCheck> prefetchqueue(8);
+static CCheckQueue<CPrevalidationCheck> prevalidationqueue(1);
 
 void StartScriptCheckWorkerThreads(int threads_num)
 {
     scriptcheckqueue.StartWorkerThreads(threads_num);
+    // Address and spent index entries are collected while the scripts are checked
+    indexentryqueue.StartWorkerThreads(std::min(threads_num, MAX_INDEX_ENTRY_THREADS), "indexch");
+    // Block inputs are read before ConnectBlock, the workers wait on the disk
+    prefetchqueue.StartWorkerThreads(PREFETCH_THREADS, "prefetch", SyscallSandboxPolicy::VALIDATION_PREFETCH);
+    // Relayed transactions are checked outside cs_main, block validation keeps its own workers
+    prevalidationqueue.StartWorkerThreads(threads_num, "prevalid", SyscallSandboxPolicy::VALIDATION_PREVALIDATE);
 }
 
 void StopScriptCheckWorkerThreads()
 {
     scriptcheckqueue.StopWorkerThreads();
+    indexentryqueue.StopWorkerThreads();
+    prefetchqueue.StopWorkerThreads();
+    prevalidationqueue.StopWorkerThreads();
+}
+
+void Chainstate::PrefetchInputs(const CBlock& block)
+{
+    AssertLockHeld(cs_main);
+    if (!g_parallel_script_checks) {
+        return;
+    }
+    CCoinsViewCache& tip = CoinsTip();
+    std::set<uint256> block_txids;
+    std::vector<COutPoint> outpoints;
+    std::set<int64_t> anon_indices;
+    for (const auto& tx : block.vtx) {
+        for (const auto& txin : tx->vin) {
+            if (tx->IsCoinBase()) {
+                break;
+            }
+            if (!txin.IsAnonInput()) {
+                // Outputs of earlier transactions in the block are not in the database
+                if (!block_txids.count(txin.prevout.hash) && !tip.HaveCoinInCache(txin.prevout)) {
+                    outpoints.push_back(txin.prevout);
+                }
+                continue;
+            }
+            uint32_t nInputs, nRingSize;
+            if (!txin.GetAnonInfo(nInputs, nRingSize) ||
+                txin.scriptWitness.stack.size() != 2 ||
+                (size_t)nInputs * nRingSize > MAX_ANON_INPUTS * MAX_RINGSIZE) {
+                continue;
+            }
+            const std::vector<uint8_t>& vMI = txin.scriptWitness.stack[0];
+            size_t ofs = 0, nB = 0;
+            for (size_t i = 0; i < (size_t)nInputs * nRingSize && ofs < vMI.size(); ++i, ofs += nB) {
+                uint64_t nIndex;
+                if (0 != part::GetVarInt(vMI, ofs, nIndex, nB)) {
+                    break;
+                }
+                anon_indices.insert(nIndex);
+            }
+        }
+        block_txids.insert(tx->GetHash());
+    }
+    if (outpoints.empty() && anon_indices.empty()) {
+        return;
+    }
+
+    std::vector<std::optional<Coin>> coins(outpoints.size());
+    std::vector<CPrefetchCheck> vChecks;
+    vChecks.reserve(outpoints.size() + anon_indices.size());
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        vChecks.emplace_back(CoinsDB(), outpoints[i], coins[i]);
+    }
+    for (int64_t index : anon_indices) {
+        vChecks.emplace_back(*m_blockman.m_block_tree_db, index);
+    }
+    CCheckQueueControl<CPrefetchCheck> control(&prefetchqueue);
+    control.Add(vChecks);
+    control.Wait();
+
+    // The database can't change while cs_main is held, so the coins read are
+    // what the tip cache would have fetched
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        if (coins[i]) {
+            tip.AddFetchedCoin(outpoints[i], std::move(*coins[i]));
+        }
+    }
 }
 
 /**
@@ -2337,9 +2562,15 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex& block_index, const Ch
 }
 
 
+ValidationPhaseTimes g_validation_phase_times;
+
 static int64_t nTimeCheck = 0;
 static int64_t nTimeForks = 0;
 static int64_t nTimeConnect = 0;
+static int64_t nTimeIndexQueue = 0;
+static int64_t nTimeScriptWait = 0;
+static int64_t nTimeIndexWait = 0;
+static int64_t nTimeIndexMerge = 0;
 static int64_t nTimeVerify = 0;
 static int64_t nTimeUndo = 0;
 static int64_t nTimeIndex = 0;
@@ -2387,7 +2618,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
 
     if (block.IsProofOfStake()) {
-        pindex->bnStakeModifier = ComputeStakeModifierV2(pindex->pprev, pindex->prevoutStake.hash);
+        pindex->SetStakeModifier(ComputeStakeModifierV2(pindex->pprev, pindex->GetPrevoutStake().hash));
         m_blockman.m_dirty_blockindex.insert(pindex);
 
         uint256 hashProof, targetProofOfStake;
@@ -2548,6 +2779,8 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
     LogPrint(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), nTimeForks * MICRO, nTimeForks * MILLI / nBlocksTotal);
+    // Excludes the rangeproofs and MLSAGs checked inline, they have their own phases
+    ValidationPhaseTimer coins_timer{&ValidationPhaseTimes::coins};
 
     CBlockUndo blockundo;
 
@@ -2646,35 +2879,6 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
                         // Cache recently spent coins for staking.
                         view.spent_cache.emplace_back(input.prevout, SpentCoin(coin, pindex->nHeight));
                     }
-                    if (!fAddressIndex && !fSpentIndex) {
-                        continue;
-                    }
-
-                    const CScript *pScript = &coin.out.scriptPubKey;
-                    CAmount nValue = coin.nType == OUTPUT_CT ? 0 : coin.out.nValue;
-                    std::vector<uint8_t> hashBytes;
-                    int scriptType = 0;
-
-                    if (!ExtractIndexInfo(pScript, scriptType, hashBytes)) {
-                        continue;
-                    }
-
-                    uint256 hashAddress;
-                    if (scriptType > 0) {
-                        hashAddress = uint256(hashBytes.data(), hashBytes.size());
-                    }
-                    if (fAddressIndex && scriptType > 0) {
-                        // record spending activity
-                        view.addressIndex.push_back(std::make_pair(CAddressIndexKey(scriptType, hashAddress, pindex->nHeight, i, txhash, j, true), nValue * -1));
-                        // remove address from unspent index
-                        view.addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(scriptType, hashAddress, input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
-                    }
-                    if (fSpentIndex) {
-                        CAmount nValue = coin.nType == OUTPUT_CT ? -1 : coin.out.nValue;
-                        // add the spent index to determine the txid and input that spent an output
-                        // and to find the amount and address from an input
-                        view.spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, pindex->nHeight, nValue, scriptType, hashAddress)));
-                    }
                 }
 
                 if (tx_state.m_funds_smsg) {
@@ -2781,32 +2985,6 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             }
         }
 
-        if (fAddressIndex) {
-            // Update outputs for insight
-            for (unsigned int k = 0; k < tx.vpout.size(); k++) {
-                const CTxOutBase *out = tx.vpout[k].get();
-
-                if (!out->IsType(OUTPUT_STANDARD)
-                    && !out->IsType(OUTPUT_CT)) {
-                    continue;
-                }
-
-                const CScript *pScript;
-                std::vector<unsigned char> hashBytes;
-                int scriptType = 0;
-                CAmount nValue;
-                if (!ExtractIndexInfo(out, scriptType, hashBytes, nValue, pScript)
-                    || scriptType == 0) {
-                    continue;
-                }
-
-                // Record receiving activity
-                view.addressIndex.push_back(std::make_pair(CAddressIndexKey(scriptType, uint256(hashBytes.data(), hashBytes.size()), pindex->nHeight, i, txhash, k, false), nValue));
-                // Record unspent output
-                view.addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(scriptType, uint256(hashBytes.data(), hashBytes.size()), txhash, k), CAddressUnspentValue(nValue, *pScript, pindex->nHeight)));
-            }
-        }
-
         block_balances[BAL_IND_PLAIN] += tx_state.tx_balances[BAL_IND_PLAIN_ADDED] - tx_state.tx_balances[BAL_IND_PLAIN_REMOVED];
         block_balances[BAL_IND_BLIND] += tx_state.tx_balances[BAL_IND_BLIND_ADDED] - tx_state.tx_balances[BAL_IND_BLIND_REMOVED];
         block_balances[BAL_IND_ANON]  += tx_state.tx_balances[BAL_IND_ANON_ADDED]  - tx_state.tx_balances[BAL_IND_ANON_REMOVED];
@@ -2814,14 +2992,64 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
 
     int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
+    coins_timer.Stop();
     LogPrint(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * MICRO, nTimeConnect * MILLI / nBlocksTotal);
 
+    // Collect address and spent index entries on the index workers while the
+    // scripts are checked, spent coins are in the undo data now.
+    const bool fIndexEntries = fAddressIndex || fSpentIndex;
+    std::vector<TxIndexEntries> vTxIndexEntries(fIndexEntries ? block.vtx.size() : 0);
+    CCheckQueueControl<CIndexEntryCheck> index_control(fIndexEntries && g_parallel_script_checks ? &indexentryqueue : nullptr);
+    if (fIndexEntries) {
+        std::vector<CIndexEntryCheck> vIndexChecks;
+        vIndexChecks.reserve(block.vtx.size());
+        size_t nUndo = 0;
+        for (unsigned int i = 0; i < block.vtx.size(); i++) {
+            const CTransaction &tx = *(block.vtx[i]);
+            const CTxUndo *txundo = nullptr;
+            if (!tx.IsCoinBase()) {
+                if (tx.IsGlobeVersion()) {
+                    txundo = &blockundo.vtxundo[nUndo];
+                }
+                nUndo++;
+            }
+            if (!txundo && !fAddressIndex) {
+                continue;
+            }
+            vIndexChecks.emplace_back(tx, txundo, i, pindex->nHeight, vTxIndexEntries[i]);
+        }
+        if (g_parallel_script_checks) {
+            index_control.Add(vIndexChecks);
+        } else {
+            for (auto &check : vIndexChecks) {
+                check();
+            }
+        }
+    }
+    int64_t nTime3a = GetTimeMicros(); nTimeIndexQueue += nTime3a - nTime3;
 
     if (!control.Wait()) {
         LogPrintf("ERROR: %s: CheckQueue failed\n", __func__);
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "block-validation-failed");
     }
 
+    if (fIndexEntries) {
+        int64_t nTime3b = GetTimeMicros(); nTimeScriptWait += nTime3b - nTime3a;
+        index_control.Wait();
+        int64_t nTime3c = GetTimeMicros(); nTimeIndexWait += nTime3c - nTime3b;
+        // Merge in block order, the same order the entries were added in serially
+        for (auto &entries : vTxIndexEntries) {
+            view.addressIndex.insert(view.addressIndex.end(), std::make_move_iterator(entries.addressIndex.begin()), std::make_move_iterator(entries.addressIndex.end()));
+            view.addressUnspentIndex.insert(view.addressUnspentIndex.end(), std::make_move_iterator(entries.addressUnspentIndex.begin()), std::make_move_iterator(entries.addressUnspentIndex.end()));
+            view.spentIndex.insert(view.spentIndex.end(), std::make_move_iterator(entries.spentIndex.begin()), std::make_move_iterator(entries.spentIndex.end()));
+        }
+        int64_t nTime3d = GetTimeMicros(); nTimeIndexMerge += nTime3d - nTime3c;
+        LogPrint(BCLog::BENCH, "      - Index entries queued: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3a - nTime3), nTimeIndexQueue * MICRO, nTimeIndexQueue * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCH, "      - Script checks alongside: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3b - nTime3a), nTimeScriptWait * MICRO, nTimeScriptWait * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCH, "      - Index entries wait: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3c - nTime3b), nTimeIndexWait * MICRO, nTimeIndexWait * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCH, "      - Index entries merge: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3d - nTime3c), nTimeIndexMerge * MICRO, nTimeIndexMerge * MILLI / nBlocksTotal);
+    }
+
     if (fGlobeMode) {
         if (block.nTime >= consensus.clamp_tx_version_time) {
             nMoneyCreated -= nFees;  // nStakeReward includes fees
@@ -3040,6 +3268,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     view.SetBestBlock(pindex->GetBlockHash(), pindex->nHeight);
 
     int64_t nTime6 = GetTimeMicros(); nTimeIndex += nTime6 - nTime5;
+    AddValidationPhaseTime(&ValidationPhaseTimes::index, nTime6 - nTime5);
     LogPrint(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime6 - nTime5), nTimeIndex * MICRO, nTimeIndex * MILLI / nBlocksTotal);
 
     TRACE6(validation, block_connected,
@@ -3337,9 +3566,13 @@ bool FlushView(CCoinsViewCache *view, BlockValidationState& state, Chainstate &c
             std::pair<uint8_t, CCmpPubKey> key = std::make_pair(DB_RCTKEYIMAGE, it.first);
             batch.Write(key, data);
         }
-        for (const auto &it : view->anonOutputs) {
+        for (auto &it : view->anonOutputs) {
+            // Stored so rings using the output skip the hash to curve
+            if (!SetKeyImageBase(it.second)) {
+                return error("%s: SetKeyImageBase failed, index %d.", __func__, it.first);
+            }
             std::pair<uint8_t, int64_t> key = std::make_pair(DB_RCTOUTPUT, it.first);
-            batch.Write(key, it.second);
+            batch.Write(key, Using<AnonOutputDBFormatter>(it.second));
         }
         for (const auto &it : view->anonOutputLinks) {
             std::pair<uint8_t, CCmpPubKey> key = std::make_pair(DB_RCTOUTPUT_LINK, it.first);
@@ -3519,6 +3752,7 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
 }
 
 static int64_t nTimeReadFromDiskTotal = 0;
+static int64_t nTimePrefetchTotal = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -3594,6 +3828,10 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDiskTotal += nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDiskTotal * MICRO, nTimeReadFromDiskTotal * MILLI / nBlocksTotal);
+    PrefetchInputs(blockConnecting);
+    int64_t nTime2a = GetTimeMicros(); nTimePrefetchTotal += nTime2a - nTime2;
+    AddValidationPhaseTime(&ValidationPhaseTimes::prefetch, nTime2a - nTime2);
+    LogPrint(BCLog::BENCH, "  - Prefetch inputs: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime2a - nTime2) * MILLI, nTimePrefetchTotal * MICRO, nTimePrefetchTotal * MILLI / nBlocksTotal);
     {
         CCoinsViewCache view(&CoinsTip());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view);
@@ -3606,13 +3844,14 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
                 InvalidBlockFound(pindexNew, state);
             return error("%s: ConnectBlock %s failed, %s", __func__, pindexNew->GetBlockHash().ToString(), state.ToString());
         }
-        nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
+        nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2a;
         assert(nBlocksTotal > 0);
-        LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2a) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
         bool flushed = FlushView(&view, state, *this, false);
         assert(flushed);
     }
     int64_t nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
+    AddValidationPhaseTime(&ValidationPhaseTimes::flush, nTime4 - nTime3);
     LogPrint(BCLog::BENCH, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, nTimeFlush * MICRO, nTimeFlush * MILLI / nBlocksTotal);
     // Write the chain state to disk, if necessary.
     if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED))
@@ -3621,6 +3860,7 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
         return false;
     }
     int64_t nTime5 = GetTimeMicros(); nTimeChainState += nTime5 - nTime4;
+    AddValidationPhaseTime(&ValidationPhaseTimes::flush, nTime5 - nTime4);
     LogPrint(BCLog::BENCH, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime5 - nTime4) * MILLI, nTimeChainState * MICRO, nTimeChainState * MILLI / nBlocksTotal);
     // Remove conflicting transactions from the mempool.;
     if (m_mempool) {
@@ -3847,7 +4087,7 @@ static bool NotifyHeaderTip(Chainstate& chainstate) LOCKS_EXCLUDED(cs_main) {
 static void LimitValidationInterfaceQueue() LOCKS_EXCLUDED(cs_main) {
     AssertLockNotHeld(cs_main);
 
-    if (GetMainSignals().CallbacksPending() > 10) {
+    if (GetMainSignals().CallbacksPending() > GetMainSignals().CallbacksPendingLimit()) {
         SyncWithValidationInterfaceQueue();
     }
 }
@@ -4256,6 +4496,8 @@ bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensu
     if (block.fChecked)
         return true;
 
+    const ValidationPhaseTimer timer{&ValidationPhaseTimes::check_block};
+
     // Check that the header is valid (particularly PoW).  This is mostly
     // redundant with the call in AcceptBlockHeader.
     if (!CheckBlockHeader(block, state, consensusParams, fCheckPOW))
@@ -4918,9 +5160,9 @@ bool Chainstate::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockV
 
     if (block.IsProofOfStake()) {
         pindex->SetProofOfStake();
-        pindex->prevoutStake = pblock->vtx[0]->vin[0].prevout;
+        pindex->SetPrevoutStake(pblock->vtx[0]->vin[0].prevout);
         if (!pindex->pprev ||
-            (pindex->pprev->bnStakeModifier.IsNull() &&
+            (pindex->pprev->GetStakeModifier().IsNull() &&
              pindex->pprev->GetBlockHash() != m_params.GetConsensus().hashGenesisBlock)) {
             // Block received out of order
             if (fGlobeMode && !IsInitialBlockDownload()) {
@@ -4933,7 +5175,7 @@ bool Chainstate::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockV
                 return globe::DelayBlock(m_blockman, pblock, state);
             }
         } else {
-            pindex->bnStakeModifier = ComputeStakeModifierV2(pindex->pprev, pindex->prevoutStake.hash);
+            pindex->SetStakeModifier(ComputeStakeModifierV2(pindex->pprev, pblock->vtx[0]->vin[0].prevout.hash));
         }
         pindex->nFlags = pindex->nFlags & (uint32_t)~BLOCK_DELAYED;
         m_blockman.m_dirty_blockindex.insert(pindex);
@@ -5089,6 +5331,47 @@ MempoolAcceptResult ChainstateManager::ProcessTransaction(const CTransactionRef&
     return result;
 }
 
+void ChainstateManager::PrevalidateTransaction(const CTransactionRef& tx)
+{
+    AssertLockNotHeld(cs_main);
+    if (!g_parallel_script_checks || !tx->IsGlobeVersion()) {
+        return;
+    }
+    const auto [spend_height, mempool] = WITH_LOCK(cs_main, return std::make_pair(ActiveChain().Height(), ActiveChainstate().GetMempool()));
+    if (!mempool) {
+        return;
+    }
+    TxValidationState state;
+    state.SetStateInfo(GetTime(), spend_height, GetConsensus(), fGlobeMode, /*skip_rangeproof=*/false);
+    // Transactions reusing a key image are rejected cheaply under cs_main,
+    // don't verify their proofs first
+    if (!PrecheckAnonKeyImages(*tx, *m_blockman.m_block_tree_db, mempool, state)) {
+        return;
+    }
+
+    std::vector<CPrevalidationCheck> vChecks;
+    for (size_t i = 0; i < tx->vpout.size(); ++i) {
+        if (tx->vpout[i]->IsType(OUTPUT_CT) || tx->vpout[i]->IsType(OUTPUT_RINGCT)) {
+            vChecks.emplace_back(*tx, state, i);
+        }
+    }
+    for (size_t i = 0; i < tx->vin.size(); ++i) {
+        if (tx->vin[i].IsAnonInput()) {
+            vChecks.emplace_back(*tx, state, *m_blockman.m_block_tree_db, i);
+        }
+    }
+    if (vChecks.empty()) {
+        return;
+    }
+    const size_t num_checks = vChecks.size();
+    const auto time_start{SteadyClock::now()};
+    CCheckQueueControl<CPrevalidationCheck> control(&prevalidationqueue);
+    control.Add(vChecks);
+    control.Wait();
+    LogPrint(BCLog::BENCH, "Prevalidated %s: %u checks in %dus\n", tx->GetHash().ToString(), num_checks,
+             Ticks<std::chrono::microseconds>(SteadyClock::now() - time_start));
+}
+
 bool TestBlockValidity(BlockValidationState& state,
                        const CChainParams& chainparams,
                        Chainstate& chainstate,
@@ -6784,9 +7067,10 @@ bool ProcessDuplicateStakeHeader(BlockManager &blockman, CBlockIndex *pindex, No
                     pindexPrev->nStatus &= (~BLOCK_FAILED_VALID);
                     blockman.m_dirty_blockindex.insert(pindexPrev);
 
-                    if (!pindexPrev->prevoutStake.IsNull()) {
+                    const COutPoint prevout_stake = pindexPrev->GetPrevoutStake();
+                    if (!prevout_stake.IsNull()) {
                         uint256 prevhash = pindexPrev->GetBlockHash();
-                        globe::AddToMapStakeSeen(pindexPrev->prevoutStake, prevhash);
+                        globe::AddToMapStakeSeen(prevout_stake, prevhash);
                     }
 
                     pindexPrev->nStatus &= (~BLOCK_FAILED_CHILD);
@@ -6798,8 +7082,9 @@ bool ProcessDuplicateStakeHeader(BlockManager &blockman, CBlockIndex *pindex, No
             pindex->nStatus &= (~BLOCK_FAILED_CHILD);
         //};
 
-        if (!pindex->prevoutStake.IsNull()) {
-            globe::AddToMapStakeSeen(pindex->prevoutStake, hash);
+        const COutPoint prevout_stake = pindex->GetPrevoutStake();
+        if (!prevout_stake.IsNull()) {
+            globe::AddToMapStakeSeen(prevout_stake, hash);
         }
         return true;
     }
@@ -29,6 +29,7 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/hasher.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <versionbits.h>
 
@@ -88,6 +89,10 @@ static const uint64_t MEMPOOL_MIN_GAS_LIMIT = 22000;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static const int MAX_SCRIPTCHECK_THREADS = 15;
+/** Maximum number of threads collecting address and spent index entries */
+static const int MAX_INDEX_ENTRY_THREADS = 2;
+/** Number of threads reading block inputs from disk before ConnectBlock */
+static const int PREFETCH_THREADS = 4;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
 static const int64_t DEFAULT_MAX_TIP_AGE = 12 * 60 * 60; //Changed to 12 hours so that isInitialBlockDownload() is more accurate
@@ -165,6 +170,84 @@ void StartScriptCheckWorkerThreads(int threads_num);
 /** Stop all of the script checking worker threads */
 void StopScriptCheckWorkerThreads();
 
+/**
+ * Time spent in each block validation phase in microseconds, summed over all
+ * threads. Only collected while enabled, see globe-chainstate -replay.
+ * The phases are exclusive: time spent in a phase nested in another on the
+ * same thread, like the rangeproofs checked by CheckBlock, only counts for
+ * the inner phase.
+ */
+struct ValidationPhaseTimes
+{
+    std::atomic<bool> enabled{false};
+    std::atomic<int64_t> check_block{0};
+    std::atomic<int64_t> prefetch{0};
+    std::atomic<int64_t> rangeproof{0};
+    std::atomic<int64_t> mlsag{0};
+    std::atomic<int64_t> coins{0};
+    std::atomic<int64_t> index{0};
+    std::atomic<int64_t> flush{0};
+};
+extern ValidationPhaseTimes g_validation_phase_times;
+
+/**
+ * Adds its lifetime, or the time until Stop, to a phase of
+ * g_validation_phase_times. The timer running on the thread before it is
+ * paused meanwhile. Timers must end in the reverse order they started.
+ */
+class ValidationPhaseTimer
+{
+    std::atomic<int64_t>* m_phase{nullptr};
+    int64_t m_start{0};
+    ValidationPhaseTimer* m_outer{nullptr};
+
+    /** Innermost running timer of this thread */
+    static inline thread_local ValidationPhaseTimer* g_innermost{nullptr};
+
+public:
+    explicit ValidationPhaseTimer(std::atomic<int64_t> ValidationPhaseTimes::*phase)
+    {
+        if (g_validation_phase_times.enabled.load(std::memory_order_relaxed)) {
+            m_phase = &(g_validation_phase_times.*phase);
+            m_start = GetTimeMicros();
+            m_outer = g_innermost;
+            if (m_outer) {
+                m_outer->m_phase->fetch_add(m_start - m_outer->m_start, std::memory_order_relaxed);
+            }
+            g_innermost = this;
+        }
+    }
+    ~ValidationPhaseTimer()
+    {
+        Stop();
+    }
+    void Stop()
+    {
+        if (!m_phase) {
+            return;
+        }
+        assert(g_innermost == this);
+        const int64_t now = GetTimeMicros();
+        m_phase->fetch_add(now - m_start, std::memory_order_relaxed);
+        m_phase = nullptr;
+        g_innermost = m_outer;
+        if (m_outer) {
+            m_outer->m_start = now;
+        }
+    }
+    ValidationPhaseTimer(const ValidationPhaseTimer&) = delete;
+    ValidationPhaseTimer& operator=(const ValidationPhaseTimer&) = delete;
+};
+
+/** Add an interval measured by the caller to a phase of g_validation_phase_times,
+ * the interval must not contain a ValidationPhaseTimer */
+inline void AddValidationPhaseTime(std::atomic<int64_t> ValidationPhaseTimes::*phase, int64_t micros)
+{
+    if (g_validation_phase_times.enabled.load(std::memory_order_relaxed)) {
+        (g_validation_phase_times.*phase).fetch_add(micros, std::memory_order_relaxed);
+    }
+}
+
 namespace globe {
 static constexpr size_t MAX_STAKE_SEEN_SIZE = 1000;
 inline int64_t FutureDrift(int64_t nTime) { return nTime + 15; } // FutureDriftV2
@@ -431,6 +514,19 @@ public:
 /** Initializes the script-execution cache */
 [[nodiscard]] bool InitScriptExecutionCache(size_t max_size_bytes);
 
+/**
+ * Rangeproofs and MLSAG signatures verified outside of block validation, so
+ * neither the mempool nor block validation repeats checks run by
+ * ChainstateManager::PrevalidateTransaction. Entries are salted hashes of
+ * all data a check read.
+ */
+[[nodiscard]] bool InitPrevalidationCache(size_t max_size_bytes);
+uint256 RangeProofCacheEntry(const secp256k1_pedersen_commitment& commitment, const std::vector<uint8_t>& rangeproof, bool bulletproof);
+/** Entry for the MLSAG of input n of transaction wtxid over the ring read from the rct index */
+uint256 MLSAGCacheEntry(const uint256& wtxid, size_t input, Span<const uint8_t> ring_pubkeys, const std::vector<secp256k1_pedersen_commitment>& ring_commitments);
+bool PrevalidationCacheContains(const uint256& entry, bool erase);
+void PrevalidationCacheInsert(const uint256& entry);
+
 /** Functions for validating blocks and updating the block tree */
 
 /** Context-independent validity checks */
@@ -843,6 +939,8 @@ public:
 //private:
     bool ActivateBestChainStep(BlockValidationState& state, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
     bool ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+    /** Read the coins and anon ring members spent by block in parallel, so ConnectBlock finds them cached */
+    void PrefetchInputs(const CBlock& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     void InvalidBlockFound(CBlockIndex* pindex, const BlockValidationState& state) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -1153,6 +1251,14 @@ public:
     [[nodiscard]] MempoolAcceptResult ProcessTransaction(const CTransactionRef& tx, bool test_accept=false, bool ignore_locks=false)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Verify the rangeproofs and MLSAG signatures of a transaction on the
+     * script check workers before ProcessTransaction takes cs_main. Rings
+     * are read from the rct index as it is now. Checks that pass are cached
+     * for ProcessTransaction, failures are left for it to report.
+     */
+    void PrevalidateTransaction(const CTransactionRef& tx) LOCKS_EXCLUDED(cs_main);
+
     //! Load the block tree and coins database from disk, initializing state if we're running with -reindex
     bool LoadBlockIndex() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
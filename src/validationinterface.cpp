@@ -12,11 +12,179 @@
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <scheduler.h>
+#include <tinyformat.h>
+#include <util/thread.h>
+#include <util/time.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <future>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
+namespace {
+/**
+ * Ordered queue of callbacks for a single subscriber, serviced by its own thread.
+ */
+class SubscriberQueue
+{
+private:
+    struct Item {
+        std::function<void()> func;
+        SteadyClock::time_point queued;
+    };
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Item> m_queue GUARDED_BY(m_mutex);
+    //! Time the callback being run was queued
+    std::optional<SteadyClock::time_point> m_running GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    //! Set when the thread returns after being stopped
+    bool m_finished GUARDED_BY(m_mutex){false};
+    size_t m_max_pending GUARDED_BY(m_mutex){0};
+    uint64_t m_processed GUARDED_BY(m_mutex){0};
+    std::thread m_thread;
+
+    void Run() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::function<void()> func;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                while (!m_stop && m_queue.empty()) {
+                    m_cond.wait(lock);
+                }
+                if (m_stop) {
+                    m_finished = true;
+                    m_cond.notify_all();
+                    return;
+                }
+                func = std::move(m_queue.front().func);
+                m_running = m_queue.front().queued;
+                m_queue.pop_front();
+            }
+            func();
+            func = nullptr;
+            {
+                LOCK(m_mutex);
+                m_running.reset();
+                m_processed++;
+            }
+            m_cond.notify_all();
+        }
+    }
+
+public:
+    const std::string m_name;
+
+    SubscriberQueue(std::string name, int id) : m_name(std::move(name))
+    {
+        m_thread = std::thread(&util::TraceThread, strprintf("valqueue.%d", id), [this] { Run(); });
+    }
+
+    /** Must not be destroyed on its own thread */
+    ~SubscriberQueue()
+    {
+        Stop();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    void Add(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            LOCK(m_mutex);
+            if (m_stop) {
+                return;
+            }
+            m_queue.push_back({std::move(func), SteadyClock::now()});
+            m_max_pending = std::max(m_max_pending, m_queue.size());
+        }
+        m_cond.notify_all();
+    }
+
+    /** Stop the thread after the running callback, pending callbacks are dropped */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::deque<Item> dropped;
+        {
+            LOCK(m_mutex);
+            m_stop = true;
+            dropped.swap(m_queue);
+        }
+        m_cond.notify_all();
+    }
+
+    /** Wait until the thread of a stopped queue has returned, does nothing on the queue's thread */
+    void WaitFinished() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_thread.get_id() == std::this_thread::get_id()) {
+            return;
+        }
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_finished) {
+            m_cond.wait(lock);
+        }
+    }
+
+    bool Finished() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return m_finished;
+    }
+
+    /** Wait until every queued callback has run, must not be called from the queue's thread */
+    void WaitIdle() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_stop && (!m_queue.empty() || m_running)) {
+            m_cond.wait(lock);
+        }
+    }
+
+    size_t Pending() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return m_queue.size() + (m_running ? 1 : 0);
+    }
+
+    ValidationQueueInfo GetInfo() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        ValidationQueueInfo info;
+        info.name = m_name;
+        info.pending = m_queue.size() + (m_running ? 1 : 0);
+        info.max_pending = m_max_pending;
+        info.processed = m_processed;
+        std::optional<SteadyClock::time_point> oldest = m_running;
+        if (!oldest && !m_queue.empty()) {
+            oldest = m_queue.front().queued;
+        }
+        if (oldest) {
+            info.lag_ms = Ticks<std::chrono::milliseconds>(SteadyClock::now() - *oldest);
+        }
+        return info;
+    }
+};
+
+/**
+ * Runs a function on the shared queue once every subscriber queue holding a
+ * reference has reached it, destroying the closure releases the reference.
+ */
+class QueueBarrier
+{
+private:
+    SingleThreadedSchedulerClient& m_client;
+    std::function<void()> m_func;
+
+public:
+    QueueBarrier(SingleThreadedSchedulerClient& client, std::function<void()> func) : m_client(client), m_func(std::move(func)) {}
+    ~QueueBarrier() { m_client.AddToProcessQueue(std::move(m_func)); }
+};
+} // namespace
+
 /**
  * MainSignalsImpl manages a list of shared_ptr<CValidationInterface> callbacks.
  *
@@ -33,9 +201,38 @@ private:
     //! count is equal to the number of current executions of that entry, plus 1
     //! if it's registered. It cannot be 0 because that would imply it is
     //! unregistered and also not being executed (so shouldn't exist).
-    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; };
+    //! The queue is only set when subscribers have their own queues.
+    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; std::shared_ptr<SubscriberQueue> queue; };
     std::list<ListEntry> m_list GUARDED_BY(m_mutex);
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
+    int m_next_queue_id GUARDED_BY(m_mutex){0};
+    //! Queues of unregistered subscribers, their threads are joined once finished
+    //! as unregistering may happen on the thread itself or with locks held that it needs.
+    std::vector<std::shared_ptr<SubscriberQueue>> m_stopped_queues GUARDED_BY(m_mutex);
+
+    /** Release the stopped queues whose thread has returned */
+    void PruneStoppedQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<std::shared_ptr<SubscriberQueue>> finished;
+        {
+            LOCK(m_mutex);
+            auto it = std::partition(m_stopped_queues.begin(), m_stopped_queues.end(),
+                                     [](const auto& queue) { return !queue->Finished(); });
+            finished.assign(std::make_move_iterator(it), std::make_move_iterator(m_stopped_queues.end()));
+            m_stopped_queues.erase(it, m_stopped_queues.end());
+        }
+        // Their threads are joined here, outside of m_mutex
+    }
+
+    std::vector<std::shared_ptr<SubscriberQueue>> GetQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        for (const auto& entry : m_map) {
+            queues.push_back(entry.second->queue);
+        }
+        return queues;
+    }
 
 public:
     // We are not allowed to assume the scheduler only runs in one thread,
@@ -43,24 +240,45 @@ public:
     // our own queue here :(
     SingleThreadedSchedulerClient m_schedulerClient;
 
-    explicit MainSignalsImpl(CScheduler& scheduler LIFETIMEBOUND) : m_schedulerClient(scheduler) {}
+    //! Max pending callbacks per subscriber queue, 0 if subscribers share m_schedulerClient
+    const size_t m_queue_depth;
+
+    explicit MainSignalsImpl(CScheduler& scheduler LIFETIMEBOUND, size_t queue_depth) : m_schedulerClient(scheduler), m_queue_depth(queue_depth) {}
+
+    ~MainSignalsImpl()
+    {
+        Clear();
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        WITH_LOCK(m_mutex, queues.swap(m_stopped_queues));
+    }
 
     void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto inserted = m_map.emplace(callbacks.get(), m_list.end());
         if (inserted.second) inserted.first->second = m_list.emplace(m_list.end());
+        if (m_queue_depth > 0 && !inserted.first->second->queue) {
+            inserted.first->second->queue = std::make_shared<SubscriberQueue>(callbacks->ValidationQueueName(), m_next_queue_id++);
+        }
         inserted.first->second->callbacks = std::move(callbacks);
     }
 
     void Unregister(CValidationInterface* callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        LOCK(m_mutex);
-        auto it = m_map.find(callbacks);
-        if (it != m_map.end()) {
-            if (!--it->second->count) m_list.erase(it->second);
-            m_map.erase(it);
+        std::shared_ptr<SubscriberQueue> queue;
+        {
+            LOCK(m_mutex);
+            auto it = m_map.find(callbacks);
+            if (it != m_map.end()) {
+                queue = std::move(it->second->queue);
+                if (queue) m_stopped_queues.push_back(queue);
+                if (!--it->second->count) m_list.erase(it->second);
+                m_map.erase(it);
+            }
         }
+        // Pending callbacks are dropped, as they would be skipped by Iterate
+        if (queue) queue->Stop();
+        PruneStoppedQueues();
     }
 
     //! Clear unregisters every previously registered callback, erasing every
@@ -69,11 +287,20 @@ public:
     //! executing.
     void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        LOCK(m_mutex);
-        for (const auto& entry : m_map) {
-            if (!--entry.second->count) m_list.erase(entry.second);
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        {
+            LOCK(m_mutex);
+            for (const auto& entry : m_map) {
+                if (entry.second->queue) queues.push_back(std::move(entry.second->queue));
+                if (!--entry.second->count) m_list.erase(entry.second);
+            }
+            m_map.clear();
+            m_stopped_queues.insert(m_stopped_queues.end(), queues.begin(), queues.end());
+        }
+        for (const auto& queue : queues) {
+            queue->Stop();
         }
-        m_map.clear();
+        PruneStoppedQueues();
     }
 
     template<typename F> void Iterate(F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
@@ -88,14 +315,90 @@ public:
             it = --it->count ? std::next(it) : m_list.erase(it);
         }
     }
+
+    /** Queue an event for every subscriber */
+    void Enqueue(std::function<void(CValidationInterface&)> event, std::function<void()> log) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_queue_depth == 0) {
+            m_schedulerClient.AddToProcessQueue([this, event = std::move(event), log = std::move(log)] {
+                log();
+                Iterate(event);
+            });
+            return;
+        }
+        LOCK(m_mutex);
+        for (const auto& entry : m_map) {
+            entry.second->queue->Add([callbacks = entry.second->callbacks, event, log] {
+                log();
+                event(*callbacks);
+            });
+        }
+    }
+
+    /** Run func on the shared queue once all events queued before it were processed */
+    void EnqueueBarrier(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_queue_depth == 0) {
+            m_schedulerClient.AddToProcessQueue(std::move(func));
+            return;
+        }
+        auto barrier = std::make_shared<QueueBarrier>(m_schedulerClient, std::move(func));
+        for (const auto& queue : GetQueues()) {
+            queue->Add([barrier] {});
+        }
+    }
+
+    /** Wait for the callbacks still running for unregistered subscribers */
+    void WaitStoppedQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        for (const auto& queue : WITH_LOCK(m_mutex, return m_stopped_queues)) {
+            queue->WaitFinished();
+        }
+        PruneStoppedQueues();
+    }
+
+    /** Wait for every subscriber queue, then run the shared queue on the calling thread */
+    void EmptyQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WaitStoppedQueues();
+        for (const auto& queue : GetQueues()) {
+            queue->WaitIdle();
+        }
+        m_schedulerClient.EmptyQueue();
+    }
+
+    size_t CallbacksPending() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        size_t pending = m_schedulerClient.CallbacksPending();
+        for (const auto& queue : GetQueues()) {
+            pending = std::max(pending, queue->Pending());
+        }
+        return pending;
+    }
+
+    std::vector<ValidationQueueInfo> GetQueueInfo() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<ValidationQueueInfo> infos;
+        if (m_queue_depth == 0) {
+            ValidationQueueInfo info;
+            info.name = "shared";
+            info.pending = m_schedulerClient.CallbacksPending();
+            infos.push_back(info);
+            return infos;
+        }
+        for (const auto& queue : GetQueues()) {
+            infos.push_back(queue->GetInfo());
+        }
+        return infos;
+    }
 };
 
 static CMainSignals g_signals;
 
-void CMainSignals::RegisterBackgroundSignalScheduler(CScheduler& scheduler)
+void CMainSignals::RegisterBackgroundSignalScheduler(CScheduler& scheduler, size_t queue_depth)
 {
     assert(!m_internals);
-    m_internals = std::make_unique<MainSignalsImpl>(scheduler);
+    m_internals = std::make_unique<MainSignalsImpl>(scheduler, queue_depth);
 }
 
 void CMainSignals::UnregisterBackgroundSignalScheduler()
@@ -106,14 +409,26 @@ void CMainSignals::UnregisterBackgroundSignalScheduler()
 void CMainSignals::FlushBackgroundCallbacks()
 {
     if (m_internals) {
-        m_internals->m_schedulerClient.EmptyQueue();
+        m_internals->EmptyQueues();
     }
 }
 
 size_t CMainSignals::CallbacksPending()
 {
     if (!m_internals) return 0;
-    return m_internals->m_schedulerClient.CallbacksPending();
+    return m_internals->CallbacksPending();
+}
+
+size_t CMainSignals::CallbacksPendingLimit()
+{
+    if (!m_internals || m_internals->m_queue_depth == 0) return SHARED_VALIDATION_QUEUE_DEPTH;
+    return m_internals->m_queue_depth;
+}
+
+std::vector<ValidationQueueInfo> CMainSignals::GetQueueInfo()
+{
+    if (!m_internals) return {};
+    return m_internals->GetQueueInfo();
 }
 
 CMainSignals& GetMainSignals()
@@ -157,12 +472,14 @@ void UnregisterAllValidationInterfaces()
 
 void CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    g_signals.m_internals->m_schedulerClient.AddToProcessQueue(std::move(func));
+    g_signals.m_internals->EnqueueBarrier(std::move(func));
 }
 
 void SyncWithValidationInterfaceQueue()
 {
     AssertLockNotHeld(cs_main);
+    // Callbacks of unregistered subscribers may still be running on their own queues
+    g_signals.m_internals->WaitStoppedQueues();
     // Block until the validation queue drains
     std::promise<void> promise;
     CallFunctionInValidationInterfaceQueue([&promise] {
@@ -179,9 +496,8 @@ void SyncWithValidationInterfaceQueue()
     do {                                                       \
         auto local_name = (name);                              \
         LOG_EVENT("Enqueuing " fmt, local_name, __VA_ARGS__);  \
-        m_internals->m_schedulerClient.AddToProcessQueue([=] { \
+        m_internals->Enqueue(event, [=] {                      \
             LOG_EVENT(fmt, local_name, __VA_ARGS__);           \
-            event();                                           \
         });                                                    \
     } while (0)
 
@@ -193,8 +509,8 @@ void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockInd
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    auto event = [pindexNew, pindexFork, fInitialDownload](CValidationInterface& callbacks) {
+        callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: new block hash=%s fork block hash=%s (in IBD=%s)", __func__,
                           pindexNew->GetBlockHash().ToString(),
@@ -203,8 +519,8 @@ void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockInd
 }
 
 void CMainSignals::TransactionAddedToMempool(const CTransactionRef& tx, uint64_t mempool_sequence) {
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
+    auto event = [tx, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionAddedToMempool(tx, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
                           tx->GetHash().ToString(),
@@ -212,8 +528,8 @@ void CMainSignals::TransactionAddedToMempool(const CTransactionRef& tx, uint64_t
 }
 
 void CMainSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
+    auto event = [tx, reason, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
                           tx->GetHash().ToString(),
@@ -221,8 +537,8 @@ void CMainSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemP
 }
 
 void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex) {
-    auto event = [pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(pblock, pindex); });
+    auto event = [pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockConnected(pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -231,8 +547,8 @@ void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, c
 
 void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex)
 {
-    auto event = [pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
+    auto event = [pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockDisconnected(pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -240,8 +556,8 @@ void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock
 }
 
 void CMainSignals::ChainStateFlushed(const CBlockLocator &locator) {
-    auto event = [locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(locator); });
+    auto event = [locator](CValidationInterface& callbacks) {
+        callbacks.ChainStateFlushed(locator);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
@@ -11,6 +11,8 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 extern RecursiveMutex cs_main;
 class BlockValidationState;
@@ -25,6 +27,23 @@ namespace smsg {
 class SecureMessage;
 }
 
+/** Default for -validationqueues, run each subscriber's callbacks on its own thread */
+static constexpr bool DEFAULT_VALIDATION_QUEUES{false};
+/** Default for -validationqueuedepth, pending callbacks before validation waits for subscribers */
+static constexpr unsigned int DEFAULT_VALIDATION_QUEUE_DEPTH{100};
+/** Pending callbacks before validation waits when all subscribers share one queue */
+static constexpr unsigned int SHARED_VALIDATION_QUEUE_DEPTH{10};
+
+/** State of a validation notification queue */
+struct ValidationQueueInfo {
+    std::string name;
+    size_t pending{0};
+    size_t max_pending{0};
+    uint64_t processed{0};
+    //! Age of the oldest callback not yet completed
+    int64_t lag_ms{0};
+};
+
 /** Register subscriber */
 void RegisterValidationInterface(CValidationInterface* callbacks);
 /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
@@ -180,6 +199,10 @@ protected:
     virtual void NewSecureMessage(const smsg::SecureMessage *psmsg, const uint160 &hash) {};
     virtual void LeavingIBD() {};
 
+public:
+    /** Name of the subscriber, reported for its notification queue */
+    virtual std::string ValidationQueueName() const { return "unnamed"; }
+
     friend class CMainSignals;
     friend class ValidationInterfaceTest;
 };
@@ -193,17 +216,26 @@ private:
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
     friend void ::CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
+    friend void ::SyncWithValidationInterfaceQueue();
 
 public:
-    /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
-    void RegisterBackgroundSignalScheduler(CScheduler& scheduler);
+    /**
+     * Register a CScheduler to give callbacks which should run in the background (may only be called once)
+     * If queue_depth is not 0 each subscriber gets its own ordered queue and thread, so a slow
+     * subscriber does not delay the others. Validation waits for a queue deeper than queue_depth.
+     */
+    void RegisterBackgroundSignalScheduler(CScheduler& scheduler, size_t queue_depth = 0);
     /** Unregister a CScheduler to give callbacks which should run in the background - these callbacks will now be dropped! */
     void UnregisterBackgroundSignalScheduler();
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Number of callbacks pending in the deepest queue */
     size_t CallbacksPending();
-
+    /** Pending callbacks above which validation should wait for the queues to drain */
+    size_t CallbacksPendingLimit();
+    /** Per queue state, one entry per subscriber when subscribers have their own queues */
+    std::vector<ValidationQueueInfo> GetQueueInfo();
 
     void UpdatedBlockTip(const CBlockIndex *, const CBlockIndex *, bool fInitialDownload);
     void TransactionAddedToMempool(const CTransactionRef&, uint64_t mempool_sequence);
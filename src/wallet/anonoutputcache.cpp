@@ -0,0 +1,186 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/anonoutputcache.h>
+
+namespace wallet {
+void AnonOutputCache::Insert(int64_t index, const CAnonOutput& ao, bool own)
+{
+    auto it = m_outputs.find(index);
+    if (it != m_outputs.end()) {
+        if (own && !it->second.own) {
+            it->second.own = true;
+            m_links[ao.pubkey] = index;
+            m_num_decoys--;
+            m_dirty_own = true;
+            m_dirty_decoys = true;
+        }
+        return;
+    }
+    m_outputs[index] = Entry{ao, own};
+    MarkDirty(own);
+    if (own) {
+        m_links[ao.pubkey] = index;
+        return;
+    }
+    m_decoy_order.push_back(index);
+    m_num_decoys++;
+    while (m_num_decoys > m_max_decoys && !m_decoy_order.empty()) {
+        it = m_outputs.find(m_decoy_order.front());
+        m_decoy_order.pop_front();
+        if (it != m_outputs.end() && !it->second.own) {
+            m_outputs.erase(it);
+            m_num_decoys--;
+        }
+    }
+}
+
+bool AnonOutputCache::ReadOutput(int64_t index, CAnonOutput& ao, bool own, const OutputReader& read)
+{
+    {
+        LOCK(m_mutex);
+        auto it = m_outputs.find(index);
+        if (it != m_outputs.end()) {
+            m_hits++;
+            ao = it->second.ao;
+            if (own) {
+                Insert(index, ao, own);
+            }
+            return true;
+        }
+        m_misses++;
+    }
+    // Read without m_mutex held, the reader locks cs_main
+    if (!read(index, ao)) {
+        return false;
+    }
+    LOCK(m_mutex);
+    Insert(index, ao, own);
+    return true;
+}
+
+bool AnonOutputCache::ReadOutputLink(const CCmpPubKey& pk, int64_t& index, const LinkReader& read_link, const OutputReader& read)
+{
+    {
+        LOCK(m_mutex);
+        auto it = m_links.find(pk);
+        if (it != m_links.end()) {
+            m_hits++;
+            index = it->second;
+            return true;
+        }
+    }
+    if (!read_link(pk, index)) {
+        return false;
+    }
+    // The output is needed too, its height decides when the link is invalidated
+    CAnonOutput ao;
+    return ReadOutput(index, ao, /*own=*/true, read) && ao.pubkey == pk;
+}
+
+void AnonOutputCache::Truncate(int height)
+{
+    for (auto it = m_outputs.begin(); it != m_outputs.end();) {
+        if (it->second.ao.nBlockHeight < height) {
+            ++it;
+            continue;
+        }
+        if (it->second.own) {
+            m_links.erase(it->second.ao.pubkey);
+        } else {
+            m_num_decoys--;
+        }
+        MarkDirty(it->second.own);
+        it = m_outputs.erase(it);
+    }
+}
+
+void AnonOutputCache::BlockDisconnected(int height)
+{
+    LOCK(m_mutex);
+    Truncate(height);
+}
+
+AnonOutputCache::Record AnonOutputCache::GetRecord(bool own, const uint256& tip_hash, int tip_height) const
+{
+    LOCK(m_mutex);
+    Record record;
+    record.tip_hash = tip_hash;
+    record.tip_height = tip_height;
+    for (const auto& entry : m_outputs) {
+        if (entry.second.own == own) {
+            record.outputs.emplace_hint(record.outputs.end(), entry.first, entry.second.ao);
+        }
+    }
+    return record;
+}
+
+void AnonOutputCache::LoadRecord(const Record& record, bool own, std::optional<int> tip_height)
+{
+    LOCK(m_mutex);
+    if (!tip_height || *tip_height != record.tip_height) {
+        // The recorded tip left the active chain, overwrite the record when next flushed
+        if (!record.outputs.empty()) {
+            MarkDirty(own);
+        }
+        return;
+    }
+    for (const auto& entry : record.outputs) {
+        // Outputs read ahead of the recorded tip may have been reorged out since
+        if (entry.second.nBlockHeight > record.tip_height) {
+            MarkDirty(own);
+            continue;
+        }
+        m_outputs.emplace(entry.first, Entry{entry.second, own});
+    }
+    Rebuild();
+}
+
+void AnonOutputCache::Rebuild()
+{
+    m_links.clear();
+    m_decoy_order.clear();
+    m_num_decoys = 0;
+    for (const auto& entry : m_outputs) {
+        if (entry.second.own) {
+            m_links[entry.second.ao.pubkey] = entry.first;
+        } else {
+            m_decoy_order.push_back(entry.first);
+            m_num_decoys++;
+        }
+    }
+}
+
+void AnonOutputCache::Clear()
+{
+    LOCK(m_mutex);
+    m_dirty_own |= !m_links.empty();
+    m_dirty_decoys |= m_num_decoys > 0;
+    m_outputs.clear();
+    Rebuild();
+}
+
+bool AnonOutputCache::IsDirty(bool own) const
+{
+    LOCK(m_mutex);
+    return own ? m_dirty_own : m_dirty_decoys;
+}
+
+void AnonOutputCache::MarkClean(bool own)
+{
+    LOCK(m_mutex);
+    (own ? m_dirty_own : m_dirty_decoys) = false;
+}
+
+AnonOutputCache::Stats AnonOutputCache::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats;
+    stats.own_outputs = m_links.size();
+    stats.decoys = m_num_decoys;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    return stats;
+}
+} // namespace wallet
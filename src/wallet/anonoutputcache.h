@@ -0,0 +1,110 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBE_WALLET_ANONOUTPUTCACHE_H
+#define GLOBE_WALLET_ANONOUTPUTCACHE_H
+
+#include <pubkey.h>
+#include <rctindex.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+
+namespace wallet {
+static constexpr size_t DEFAULT_ANON_OUTPUT_CACHE_DECOYS{10000};
+
+/**
+ * Anon output records read from the node, by anon index.
+ *
+ * Outputs owned by the wallet are kept until a reorg removes their block,
+ * decoys are kept up to a limit and evicted oldest first. Entries above a
+ * disconnected block are dropped as anon indices are reused by the replacing
+ * chain.
+ *
+ * Owned outputs and decoys are stored as separate records, each with the chain
+ * tip it was written at, so the small owned record can be written as it
+ * changes while the decoys are written less often.
+ */
+class AnonOutputCache
+{
+public:
+    using OutputReader = std::function<bool(int64_t index, CAnonOutput& ao)>;
+    using LinkReader = std::function<bool(const CCmpPubKey& pk, int64_t& index)>;
+
+    struct Stats {
+        size_t own_outputs{0};
+        size_t decoys{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
+    };
+
+    /** Entries of one kind as stored in the wallet db */
+    struct Record {
+        uint256 tip_hash;
+        int tip_height{-1};
+        std::map<int64_t, CAnonOutput> outputs;
+
+        SERIALIZE_METHODS(Record, obj)
+        {
+            READWRITE(obj.tip_hash, obj.tip_height, obj.outputs);
+        }
+    };
+
+    explicit AnonOutputCache(size_t max_decoys = DEFAULT_ANON_OUTPUT_CACHE_DECOYS) : m_max_decoys(max_decoys) {}
+
+    /** Read the output at index, reading through to the node on a miss */
+    bool ReadOutput(int64_t index, CAnonOutput& ao, bool own, const OutputReader& read) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Find the anon index of an owned output's pubkey */
+    bool ReadOutputLink(const CCmpPubKey& pk, int64_t& index, const LinkReader& read_link, const OutputReader& read) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Drop entries from blocks at or above height */
+    void BlockDisconnected(int height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Copy the owned outputs or the decoys, to be stored with the tip the wallet has processed */
+    Record GetRecord(bool own, const uint256& tip_hash, int tip_height) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /**
+     * Add the entries of a stored record the chain can't have replaced,
+     * tip_height is the height of the record's tip in the active chain.
+     */
+    void LoadRecord(const Record& record, bool own, std::optional<int> tip_height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** True if owned outputs or decoys changed since the last MarkClean of that kind */
+    bool IsDirty(bool own) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void MarkClean(bool own) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        CAnonOutput ao;
+        bool own{false};
+    };
+
+    mutable Mutex m_mutex;
+    const size_t m_max_decoys;
+    std::map<int64_t, Entry> m_outputs GUARDED_BY(m_mutex);
+    std::map<CCmpPubKey, int64_t> m_links GUARDED_BY(m_mutex);
+    //! Decoy indices in insertion order, may hold indices already removed
+    std::deque<int64_t> m_decoy_order GUARDED_BY(m_mutex);
+    size_t m_num_decoys GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+    bool m_dirty_own GUARDED_BY(m_mutex){false};
+    bool m_dirty_decoys GUARDED_BY(m_mutex){false};
+
+    void Insert(int64_t index, const CAnonOutput& ao, bool own) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Truncate(int height) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Rebuild() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void MarkDirty(bool own) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { (own ? m_dirty_own : m_dirty_decoys) = true; }
+};
+} // namespace wallet
+
+#endif // GLOBE_WALLET_ANONOUTPUTCACHE_H
@@ -10,6 +10,7 @@
 #include <util/system.h>
 #include <util/moneystr.h>
 
+#include <algorithm>
 #include <numeric>
 #include <optional>
 
@@ -324,6 +325,53 @@ std::optional<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups,
     return result;
 }
 
+std::optional<SelectionResult> ChooseBlindedSelectionResult(const std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
+                                                            const CoinSelectionParams& coin_selection_params, bool random_selection,
+                                                            size_t max_preferred_inputs)
+{
+    std::vector<SelectionResult> results;
+
+    std::vector<OutputGroup> positive_groups;
+    positive_groups.reserve(groups.size());
+    for (const OutputGroup& group : groups) {
+        if (group.GetSelectionAmount() > 0) {
+            positive_groups.push_back(group);
+        }
+    }
+
+    // SRD first, BnB sorts the pool
+    for (int i = 0; i < (random_selection ? BLINDED_SRD_DRAWS : 1); ++i) {
+        if (auto srd_result{SelectCoinsSRD(positive_groups, nTargetValue, coin_selection_params.rng_fast)}) {
+            srd_result->ComputeAndSetWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+            results.push_back(*srd_result);
+        }
+    }
+
+    if (auto bnb_result{SelectCoinsBnB(positive_groups, nTargetValue, coin_selection_params.m_cost_of_change)}) {
+        results.push_back(*bnb_result);
+    }
+
+    if (!random_selection) {
+        std::vector<OutputGroup> all_groups(groups);
+        if (auto knapsack_result{KnapsackSolver(all_groups, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast)}) {
+            knapsack_result->ComputeAndSetWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+            results.push_back(*knapsack_result);
+        }
+    }
+
+    if (results.empty()) {
+        return std::nullopt;
+    }
+    if (max_preferred_inputs > 0) {
+        const auto preferred = [&](const SelectionResult& result) { return result.GetInputSet().size() <= max_preferred_inputs; };
+        const auto end = std::partition(results.begin(), results.end(), preferred);
+        if (end != results.begin()) {
+            results.erase(end, results.end());
+        }
+    }
+    return *std::min_element(results.begin(), results.end());
+}
+
 /******************************************************************************
 
  OutputGroup
@@ -371,6 +371,21 @@ std::optional<SelectionResult> SelectCoinsSRD(const std::vector<OutputGroup>& ut
 // Original coin selection algorithm as a fallback
 std::optional<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
                                               CAmount change_target, FastRandomContext& rng);
+
+/** Number of SRD draws compared by ChooseBlindedSelectionResult when the selection must be random */
+static constexpr int BLINDED_SRD_DRAWS{4};
+
+/**
+ * Choose inputs among blinded or anon outputs, each in its own OutputGroup.
+ * Runs BnB and SRD, and the knapsack solver unless random_selection is set,
+ * returning the result with the least waste. When random_selection is set
+ * several SRD draws are compared, as a ring signature input costs much more
+ * than a plain one. If max_preferred_inputs is set, results with at most that
+ * many inputs are chosen over any with more.
+ */
+std::optional<SelectionResult> ChooseBlindedSelectionResult(const std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
+                                                            const CoinSelectionParams& coin_selection_params, bool random_selection,
+                                                            size_t max_preferred_inputs = 0);
 } // namespace wallet
 
 #endif // GLOBE_WALLET_COINSELECTION_H
@@ -0,0 +1,171 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/devicekeycache.h>
+
+#include <key/keyutil.h>
+
+#include <algorithm>
+
+namespace wallet {
+bool DeviceKeyCache::SetDevice(const std::string& device_id)
+{
+    LOCK(m_mutex);
+    if (m_device_id == device_id) {
+        return false;
+    }
+    m_device_id = device_id;
+    m_dirty = true;
+    if (m_xpubs.empty()) {
+        return false;
+    }
+    m_xpubs.clear();
+    return true;
+}
+
+int DeviceKeyCache::Lookup(OpStats& stats, const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error, const XPubFetcher& fetch)
+{
+    if (path.empty()) {
+        error = "Path is empty.";
+        return 1;
+    }
+
+    auto it = m_xpubs.find(path);
+    if (it != m_xpubs.end()) {
+        m_hits++;
+        ekp = it->second;
+        return 0;
+    }
+
+    // Longest cached prefix the rest of the path can be derived from without private keys
+    size_t have = 0;
+    for (size_t len = path.size() - 1; len > 0; --len) {
+        if (IsHardened(path[len])) {
+            break;
+        }
+        it = m_xpubs.find(std::vector<uint32_t>(path.begin(), path.begin() + len));
+        if (it != m_xpubs.end()) {
+            have = len;
+            ekp = it->second;
+            break;
+        }
+    }
+
+    if (have > 0) {
+        m_hits++;
+    } else {
+        // Read the hardened prefix from the device, a path without hardened
+        // indices stops one level up so its siblings are covered too.
+        size_t fetch_len = 0;
+        for (size_t i = 0; i < path.size(); ++i) {
+            if (IsHardened(path[i])) {
+                fetch_len = i + 1;
+            }
+        }
+        if (fetch_len == 0) {
+            fetch_len = std::max<size_t>(1, path.size() - 1);
+        }
+        std::vector<uint32_t> prefix(path.begin(), path.begin() + fetch_len);
+        stats.round_trips++;
+        if (0 != fetch(prefix, ekp, error)) {
+            return 1;
+        }
+        m_xpubs[prefix] = ekp;
+        m_dirty = true;
+        have = fetch_len;
+    }
+
+    for (size_t i = have; i < path.size(); ++i) {
+        CExtPubKey child;
+        if (!ekp.Derive(child, path[i])) {
+            error = "CExtPubKey Derive failed.";
+            return 1;
+        }
+        ekp = child;
+    }
+    return 0;
+}
+
+int DeviceKeyCache::GetXPub(const std::string& op, const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error, const XPubFetcher& fetch)
+{
+    LOCK(m_mutex);
+    OpStats& stats = m_op_stats[op];
+    const uint64_t round_trips = stats.round_trips;
+    stats.calls++;
+    int rv = Lookup(stats, path, ekp, error, fetch);
+    stats.last_round_trips = stats.round_trips - round_trips;
+    return rv;
+}
+
+int DeviceKeyCache::GetPubKey(const std::string& op, const std::vector<uint32_t>& path, CPubKey& pk, std::string& error, const XPubFetcher& fetch)
+{
+    CExtPubKey ekp;
+    if (0 != GetXPub(op, path, ekp, error, fetch)) {
+        return 1;
+    }
+    pk = ekp.pubkey;
+    return 0;
+}
+
+void DeviceKeyCache::CountDeviceCall(const std::string& op)
+{
+    LOCK(m_mutex);
+    OpStats& stats = m_op_stats[op];
+    stats.calls++;
+    stats.round_trips++;
+    stats.last_round_trips = 1;
+}
+
+void DeviceKeyCache::CountLocalDerivations(const std::string& op, uint64_t count)
+{
+    LOCK(m_mutex);
+    OpStats& stats = m_op_stats[op];
+    stats.calls += count;
+    stats.last_round_trips = 0;
+    m_hits += count;
+}
+
+void DeviceKeyCache::Clear()
+{
+    LOCK(m_mutex);
+    m_dirty |= !m_xpubs.empty();
+    m_xpubs.clear();
+}
+
+bool DeviceKeyCache::IsDirty() const
+{
+    LOCK(m_mutex);
+    return m_dirty;
+}
+
+void DeviceKeyCache::MarkClean()
+{
+    LOCK(m_mutex);
+    m_dirty = false;
+}
+
+std::string DeviceKeyCache::GetDeviceId() const
+{
+    LOCK(m_mutex);
+    return m_device_id;
+}
+
+size_t DeviceKeyCache::Size() const
+{
+    LOCK(m_mutex);
+    return m_xpubs.size();
+}
+
+uint64_t DeviceKeyCache::GetHits() const
+{
+    LOCK(m_mutex);
+    return m_hits;
+}
+
+std::map<std::string, DeviceKeyCache::OpStats> DeviceKeyCache::GetOpStats() const
+{
+    LOCK(m_mutex);
+    return m_op_stats;
+}
+} // namespace wallet
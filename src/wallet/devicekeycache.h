@@ -0,0 +1,90 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBE_WALLET_DEVICEKEYCACHE_H
+#define GLOBE_WALLET_DEVICEKEYCACHE_H
+
+#include <key/extkey.h>
+#include <serialize.h>
+#include <sync.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wallet {
+/**
+ * Extended public keys read from a hardware device, by path.
+ *
+ * Public keys below a cached xpub are derived locally when the remaining
+ * path is not hardened, so only the hardened prefix of a path costs a device
+ * round trip. The cache belongs to one device, identified by vendor, product,
+ * serial number and master key fingerprint, and is emptied when another
+ * device is connected or the device is reseeded.
+ */
+class DeviceKeyCache
+{
+public:
+    //! Reads the xpub at path from the device, returns 0 on success.
+    using XPubFetcher = std::function<int(const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error)>;
+
+    struct OpStats {
+        uint64_t calls{0};
+        uint64_t round_trips{0};
+        //! Round trips made by the most recent call
+        uint64_t last_round_trips{0};
+    };
+
+    /** Set the connected device, returns true if the cache was emptied */
+    bool SetDevice(const std::string& device_id) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    int GetXPub(const std::string& op, const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error, const XPubFetcher& fetch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    int GetPubKey(const std::string& op, const std::vector<uint32_t>& path, CPubKey& pk, std::string& error, const XPubFetcher& fetch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Record a call that must go to the device, such as displaying a key */
+    void CountDeviceCall(const std::string& op) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Record keys derived from an xpub the wallet already stores, such as a hardware linked chain */
+    void CountLocalDerivations(const std::string& op, uint64_t count) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** True if entries changed since the last MarkClean */
+    bool IsDirty() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void MarkClean() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    std::string GetDeviceId() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    uint64_t GetHits() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::map<std::string, OpStats> GetOpStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    template<typename Stream>
+    void Serialize(Stream& s) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        s << m_device_id << m_xpubs;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        s >> m_device_id >> m_xpubs;
+        m_dirty = false;
+    }
+
+private:
+    mutable Mutex m_mutex;
+    std::string m_device_id GUARDED_BY(m_mutex);
+    std::map<std::vector<uint32_t>, CExtPubKey> m_xpubs GUARDED_BY(m_mutex);
+    std::map<std::string, OpStats> m_op_stats GUARDED_BY(m_mutex);
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    bool m_dirty GUARDED_BY(m_mutex){false};
+
+    /** Find the xpub at path, reading at most its hardened prefix from the device */
+    int Lookup(OpStats& stats, const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error, const XPubFetcher& fetch) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+} // namespace wallet
+
+#endif // GLOBE_WALLET_DEVICEKEYCACHE_H
@@ -54,6 +54,18 @@ using interfaces::FoundBlock;
 
 static constexpr size_t OUTPUT_GROUP_MAX_ENTRIES{100};
 
+/** Estimated virtual sizes for coin selection, a rangeproof is about 675 bytes */
+static constexpr int BLINDED_INPUT_VSIZE{68};
+static constexpr int BLINDED_OUTPUT_VSIZE{772};
+static constexpr int ANON_OUTPUT_VSIZE{779};
+
+/** Estimated virtual size of one anon input spent in a ring of ring_size members */
+static int AnonInputVSize(size_t ring_size)
+{
+    // Prevout, sequence and key image, the ring member indices and a row of the MLSAG are witness data
+    return 36 + 4 + 1 + 33 + (int)(ring_size * (3 + 32)) / WITNESS_SCALE_FACTOR;
+}
+
 static uint8_t GetOutputType(ChainstateManager *pchainman, const COutPoint &prevout)
 {
     LOCK(cs_main);
@@ -1535,6 +1547,18 @@ DBErrors CHDWallet::LoadWallet()
     ProcessStakingSettings(sError);
     ProcessWalletSettings(sError);
 
+    {
+        CHDWalletDB wdb(*m_database);
+        wdb.ReadDeviceKeyCache(m_device_key_cache);
+        // Owned outputs first, they take precedence over a decoy record written earlier
+        for (const bool own : {true, false}) {
+            AnonOutputCache::Record record;
+            if (wdb.ReadAnonOutputCache(own, record)) {
+                m_anon_output_cache.LoadRecord(record, own, HaveChain() ? chain().getBlockHeight(record.tip_hash) : std::nullopt);
+            }
+        }
+    }
+
     LoadMasterKeys();
 
     {
@@ -4384,6 +4408,7 @@ int CHDWallet::AddBlindedInputs(CWalletTx &wtx, CTransactionRecord &rtx,
         size_t nSubFeeTries = 100;
         bool pick_new_inputs = true;
         CAmount nValueIn = 0;
+        CAmount nInputsFee = 0;
         // Start with no fee and loop until there is enough fee
         for (;;) {
             txNew.vin.clear();
@@ -4399,9 +4424,16 @@ int CHDWallet::AddBlindedInputs(CWalletTx &wtx, CTransactionRecord &rtx,
             if (pick_new_inputs) {
                 nValueIn = 0;
                 setCoins.clear();
-                if (!SelectBlindedCoins(vAvailableCoins, nValueToSelect, setCoins, nValueIn, coinControl)) {
+                // Selection adds the fee of the inputs it picks, take out the fee of the last round's inputs
+                if (!SelectBlindedCoins(vAvailableCoins, nValueToSelect - nInputsFee, setCoins, nValueIn, coinControl, /*random_selection=*/false, /*ring_size=*/0, nSubtractFeeFromAmount > 0)) {
                     return wserrorN(1, sError, __func__, _("Insufficient funds.").translated);
                 }
+                if (nSubtractFeeFromAmount == 0) {
+                    const CAmount inputs_fee = GetBlindedInputsFee(setCoins.size(), coinControl);
+                    nFeeRet += inputs_fee - nInputsFee;
+                    nInputsFee = inputs_fee;
+                    nValueToSelect = nValue + nFeeRet;
+                }
             }
 
             const CAmount nChange = nValueIn - nValueToSelect;
@@ -4916,7 +4948,7 @@ int CHDWallet::PlaceRealOutputs(std::vector<std::vector<int64_t> > &vMI, size_t
 
                 int64_t index;
 
-                if (!chain().readRCTOutputLink(*pk, index)) {
+                if (!ReadAnonOutputLink(*pk, index)) {
                     return wserrorN(1, sError, __func__, _("Anon pubkey not found in db, %s").translated, HexStr(*pk));
                 }
                 if (setHave.count(index)) {
@@ -4933,6 +4965,22 @@ int CHDWallet::PlaceRealOutputs(std::vector<std::vector<int64_t> > &vMI, size_t
     return 0;
 };
 
+bool CHDWallet::ReadAnonOutput(int64_t index, CAnonOutput &ao, bool own) const
+{
+    return m_anon_output_cache.ReadOutput(index, ao, own, [this](int64_t i, CAnonOutput &ao_read) {
+        return chain().readRCTOutput(i, ao_read);
+    });
+};
+
+bool CHDWallet::ReadAnonOutputLink(const CCmpPubKey &pk, int64_t &index) const
+{
+    return m_anon_output_cache.ReadOutputLink(pk, index, [this](const CCmpPubKey &pk_read, int64_t &i) {
+        return chain().readRCTOutputLink(pk_read, i);
+    }, [this](int64_t i, CAnonOutput &ao_read) {
+        return chain().readRCTOutput(i, ao_read);
+    });
+};
+
 int CHDWallet::PickHidingOutputs(std::vector<std::vector<int64_t> > &vMI,
     size_t nSecretColumn, size_t nRingSize, std::set<int64_t> &setHave, const CCoinControl *coinControl, std::string &sError)
 {
@@ -4966,7 +5014,7 @@ int CHDWallet::PickHidingOutputs(std::vector<std::vector<int64_t> > &vMI,
     // Remove outputs without required depth
     while (nLastRCTOutIndex > 1) {
         CAnonOutput ao;
-        if (!chain().readRCTOutput(nLastRCTOutIndex, ao)) {
+        if (!ReadAnonOutput(nLastRCTOutIndex, ao)) {
             return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, nLastRCTOutIndex);
         }
         if (nBestHeight - ao.nBlockHeight + 1 < consensusParams.nMinRCTOutputDepth) {
@@ -5014,7 +5062,7 @@ int CHDWallet::PickHidingOutputs(std::vector<std::vector<int64_t> > &vMI,
 
             int64_t output_id = nLastRCTOutIndex - std::min(nLastRCTOutIndex-1, std::max(min_anon_input, ranges[j]));
             CAnonOutput ao;
-            if (!chain().readRCTOutput(output_id, ao)) {
+            if (!ReadAnonOutput(output_id, ao)) {
                 return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, output_id);
             }
 
@@ -5095,10 +5143,10 @@ int CHDWallet::PickHidingOutputs(std::vector<std::vector<int64_t> > &vMI,
 
                     int64_t num_blocks, num_aos = select_max - select_min;
                     CAnonOutput ao_min, ao_max;
-                    if (!chain().readRCTOutput(select_min, ao_min)) {
+                    if (!ReadAnonOutput(select_min, ao_min)) {
                         return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, select_min);
                     }
-                    if (!chain().readRCTOutput(select_max, ao_max)) {
+                    if (!ReadAnonOutput(select_max, ao_max)) {
                         return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, select_max);
                     }
                     num_blocks = ao_max.nBlockHeight - ao_min.nBlockHeight;
@@ -5200,6 +5248,7 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
         size_t nSubFeeTries = 100;
         bool pick_new_inputs = true;
         CAmount nValueIn = 0;
+        CAmount nInputsFee = 0;
         // Start with no fee and loop until there is enough fee
         for (;;) {
             txNew.vin.clear();
@@ -5215,9 +5264,16 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
             if (pick_new_inputs) {
                 nValueIn = 0;
                 setCoins.clear();
-                if (!SelectBlindedCoins(vAvailableCoins, nValueToSelect, setCoins, nValueIn, coinControl, true)) {
+                // Selection adds the fee of the inputs it picks, take out the fee of the last round's inputs
+                if (!SelectBlindedCoins(vAvailableCoins, nValueToSelect - nInputsFee, setCoins, nValueIn, coinControl, /*random_selection=*/true, nRingSize, nSubtractFeeFromAmount > 0)) {
                     return wserrorN(1, sError, __func__, _("Insufficient funds.").translated);
                 }
+                if (nSubtractFeeFromAmount == 0) {
+                    const CAmount inputs_fee = GetBlindedInputsFee(setCoins.size(), coinControl, nRingSize);
+                    nFeeRet += inputs_fee - nInputsFee;
+                    nInputsFee = inputs_fee;
+                    nValueToSelect = nValue + nFeeRet;
+                }
             }
 
             const CAmount nChange = nValueIn - nValueToSelect;
@@ -5509,7 +5565,7 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
                     int64_t nIndex = vMI[l][k][i];
 
                     CAnonOutput ao;
-                    if (!chain().readRCTOutput(nIndex, ao)) {
+                    if (!ReadAnonOutput(nIndex, ao, /*own=*/true)) {
                         return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, nIndex);
                     }
 
@@ -5545,19 +5601,25 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
                 std::vector<uint8_t> &vDL = txin.scriptWitness.stack[1];
                 std::vector<secp256k1_pedersen_commitment> vCommitments;
                 vCommitments.reserve(nCols * nSigInputs);
+                std::vector<std::array<uint8_t, 64>> vKeyImageBases(nCols * nSigInputs);
+                std::vector<const uint8_t*> vpKeyImageBases(nCols * nSigInputs, nullptr);
 
                 for (size_t k = 0; k < nSigInputs; ++k)
                 for (size_t i = 0; i < nCols; ++i) {
                     int64_t nIndex = vMI[l][k][i];
 
                     CAnonOutput ao;
-                    if (!chain().readRCTOutput(nIndex, ao)) {
+                    if (!ReadAnonOutput(nIndex, ao, /*own=*/i == vSecretColumns[l])) {
                         return wserrorN(1, sError, __func__, _("Anon output not found in db, %d").translated, nIndex);
                     }
 
                     memcpy(&vm[(i+k*nCols)*33], ao.pubkey.begin(), 33);
                     vCommitments.push_back(ao.commitment);
                     vpInCommits[i+k*nCols] = vCommitments.back().data;
+                    if (ao.key_image_base) {
+                        vKeyImageBases[i+k*nCols] = *ao.key_image_base;
+                        vpKeyImageBases[i+k*nCols] = vKeyImageBases[i+k*nCols].data();
+                    }
 
                     if (i == vSecretColumns[l]) {
                         CKeyID idk = ao.pubkey.GetID();
@@ -5630,9 +5692,9 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
                 }
 
                 uint256 txhash = txNew.GetHash();
-                if (0 != (rv = secp256k1_generate_mlsag(secp256k1_ctx_blind, vKeyImages.data(), &vDL[0], &vDL[32],
+                if (0 != (rv = secp256k1_generate_mlsag_hp(secp256k1_ctx_blind, vKeyImages.data(), &vDL[0], &vDL[32],
                     randSeed, txhash.begin(), nCols, nRows, vSecretColumns[l],
-                    &vpsk[0], &vm[0]))) {
+                    &vpsk[0], &vm[0], vpKeyImageBases.data()))) {
                     return wserrorN(1, sError, __func__, "secp256k1_generate_mlsag failed %d", rv);
                 }
             }
@@ -5723,6 +5785,10 @@ int CHDWallet::AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
         }
     }
 
+    if (!FlushAnonOutputCache()) {
+        WalletLogPrintf("Warning: %s - FlushAnonOutputCache failed.\n", __func__);
+    }
+
     return 0;
 };
 
@@ -5779,6 +5845,13 @@ void CHDWallet::leavingIBD()
 {
 }
 
+void CHDWallet::blockDisconnected(const interfaces::BlockInfo& block)
+{
+    CWallet::blockDisconnected(block);
+    // Anon indices from the disconnected block are reused by the next one
+    m_anon_output_cache.BlockDisconnected(block.height);
+}
+
 void CHDWallet::RemoveFromTxSpends(const uint256 &hash, const CTransactionRef pt)
 {
     for (const auto &txin : pt->vin) {
@@ -7144,6 +7217,17 @@ int CHDWallet::ExtKeyReload(const CStoredExtKey *sek)
     return 0;
 }
 
+int CHDWallet::ExtKeyAccountAddLookAhead(CExtKeyAccount *sea, uint32_t nChain, uint32_t nKeys) const
+{
+    int rv = sea->AddLookAhead(nChain, nKeys);
+    const CStoredExtKey *pc = sea->GetChain(nChain);
+    if (rv == 0 && pc && (pc->nFlags & EAF_HARDWARE_DEVICE)) {
+        // Derived from the stored chain xpub, never from the device
+        m_device_key_cache.CountLocalDerivations("lookahead", nKeys);
+    }
+    return rv;
+}
+
 int CHDWallet::ExtKeyAddLookAhead(CStoredExtKey *sek) const
 {
     CKeyID derivedId, idk = sek->GetID();
@@ -7287,7 +7371,7 @@ int CHDWallet::ExtKeyAddAccountToMaps(const CKeyID &idAccount, CExtKeyAccount *s
             }
 
             if (fAddToLookAhead) {
-                sea->AddLookAhead(i, (uint32_t)nLookAhead);
+                ExtKeyAccountAddLookAhead(sea, i, (uint32_t)nLookAhead);
             }
         }
 
@@ -7491,7 +7575,7 @@ int CHDWallet::PrepareLookahead()
                     nLookAhead = GetCompressedInt64(itV->second, nLookAhead);
                 }
 
-                sea->AddLookAhead(i, (uint32_t)nLookAhead);
+                ExtKeyAccountAddLookAhead(sea, i, (uint32_t)nLookAhead);
             }
         }
     }
@@ -7615,7 +7699,7 @@ int CHDWallet::ExtKeySaveKey(CHDWalletDB *pwdb, CExtKeyAccount *sea, const CKeyI
 
                     if (pc->IsActive()
                         && pc->IsReceiveEnabled()) {
-                        sea->AddLookAhead(nChain, 1);
+                        ExtKeyAccountAddLookAhead(sea, nChain, 1);
                     }
 
                     if (LogAcceptCategory(BCLog::HDWALLET, BCLog::Level::Debug)) {
@@ -7625,7 +7709,7 @@ int CHDWallet::ExtKeySaveKey(CHDWalletDB *pwdb, CExtKeyAccount *sea, const CKeyI
             }
             if (pc->IsActive()
                 && pc->IsReceiveEnabled()) {
-                sea->AddLookAhead(nChain, 1);
+                ExtKeyAccountAddLookAhead(sea, nChain, 1);
             }
             if (LogAcceptCategory(BCLog::HDWALLET, BCLog::Level::Debug)) {
                 WalletLogPrintf("Saved key %s %d, %s.\n", sea->GetIDString58(), nChain, EncodeDestination(PKHash(keyId)));
@@ -8500,7 +8584,7 @@ int CHDWallet::NewExtKeyFromAccount(CHDWalletDB *pwdb, const CKeyID &idAccount,
     if (mvi != sekOut->mapValue.end()) {
         nLookAhead = GetCompressedInt64(mvi->second, nLookAhead);
     }
-    sea->AddLookAhead(chainNo, nLookAhead);
+    ExtKeyAccountAddLookAhead(sea, chainNo, nLookAhead);
 
     mapExtKeys[idNewChain] = sekOut;
 
@@ -11838,7 +11922,14 @@ void CHDWallet::AvailableBlindedCoins(std::vector<COutputR>& vCoins, const CCoin
     return;
 };
 
-bool CHDWallet::SelectBlindedCoins(const std::vector<COutputR> &vAvailableCoins, const CAmount &nTargetValue, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &setCoinsRet, CAmount &nValueRet, const CCoinControl *coinControl, bool random_selection) const
+CAmount CHDWallet::GetBlindedInputsFee(size_t num_inputs, const CCoinControl *coinControl, size_t ring_size) const
+{
+    const CCoinControl cc_default;
+    const CFeeRate feerate = GetMinimumFeeRate(*this, coinControl ? *coinControl : cc_default, nullptr);
+    return (CAmount)num_inputs * feerate.GetFee(ring_size > 0 ? AnonInputVSize(ring_size) : BLINDED_INPUT_VSIZE);
+}
+
+bool CHDWallet::SelectBlindedCoins(const std::vector<COutputR> &vAvailableCoins, const CAmount &nTargetValue, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &setCoinsRet, CAmount &nValueRet, const CCoinControl *coinControl, bool random_selection, size_t ring_size, bool subtract_fee_outputs) const
 {
     std::vector<COutputR> vCoins(vAvailableCoins);
 
@@ -11867,12 +11958,14 @@ bool CHDWallet::SelectBlindedCoins(const std::vector<COutputR> &vAvailableCoins,
             return werror("%s: Can't find output %s\n", __func__, outpoint.ToString());
         }
     }
+    // Preset inputs must pay the fee to spend them as the selected ones do
+    const CAmount preset_inputs_fee = subtract_fee_outputs ? 0 : GetBlindedInputsFee(vPresetCoins.size(), coinControl, ring_size);
 
     // coin control -> return all selected outputs (we want all selected to go into the transaction for sure)
     if (coinControl && coinControl->HasSelected() && !coinControl->m_allow_other_inputs) {
         nValueRet = nValueFromPresetInputs;
         setCoinsRet.insert(setCoinsRet.end(), vPresetCoins.begin(), vPresetCoins.end());
-        return (nValueRet >= nTargetValue);
+        return (nValueRet >= nTargetValue + preset_inputs_fee);
     }
 
     // Remove preset inputs from vCoins
@@ -11898,62 +11991,99 @@ bool CHDWallet::SelectBlindedCoins(const std::vector<COutputR> &vAvailableCoins,
     size_t max_ancestors = (size_t)std::max<int64_t>(1, gArgs.GetIntArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT));
     size_t max_descendants = (size_t)std::max<int64_t>(1, gArgs.GetIntArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT));
     bool fRejectLongChains = gArgs.GetBoolArg("-walletrejectlongchains", DEFAULT_WALLET_REJECT_LONG_CHAINS);
-    bool res = nTargetValue <= nValueFromPresetInputs;
+    bool res = nTargetValue + preset_inputs_fee <= nValueFromPresetInputs;
     if (!res) {
-        if (random_selection) {
-            Shuffle(vCoins.begin(), vCoins.end(), FastRandomContext());
-
-            CAmount target_val = nTargetValue - nValueFromPresetInputs;
-            std::vector<CAmount> coin_values;
-            for (auto it = vCoins.begin(); it != vCoins.end();) {
-                MapRecords_t::const_iterator rtxi = it->rtx;
-                const CTransactionRecord *rtx = &rtxi->second;
-                const CWalletTx *pcoin = GetWalletOrTempTx(it->txhash, rtx);
-                if (!pcoin) {
-                    return werror("%s: GetWalletOrTempTx failed.\n", __func__);
-                }
-                const COutputRecord *oR = rtx->GetOutput(it->i);
-                if (!oR) {
-                    return werror("%s: GetOutput failed, %s, %d.\n", it->txhash.ToString(), it->i);
-                }
+        const CAmount target_value = nTargetValue + preset_inputs_fee - nValueFromPresetInputs;
+        FastRandomContext rng_fast;
+        CoinSelectionParams coin_selection_params{rng_fast};
+        {
+            const CCoinControl cc_default;
+            coin_selection_params.m_effective_feerate = GetMinimumFeeRate(*this, coinControl ? *coinControl : cc_default, nullptr);
+            CCoinControl cc_temp;
+            cc_temp.m_confirm_target = chain().estimateMaxBlocks();
+            coin_selection_params.m_long_term_feerate = GetMinimumFeeRate(*this, cc_temp, nullptr);
+        }
+        coin_selection_params.m_subtract_fee_outputs = subtract_fee_outputs;
+        coin_selection_params.m_discard_feerate = GetDiscardRate(*this);
+        const int input_bytes = ring_size > 0 ? AnonInputVSize(ring_size) : BLINDED_INPUT_VSIZE;
+        coin_selection_params.change_output_size = ring_size > 0 ? ANON_OUTPUT_VSIZE : BLINDED_OUTPUT_VSIZE;
+        coin_selection_params.change_spend_size = input_bytes;
+        coin_selection_params.m_change_fee = coin_selection_params.m_effective_feerate.GetFee(coin_selection_params.change_output_size);
+        coin_selection_params.m_cost_of_change = coin_selection_params.m_discard_feerate.GetFee(coin_selection_params.change_spend_size) + coin_selection_params.m_change_fee;
+        coin_selection_params.min_viable_change = coin_selection_params.m_discard_feerate.GetFee(coin_selection_params.change_spend_size) + 1;
+        coin_selection_params.m_min_change_target = GenerateChangeTarget(target_value, coin_selection_params.m_change_fee, rng_fast);
+
+        // Look up what selection needs once, effective values are weighted by the size of a blinded or anon input
+        std::vector<OutputGroup> groups;
+        std::map<COutPoint, MapRecords_t::const_iterator> coin_records;
+        groups.reserve(vCoins.size());
+        for (const auto &r : vCoins) {
+            const CTransactionRecord *rtx = &r.rtx->second;
+            const CWalletTx *pcoin = GetWalletOrTempTx(r.txhash, rtx);
+            if (!pcoin) {
+                return werror("%s: GetWalletOrTempTx failed.\n", __func__);
+            }
+            const COutputRecord *oR = rtx->GetOutput(r.i);
+            if (!oR) {
+                return werror("%s: GetOutput failed, %s, %d.\n", __func__, r.txhash.ToString(), r.i);
+            }
+            size_t ancestors, descendants;
+            chain().getTransactionAncestry(r.txhash, ancestors, descendants);
 
-                bool add_input = false;
-                if (nValueRet < target_val) {
-                    add_input = true;
-                } else {
-                    for (int k = 0; k < (int)setCoinsRet.size(); ++k) {
-                        if (setCoinsRet.size() + (add_input ? 1 : 0) <= prefer_max_num_anon_inputs) {
-                            break;
-                        }
-                        // Replace output if possible
-                        if ((nValueRet + oR->nValue) - coin_values[k] >= target_val) {
-                            add_input = true;
-                            nValueRet -= coin_values[k];
-                            setCoinsRet.erase(setCoinsRet.begin() + k);
-                            coin_values.erase(coin_values.begin() + k);
-                            k--;
-                            continue;
-                        }
-                    }
-                }
-                if (add_input) {
-                    nValueRet += oR->nValue;
-                    setCoinsRet.push_back(std::make_pair(rtxi, it->i));
-                    coin_values.push_back(oR->nValue);
-                    it = vCoins.erase(it);
-                    continue;
+            const COutPoint outpoint(r.txhash, r.i);
+            const COutput output(outpoint, CTxOut(oR->nValue, CScript()), r.nDepth, input_bytes, /*spendable=*/true, /*solvable=*/true, /*safe=*/true,
+                                 rtx->GetTxTime(), CachedTxIsFromMe(*this, *pcoin, ISMINE_ALL), coin_selection_params.m_effective_feerate);
+            OutputGroup group(coin_selection_params);
+            group.Insert(output, ancestors, descendants, /*positive_only=*/false);
+            groups.push_back(std::move(group));
+            coin_records.emplace(outpoint, r.rtx);
+        }
+
+        const auto attempt_selection = [&](const CoinEligibilityFilter& eligibility_filter) {
+            std::vector<OutputGroup> eligible_groups;
+            for (const OutputGroup& group : groups) {
+                if (group.EligibleForSpending(eligibility_filter)) {
+                    eligible_groups.push_back(group);
                 }
-                ++it;
             }
-            res = nValueRet >= nTargetValue - nValueFromPresetInputs;
+            return ChooseBlindedSelectionResult(eligible_groups, target_value, coin_selection_params, random_selection,
+                                                ring_size > 0 ? prefer_max_num_anon_inputs : 0);
+        };
+
+        std::vector<CoinEligibilityFilter> filters;
+        if (random_selection) {
+            filters.emplace_back(0, 0, std::numeric_limits<uint64_t>::max());
         } else {
-             res = AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(1, 6, 0), vCoins, setCoinsRet, nValueRet) ||
-                AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(1, 1, 0), vCoins, setCoinsRet, nValueRet) ||
-                (m_spend_zero_conf_change && AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(0, 1, 2), vCoins, setCoinsRet, nValueRet)) ||
-                (m_spend_zero_conf_change && AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(0, 1, std::min((size_t)4, max_ancestors/3), std::min((size_t)4, max_descendants/3)), vCoins, setCoinsRet, nValueRet)) ||
-                (m_spend_zero_conf_change && AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(0, 1, max_ancestors/2, max_descendants/2), vCoins, setCoinsRet, nValueRet)) ||
-                (m_spend_zero_conf_change && AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(0, 1, max_ancestors-1, max_descendants-1), vCoins, setCoinsRet, nValueRet)) ||
-                (m_spend_zero_conf_change && !fRejectLongChains && AttemptSelection(nTargetValue - nValueFromPresetInputs, CoinEligibilityFilter(0, 1, std::numeric_limits<uint64_t>::max()), vCoins, setCoinsRet, nValueRet));
+            filters.emplace_back(1, 6, 0);
+            filters.emplace_back(1, 1, 0);
+            if (m_spend_zero_conf_change) {
+                filters.emplace_back(0, 1, 2);
+                filters.emplace_back(0, 1, std::min((size_t)4, max_ancestors/3), std::min((size_t)4, max_descendants/3));
+                filters.emplace_back(0, 1, max_ancestors/2, max_descendants/2);
+                filters.emplace_back(0, 1, max_ancestors-1, max_descendants-1);
+                if (!fRejectLongChains) {
+                    filters.emplace_back(0, 1, std::numeric_limits<uint64_t>::max());
+                }
+            }
+        }
+        std::optional<SelectionResult> result;
+        for (const auto& filter : filters) {
+            if ((result = attempt_selection(filter))) {
+                break;
+            }
+        }
+
+        if (result) {
+            for (const COutput& coin : result->GetInputSet()) {
+                setCoinsRet.push_back(std::make_pair(coin_records.at(coin.outpoint), coin.outpoint.n));
+            }
+            nValueRet = result->GetSelectedValue();
+            res = true;
+
+            if (LogAcceptCategory(BCLog::SELECTCOINS, BCLog::Level::Debug)) {
+                WalletLogPrintf("%s: %s selected %u inputs, total %s, waste %s\n", __func__, GetAlgorithmName(result->GetAlgo()),
+                                result->GetInputSet().size(), FormatMoney(nValueRet), FormatMoney(result->GetWaste()));
+            }
         }
     }
 
@@ -12048,7 +12178,7 @@ void CHDWallet::AvailableAnonCoins(std::vector<COutputR> &vCoins, const CCoinCon
                 int64_t index;
                 if (!wdb.ReadStoredTx(txid, stx) ||
                     !stx.tx->vpout[r.n]->IsType(OUTPUT_RINGCT) ||
-                    !chain().readRCTOutputLink(((CTxOutRingCT*)stx.tx->vpout[r.n].get())->pk, index) ||
+                    !ReadAnonOutputLink(((CTxOutRingCT*)stx.tx->vpout[r.n].get())->pk, index) ||
                     IsBlacklistedAnonOutput(index) ||
                     (!IsWhitelistedAnonOutput(index, time_now, consensusParams) && r.nValue > consensusParams.m_max_tainted_value_out)) {
                     continue;
@@ -12271,174 +12401,6 @@ std::map<CTxDestination, std::vector<COutputR>> CHDWallet::ListCoins(OutputTypes
     return result;
 };
 
-struct CompareValueOnly
-{
-    bool operator()(const std::pair<CAmount, std::pair<MapRecords_t::const_iterator, unsigned int> >& t1,
-                    const std::pair<CAmount, std::pair<MapRecords_t::const_iterator, unsigned int> >& t2) const
-    {
-        return t1.first < t2.first;
-    }
-};
-
-static void ApproximateBestSubset(std::vector<std::pair<CAmount, std::pair<MapRecords_t::const_iterator,unsigned int> > >vValue, const CAmount& nTotalLower, const CAmount& nTargetValue,
-                                  std::vector<char>& vfBest, CAmount& nBest, int iterations = 1000)
-{
-    std::vector<char> vfIncluded;
-
-    vfBest.assign(vValue.size(), true);
-    nBest = nTotalLower;
-
-    FastRandomContext insecure_rand;
-
-    for (int nRep = 0; nRep < iterations && nBest != nTargetValue; nRep++)
-    {
-        vfIncluded.assign(vValue.size(), false);
-        CAmount nTotal = 0;
-        bool fReachedTarget = false;
-        for (int nPass = 0; nPass < 2 && !fReachedTarget; nPass++)
-        {
-            for (unsigned int i = 0; i < vValue.size(); i++)
-            {
-                //The solver here uses a randomized algorithm,
-                //the randomness serves no real security purpose but is just
-                //needed to prevent degenerate behavior and it is important
-                //that the rng is fast. We do not use a constant random sequence,
-                //because there may be some privacy improvement by making
-                //the selection random.
-                if (nPass == 0 ? insecure_rand.rand32()&1 : !vfIncluded[i])
-                {
-                    nTotal += vValue[i].first;
-                    vfIncluded[i] = true;
-                    if (nTotal >= nTargetValue)
-                    {
-                        fReachedTarget = true;
-                        if (nTotal < nBest)
-                        {
-                            nBest = nTotal;
-                            vfBest = vfIncluded;
-                        }
-                        nTotal -= vValue[i].first;
-                        vfIncluded[i] = false;
-                    }
-                }
-            }
-        }
-    }
-    return;
-}
-
-bool CHDWallet::AttemptSelection(const CAmount& nTargetValue, const CoinEligibilityFilter& eligibility_filter,
-    std::vector<COutputR> vCoins, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> >& setCoinsRet, CAmount& nValueRet) const
-{
-    setCoinsRet.clear();
-    nValueRet = 0;
-
-    // List of values less than target
-    std::pair<CAmount, std::pair<MapRecords_t::const_iterator,unsigned int> > coinLowestLarger;
-    coinLowestLarger.first = std::numeric_limits<CAmount>::max();
-    coinLowestLarger.second.first = mapRecords.end();
-    std::vector<std::pair<CAmount, std::pair<MapRecords_t::const_iterator,unsigned int> > > vValue;
-    CAmount nTotalLower = 0;
-
-    Shuffle(vCoins.begin(), vCoins.end(), FastRandomContext());
-
-    for (const auto &r : vCoins) {
-        //if (!r.fSpendable)
-        //    continue;
-        MapRecords_t::const_iterator rtxi = r.rtx;
-        const CTransactionRecord *rtx = &rtxi->second;
-
-        const CWalletTx *pcoin = GetWalletOrTempTx(r.txhash, rtx);
-        if (!pcoin) {
-            return werror("%s: GetWalletOrTempTx failed.\n", __func__);
-        }
-
-        if (r.nDepth < (CachedTxIsFromMe(*this, *pcoin, ISMINE_ALL) ? eligibility_filter.conf_mine : eligibility_filter.conf_theirs)) {
-            continue;
-        }
-
-        size_t ancestors, descendants;
-        chain().getTransactionAncestry(r.txhash, ancestors, descendants);
-        if (ancestors > eligibility_filter.max_ancestors || descendants > eligibility_filter.max_descendants) {
-             continue;
-        }
-
-        const COutputRecord *oR = rtx->GetOutput(r.i);
-        if (!oR) {
-            return werror("%s: GetOutput failed, %s, %d.\n", r.txhash.ToString(), r.i);
-        }
-
-        CAmount nV = oR->nValue;
-        std::pair<CAmount,std::pair<MapRecords_t::const_iterator,unsigned int> > coin = std::make_pair(nV, std::make_pair(rtxi, r.i));
-
-        if (nV == nTargetValue) {
-            setCoinsRet.push_back(coin.second);
-            nValueRet += coin.first;
-            return true;
-        } else
-        if (nV < nTargetValue + CHANGE_UPPER) {
-            vValue.push_back(coin);
-            nTotalLower += nV;
-        } else
-        if (nV < coinLowestLarger.first) {
-            coinLowestLarger = coin;
-        }
-    }
-
-    if (nTotalLower == nTargetValue) {
-        for (unsigned int i = 0; i < vValue.size(); ++i) {
-            setCoinsRet.push_back(vValue[i].second);
-            nValueRet += vValue[i].first;
-        }
-        return true;
-    }
-
-    if (nTotalLower < nTargetValue) {
-        if (coinLowestLarger.second.first == mapRecords.end()) {
-            return false;
-        }
-        setCoinsRet.push_back(coinLowestLarger.second);
-        nValueRet += coinLowestLarger.first;
-        return true;
-    }
-
-    // Solve subset sum by stochastic approximation
-    std::sort(vValue.begin(), vValue.end(), CompareValueOnly());
-    std::reverse(vValue.begin(), vValue.end());
-    std::vector<char> vfBest;
-    CAmount nBest;
-
-    ApproximateBestSubset(vValue, nTotalLower, nTargetValue, vfBest, nBest);
-    if (nBest != nTargetValue && nTotalLower >= nTargetValue + CHANGE_UPPER) {
-        ApproximateBestSubset(vValue, nTotalLower, nTargetValue + CHANGE_UPPER, vfBest, nBest);
-    }
-
-    // If we have a bigger coin and (either the stochastic approximation didn't find a good solution,
-    //                                   or the next bigger coin is closer), return the bigger coin
-    if (coinLowestLarger.second.first != mapRecords.end() &&
-        ((nBest != nTargetValue && nBest < nTargetValue + CHANGE_UPPER) || coinLowestLarger.first <= nBest)) {
-        setCoinsRet.push_back(coinLowestLarger.second);
-        nValueRet += coinLowestLarger.first;
-    } else {
-        for (unsigned int i = 0; i < vValue.size(); i++) {
-            if (vfBest[i]) {
-                setCoinsRet.push_back(vValue[i].second);
-                nValueRet += vValue[i].first;
-            }
-        }
-
-        if (LogAcceptCategory(BCLog::SELECTCOINS, BCLog::Level::Debug)) {
-            WalletLogPrintf("SelectCoins() best subset: "); /* Continued */
-            for (unsigned int i = 0; i < vValue.size(); i++)
-                if (vfBest[i])
-                    LogPrintf("%s ", FormatMoney(vValue[i].first)); /* Continued */
-            LogPrintf("total %s\n", FormatMoney(nBest));
-        }
-    }
-
-    return true;
-}
-
 /**
  * Outpoint is spent if any non-conflicted transaction
  * spends it:
@@ -12903,6 +12865,54 @@ bool CHDWallet::EraseSetting(const std::string &setting)
     return true;
 };
 
+bool CHDWallet::FlushDeviceKeyCache()
+{
+    if (!m_device_key_cache.IsDirty()) {
+        return true;
+    }
+    LOCK(cs_wallet);
+
+    CHDWalletDB wdb(*m_database);
+
+    // Entries missing from the db are read from the device again
+    m_device_key_cache.MarkClean();
+    if (!wdb.WriteDeviceKeyCache(m_device_key_cache)) {
+        return werror("%s: WriteDeviceKeyCache failed.", __func__);
+    }
+    return true;
+};
+
+bool CHDWallet::FlushAnonOutputCache(bool flush_decoys)
+{
+    const bool write_own = m_anon_output_cache.IsDirty(/*own=*/true);
+    const bool write_decoys = flush_decoys && m_anon_output_cache.IsDirty(/*own=*/false);
+    if (!write_own && !write_decoys) {
+        return true;
+    }
+    LOCK(cs_wallet);
+
+    CHDWalletDB wdb(*m_database);
+
+    for (const bool own : {true, false}) {
+        if (!(own ? write_own : write_decoys)) {
+            continue;
+        }
+        // Entries are checked against this block when loaded
+        m_anon_output_cache.MarkClean(own);
+        if (!wdb.WriteAnonOutputCache(own, m_anon_output_cache.GetRecord(own, m_last_block_processed, m_last_block_processed_height))) {
+            return werror("%s: WriteAnonOutputCache failed.", __func__);
+        }
+    }
+    return true;
+};
+
+void CHDWallet::FlushCaches()
+{
+    if (!FlushAnonOutputCache(/*flush_decoys=*/true)) {
+        WalletLogPrintf("Warning: %s - FlushAnonOutputCache failed.\n", __func__);
+    }
+};
+
 int64_t CHDWallet::GetTimeFirstKey()
 {
     int64_t time_first_key = 0;
@@ -13750,9 +13760,15 @@ bool CHDWallet::SignBlock(node::CBlockTemplate *pblocktemplate, int nHeight, int
             // Insert coinstake as txn0
             pblock->vtx.insert(pblock->vtx.begin(), MakeTransactionRef(txCoinStake));
 
-            bool mutated;
-            pblock->hashMerkleRoot = BlockMerkleRoot(*pblock, &mutated);
-            pblock->hashWitnessMerkleRoot = BlockWitnessMerkleRoot(*pblock, &mutated);
+            // The trees are built with the template, only txn0 changed since
+            auto &trees = pblocktemplate->merkle_trees;
+            if (trees && trees->Matches(*pblock)) {
+                trees->UpdateFirst(*pblock);
+            } else {
+                trees = std::make_unique<BlockMerkleTrees>(*pblock);
+            }
+            pblock->hashMerkleRoot = trees->MerkleRoot();
+            pblock->hashWitnessMerkleRoot = trees->WitnessMerkleRoot();
 
             // Append a signature to the block
             return key.Sign(pblock->GetHash(), pblock->vchBlockSig);
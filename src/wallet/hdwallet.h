@@ -6,6 +6,8 @@
 #define GLOBE_WALLET_HDWALLET_H
 
 #include <wallet/wallet.h>
+#include <wallet/anonoutputcache.h>
+#include <wallet/devicekeycache.h>
 #include <wallet/hdwalletdb.h>
 #include <wallet/hdwallettypes.h>
 #include <wallet/spend.h>
@@ -217,6 +219,10 @@ public:
         const std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &vCoins, std::vector<uint8_t> &vInputBlinds, const CCoinControl *coinControl, std::string &sError);
     int PickHidingOutputs(std::vector<std::vector<int64_t> > &vMI, size_t nSecretColumn, size_t nRingSize, std::set<int64_t> &setHave, const CCoinControl *coinControl, std::string &sError);
 
+    /** Read anon outputs through m_anon_output_cache */
+    bool ReadAnonOutput(int64_t index, CAnonOutput &ao, bool own=false) const;
+    bool ReadAnonOutputLink(const CCmpPubKey &pk, int64_t &index) const;
+
     int AddAnonInputs(CWalletTx &wtx, CTransactionRecord &rtx,
         std::vector<CTempRecipient> &vecSend,
         CExtKeyAccount *sea, CStoredExtKey *pc,
@@ -226,9 +232,11 @@ public:
 
 
     void ClearCachedBalances() override;
+    void FlushCaches() override;
     bool LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx) override EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void LoadToWallet(const uint256 &hash, CTransactionRecord &rtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void leavingIBD() override;
+    void blockDisconnected(const interfaces::BlockInfo& block) override;
 
     /** Remove txn from mapwallet and TxSpends */
     void RemoveFromTxSpends(const uint256 &hash, const CTransactionRef pt) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -278,6 +286,9 @@ public:
     /** Prepare loose extkey lookahead
      *  fake const for IsMine */
     int ExtKeyAddLookAhead(CStoredExtKey *sek) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Extend the lookahead of an account chain, counted in m_device_key_cache for hardware linked chains
+     *  fake const for IsMine */
+    int ExtKeyAccountAddLookAhead(CExtKeyAccount *sea, uint32_t nChain, uint32_t nKeys) const;
     /** Promote loose extkey lookahead key to saved key
      *  fake const for IsMine */
     int ExtKeyPromoteKey(CStoredExtKey *sek, uint32_t nChildKey) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -429,7 +440,12 @@ public:
         const CCoinControl& coin_control, const CoinSelectionParams& coin_selection_params) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     void AvailableBlindedCoins(std::vector<COutputR>& vCoins, const CCoinControl *coinControl = nullptr, const CAmount& nMinimumAmount = 1, const CAmount& nMaximumAmount = MAX_MONEY, const CAmount& nMinimumSumAmount = MAX_MONEY, const uint64_t& nMaximumCount = 0) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
-    bool SelectBlindedCoins(const std::vector<COutputR>& vAvailableCoins, const CAmount& nTargetValue, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &setCoinsRet, CAmount &nValueRet, const CCoinControl *coinControl = nullptr, bool random_selection = false) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Select blinded outputs, or anon outputs spent in rings of ring_size members when ring_size > 0.
+     * nTargetValue excludes the fee of the inputs, each input counts at its value less the fee to spend it
+     * unless subtract_fee_outputs is set. */
+    bool SelectBlindedCoins(const std::vector<COutputR>& vAvailableCoins, const CAmount& nTargetValue, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &setCoinsRet, CAmount &nValueRet, const CCoinControl *coinControl = nullptr, bool random_selection = false, size_t ring_size = 0, bool subtract_fee_outputs = false) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Fee SelectBlindedCoins counts for spending num_inputs of its inputs */
+    CAmount GetBlindedInputsFee(size_t num_inputs, const CCoinControl *coinControl = nullptr, size_t ring_size = 0) const;
 
     void AvailableAnonCoins(std::vector<COutputR> &vCoins, const CCoinControl *coinControl = nullptr, const CAmount& nMinimumAmount = 1, const CAmount& nMaximumAmount = MAX_MONEY, const CAmount& nMinimumSumAmount = MAX_MONEY, const uint64_t& nMaximumCount = 0) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
@@ -442,7 +458,6 @@ public:
     std::map<CTxDestination, std::vector<COutput>> ListCoins() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     std::map<CTxDestination, std::vector<COutputR>> ListCoins(OutputTypes nType) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
-    bool AttemptSelection(const CAmount& nTargetValue, const CoinEligibilityFilter& eligibility_filter, std::vector<COutputR> vCoins, std::vector<std::pair<MapRecords_t::const_iterator,unsigned int> > &setCoinsRet, CAmount &nValueRet) const;
 
     bool IsSpent(const COutPoint& outpoint) const override EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool GetSpendingTxid(const uint256& hash, unsigned int n, uint256 &spent_by_txid) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -473,6 +488,11 @@ public:
     bool SetSetting(const std::string &setting, const UniValue &json);
     bool EraseSetting(const std::string &setting);
 
+    /** Write m_device_key_cache to the db if it changed */
+    bool FlushDeviceKeyCache();
+    /** Write the owned outputs of m_anon_output_cache to the db if they changed, and the decoys if flush_decoys is set */
+    bool FlushAnonOutputCache(bool flush_decoys = false);
+
     int64_t GetTimeFirstKey();
 
     /** Return a prevout if it exists in the wallet. */
@@ -575,6 +595,9 @@ public:
 
     std::map<CKeyID, uint32_t> m_derived_keys; // Allows multiple provisional derivations from the same extkey
 
+    mutable DeviceKeyCache m_device_key_cache; // Xpubs read from the hardware device of a hardware linked wallet
+    mutable AnonOutputCache m_anon_output_cache; // Anon outputs of the wallet and recent decoys read from the node
+
 private:
     void ParseAddressForMetaData(const CTxDestination &addr, COutputRecord &rec);
 
@@ -296,6 +296,26 @@ bool CHDWalletDB::EraseWalletSetting(const std::string &setting)
     return EraseIC(std::make_pair(DBKeys::PART_WALLETSETTING, setting));
 };
 
+bool CHDWalletDB::ReadDeviceKeyCache(DeviceKeyCache &cache, uint32_t nFlags)
+{
+    return m_batch->Read(DBKeys::PART_DEVICEKEYCACHE, cache, nFlags);
+};
+
+bool CHDWalletDB::WriteDeviceKeyCache(const DeviceKeyCache &cache)
+{
+    return WriteIC(DBKeys::PART_DEVICEKEYCACHE, cache, true);
+};
+
+bool CHDWalletDB::ReadAnonOutputCache(bool own, AnonOutputCache::Record &record, uint32_t nFlags)
+{
+    return m_batch->Read(std::make_pair(DBKeys::PART_ANONOUTPUTCACHE, own), record, nFlags);
+};
+
+bool CHDWalletDB::WriteAnonOutputCache(bool own, const AnonOutputCache::Record &record)
+{
+    return WriteIC(std::make_pair(DBKeys::PART_ANONOUTPUTCACHE, own), record, true);
+};
+
 bool CHDWalletDB::ReadEKLKey(const CKeyID &id, CEKLKey &c, uint32_t nFlags)
 {
     return m_batch->Read(std::make_pair(DBKeys::PART_LEXTKEYCK, id), c, nFlags);
@@ -6,6 +6,7 @@
 #define GLOBE_WALLET_HDWALLETDB_H
 
 #include <primitives/transaction.h>
+#include <wallet/anonoutputcache.h>
 #include <wallet/bdb.h>
 #include <wallet/walletdb.h>
 #include <key/types.h>
@@ -15,6 +16,7 @@
 
 namespace wallet {
 class CAddressBookData;
+class DeviceKeyCache;
 } // namespace wallet
 
 using namespace wallet;
@@ -46,6 +48,7 @@ prefixes
     cscript
 
     defaultkey
+    dkc                 - hardware device xpub cache
 
     eacc                - extended account
     ecpk                - extended account stealth child key pack
@@ -416,6 +419,13 @@ public:
     bool WriteWalletSetting(const std::string &setting, const std::string &json);
     bool EraseWalletSetting(const std::string &setting);
 
+    bool ReadDeviceKeyCache(DeviceKeyCache &cache, uint32_t nFlags=DB_READ_UNCOMMITTED);
+    bool WriteDeviceKeyCache(const DeviceKeyCache &cache);
+
+    /** Owned outputs and decoys of the anon output cache are separate records */
+    bool ReadAnonOutputCache(bool own, AnonOutputCache::Record &record, uint32_t nFlags=DB_READ_UNCOMMITTED);
+    bool WriteAnonOutputCache(bool own, const AnonOutputCache::Record &record);
+
     /** extkey chain loose child keys */
     bool ReadEKLKey(const CKeyID &id, CEKLKey &c, uint32_t nFlags=DB_READ_UNCOMMITTED);
     bool WriteEKLKey(const CKeyID &id, const CEKLKey &c);
@@ -11,6 +11,7 @@
 #include <util/check.h>
 #include <util/string.h>
 #include <util/system.h>
+#include <util/thread.h>
 #include <util/translation.h>
 #include <wallet/context.h>
 #include <wallet/spend.h>
@@ -21,7 +22,10 @@
 
 #include <univalue.h>
 
+#include <algorithm>
+#include <atomic>
 #include <system_error>
+#include <thread>
 
 namespace wallet {
 bool VerifyWallets(WalletContext& context)
@@ -108,33 +112,80 @@ bool LoadWallets(WalletContext& context)
 {
     interfaces::Chain& chain = *context.chain;
     try {
+        struct WalletToLoad {
+            std::string name;
+            DatabaseOptions options;
+            std::unique_ptr<WalletDatabase> database;
+            std::shared_ptr<CWallet> wallet;
+            bilingual_str error;
+            std::vector<bilingual_str> warnings;
+        };
+        std::vector<WalletToLoad> to_load;
         std::set<fs::path> wallet_paths;
         for (const auto& wallet : chain.getSettingsList("wallet")) {
             const auto& name = wallet.get_str();
             if (!wallet_paths.insert(fs::PathFromString(name)).second) {
                 continue;
             }
-            DatabaseOptions options;
+            WalletToLoad entry;
+            entry.name = name;
             DatabaseStatus status;
-            ReadDatabaseArgs(*context.args, options);
-            options.require_existing = true;
-            options.verify = false; // No need to verify, assuming verified earlier in VerifyWallets()
-            bilingual_str error;
-            std::vector<bilingual_str> warnings;
-            std::unique_ptr<WalletDatabase> database = MakeWalletDatabase(name, options, status, error);
-            if (!database && status == DatabaseStatus::FAILED_NOT_FOUND) {
+            ReadDatabaseArgs(*context.args, entry.options);
+            entry.options.require_existing = true;
+            entry.options.verify = false; // No need to verify, assuming verified earlier in VerifyWallets()
+            entry.database = MakeWalletDatabase(name, entry.options, status, entry.error);
+            if (!entry.database && status == DatabaseStatus::FAILED_NOT_FOUND) {
                 continue;
             }
-            chain.initMessage(_("Loading wallet…").translated);
-            std::shared_ptr<CWallet> pwallet = database ? CWallet::Create(context, name, std::move(database), options.create_flags, error, warnings) : nullptr;
-            if (!warnings.empty()) chain.initWarning(Join(warnings, Untranslated("\n")));
-            if (!pwallet) {
-                chain.initError(error);
-                return false;
+            to_load.push_back(std::move(entry));
+        }
+        if (to_load.empty()) {
+            return true;
+        }
+
+        // Wallets are created concurrently so that their rescans share block reads, see RescanCoordinator
+        chain.initMessage(_("Loading wallet…").translated);
+        std::atomic<size_t> next{0};
+        auto load_wallets = [&] {
+            for (size_t i = next++; i < to_load.size(); i = next++) {
+                WalletToLoad& entry = to_load[i];
+                if (!entry.database) continue;
+                // An exception escaping a load thread would terminate the process
+                try {
+                    entry.wallet = CWallet::Create(context, entry.name, std::move(entry.database), entry.options.create_flags, entry.error, entry.warnings);
+                } catch (const std::exception& e) {
+                    entry.error = Untranslated(e.what());
+                } catch (...) {
+                    entry.error = Untranslated(strprintf("Unknown exception loading wallet %s", entry.name));
+                }
             }
+        };
+        const size_t num_threads = std::clamp<int64_t>(context.args->GetIntArg("-walletloadthreads", DEFAULT_WALLET_LOAD_THREADS), 1, to_load.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < num_threads; ++i) {
+            threads.emplace_back(&util::TraceThread, "walletload", load_wallets);
+        }
+        load_wallets();
+        for (auto& thread : threads) {
+            thread.join();
+        }
 
-            NotifyWalletLoaded(context, pwallet);
-            AddWallet(context, pwallet);
+        for (WalletToLoad& entry : to_load) {
+            if (!entry.warnings.empty()) chain.initWarning(Join(entry.warnings, Untranslated("\n")));
+            if (!entry.wallet) {
+                chain.initError(entry.error);
+                // Wallets created by other threads are not in the context, unload them here
+                for (WalletToLoad& created : to_load) {
+                    if (!created.wallet) continue;
+                    RemoveWallet(context, created.wallet, /*load_on_start=*/std::nullopt);
+                    UnloadWallet(std::move(created.wallet));
+                }
+                return false;
+            }
+        }
+        for (WalletToLoad& entry : to_load) {
+            NotifyWalletLoaded(context, entry.wallet);
+            AddWallet(context, entry.wallet);
         }
         return true;
     } catch (const std::runtime_error& e) {
@@ -154,11 +205,17 @@ void StartWallets(WalletContext& context, CScheduler& scheduler)
         scheduler.scheduleEvery([&context] { MaybeCompactWalletDB(context); }, std::chrono::milliseconds{500});
     }
     scheduler.scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min);
+    scheduler.scheduleEvery([&context] {
+        for (const std::shared_ptr<CWallet>& pwallet : GetWallets(context)) {
+            pwallet->FlushCaches();
+        }
+    }, 10min);
 }
 
 void FlushWallets(WalletContext& context)
 {
     for (const std::shared_ptr<CWallet>& pwallet : GetWallets(context)) {
+        pwallet->FlushCaches();
         pwallet->Flush();
     }
 }
@@ -19,6 +19,9 @@ class Chain;
 namespace wallet {
 struct WalletContext;
 
+//! Default for -walletloadthreads, wallets created at the same time during startup
+static constexpr int DEFAULT_WALLET_LOAD_THREADS{4};
+
 //! Responsible for reading and validating the -wallet arguments and verifying the wallet database.
 bool VerifyWallets(WalletContext& context);
 
@@ -0,0 +1,131 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/rescan.h>
+
+#include <core_memusage.h>
+#include <primitives/block.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace wallet {
+RescanCoordinator::Scan::Scan(RescanCoordinator& coordinator, int start_height)
+    : m_coordinator(coordinator), m_id(coordinator.Register(start_height))
+{
+}
+
+RescanCoordinator::Scan::~Scan()
+{
+    m_coordinator.Unregister(m_id);
+}
+
+std::shared_ptr<const CBlock> RescanCoordinator::Scan::ReadBlock(const uint256& hash, int height, const BlockReader& reader)
+{
+    return m_coordinator.ReadBlock(m_id, hash, height, reader);
+}
+
+uint64_t RescanCoordinator::Register(int start_height)
+{
+    LOCK(m_mutex);
+    const uint64_t id = m_next_scan_id++;
+    m_scans.emplace(id, start_height);
+    return id;
+}
+
+void RescanCoordinator::Unregister(uint64_t id)
+{
+    LOCK(m_mutex);
+    m_scans.erase(id);
+    Prune();
+}
+
+std::shared_ptr<const CBlock> RescanCoordinator::ReadBlock(uint64_t id, const uint256& hash, int height, const BlockReader& reader)
+{
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_scans[id] = height;
+        auto it = m_blocks.find(hash);
+        while (it != m_blocks.end() && it->second.reading) {
+            m_cond.wait(lock);
+            // The entry may have been evicted once read
+            it = m_blocks.find(hash);
+        }
+        if (it != m_blocks.end() && it->second.block) {
+            m_hits++;
+            std::shared_ptr<const CBlock> block = it->second.block;
+            Prune();
+            return block;
+        }
+        if (it == m_blocks.end()) {
+            m_blocks.emplace(hash, Entry{height, /*block=*/nullptr, /*reading=*/true, /*usage=*/0});
+        } else {
+            // Previous read failed, try again
+            it->second.reading = true;
+        }
+        m_reads++;
+    }
+
+    auto block = std::make_shared<CBlock>();
+    if (!reader(hash, *block) || block->IsNull()) {
+        block.reset();
+    }
+
+    LOCK(m_mutex);
+    Entry& entry = m_blocks.at(hash);
+    entry.reading = false;
+    entry.block = block;
+    entry.usage = block ? RecursiveDynamicUsage(*block) : 0;
+    m_usage += entry.usage;
+    Prune();
+    m_cond.notify_all();
+    return block;
+}
+
+void RescanCoordinator::Prune()
+{
+    int min_height = std::numeric_limits<int>::max();
+    for (const auto& scan : m_scans) {
+        min_height = std::min(min_height, scan.second);
+    }
+    for (auto it = m_blocks.begin(); it != m_blocks.end();) {
+        // Scans move up the chain, so a block below all of them is not needed again.
+        // A lone scan has already read the block at its own height.
+        if (!it->second.reading && (it->second.height < min_height || (it->second.height == min_height && m_scans.size() <= 1))) {
+            m_usage -= it->second.usage;
+            it = m_blocks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_usage <= m_max_usage) {
+        return;
+    }
+    std::multimap<int, std::map<uint256, Entry>::iterator> by_height;
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        if (!it->second.reading) by_height.emplace(it->second.height, it);
+    }
+    for (auto it = by_height.begin(); m_usage > m_max_usage && it != by_height.end(); ++it) {
+        m_usage -= it->second->second.usage;
+        m_blocks.erase(it->second);
+    }
+}
+
+RescanCoordinator::Stats RescanCoordinator::GetStats()
+{
+    LOCK(m_mutex);
+    Stats stats;
+    stats.reads = m_reads;
+    stats.hits = m_hits;
+    stats.cached_blocks = m_blocks.size();
+    stats.cached_usage = m_usage;
+    return stats;
+}
+
+RescanCoordinator& GetRescanCoordinator()
+{
+    static RescanCoordinator g_rescan_coordinator;
+    return g_rescan_coordinator;
+}
+} // namespace wallet
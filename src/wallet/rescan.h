@@ -0,0 +1,95 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBE_WALLET_RESCAN_H
+#define GLOBE_WALLET_RESCAN_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+
+class CBlock;
+
+namespace wallet {
+//! Memory the shared rescan block cache may use, in bytes.
+static constexpr size_t DEFAULT_RESCAN_CACHE_SIZE{64 << 20};
+
+/**
+ * Shares block reads between wallets rescanning the chain at the same time.
+ *
+ * Each scan registers its position. A block read for one scan is kept until
+ * every registered scan has moved past its height, so wallets scanning the
+ * same range read and deserialise each block once. When the cache is full
+ * the lowest blocks are evicted and a scan that falls behind reads them again.
+ */
+class RescanCoordinator
+{
+public:
+    //! Reads a block, returns false if it is not available.
+    using BlockReader = std::function<bool(const uint256& hash, CBlock& block)>;
+
+    struct Stats {
+        uint64_t reads{0};
+        uint64_t hits{0};
+        size_t cached_blocks{0};
+        size_t cached_usage{0};
+    };
+
+    /** Position of a rescan, registered for the handle's lifetime */
+    class Scan
+    {
+    public:
+        Scan(RescanCoordinator& coordinator, int start_height);
+        ~Scan();
+        Scan(const Scan&) = delete;
+        Scan& operator=(const Scan&) = delete;
+
+        /** Get the block at height, returns nullptr if it could not be read */
+        std::shared_ptr<const CBlock> ReadBlock(const uint256& hash, int height, const BlockReader& reader);
+
+    private:
+        RescanCoordinator& m_coordinator;
+        const uint64_t m_id;
+    };
+
+    explicit RescanCoordinator(size_t max_usage = DEFAULT_RESCAN_CACHE_SIZE) : m_max_usage(max_usage) {}
+
+    Stats GetStats() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        int height;
+        //! Null while being read, or if the read failed
+        std::shared_ptr<const CBlock> block;
+        bool reading{true};
+        size_t usage{0};
+    };
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::map<uint256, Entry> m_blocks GUARDED_BY(m_mutex);
+    //! Height each registered scan is at
+    std::map<uint64_t, int> m_scans GUARDED_BY(m_mutex);
+    uint64_t m_next_scan_id GUARDED_BY(m_mutex){0};
+    size_t m_usage GUARDED_BY(m_mutex){0};
+    uint64_t m_reads GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    const size_t m_max_usage;
+
+    uint64_t Register(int start_height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Unregister(uint64_t id) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::shared_ptr<const CBlock> ReadBlock(uint64_t id, const uint256& hash, int height, const BlockReader& reader) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Drop blocks every scan has passed, then the lowest blocks until under the limit */
+    void Prune() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+/** Coordinator shared by all wallets in the process */
+RescanCoordinator& GetRescanCoordinator();
+} // namespace wallet
+
+#endif // GLOBE_WALLET_RESCAN_H
@@ -927,13 +927,13 @@ Span<const CRPCCommand> GetWalletRPCCommands()
         {"wallet", &dumpwallet},
         {"wallet", &encryptwallet},
         {"wallet", &getaddressesbylabel},
-        {"wallet", &getaddressinfo},
+        {"wallet", &getaddressinfo, /*batch_parallel_safe=*/true},
         {"wallet", &getbalance},
         {"wallet", &getnewaddress},
         {"wallet", &getrawchangeaddress},
         {"wallet", &getreceivedbyaddress},
         {"wallet", &getreceivedbylabel},
-        {"wallet", &gettransaction},
+        {"wallet", &gettransaction, /*batch_parallel_safe=*/true},
         {"wallet", &getunconfirmedbalance},
         {"wallet", &getbalances},
         {"wallet", &getwalletinfo},
@@ -2908,6 +2908,10 @@ static RPCHelpMan deriverangekeys()
                 }
             }
         }
+        if (sek->nFlags & EAF_HARDWARE_DEVICE) {
+            // Derived from the stored chain xpub, never from the device
+            pwallet->m_device_key_cache.CountLocalDerivations("deriverangekeys", nEnd - nStart + 1);
+        }
     }
 
     return result;
@@ -6861,6 +6865,29 @@ static RPCHelpMan debugwallet()
         result.pushKV("map_loose_keys_size", (int)pwallet->mapLooseKeys.size());                // Child keys derived from ext keys not in accounts
         result.pushKV("map_loose_lookahead_size", (int)pwallet->mapLooseLookAhead.size());      // Includes account keys
 
+        UniValue device_keys(UniValue::VOBJ);
+        device_keys.pushKV("device", pwallet->m_device_key_cache.GetDeviceId());
+        device_keys.pushKV("size", (int)pwallet->m_device_key_cache.Size());
+        device_keys.pushKV("hits", pwallet->m_device_key_cache.GetHits());
+        UniValue device_ops(UniValue::VOBJ);
+        for (const auto &op : pwallet->m_device_key_cache.GetOpStats()) {
+            UniValue op_stats(UniValue::VOBJ);
+            op_stats.pushKV("calls", op.second.calls);
+            op_stats.pushKV("round_trips", op.second.round_trips);          // Device reads of xpubs
+            op_stats.pushKV("last_round_trips", op.second.last_round_trips);
+            device_ops.pushKV(op.first, op_stats);
+        }
+        device_keys.pushKV("operations", device_ops);
+        result.pushKV("device_key_cache", device_keys);
+
+        const AnonOutputCache::Stats anon_stats = pwallet->m_anon_output_cache.GetStats();
+        UniValue anon_outputs(UniValue::VOBJ);
+        anon_outputs.pushKV("own_outputs", (int)anon_stats.own_outputs);
+        anon_outputs.pushKV("decoys", (int)anon_stats.decoys);
+        anon_outputs.pushKV("hits", anon_stats.hits);
+        anon_outputs.pushKV("misses", anon_stats.misses);            // Reads from the node
+        result.pushKV("anon_output_cache", anon_outputs);
+
         for (auto it = pwallet->mapWallet.cbegin(); it != pwallet->mapWallet.cend(); ++it) {
             const uint256 &wtxid = it->first;
             const CWalletTx &wtx = it->second;
@@ -0,0 +1,168 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <key.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <version.h>
+#include <wallet/anonoutputcache.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace wallet {
+BOOST_FIXTURE_TEST_SUITE(anonoutputcache_tests, BasicTestingSetup)
+
+/** Anon outputs as the node's rct index would return them, counting reads */
+struct TestIndex {
+    std::map<int64_t, CAnonOutput> outputs;
+    int reads{0};
+    int link_reads{0};
+
+    void Add(int64_t index, int height)
+    {
+        CKey key;
+        key.MakeNewKey(true);
+        CPubKey pk = key.GetPubKey();
+        CAnonOutput ao;
+        ao.pubkey = CCmpPubKey(pk.begin(), pk.end());
+        ao.nBlockHeight = height;
+        outputs[index] = ao;
+    }
+    AnonOutputCache::OutputReader Reader()
+    {
+        return [this](int64_t index, CAnonOutput& ao) {
+            reads++;
+            auto it = outputs.find(index);
+            if (it == outputs.end()) {
+                return false;
+            }
+            ao = it->second;
+            return true;
+        };
+    }
+    AnonOutputCache::LinkReader LinkReader()
+    {
+        return [this](const CCmpPubKey& pk, int64_t& index) {
+            link_reads++;
+            for (const auto& entry : outputs) {
+                if (entry.second.pubkey == pk) {
+                    index = entry.first;
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+};
+
+BOOST_AUTO_TEST_CASE(anonoutputcache_read)
+{
+    TestIndex index;
+    for (int64_t i = 1; i <= 20; ++i) {
+        index.Add(i, /*height=*/i);
+    }
+    AnonOutputCache cache(/*max_decoys=*/5);
+
+    // Own outputs are found by pubkey and kept
+    int64_t found;
+    BOOST_CHECK(cache.ReadOutputLink(index.outputs[3].pubkey, found, index.LinkReader(), index.Reader()));
+    BOOST_CHECK_EQUAL(found, 3);
+    BOOST_CHECK(cache.ReadOutputLink(index.outputs[3].pubkey, found, index.LinkReader(), index.Reader()));
+    BOOST_CHECK_EQUAL(index.link_reads, 1);
+    BOOST_CHECK_EQUAL(index.reads, 1);
+    BOOST_CHECK(cache.IsDirty(/*own=*/true));
+    BOOST_CHECK(!cache.IsDirty(/*own=*/false));
+
+    // Decoys are evicted oldest first past the limit
+    CAnonOutput ao;
+    for (int64_t i = 10; i <= 20; ++i) {
+        BOOST_CHECK(cache.ReadOutput(i, ao, /*own=*/false, index.Reader()));
+        BOOST_CHECK(ao.pubkey == index.outputs[i].pubkey);
+    }
+    BOOST_CHECK_EQUAL(cache.GetStats().decoys, 5U);
+    BOOST_CHECK_EQUAL(cache.GetStats().own_outputs, 1U);
+    const int reads = index.reads;
+    BOOST_CHECK(cache.ReadOutput(20, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK(cache.ReadOutput(3, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK_EQUAL(index.reads, reads);
+    BOOST_CHECK(cache.ReadOutput(10, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK_EQUAL(index.reads, reads + 1);
+
+    // Missing outputs are reported and not cached
+    BOOST_CHECK(!cache.ReadOutput(100, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK(!cache.ReadOutput(100, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK_EQUAL(index.reads, reads + 3);
+
+    // Reading decoys leaves the owned outputs clean
+    cache.MarkClean(/*own=*/true);
+    cache.MarkClean(/*own=*/false);
+    BOOST_CHECK(cache.ReadOutput(11, ao, /*own=*/false, index.Reader()));
+    BOOST_CHECK(!cache.IsDirty(/*own=*/true));
+    BOOST_CHECK(cache.IsDirty(/*own=*/false));
+
+    // Owned outputs and decoys are stored separately and survive a reload
+    AnonOutputCache loaded(/*max_decoys=*/5);
+    for (const bool own : {true, false}) {
+        CDataStream stream(SER_DISK, PROTOCOL_VERSION);
+        stream << cache.GetRecord(own, uint256::ONE, 20);
+        AnonOutputCache::Record record;
+        stream >> record;
+        BOOST_CHECK(record.tip_hash == uint256::ONE);
+        BOOST_CHECK_EQUAL(record.outputs.size(), own ? 1U : 5U);
+        loaded.LoadRecord(record, own, /*tip_height=*/20);
+    }
+    BOOST_CHECK(!loaded.IsDirty(/*own=*/true));
+    BOOST_CHECK(!loaded.IsDirty(/*own=*/false));
+    BOOST_CHECK_EQUAL(loaded.GetStats().decoys, 5U);
+    BOOST_CHECK(loaded.ReadOutputLink(index.outputs[3].pubkey, found, index.LinkReader(), index.Reader()));
+    BOOST_CHECK_EQUAL(found, 3);
+    BOOST_CHECK_EQUAL(index.link_reads, 1);
+}
+
+BOOST_AUTO_TEST_CASE(anonoutputcache_reorg)
+{
+    TestIndex index;
+    for (int64_t i = 1; i <= 10; ++i) {
+        index.Add(i, /*height=*/i);
+    }
+    AnonOutputCache cache;
+    CAnonOutput ao;
+    for (int64_t i = 1; i <= 10; ++i) {
+        BOOST_CHECK(cache.ReadOutput(i, ao, /*own=*/i % 2 == 0, index.Reader()));
+    }
+    cache.MarkClean(/*own=*/true);
+    cache.MarkClean(/*own=*/false);
+
+    // Index 8 onwards is replaced by the new chain
+    cache.BlockDisconnected(8);
+    BOOST_CHECK(cache.IsDirty(/*own=*/true));
+    BOOST_CHECK(cache.IsDirty(/*own=*/false));
+    BOOST_CHECK_EQUAL(cache.GetStats().own_outputs, 3U);
+    BOOST_CHECK_EQUAL(cache.GetStats().decoys, 4U);
+    index.Add(8, /*height=*/8);
+    int64_t found;
+    BOOST_CHECK(cache.ReadOutputLink(index.outputs[8].pubkey, found, index.LinkReader(), index.Reader()));
+    BOOST_CHECK_EQUAL(found, 8);
+
+    // Outputs above the recorded tip are dropped on load
+    AnonOutputCache loaded;
+    for (const bool own : {true, false}) {
+        loaded.LoadRecord(cache.GetRecord(own, uint256::ONE, 6), own, /*tip_height=*/6);
+    }
+    BOOST_CHECK_EQUAL(loaded.GetStats().own_outputs, 3U);
+    BOOST_CHECK_EQUAL(loaded.GetStats().decoys, 3U);
+    BOOST_CHECK(loaded.IsDirty(/*own=*/true));
+    BOOST_CHECK(loaded.IsDirty(/*own=*/false));
+
+    // A tip no longer in the chain loads nothing
+    AnonOutputCache stale;
+    for (const bool own : {true, false}) {
+        stale.LoadRecord(cache.GetRecord(own, uint256::ONE, 10), own, /*tip_height=*/std::nullopt);
+    }
+    BOOST_CHECK_EQUAL(stale.GetStats().own_outputs, 0U);
+    BOOST_CHECK_EQUAL(stale.GetStats().decoys, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace wallet
@@ -1009,5 +1009,90 @@ BOOST_FIXTURE_TEST_CASE(wallet_coinsresult_test, BasicTestingSetup)
     }
 }
 
+BOOST_AUTO_TEST_CASE(blinded_selection_test)
+{
+    // Anon sized inputs at a high feerate, one coin matching the target beats many small ones on waste
+    const int input_bytes = 779;
+    FastRandomContext rand{};
+    CoinSelectionParams params{
+        rand,
+        /*change_output_size=*/ 772,
+        /*change_spend_size=*/ input_bytes,
+        /*min_change_target=*/ CENT,
+        /*effective_feerate=*/ CFeeRate(10000),
+        /*long_term_feerate=*/ CFeeRate(1000),
+        /*discard_feerate=*/ CFeeRate(1000),
+        /*tx_noinputs_size=*/ 0,
+        /*avoid_partial=*/ false,
+    };
+    params.m_change_fee = params.m_effective_feerate.GetFee(params.change_output_size);
+    params.m_cost_of_change = params.m_discard_feerate.GetFee(params.change_spend_size) + params.m_change_fee;
+    params.min_viable_change = params.m_discard_feerate.GetFee(params.change_spend_size);
+
+    std::vector<OutputGroup> groups;
+    auto add_group = [&](CAmount value) {
+        CMutableTransaction tx;
+        tx.vout.resize(1);
+        tx.vout[0].nValue = value;
+        tx.nLockTime = nextLockTime++;
+        COutput output(COutPoint(tx.GetHash(), 0), tx.vout.at(0), /*depth=*/ 6, input_bytes, /*spendable=*/ true, /*solvable=*/ true, /*safe=*/ true, /*time=*/ 0, /*from_me=*/ false, params.m_effective_feerate);
+        OutputGroup group(params);
+        group.Insert(output, /*ancestors=*/ 0, /*descendants=*/ 0, /*positive_only=*/ true);
+        groups.push_back(group);
+    };
+    for (int i = 0; i < 20; ++i) {
+        add_group(10 * CENT);
+    }
+    const CAmount match = 1 * COIN + params.m_effective_feerate.GetFee(input_bytes);
+    add_group(match);
+    // Spending this one costs more than it is worth
+    add_group(500);
+
+    const auto result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ false);
+    BOOST_REQUIRE(result);
+    BOOST_CHECK_EQUAL(result->GetInputSet().size(), 1U);
+    BOOST_CHECK_EQUAL(result->GetSelectedValue(), match);
+
+    // Random draws compete on waste against BnB
+    for (int i = 0; i < 10; ++i) {
+        const auto random_result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ true);
+        BOOST_REQUIRE(random_result);
+        BOOST_CHECK_EQUAL(random_result->GetInputSet().size(), 1U);
+    }
+
+    // Without a match the random draws still cover the target
+    groups.pop_back();
+    groups.pop_back();
+    const auto random_result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ true);
+    BOOST_REQUIRE(random_result);
+    BOOST_CHECK_GE(random_result->GetSelectedEffectiveValue(), 1 * COIN);
+
+    BOOST_CHECK(!ChooseBlindedSelectionResult(groups, 5 * COIN, params, /*random_selection=*/ false));
+
+    // Below the long term feerate more inputs waste less, a limit on the inputs is preferred over waste
+    params.m_effective_feerate = CFeeRate(1000);
+    params.m_long_term_feerate = CFeeRate(10000);
+    params.m_change_fee = params.m_effective_feerate.GetFee(params.change_output_size);
+    params.m_cost_of_change = params.m_discard_feerate.GetFee(params.change_spend_size) + params.m_change_fee;
+    groups.clear();
+    const CAmount input_fee = params.m_effective_feerate.GetFee(input_bytes);
+    for (int i = 0; i < 10; ++i) {
+        add_group(10 * CENT + input_fee);
+    }
+    // Knapsack takes the exact match, BnB the ten inputs matching with less waste
+    add_group(1 * COIN + input_fee);
+    const auto many_result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ false);
+    BOOST_REQUIRE(many_result);
+    BOOST_CHECK_GE(many_result->GetInputSet().size(), 10U);
+    const auto few_result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ false, /*max_preferred_inputs=*/ 5);
+    BOOST_REQUIRE(few_result);
+    BOOST_CHECK_LE(few_result->GetInputSet().size(), 5U);
+    // Without a result under the limit the least waste is still chosen
+    groups.pop_back();
+    const auto over_result = ChooseBlindedSelectionResult(groups, 1 * COIN, params, /*random_selection=*/ false, /*max_preferred_inputs=*/ 5);
+    BOOST_REQUIRE(over_result);
+    BOOST_CHECK_EQUAL(over_result->GetInputSet().size(), 10U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -0,0 +1,142 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <key/extkey.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <version.h>
+#include <wallet/devicekeycache.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace wallet {
+BOOST_FIXTURE_TEST_SUITE(devicekeycache_tests, BasicTestingSetup)
+
+/** Derives like usbdevice/debugdevice.cpp, counting reads */
+struct TestDevice {
+    CExtKey master;
+    int reads{0};
+
+    explicit TestDevice(const std::string& seed)
+    {
+        master.SetSeed((const uint8_t*)seed.data(), seed.size());
+    }
+    CExtPubKey Derive(const std::vector<uint32_t>& path) const
+    {
+        CExtKey out, work = master;
+        for (uint32_t n : path) {
+            BOOST_REQUIRE(work.Derive(out, n));
+            work = out;
+        }
+        return work.Neutered();
+    }
+    DeviceKeyCache::XPubFetcher Fetcher()
+    {
+        return [this](const std::vector<uint32_t>& path, CExtPubKey& ekp, std::string& error) {
+            reads++;
+            ekp = Derive(path);
+            return 0;
+        };
+    }
+};
+
+BOOST_AUTO_TEST_CASE(devicekeycache_derive)
+{
+    TestDevice device("debug key");
+    DeviceKeyCache cache;
+    BOOST_CHECK(!cache.SetDevice("ffff:0001:1"));
+
+    const std::vector<uint32_t> account{WithHardenedBit(44), WithHardenedBit(1), WithHardenedBit(0)};
+    std::string error;
+    CExtPubKey ekp;
+    BOOST_CHECK_EQUAL(cache.GetXPub("init", account, ekp, error, device.Fetcher()), 0);
+    BOOST_CHECK(ekp == device.Derive(account));
+    BOOST_CHECK_EQUAL(device.reads, 1);
+
+    // Non hardened children of the account are derived locally
+    for (uint32_t i = 0; i < 10; ++i) {
+        std::vector<uint32_t> path = account;
+        path.push_back(i % 2);
+        path.push_back(i);
+        CPubKey pk;
+        BOOST_CHECK_EQUAL(cache.GetPubKey("sign", path, pk, error, device.Fetcher()), 0);
+        BOOST_CHECK(pk == device.Derive(path).pubkey);
+    }
+    BOOST_CHECK_EQUAL(device.reads, 1);
+    BOOST_CHECK_EQUAL(cache.GetOpStats()["sign"].calls, 10U);
+    BOOST_CHECK_EQUAL(cache.GetOpStats()["sign"].round_trips, 0U);
+
+    // Keys derived from stored chains are counted without round trips
+    const uint64_t hits = cache.GetHits();
+    cache.CountLocalDerivations("lookahead", 20);
+    BOOST_CHECK_EQUAL(cache.GetOpStats()["lookahead"].calls, 20U);
+    BOOST_CHECK_EQUAL(cache.GetOpStats()["lookahead"].round_trips, 0U);
+    BOOST_CHECK_EQUAL(cache.GetHits(), hits + 20);
+
+    // A hardened index past the cached prefix needs the device
+    std::vector<uint32_t> spend = account;
+    spend.push_back(WithHardenedBit(444445));
+    spend.push_back(3);
+    CPubKey pk;
+    BOOST_CHECK_EQUAL(cache.GetPubKey("stealth", spend, pk, error, device.Fetcher()), 0);
+    BOOST_CHECK(pk == device.Derive(spend).pubkey);
+    BOOST_CHECK_EQUAL(device.reads, 2);
+    BOOST_CHECK_EQUAL(cache.GetOpStats()["stealth"].last_round_trips, 1U);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+
+    // Persisted entries survive a reload
+    CDataStream stream(SER_DISK, PROTOCOL_VERSION);
+    stream << cache;
+    DeviceKeyCache loaded;
+    stream >> loaded;
+    BOOST_CHECK(!loaded.IsDirty());
+    BOOST_CHECK_EQUAL(loaded.GetDeviceId(), "ffff:0001:1");
+    BOOST_CHECK_EQUAL(loaded.Size(), 2U);
+    spend.back() = 4;
+    BOOST_CHECK_EQUAL(loaded.GetPubKey("stealth", spend, pk, error, device.Fetcher()), 0);
+    BOOST_CHECK(pk == device.Derive(spend).pubkey);
+    BOOST_CHECK_EQUAL(device.reads, 2);
+}
+
+BOOST_AUTO_TEST_CASE(devicekeycache_device_change)
+{
+    TestDevice device_a("debug key"), device_b("other key");
+    DeviceKeyCache cache;
+    cache.SetDevice("ffff:0001:1");
+    cache.MarkClean();
+
+    const std::vector<uint32_t> path{WithHardenedBit(44), WithHardenedBit(1), WithHardenedBit(0), 0, 0};
+    std::string error;
+    CPubKey pk;
+    BOOST_CHECK_EQUAL(cache.GetPubKey("sign", path, pk, error, device_a.Fetcher()), 0);
+    BOOST_CHECK(cache.IsDirty());
+    cache.MarkClean();
+
+    // Same device, nothing is cleared
+    BOOST_CHECK(!cache.SetDevice("ffff:0001:1"));
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+
+    BOOST_CHECK(cache.SetDevice("ffff:0001:2"));
+    BOOST_CHECK(cache.IsDirty());
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK_EQUAL(cache.GetPubKey("sign", path, pk, error, device_b.Fetcher()), 0);
+    BOOST_CHECK(pk == device_b.Derive(path).pubkey);
+    BOOST_CHECK(pk != device_a.Derive(path).pubkey);
+    BOOST_CHECK_EQUAL(device_b.reads, 1);
+
+    // Device errors are passed through and not cached
+    const auto failing = [](const std::vector<uint32_t>&, CExtPubKey&, std::string& error) {
+        error = "Device busy.";
+        return 1;
+    };
+    const std::vector<uint32_t> other{WithHardenedBit(44), WithHardenedBit(1), WithHardenedBit(1)};
+    BOOST_CHECK_EQUAL(cache.GetPubKey("sign", other, pk, error, failing), 1);
+    BOOST_CHECK_EQUAL(error, "Device busy.");
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    CExtPubKey ekp;
+    BOOST_CHECK_EQUAL(cache.GetXPub("sign", {}, ekp, error, failing), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace wallet
@@ -462,4 +462,124 @@ BOOST_AUTO_TEST_CASE(rct_test)
     globe::SetNumBlocksOfPeers(peer_blocks);
 }
 
+/** Cache entry of the MLSAG of input n, built from the ring as CheckMLSAG reads it */
+static uint256 MLSAGEntryOf(CBlockTreeDB &blocktree, const CTransaction &tx, size_t n)
+{
+    const CTxIn &txin = tx.vin[n];
+    uint32_t nInputs, nRingSize;
+    txin.GetAnonInfo(nInputs, nRingSize);
+    const std::vector<uint8_t> &vMI = txin.scriptWitness.stack[0];
+    std::vector<uint8_t> ring_pubkeys;
+    std::vector<secp256k1_pedersen_commitment> ring_commitments;
+    size_t ofs = 0, nb = 0;
+    for (size_t i = 0; i < nInputs * nRingSize; ++i) {
+        int64_t anon_index;
+        BOOST_REQUIRE(0 == part::GetVarInt(vMI, ofs, (uint64_t&)anon_index, nb));
+        ofs += nb;
+        CAnonOutput ao;
+        BOOST_REQUIRE(blocktree.ReadRCTOutput(anon_index, ao));
+        ring_pubkeys.insert(ring_pubkeys.end(), ao.pubkey.begin(), ao.pubkey.end());
+        ring_commitments.push_back(ao.commitment);
+    }
+    return MLSAGCacheEntry(tx.GetWitnessHash(), n, ring_pubkeys, ring_commitments);
+}
+
+BOOST_AUTO_TEST_CASE(rct_prevalidation_test)
+{
+    SeedInsecureRand();
+    auto &chain_active = m_node.chainman->ActiveChain();
+    CBlockTreeDB &blocktree = *m_node.chainman->m_blockman.m_block_tree_db;
+    CHDWallet *pwallet = pwalletMain.get();
+    const auto context = util::AnyPtr<node::NodeContext>(&m_node);
+    {
+        int last_height = WITH_LOCK(cs_main, return chain_active.Height());
+        uint256 last_hash = WITH_LOCK(cs_main, return chain_active.Tip()->GetBlockHash());
+        WITH_LOCK(pwallet->cs_wallet, pwallet->SetLastBlockProcessed(last_height, last_hash));
+    }
+    UniValue rv;
+    std::string sError;
+
+    int peer_blocks = globe::GetNumBlocksOfPeers();
+    globe::SetNumBlocksOfPeers(0);
+
+    BOOST_CHECK_NO_THROW(rv = CallRPC("extkeyimportmaster tprv8ZgxMBicQKsPeK5mCpvMsd1cwyT1JZsrBN82XkoYuZY1EVK7EwDaiL9sDfqUU5SntTfbRfnRedFWjg5xkDG5i3iwd3yP7neX5F2dtdCojk4", context));
+    BOOST_CHECK_NO_THROW(rv = CallRPC("extkeyimportmaster tprv8ZgxMBicQKsPe3x7bUzkHAJZzCuGqN6y28zFFyg5i7Yqxqm897VCnmMJz6QScsftHDqsyWW5djx6FzrbkF9HSD3ET163z1SzRhfcWxvwL4G", context));
+    BOOST_CHECK_NO_THROW(rv = CallRPC("getnewextaddress lblHDKey", context));
+
+    CTxDestination stealth_address;
+    {
+        LOCK(pwallet->cs_wallet);
+        pwallet->SetBroadcastTransactions(true);
+        BOOST_CHECK_NO_THROW(rv = CallRPC("getnewstealthaddress", context));
+        stealth_address = DecodeDestination(part::StripQuotes(rv.write()));
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        AddTxn(pwallet, stealth_address, OUTPUT_STANDARD, OUTPUT_RINGCT, 20 * COIN);
+    }
+    StakeNBlocks(pwallet, 2);
+
+    // Two anon to blind transactions spending different outputs
+    std::vector<CTransactionRef> txns;
+    {
+    LOCK(pwallet->cs_wallet);
+    std::vector<COutputR> vAvailableCoins;
+    CCoinControl cctl_all;
+    pwallet->AvailableAnonCoins(vAvailableCoins, &cctl_all, 100000);
+    BOOST_REQUIRE(vAvailableCoins.size() >= 2);
+    for (size_t i = 0; i < 2; ++i) {
+        const COutputR &output = vAvailableCoins[i];
+        CCoinControl cctl;
+        cctl.Select(COutPoint(output.txhash, output.i));
+
+        std::vector<CTempRecipient> vecSend;
+        vecSend.emplace_back(OUTPUT_CT, output.rtx->second.GetOutput(output.i)->nValue, stealth_address);
+        vecSend.back().fSubtractFeeFromAmount = true;
+
+        CTransactionRef tx_new;
+        CWalletTx wtx(tx_new, TxStateInactive{});
+        CTransactionRecord rtx;
+        CAmount nFee;
+        BOOST_REQUIRE(0 == pwallet->AddAnonInputs(wtx, rtx, vecSend, true, 3, 1, nFee, &cctl, sError));
+        txns.push_back(wtx.tx);
+    }
+    }
+
+    auto range_proof_entry = [](const CTransaction &tx, size_t n) {
+        const CTxOutCT *txout = (const CTxOutCT*)tx.vpout[n].get();
+        return RangeProofCacheEntry(txout->commitment, txout->vRangeproof, /*bulletproof=*/true);
+    };
+    size_t blind_output = 0;
+    while (blind_output < txns[1]->vpout.size() && !txns[1]->vpout[blind_output]->IsType(OUTPUT_CT)) {
+        ++blind_output;
+    }
+    BOOST_REQUIRE(blind_output < txns[1]->vpout.size());
+
+    // Prevalidation verifies and caches the proofs
+    BOOST_CHECK(!PrevalidationCacheContains(range_proof_entry(*txns[1], blind_output), /*erase=*/false));
+    BOOST_CHECK(!PrevalidationCacheContains(MLSAGEntryOf(blocktree, *txns[1], 0), /*erase=*/false));
+    m_node.chainman->PrevalidateTransaction(txns[1]);
+    BOOST_CHECK(PrevalidationCacheContains(range_proof_entry(*txns[1], blind_output), /*erase=*/false));
+    BOOST_CHECK(PrevalidationCacheContains(MLSAGEntryOf(blocktree, *txns[1], 0), /*erase=*/false));
+
+    // Rangeproofs found in the cache are not verified again, so no time is
+    // spent in the rangeproof phase while accepting the prevalidated transaction
+    g_validation_phase_times.enabled = true;
+    g_validation_phase_times.rangeproof = 0;
+    BOOST_CHECK(WITH_LOCK(cs_main, return m_node.chainman->ProcessTransaction(txns[0])).m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(g_validation_phase_times.rangeproof > 0);
+    g_validation_phase_times.rangeproof = 0;
+    BOOST_CHECK(WITH_LOCK(cs_main, return m_node.chainman->ProcessTransaction(txns[1])).m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(g_validation_phase_times.rangeproof, 0);
+    g_validation_phase_times.enabled = false;
+
+    // A transaction reusing a key image in the mempool is not prevalidated
+    CMutableTransaction mtx_dup(*txns[1]);
+    mtx_dup.vpout.pop_back();
+    const CTransactionRef tx_dup = MakeTransactionRef(mtx_dup);
+    m_node.chainman->PrevalidateTransaction(tx_dup);
+    BOOST_CHECK(!PrevalidationCacheContains(MLSAGEntryOf(blocktree, *tx_dup, 0), /*erase=*/false));
+
+    globe::SetNumBlocksOfPeers(peer_blocks);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <test/util/setup_common.h>
+#include <wallet/rescan.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace wallet {
+BOOST_FIXTURE_TEST_SUITE(rescan_tests, BasicTestingSetup)
+
+struct TestBlocks {
+    std::vector<CBlock> blocks;
+    int reads{0};
+
+    explicit TestBlocks(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            CBlock block;
+            block.nTime = i;
+            CMutableTransaction mtx;
+            mtx.vout.resize(1);
+            mtx.vout[0].nValue = i;
+            block.vtx.push_back(MakeTransactionRef(mtx));
+            blocks.push_back(block);
+        }
+    }
+    RescanCoordinator::BlockReader Reader()
+    {
+        return [this](const uint256& hash, CBlock& block) {
+            for (const auto& b : blocks) {
+                if (b.GetHash() == hash) {
+                    reads++;
+                    block = b;
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+};
+
+BOOST_AUTO_TEST_CASE(rescan_shared_reads)
+{
+    TestBlocks chain(10);
+    RescanCoordinator coordinator;
+    {
+        RescanCoordinator::Scan scan_a(coordinator, 0);
+        RescanCoordinator::Scan scan_b(coordinator, 0);
+        for (int h = 0; h < 10; ++h) {
+            auto block = scan_a.ReadBlock(chain.blocks[h].GetHash(), h, chain.Reader());
+            BOOST_REQUIRE(block);
+            BOOST_CHECK(block->GetHash() == chain.blocks[h].GetHash());
+        }
+        // Scan b has not passed the blocks yet
+        BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 10U);
+        for (int h = 0; h < 10; ++h) {
+            auto block = scan_b.ReadBlock(chain.blocks[h].GetHash(), h, chain.Reader());
+            BOOST_REQUIRE(block);
+            BOOST_CHECK(block->GetHash() == chain.blocks[h].GetHash());
+        }
+        BOOST_CHECK_EQUAL(chain.reads, 10);
+        BOOST_CHECK_EQUAL(coordinator.GetStats().hits, 10U);
+        // Only the block both scans are at is kept
+        BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 1U);
+    }
+    BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 0U);
+    BOOST_CHECK_EQUAL(coordinator.GetStats().cached_usage, 0U);
+
+    // A lone scan keeps nothing
+    {
+        RescanCoordinator::Scan scan(coordinator, 5);
+        for (int h = 5; h < 10; ++h) {
+            BOOST_CHECK(scan.ReadBlock(chain.blocks[h].GetHash(), h, chain.Reader()));
+            BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 0U);
+        }
+    }
+
+    // Unknown blocks are reported and not cached
+    {
+        RescanCoordinator::Scan scan(coordinator, 0);
+        BOOST_CHECK(!scan.ReadBlock(uint256::ONE, 0, chain.Reader()));
+        BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 0U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rescan_cache_limit)
+{
+    TestBlocks chain(10);
+    // Room for no block, a scan falling behind reads blocks again
+    RescanCoordinator coordinator(/*max_usage=*/1);
+    RescanCoordinator::Scan scan_a(coordinator, 0);
+    RescanCoordinator::Scan scan_b(coordinator, 0);
+    for (int h = 0; h < 10; ++h) {
+        BOOST_CHECK(scan_a.ReadBlock(chain.blocks[h].GetHash(), h, chain.Reader()));
+        BOOST_CHECK_EQUAL(coordinator.GetStats().cached_blocks, 0U);
+    }
+    for (int h = 0; h < 10; ++h) {
+        BOOST_CHECK(scan_b.ReadBlock(chain.blocks[h].GetHash(), h, chain.Reader()));
+    }
+    BOOST_CHECK_EQUAL(chain.reads, 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace wallet
@@ -37,6 +37,7 @@
 #include <wallet/coincontrol.h>
 #include <wallet/context.h>
 #include <wallet/fees.h>
+#include <wallet/rescan.h>
 #include <wallet/external_signer_scriptpubkeyman.h>
 
 #include <univalue.h>
@@ -1791,6 +1792,12 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     uint256 block_hash = start_block;
     ScanResult result;
 
+    // Blocks are shared with other wallets rescanning at the same time
+    RescanCoordinator::Scan shared_scan(GetRescanCoordinator(), start_height);
+    const RescanCoordinator::BlockReader read_block = [this](const uint256& hash, CBlock& block) {
+        return chain().findBlock(hash, FoundBlock().data(block));
+    };
+
     WalletLogPrintf("Rescan started from block %s...\n", start_block.ToString());
 
     fAbortRescan = false;
@@ -1819,8 +1826,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         }
 
         // Read block data
-        CBlock block;
-        chain().findBlock(block_hash, FoundBlock().data(block));
+        std::shared_ptr<const CBlock> block = shared_scan.ReadBlock(block_hash, block_height, read_block);
 
         // Find next block separately from reading data above, because reading
         // is slow and there might be a reorg while it is read.
@@ -1829,7 +1835,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         uint256 next_block_hash;
         chain().findBlock(block_hash, FoundBlock().inActiveChain(block_still_active).nextBlock(FoundBlock().inActiveChain(next_block).hash(next_block_hash)));
 
-        if (!block.IsNull()) {
+        if (block) {
             LOCK(cs_wallet);
             if (!block_still_active) {
                 // Abort scan if current block is no longer active, to prevent
@@ -1838,8 +1844,8 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                 result.status = ScanResult::FAILURE;
                 break;
             }
-            for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
+            for (size_t posInBlock = 0; posInBlock < block->vtx.size(); ++posInBlock) {
+                SyncTransaction(block->vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
             }
             // scan succeeded, record block as most recent successfully scanned
             result.last_scanned_block = block_hash;
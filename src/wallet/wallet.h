@@ -576,6 +576,8 @@ public:
 
     //! For GlobeWallet, clear cached balances from wallet called at new block and adding new transaction
     virtual void ClearCachedBalances() {};
+    //! For GlobeWallet, write caches kept in memory to the db, called periodically and at shutdown
+    virtual void FlushCaches() {};
     void MarkDirty();
 
     //! Callback for updating transaction metadata in mapWallet.
@@ -786,6 +788,7 @@ public:
     virtual bool IsFromMe(const CTransaction& tx) const;
     virtual CAmount GetDebit(const CTransaction& tx, const isminefilter& filter) const;
     void chainStateFlushed(const CBlockLocator& loc) override;
+    std::string notificationsName() const override { return "wallet " + (GetName().empty() ? "default wallet" : GetName()); }
 
     DBErrors virtual LoadWallet();
     DBErrors ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256>& vHashOut) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -76,6 +76,8 @@ const std::string PART_LOCKEDUTXO{"luo"};
 const std::string PART_SXADDR{"sxad"};
 const std::string PART_WALLETSETTING{"wset"};
 const std::string PART_LEXTKEYCK{"elck"};
+const std::string PART_DEVICEKEYCACHE{"dkc"};
+const std::string PART_ANONOUTPUTCACHE{"aoc"};
 
 const std::unordered_set<std::string> LEGACY_TYPES{CRYPTED_KEY, CSCRIPT, DEFAULTKEY, HDCHAIN, KEYMETA, KEY, OLD_KEY, POOL, WATCHMETA, WATCHS};
 } // namespace DBKeys
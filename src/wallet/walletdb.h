@@ -102,6 +102,8 @@ extern const std::string PART_LOCKEDUTXO;
 extern const std::string PART_SXADDR;
 extern const std::string PART_WALLETSETTING;
 extern const std::string PART_LEXTKEYCK;
+extern const std::string PART_DEVICEKEYCACHE;
+extern const std::string PART_ANONOUTPUTCACHE;
 
 // Keys in this set pertain only to the legacy wallet (LegacyScriptPubKeyMan) and are removed during migration from legacy to descriptors.
 extern const std::unordered_set<std::string> LEGACY_TYPES;
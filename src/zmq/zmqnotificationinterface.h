@@ -41,6 +41,8 @@ protected:
     void TransactionAddedToWallet(const std::string &sWalletName, const CTransactionRef& tx) override;
     void NewSecureMessage(const smsg::SecureMessage *psmsg, const uint160 &hash) override;
 
+    std::string ValidationQueueName() const override { return "zmq"; }
+
 private:
     CZMQNotificationInterface();
 
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023 The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test loading the block index from the snapshot written at shutdown.
+
+A snapshot is only valid until the block tree db is written again, a start
+with -blockindexsnapshot=0 must drop it so it is not loaded later.
+"""
+
+import os
+
+from test_framework.test_framework import GlobeTestFramework
+from test_framework.util import assert_equal
+
+
+class BlockIndexSnapshotTest(GlobeTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+
+    def run_test(self):
+        node = self.nodes[0]
+        snapshot_path = os.path.join(node.datadir, self.chain, "blocks", "blockindex.dat")
+
+        self.generate(node, 10)
+        best_hash = node.getbestblockhash()
+
+        self.log.info("Load the block index from the snapshot written at shutdown")
+        with node.assert_debug_log(expected_msgs=["Wrote 11 block index entries"]):
+            self.stop_node(0)
+        assert os.path.isfile(snapshot_path)
+        with node.assert_debug_log(expected_msgs=["Loaded 11 block index entries from snapshot"]):
+            self.start_node(0)
+        assert_equal(node.getbestblockhash(), best_hash)
+
+        self.log.info("An unchanged block index keeps the snapshot instead of writing it again")
+        with node.assert_debug_log(expected_msgs=["Block index unchanged, kept"], unexpected_msgs=["Wrote 11 block index entries"]):
+            self.stop_node(0)
+        with node.assert_debug_log(expected_msgs=["Loaded 11 block index entries from snapshot"]):
+            self.start_node(0)
+
+        self.log.info("Start with the snapshot disabled, then connect a block")
+        self.restart_node(0, extra_args=["-blockindexsnapshot=0"])
+        self.generate(node, 1)
+        best_hash = node.getbestblockhash()
+        self.stop_node(0)
+
+        self.log.info("The stale snapshot is rejected when enabled again")
+        with node.assert_debug_log(expected_msgs=["Loaded 12 block index entries from database"],
+                                   unexpected_msgs=["from snapshot"]):
+            self.start_node(0)
+        assert_equal(node.getbestblockhash(), best_hash)
+        assert_equal(node.getblockcount(), 11)
+
+
+if __name__ == '__main__':
+    BlockIndexSnapshotTest().main()
@@ -98,6 +98,15 @@ class TxIndexTest(GlobeTestFramework):
         assert (ro[0]['addrspend'] == ro[1]['addrspend'] == addrSpend)
         ro = nodes[2].listcoldstakeunspent(addrStake, 2, {'mature_only': True})
         assert (len(ro) == 0)
+
+        ro = nodes[2].getcoldstakeweights(addrStake)
+        assert (ro['num_delegators'] == 1)
+        assert (ro['total'] == 2400000000000)
+        assert (ro['delegators'][0]['addrspend'] == addrSpend)
+        assert (ro['delegators'][0]['num_outputs'] == 2)
+        assert (ro['delegators'][0]['checkpoint_height'] == 2)
+        ro = nodes[2].getcoldstakeweights(addrStake, 1)
+        assert (ro['num_delegators'] == 0)
         ro = nodes[2].listcoldstakeunspent(addrStake, 2, {'mature_only': True, 'all_staked': True})
         assert (len(ro) == 0)
 
@@ -133,6 +142,8 @@ class TxIndexTest(GlobeTestFramework):
         assert (ro[0]['height'] == 2)
         assert (ro[1]['height'] == 2)
         assert (len(ro) == 2)
+        ro = nodes[2].getcoldstakeweights(addrStake, 4)
+        assert (ro['delegators'][0]['num_outputs'] == 2)
 
         ro = nodes[1].listcoldstakeunspent(addrStake)
         assert (len(ro) == 3)
@@ -189,6 +200,28 @@ class TxIndexTest(GlobeTestFramework):
                 num_found += 1
         assert (num_found == 2)
 
+        spend_addrs = []
+        page = ''
+        while True:
+            ro = nodes[2].getcoldstakeweights(addrStake, -1, {'count': 1, 'page': page})
+            assert (ro['num_delegators'] <= 1)
+            spend_addrs += [d['addrspend'] for d in ro['delegators']]
+            if 'next_page' not in ro:
+                break
+            page = ro['next_page']
+        assert (ms_addr0['address'] in spend_addrs)
+        assert (ms_addr1['address'] in spend_addrs)
+
+        ro = nodes[2].getcoldstakeweights(addrStake)
+        assert (ro['num_delegators'] == len(spend_addrs))
+        ro_hex = nodes[2].getcoldstakeweights(addrStake, -1, {'hex': True})
+        assert (ro_hex['total'] == ro['total'])
+        assert ('delegators' not in ro_hex)
+
+        ro_max = nodes[2].getcoldstakeweights(addrStake, 2**31 - 1)
+        assert (ro_max['height'] == ro['height'] == nodes[2].getblockcount())
+        assert (ro_max['total'] == ro['total'])
+
 
 if __name__ == '__main__':
     TxIndexTest().main()
@@ -425,6 +425,15 @@ class AnonTest(GlobeTestFramework):
         assert (spent['spent'] is True)
         assert (spent['txid'] == spending_txid)
 
+        spent = nodes[0].checkkeyimages([used_keyimage, keyimage, used_keyimage])
+        assert (len(spent) == 3)
+        assert (spent[0]['keyimage'] == used_keyimage)
+        assert (spent[0]['spent'] is True)
+        assert (spent[0]['txid'] == spending_txid)
+        assert (spent[1]['spent'] is False)
+        assert (spent[2] == spent[0])
+        assert (nodes[0].checkkeyimages([]) == [])
+
         self.log.info('Test rollbackrctindex')
         nodes[0].rollbackrctindex()
 
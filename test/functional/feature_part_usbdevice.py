@@ -82,6 +82,15 @@ class USBDeviceTest(GlobeTestFramework):
         assert (ro['extkey'] == 'pparszKXPyRegWYwPacdPduNPNEryRbZDCAiSyo8oZYSsbTjc6FLP4TCPEX58kAeCB6YW9cSdR6fsbpeWDBTgjbkYjXCoD9CNoFVefbkg3exzpQE')
         assert (ro['path'] == "m/44'/1'/0'")
 
+        device_keys = nodes[1].debugwallet()['device_key_cache']
+        assert (device_keys['device'] == 'ffff:0001:1')
+        assert (device_keys['size'] == 2)
+        assert (device_keys['operations']['initaccountfromdevice']['calls'] == 2)
+        assert (device_keys['operations']['initaccountfromdevice']['round_trips'] == 2)
+        # The lookahead derives from the stored chains, not the device
+        assert (device_keys['operations']['lookahead']['calls'] > 0)
+        assert (device_keys['operations']['lookahead']['round_trips'] == 0)
+
         ro = nodes[1].extkey('list', 'true')
         assert (len(ro) == 1)
         assert (ro[0]['path'] == "m/44h/1h/0h")
@@ -231,6 +240,9 @@ class USBDeviceTest(GlobeTestFramework):
         self.restart_node(1, extra_args=self.extra_args[1] + ['-wallet=default_wallet',])
         account1_r = nodes[1].extkey('account')
         assert (json.dumps(account1) == json.dumps(account1_r))
+        device_keys = nodes[1].debugwallet()['device_key_cache']
+        assert (device_keys['device'] == 'ffff:0001:1')
+        assert (device_keys['size'] >= 2)
 
         # Test for coverage
         assert (nodes[1].promptunlockdevice()['sent'] is True)
@@ -123,6 +123,13 @@ class RESTTest (GlobeTestFramework):
         resp = self.test_rest_request(uri=f"/tx/{UNKNOWN_PARAM}", ret_type=RetType.OBJ, status=404)
         assert_equal(resp.read().decode('utf-8').rstrip(), f"{UNKNOWN_PARAM} not found")
 
+        # Test /tx with shortened proofs
+        json_obj = self.test_rest_request(f"/tx/{txid}", query_params={"proofs": "omit"})
+        assert_equal(json_obj['txid'], txid)
+        assert 'hex' not in json_obj
+        resp = self.test_rest_request(f"/tx/{txid}", ret_type=RetType.OBJ, status=400, query_params={"proofs": "all"})
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid proofs parameter")
+
         self.log.info("Query an unspent TXO using the /getutxos URI")
 
         self.generate(self.wallet, 1)
@@ -258,6 +265,29 @@ class RESTTest (GlobeTestFramework):
         # Check json format
         block_json_obj = self.test_rest_request(f"/block/{bb_hash}")
         assert_equal(block_json_obj['hash'], bb_hash)
+
+        # Block json is sent with chunked transfer encoding, one chunk per transaction
+        response_json = self.test_rest_request(f"/block/{bb_hash}", ret_type=RetType.OBJ)
+        assert_equal(response_json.getheader('transfer-encoding'), 'chunked')
+        assert_equal(json.loads(response_json.read().decode('utf-8'), parse_float=Decimal), block_json_obj)
+
+        # Check the proofs parameter against the full block, which holds the test transaction
+        for proofs in ['truncate', 'omit']:
+            json_obj = self.test_rest_request(f"/block/{bb_hash}", query_params={"proofs": proofs})
+            assert_equal(json_obj['hash'], bb_hash)
+            assert_equal(len(json_obj['tx']), len(block_json_obj['tx']))
+            for tx, full_tx in zip(json_obj['tx'], block_json_obj['tx']):
+                assert_equal(tx['txid'], full_tx['txid'])
+                assert 'hex' not in tx
+                for vin, full_vin in zip(tx['vin'], full_tx['vin']):
+                    if 'txinwitness' not in full_vin:
+                        continue
+                    assert_equal(vin['witness_size'], sum(len(item) // 2 for item in full_vin['txinwitness']))
+                    if proofs == 'omit':
+                        assert 'txinwitness' not in vin
+                    else:
+                        assert_equal(vin['txinwitness'], [item[:64] for item in full_vin['txinwitness']])
+        self.test_rest_request(f"/block/{bb_hash}", ret_type=RetType.OBJ, status=400, query_params={"proofs": "all"})
         assert_equal(self.test_rest_request(f"/blockhashbyheight/{block_json_obj['height']}")['blockhash'], bb_hash)
 
         # Check hex/bin format
@@ -4,10 +4,13 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Tests some generic aspects of the RPC interface."""
 
+import http.client
 import os
+import urllib.parse
 from test_framework.authproxy import JSONRPCException
 from test_framework.test_framework import GlobeTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.test_node import ErrorMatch
+from test_framework.util import assert_equal, assert_greater_than_or_equal, str_to_b64str
 from threading import Thread
 import subprocess
 
@@ -22,6 +25,16 @@ def expect_http_status(expected_http_status, expected_rpc_code,
         assert_equal(exc.http_status, expected_http_status)
 
 
+def post_raw_request(node, body, auth=True):
+    url = urllib.parse.urlparse(node.url)
+    headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"} if auth else {}
+    conn = http.client.HTTPConnection(url.hostname, url.port)
+    conn.request('POST', '/', body, headers)
+    status = conn.getresponse().status
+    conn.close()
+    return status
+
+
 def test_work_queue_getblock(node, got_exceeded_error):
     while not got_exceeded_error:
         try:
@@ -74,6 +87,30 @@ class RPCInterfaceTest(GlobeTestFramework):
         assert_equal(result_by_id[3]['error'], None)
         assert result_by_id[3]['result'] is not None
 
+    def test_batch_request_order(self):
+        self.log.info("Testing parallel JSON-RPC batch request keeps order...")
+
+        node = self.nodes[0]
+        genesis_hash = node.getblockhash(0)
+        requests = []
+        for i in range(64):
+            if i % 16 == 15:
+                # Not parallel safe, splits the batch into runs
+                requests.append({"method": "getrpcinfo", "id": i})
+            elif i % 2 == 0:
+                requests.append({"method": "getblockhash", "id": i, "params": [0]})
+            else:
+                requests.append({"method": "getblockheader", "id": i, "params": [genesis_hash]})
+
+        for args in [[], ['-rpcbatchparallel=1'], ['-rpcbatchparallel=8', '-rpcworkqueue=1', '-rpcthreads=2']]:
+            self.restart_node(0, args)
+            results = node.batch(requests)
+            assert_equal([res['id'] for res in results], list(range(64)))
+            for res in results:
+                assert_equal(res['error'], None)
+                if res['id'] % 16 != 15 and res['id'] % 2 == 0:
+                    assert_equal(res['result'], genesis_hash)
+
     def test_http_status_codes(self):
         self.log.info("Testing HTTP status codes for JSON-RPC requests...")
 
@@ -92,11 +129,50 @@ class RPCInterfaceTest(GlobeTestFramework):
         for t in threads:
             t.join()
 
+    def test_work_queue_priorities(self):
+        self.log.info("Testing work queue priorities...")
+        node = self.nodes[0]
+        self.restart_node(0, ['-rpcpriority=getblockhash:high', '-rpcpriority=getblockcount:low', '-rpcmethodlimit=getblockheader:1'])
+        genesis_hash = node.getblockhash(0)
+        node.getblockcount()
+        node.getblockheader(genesis_hash)
+        node.getblockheader(genesis_hash)
+
+        work_queue = node.getrpcinfo()['work_queue']
+        assert_equal(work_queue['getblockhash']['count'], 1)
+        assert_equal(work_queue['getblockcount']['count'], 1)
+        assert_equal(work_queue['getblockheader']['count'], 2)
+        assert_equal(work_queue['high']['count'], 1)
+        assert_equal(work_queue['low']['count'], 1)
+        # getrpcinfo itself is running
+        assert_equal(work_queue['normal']['running'], 1)
+
+        # Only the top level method counts, ambiguous and unauthorized calls are queued at low priority
+        assert_equal(post_raw_request(node, '{"id":{"method":"getblockhash"},"method":"getblockcount"}'), 200)
+        post_raw_request(node, '{"method":"getblockhash","method":"getblockcount","params":[0]}')
+        assert_equal(post_raw_request(node, '{"method":"getblockhash","params":[0]}', auth=False), 401)
+        work_queue = node.getrpcinfo()['work_queue']
+        assert_equal(work_queue['getblockhash']['count'], 1)
+        assert_equal(work_queue['getblockcount']['count'], 2)
+        assert_equal(work_queue['high']['count'], 1)
+        assert_equal(work_queue['low']['count'], 4)
+        for stats in work_queue.values():
+            assert_greater_than_or_equal(stats['max_wait'], 0)
+            assert_equal(stats['queued'], 0)
+
+        self.stop_node(0)
+        node.assert_start_raises_init_error(['-rpcpriority=getblockcount:urgent'], 'Invalid -rpcpriority level: urgent.', match=ErrorMatch.PARTIAL_REGEX)
+        node.assert_start_raises_init_error(['-rpcmethodlimit=getblockcount:0'], 'Invalid -rpcmethodlimit count: 0.', match=ErrorMatch.PARTIAL_REGEX)
+        node.assert_start_raises_init_error(['-rpcmethodlimit=getblockcount'], 'Invalid -rpcmethodlimit specification', match=ErrorMatch.PARTIAL_REGEX)
+        self.start_node(0)
+
     def run_test(self):
         self.test_getrpcinfo()
         self.test_batch_request()
+        self.test_batch_request_order()
         self.test_http_status_codes()
         self.test_work_queue_exceeded()
+        self.test_work_queue_priorities()
 
 
 if __name__ == '__main__':
@@ -100,6 +100,22 @@ class RpcMiscTest(GlobeTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test getvalidationqueueinfo")
+        queues = node.getvalidationqueueinfo()
+        assert_equal([q["name"] for q in queues], ["shared"])
+
+        # Each subscriber gets its own queue
+        self.restart_node(0, ["-txindex", "-validationqueues"])
+        self.wait_until(lambda: node.getindexinfo()["txindex"]["synced"])
+        self.generate(node, 1)
+        queues = {q["name"]: q for q in node.getvalidationqueueinfo()}
+        assert "txindex" in queues
+        assert "peerman" in queues
+        for q in queues.values():
+            assert_equal(q["pending"], 0)
+            assert_equal(q["lag_ms"], 0)
+        assert queues["txindex"]["processed"] > 0
+
 
 if __name__ == '__main__':
     RpcMiscTest().main()